@@ -10,7 +10,7 @@ endif()
 
 function(pika_add_test category name)
   set(options FAILURE_EXPECTED RUN_SERIAL TESTING PERFORMANCE_TESTING)
-  set(one_value_args COST EXECUTABLE RANKS THREADS TIMEOUT RUNWRAPPER)
+  set(one_value_args COST EXECUTABLE PSEUDO_DEPS_NAME RANKS THREADS TIMEOUT RUNWRAPPER)
   set(multi_value_args ARGS)
   cmake_parse_arguments(${name} "${options}" "${one_value_args}" "${multi_value_args}" ${ARGN})
 
@@ -0,0 +1,84 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// A version of jacobi_pika which distributes the grids over the NUMA domains
+// of the machine. The grids are first touched by a bulk with NUMA affinity
+// and every iteration uses a bulk with the same scheduler and shape, so
+// that each block of rows is updated by the worker thread that placed it.
+
+#include "jacobi.hpp"
+
+#include <pika/execution.hpp>
+#include <pika/timing/high_resolution_timer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+namespace jacobi_smp {
+
+    void jacobi(std::size_t n, std::size_t iterations, std::size_t block_size,
+        std::string const& output_filename)
+    {
+        // The grids are default-initialized so that the pages are first
+        // touched by the bulk below
+        std::unique_ptr<double[]> grid_new(new double[n * n]);
+        std::unique_ptr<double[]> grid_old(new double[n * n]);
+
+        std::size_t n_block = static_cast<std::size_t>(
+            std::ceil(static_cast<double>(n - 2) / static_cast<double>(block_size)));
+
+        // Each block is its own chunk, so that every bulk below assigns the
+        // blocks to the same worker threads
+        auto const sched =
+            ex::with_chunk_size(ex::with_numa_affinity(ex::thread_pool_scheduler{}, true), 1);
+
+        // The rows updated by block j. The first and last blocks also own
+        // the boundary rows, which are only initialized.
+        auto const block_rows = [=](std::size_t j) {
+            std::size_t const y = 1 + j * block_size;
+            return range(y, (std::min)(y + block_size, n - 1));
+        };
+
+        tt::sync_wait(ex::schedule(sched) | ex::bulk(n_block, [&](std::size_t j) {
+            range r = block_rows(j);
+            std::size_t const y_begin = j == 0 ? 0 : r.begin();
+            std::size_t const y_end = j + 1 == n_block ? n : r.end();
+            std::fill(grid_new.get() + y_begin * n, grid_new.get() + y_end * n, 1.0);
+            std::fill(grid_old.get() + y_begin * n, grid_old.get() + y_end * n, 1.0);
+        }));
+
+        pika::chrono::detail::high_resolution_timer t;
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            tt::sync_wait(ex::schedule(sched) |
+                ex::bulk(n_block, [&, dst = grid_new.get(), src = grid_old.get()](std::size_t j) {
+                    range r = block_rows(j);
+                    for (std::size_t y = r.begin(); y < r.end(); ++y)
+                    {
+                        jacobi_kernel(dst + y * n, src + y * n, n);
+                    }
+                }));
+
+            std::swap(grid_new, grid_old);
+        }
+
+        report_timing(n, iterations, t.elapsed<std::chrono::seconds>());
+        if (!output_filename.empty())
+        {
+            output_grid(
+                output_filename, std::vector<double>(grid_old.get(), grid_old.get() + n * n), n);
+        }
+    }
+}    // namespace jacobi_smp
@@ -0,0 +1,50 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/algorithms/detail/blocks.hpp>
+#include <pika/concepts/concepts.hpp>
+#include <pika/execution/algorithms/then.hpp>
+#include <pika/execution_base/sender.hpp>
+#include <pika/executors/thread_pool_scheduler.hpp>
+#include <pika/iterator_support/traits/is_iterator.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace pika::algorithms::copy_detail {
+    template <typename RandomIt, typename OutputIt>
+    struct copy_element
+    {
+        RandomIt first;
+        OutputIt d_first;
+
+        void operator()(std::size_t i) { d_first[i] = first[i]; }
+    };
+}    // namespace pika::algorithms::copy_detail
+
+namespace pika::algorithms::experimental {
+    /// Returns a sender which copies the elements of [first, last) to the
+    /// range beginning at d_first on the thread_pool_scheduler. The elements
+    /// are copied in an unspecified order and concurrently, so the ranges
+    /// must not overlap. The sender sends the end of the output range.
+    template <typename RandomIt, typename OutputIt,
+        PIKA_CONCEPT_REQUIRES_(pika::traits::is_random_access_iterator_v<RandomIt>&&
+                pika::traits::is_random_access_iterator_v<OutputIt>)>
+    auto copy(pika::execution::experimental::thread_pool_scheduler scheduler, RandomIt first,
+        RandomIt last, OutputIt d_first)
+    {
+        auto const n = static_cast<std::size_t>(std::distance(first, last));
+        auto sender = pika::execution::experimental::schedule(scheduler);
+        return pika::execution::experimental::then(
+            detail::bulk(PIKA_MOVE(scheduler), PIKA_MOVE(sender), n,
+                copy_detail::copy_element<RandomIt, OutputIt>{first, d_first}),
+            detail::send_output_end<OutputIt>{std::next(d_first, n)});
+    }
+}    // namespace pika::algorithms::experimental
@@ -0,0 +1,69 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/executors/thread_pool_scheduler.hpp>
+#include <pika/executors/thread_pool_scheduler_bulk.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace pika::algorithms::detail {
+    // Calls f(i, ts...) for i in [0, shape) with the values ts sent by
+    // sender, using the bulk of the thread_pool_scheduler. sender must
+    // complete on a thread of the scheduler.
+    template <typename Sender, typename F>
+    auto bulk(pika::execution::experimental::thread_pool_scheduler scheduler, Sender&& sender,
+        std::size_t shape, F&& f)
+    {
+        return thread_pool_bulk_detail::thread_pool_bulk_sender<std::decay_t<Sender>, std::size_t,
+            std::decay_t<F>>{
+            PIKA_MOVE(scheduler), PIKA_FORWARD(Sender, sender), shape, PIKA_FORWARD(F, f)};
+    }
+
+    // The number of blocks to split n elements into for algorithms which
+    // work on contiguous blocks of elements instead of single elements.
+    // Blocks have at least min_block_size elements, except if there are
+    // fewer elements than that, and there are at most blocks_per_thread
+    // blocks per worker thread of the scheduler.
+    inline std::size_t get_num_blocks(
+        pika::execution::experimental::thread_pool_scheduler scheduler, std::size_t n,
+        std::size_t min_block_size, std::size_t blocks_per_thread)
+    {
+        if (n == 0) { return 0; }
+
+        std::size_t const num_threads = scheduler.get_thread_pool()->get_os_thread_count();
+        std::size_t const max_num_blocks =
+            (std::max)(num_threads * blocks_per_thread, std::size_t(1));
+        return (std::clamp)(n / min_block_size, std::size_t(1), max_num_blocks);
+    }
+
+    // The half-open range of indices of block out of num_blocks equally
+    // sized blocks of n elements. The first n % num_blocks blocks have one
+    // element more than the rest.
+    inline std::pair<std::size_t, std::size_t>
+    get_block(std::size_t n, std::size_t num_blocks, std::size_t block) noexcept
+    {
+        std::size_t const block_size = n / num_blocks;
+        std::size_t const remainder = n % num_blocks;
+        std::size_t const begin = block * block_size + (std::min)(block, remainder);
+        return {begin, begin + block_size + (block < remainder ? 1 : 0)};
+    }
+
+    // Sends the end of the output range once the elements have been
+    // written
+    template <typename OutputIt>
+    struct send_output_end
+    {
+        OutputIt d_last;
+
+        OutputIt operator()() { return d_last; }
+    };
+}    // namespace pika::algorithms::detail
@@ -0,0 +1,46 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/algorithms/detail/blocks.hpp>
+#include <pika/concepts/concepts.hpp>
+#include <pika/execution_base/sender.hpp>
+#include <pika/executors/thread_pool_scheduler.hpp>
+#include <pika/iterator_support/traits/is_iterator.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace pika::algorithms::fill_detail {
+    template <typename RandomIt, typename T>
+    struct fill_element
+    {
+        RandomIt first;
+        std::decay_t<T> value;
+
+        void operator()(std::size_t i) { first[i] = value; }
+    };
+}    // namespace pika::algorithms::fill_detail
+
+namespace pika::algorithms::experimental {
+    /// Returns a sender which assigns value to each element of [first,
+    /// last) on the thread_pool_scheduler. The elements are assigned in an
+    /// unspecified order and concurrently. The sender sends no values.
+    template <typename RandomIt, typename T,
+        PIKA_CONCEPT_REQUIRES_(pika::traits::is_random_access_iterator_v<RandomIt>)>
+    auto fill(pika::execution::experimental::thread_pool_scheduler scheduler, RandomIt first,
+        RandomIt last, T&& value)
+    {
+        auto const n = static_cast<std::size_t>(std::distance(first, last));
+        auto sender = pika::execution::experimental::schedule(scheduler);
+        return detail::bulk(PIKA_MOVE(scheduler), PIKA_MOVE(sender), n,
+            fill_detail::fill_element<RandomIt, T>{first, PIKA_FORWARD(T, value)});
+    }
+}    // namespace pika::algorithms::experimental
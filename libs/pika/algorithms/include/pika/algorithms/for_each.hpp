@@ -0,0 +1,47 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/algorithms/detail/blocks.hpp>
+#include <pika/concepts/concepts.hpp>
+#include <pika/execution_base/sender.hpp>
+#include <pika/executors/thread_pool_scheduler.hpp>
+#include <pika/functional/detail/invoke.hpp>
+#include <pika/iterator_support/traits/is_iterator.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace pika::algorithms::for_each_detail {
+    template <typename RandomIt, typename F>
+    struct for_each_element
+    {
+        RandomIt first;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<F> f;
+
+        void operator()(std::size_t i) { PIKA_INVOKE(f, first[i]); }
+    };
+}    // namespace pika::algorithms::for_each_detail
+
+namespace pika::algorithms::experimental {
+    /// Returns a sender which calls f with a reference to each element of
+    /// [first, last) on the thread_pool_scheduler. The elements are visited
+    /// in an unspecified order and concurrently. The sender sends no values.
+    template <typename RandomIt, typename F,
+        PIKA_CONCEPT_REQUIRES_(pika::traits::is_random_access_iterator_v<RandomIt>)>
+    auto for_each(pika::execution::experimental::thread_pool_scheduler scheduler, RandomIt first,
+        RandomIt last, F&& f)
+    {
+        auto const n = static_cast<std::size_t>(std::distance(first, last));
+        auto sender = pika::execution::experimental::schedule(scheduler);
+        return detail::bulk(PIKA_MOVE(scheduler), PIKA_MOVE(sender), n,
+            for_each_detail::for_each_element<RandomIt, F>{first, PIKA_FORWARD(F, f)});
+    }
+}    // namespace pika::algorithms::experimental
@@ -0,0 +1,268 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/algorithms/detail/blocks.hpp>
+#include <pika/concepts/concepts.hpp>
+#include <pika/concurrency/cache_line_data.hpp>
+#include <pika/execution/algorithms/then.hpp>
+#include <pika/execution_base/sender.hpp>
+#include <pika/executors/thread_pool_scheduler.hpp>
+#include <pika/functional/detail/invoke.hpp>
+#include <pika/iterator_support/traits/is_iterator.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pika::algorithms::scan_detail {
+    inline constexpr std::size_t min_block_size = 4096;
+    inline constexpr std::size_t blocks_per_thread = 4;
+
+    // The aggregate is the reduction of the elements of the block alone
+    // and is written by the first pass. The inclusive prefix additionally
+    // includes all preceding blocks and the initial value. It is written by
+    // the second pass and published with prefix_available.
+    template <typename T>
+    struct block_descriptor
+    {
+        std::atomic<bool> prefix_available{false};
+        std::optional<T> aggregate;
+        std::optional<T> inclusive_prefix;
+    };
+
+    template <typename RandomIt, typename OutputIt, typename T, typename BinaryOp>
+    struct scan_state
+    {
+        using value_type = T;
+
+        RandomIt first;
+        OutputIt d_first;
+        std::size_t n;
+        std::size_t num_blocks;
+        std::optional<T> init;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<BinaryOp> op;
+        std::vector<pika::concurrency::detail::cache_aligned_data<block_descriptor<T>>> blocks;
+    };
+
+    template <typename RandomIt, typename OutputIt, typename T, typename BinaryOp>
+    struct make_scan_state
+    {
+        RandomIt first;
+        OutputIt d_first;
+        std::size_t n;
+        std::size_t num_blocks;
+        std::optional<T> init;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<BinaryOp> op;
+
+        scan_state<RandomIt, OutputIt, T, BinaryOp> operator()()
+        {
+            using descriptors_type =
+                std::vector<pika::concurrency::detail::cache_aligned_data<block_descriptor<T>>>;
+            return {first, d_first, n, num_blocks, PIKA_MOVE(init), PIKA_MOVE(op),
+                descriptors_type(num_blocks)};
+        }
+    };
+
+    template <typename T, typename BinaryOp>
+    T combine(BinaryOp& op, T const& left, std::optional<T>&& right)
+    {
+        if (!right) { return left; }
+        return PIKA_INVOKE(op, left, PIKA_MOVE(*right));
+    }
+
+    // The first pass reduces each block to its aggregate. The last block
+    // is never looked back at, so its aggregate is not needed.
+    struct aggregate_block
+    {
+        template <typename State>
+        void operator()(std::size_t block, State& state) const
+        {
+            using value_type = typename State::value_type;
+
+            if (block + 1 == state.num_blocks) { return; }
+
+            auto const [begin, end] = detail::get_block(state.n, state.num_blocks, block);
+            value_type aggregate = state.first[begin];
+            for (std::size_t i = begin + 1; i < end; ++i)
+            {
+                aggregate = PIKA_INVOKE(state.op, PIKA_MOVE(aggregate), state.first[i]);
+            }
+            state.blocks[block].data_.aggregate.emplace(PIKA_MOVE(aggregate));
+        }
+    };
+
+    // The second pass finds the exclusive prefix of a block by looking
+    // back at the preceding blocks, in the style of the decoupled look-back
+    // of single-pass scans. It combines the aggregates of the preceding
+    // blocks until it finds a block which has published its inclusive
+    // prefix. Since all aggregates are available after the first pass the
+    // look-back never waits for another block, which would risk deadlocks
+    // when the blocks are not processed concurrently. Blocks are mostly
+    // processed in order, so the look-back is usually short.
+    template <bool Inclusive>
+    struct scan_block
+    {
+        template <typename State>
+        static std::optional<typename State::value_type> look_back(
+            std::size_t block, State& state)
+        {
+            std::optional<typename State::value_type> prefix;
+            for (std::size_t j = block; j-- > 0;)
+            {
+                auto& predecessor = state.blocks[j].data_;
+                if (predecessor.prefix_available.load(std::memory_order_acquire))
+                {
+                    // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+                    return combine(state.op, *predecessor.inclusive_prefix, PIKA_MOVE(prefix));
+                }
+                // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+                prefix = combine(state.op, *predecessor.aggregate, PIKA_MOVE(prefix));
+            }
+
+            if (state.init) { prefix = combine(state.op, *state.init, PIKA_MOVE(prefix)); }
+            return prefix;
+        }
+
+        template <typename State>
+        void operator()(std::size_t block, State& state) const
+        {
+            using value_type = typename State::value_type;
+
+            auto const [begin, end] = detail::get_block(state.n, state.num_blocks, block);
+            std::optional<value_type> prefix = look_back(block, state);
+
+            // The input is read before the output is written for each
+            // element so that the scan can be done in place
+            std::optional<value_type> acc;
+            if constexpr (Inclusive)
+            {
+                if (prefix)
+                {
+                    acc.emplace(PIKA_INVOKE(state.op, PIKA_MOVE(*prefix), state.first[begin]));
+                }
+                else { acc.emplace(state.first[begin]); }
+                state.d_first[begin] = *acc;
+
+                for (std::size_t i = begin + 1; i < end; ++i)
+                {
+                    acc = PIKA_INVOKE(state.op, PIKA_MOVE(*acc), state.first[i]);
+                    state.d_first[i] = *acc;
+                }
+            }
+            else
+            {
+                // An exclusive scan always has an initial value, so the
+                // prefix is always available
+                using input_value_type =
+                    typename std::iterator_traits<decltype(state.first)>::value_type;
+
+                acc = PIKA_MOVE(prefix);
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    input_value_type value = state.first[i];
+                    // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+                    state.d_first[i] = *acc;
+                    acc = PIKA_INVOKE(state.op, PIKA_MOVE(*acc), PIKA_MOVE(value));
+                }
+            }
+
+            auto& descriptor = state.blocks[block].data_;
+            descriptor.inclusive_prefix = PIKA_MOVE(acc);
+            descriptor.prefix_available.store(true, std::memory_order_release);
+        }
+    };
+
+    struct finish_scan
+    {
+        template <typename State>
+        auto operator()(State&& state) const
+        {
+            return std::next(state.d_first, state.n);
+        }
+    };
+
+    template <bool Inclusive, typename T, typename RandomIt, typename OutputIt, typename BinaryOp>
+    auto scan(pika::execution::experimental::thread_pool_scheduler scheduler, RandomIt first,
+        RandomIt last, OutputIt d_first, std::optional<T> init, BinaryOp&& op)
+    {
+        auto const n = static_cast<std::size_t>(std::distance(first, last));
+        auto const num_blocks =
+            detail::get_num_blocks(scheduler, n, min_block_size, blocks_per_thread);
+
+        auto state_sender = pika::execution::experimental::then(
+            pika::execution::experimental::schedule(scheduler),
+            make_scan_state<RandomIt, OutputIt, T, BinaryOp>{
+                first, d_first, n, num_blocks, PIKA_MOVE(init), PIKA_FORWARD(BinaryOp, op)});
+        auto aggregate_sender =
+            detail::bulk(scheduler, PIKA_MOVE(state_sender), num_blocks, aggregate_block{});
+        return pika::execution::experimental::then(
+            detail::bulk(PIKA_MOVE(scheduler), PIKA_MOVE(aggregate_sender), num_blocks,
+                scan_block<Inclusive>{}),
+            finish_scan{});
+    }
+}    // namespace pika::algorithms::scan_detail
+
+namespace pika::algorithms::experimental {
+    /// Returns a sender which writes the inclusive prefix sums of [first,
+    /// last), combined with op, to the range beginning at d_first on the
+    /// thread_pool_scheduler. op must be associative. The scan may be done
+    /// in place, i.e. d_first may be equal to first. The sender sends the
+    /// end of the output range.
+    ///
+    /// The range is split into blocks which are scanned in two passes: the
+    /// first reduces each block, and the second scans each block starting
+    /// from the combined reductions of the preceding blocks.
+    template <typename RandomIt, typename OutputIt, typename BinaryOp = std::plus<>,
+        PIKA_CONCEPT_REQUIRES_(pika::traits::is_random_access_iterator_v<RandomIt>&&
+                pika::traits::is_random_access_iterator_v<OutputIt>)>
+    auto inclusive_scan(pika::execution::experimental::thread_pool_scheduler scheduler,
+        RandomIt first, RandomIt last, OutputIt d_first, BinaryOp&& op = BinaryOp{})
+    {
+        using value_type = typename std::iterator_traits<RandomIt>::value_type;
+        return scan_detail::scan<true, value_type>(PIKA_MOVE(scheduler), first, last, d_first,
+            std::nullopt, PIKA_FORWARD(BinaryOp, op));
+    }
+
+    /// Returns a sender which writes the inclusive prefix sums of [first,
+    /// last), combined with op and starting from init, to the range
+    /// beginning at d_first on the thread_pool_scheduler. op must be
+    /// associative. The scan may be done in place. The sender sends the end
+    /// of the output range.
+    template <typename RandomIt, typename OutputIt, typename BinaryOp, typename T,
+        PIKA_CONCEPT_REQUIRES_(pika::traits::is_random_access_iterator_v<RandomIt>&&
+                pika::traits::is_random_access_iterator_v<OutputIt>)>
+    auto inclusive_scan(pika::execution::experimental::thread_pool_scheduler scheduler,
+        RandomIt first, RandomIt last, OutputIt d_first, BinaryOp&& op, T&& init)
+    {
+        return scan_detail::scan<true, std::decay_t<T>>(PIKA_MOVE(scheduler), first, last,
+            d_first, std::optional<std::decay_t<T>>(PIKA_FORWARD(T, init)),
+            PIKA_FORWARD(BinaryOp, op));
+    }
+
+    /// Returns a sender which writes the exclusive prefix sums of [first,
+    /// last), combined with op and starting from init, to the range
+    /// beginning at d_first on the thread_pool_scheduler. op must be
+    /// associative. The scan may be done in place. The sender sends the end
+    /// of the output range.
+    template <typename RandomIt, typename OutputIt, typename T, typename BinaryOp = std::plus<>,
+        PIKA_CONCEPT_REQUIRES_(pika::traits::is_random_access_iterator_v<RandomIt>&&
+                pika::traits::is_random_access_iterator_v<OutputIt>)>
+    auto exclusive_scan(pika::execution::experimental::thread_pool_scheduler scheduler,
+        RandomIt first, RandomIt last, OutputIt d_first, T&& init, BinaryOp&& op = BinaryOp{})
+    {
+        return scan_detail::scan<false, std::decay_t<T>>(PIKA_MOVE(scheduler), first, last,
+            d_first, std::optional<std::decay_t<T>>(PIKA_FORWARD(T, init)),
+            PIKA_FORWARD(BinaryOp, op));
+    }
+}    // namespace pika::algorithms::experimental
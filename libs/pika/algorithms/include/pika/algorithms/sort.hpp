@@ -0,0 +1,295 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/algorithms/detail/blocks.hpp>
+#include <pika/concepts/concepts.hpp>
+#include <pika/execution/algorithms/then.hpp>
+#include <pika/execution_base/sender.hpp>
+#include <pika/executors/thread_pool_scheduler.hpp>
+#include <pika/iterator_support/traits/is_iterator.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pika::algorithms::sort_detail {
+    inline constexpr std::size_t min_block_size = 16384;
+    inline constexpr std::size_t blocks_per_thread = 2;
+
+    template <typename RandomIt, typename Compare>
+    struct sort_state
+    {
+        using value_type = typename std::iterator_traits<RandomIt>::value_type;
+
+        RandomIt first;
+        std::size_t n;
+        std::size_t num_blocks;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<Compare> comp;
+        // The elements separating the buckets, pointing into the sorted
+        // blocks
+        std::vector<RandomIt> splitters;
+        // The index of the first element of each bucket in each block, and
+        // the end of the block, i.e. num_blocks + 1 indices per block
+        std::vector<std::size_t> bucket_bounds;
+        // The index of the first element of each bucket in the sorted range
+        std::vector<std::size_t> bucket_offsets;
+        // The buckets are merged into the buffer before the elements are
+        // moved back to the input range
+        std::unique_ptr<value_type[]> buffer;
+
+        std::size_t& bucket_bound(std::size_t block, std::size_t bucket)
+        {
+            return bucket_bounds[block * (num_blocks + 1) + bucket];
+        }
+    };
+
+    template <typename RandomIt, typename Compare>
+    struct make_sort_state
+    {
+        RandomIt first;
+        std::size_t n;
+        std::size_t num_blocks;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<Compare> comp;
+
+        sort_state<RandomIt, Compare> operator()()
+        {
+            using value_type = typename sort_state<RandomIt, Compare>::value_type;
+
+            sort_state<RandomIt, Compare> state{first, n, num_blocks, PIKA_MOVE(comp), {}, {}, {},
+                nullptr};
+            if (num_blocks > 1)
+            {
+                state.splitters.reserve(num_blocks - 1);
+                state.bucket_bounds.resize(num_blocks * (num_blocks + 1));
+                state.bucket_offsets.resize(num_blocks + 1);
+                // The buffer is default-initialized instead of
+                // value-initialized to avoid touching all elements serially
+                // for trivial types
+                state.buffer.reset(new value_type[n]);
+            }
+            return state;
+        }
+    };
+
+    // The blocks are first sorted independently
+    struct sort_block
+    {
+        template <typename State>
+        void operator()(std::size_t block, State& state) const
+        {
+            auto const [begin, end] = detail::get_block(state.n, state.num_blocks, block);
+            std::sort(state.first + begin, state.first + end, state.comp);
+        }
+    };
+
+    // Elements are ordered by their value and equal elements by their
+    // position in the sorted blocks. Without the tie-break all elements
+    // equal to a splitter would end up in one bucket.
+    template <typename RandomIt, typename Compare>
+    bool less_by_position(RandomIt a, RandomIt b, Compare& comp)
+    {
+        return comp(*a, *b) || (!comp(*b, *a) && a < b);
+    }
+
+    // The splitters are chosen by regular sampling: num_blocks evenly
+    // spaced samples are taken from each sorted block, and every
+    // num_blocks-th of the sorted samples becomes a splitter. This bounds
+    // the size of each bucket to roughly twice the size of a block, also
+    // with many equal elements since samples are ordered with
+    // less_by_position.
+    struct choose_splitters
+    {
+        template <typename State>
+        std::decay_t<State> operator()(State&& state) const
+        {
+            std::size_t const num_blocks = state.num_blocks;
+            if (num_blocks <= 1) { return PIKA_MOVE(state); }
+
+            std::vector<decltype(state.first)> samples;
+            samples.reserve(num_blocks * num_blocks);
+            for (std::size_t block = 0; block < num_blocks; ++block)
+            {
+                auto const [begin, end] = detail::get_block(state.n, num_blocks, block);
+                for (std::size_t k = 0; k < num_blocks; ++k)
+                {
+                    samples.push_back(state.first + begin + k * (end - begin) / num_blocks);
+                }
+            }
+
+            auto& comp = state.comp;
+            std::sort(samples.begin(), samples.end(),
+                [&comp](auto const& a, auto const& b) { return less_by_position(a, b, comp); });
+            for (std::size_t k = 1; k < num_blocks; ++k)
+            {
+                state.splitters.push_back(samples[k * num_blocks + num_blocks / 2 - 1]);
+            }
+
+            return PIKA_MOVE(state);
+        }
+    };
+
+    // Each sorted block is split into one range per bucket. Bucket k holds
+    // the elements which are greater than splitter k - 1 and not greater
+    // than splitter k, compared with less_by_position. Of the elements equal
+    // to a splitter, those up to the position of the splitter are not
+    // greater than it.
+    struct partition_block
+    {
+        template <typename State>
+        void operator()(std::size_t block, State& state) const
+        {
+            std::size_t const num_blocks = state.num_blocks;
+            if (num_blocks <= 1) { return; }
+
+            auto const [begin, end] = detail::get_block(state.n, num_blocks, block);
+            state.bucket_bound(block, 0) = begin;
+            for (std::size_t k = 1; k < num_blocks; ++k)
+            {
+                auto const splitter = state.splitters[k - 1];
+                auto const [lower, upper] =
+                    std::equal_range(state.first + state.bucket_bound(block, k - 1),
+                        state.first + end, *splitter, state.comp);
+                auto const bound = std::clamp(splitter + 1, lower, upper);
+                state.bucket_bound(block, k) =
+                    static_cast<std::size_t>(std::distance(state.first, bound));
+            }
+            state.bucket_bound(block, num_blocks) = end;
+        }
+    };
+
+    struct compute_bucket_offsets
+    {
+        template <typename State>
+        std::decay_t<State> operator()(State&& state) const
+        {
+            std::size_t const num_blocks = state.num_blocks;
+            if (num_blocks <= 1) { return PIKA_MOVE(state); }
+
+            state.bucket_offsets[0] = 0;
+            for (std::size_t bucket = 0; bucket < num_blocks; ++bucket)
+            {
+                std::size_t bucket_size = 0;
+                for (std::size_t block = 0; block < num_blocks; ++block)
+                {
+                    bucket_size +=
+                        state.bucket_bound(block, bucket + 1) - state.bucket_bound(block, bucket);
+                }
+                state.bucket_offsets[bucket + 1] = state.bucket_offsets[bucket] + bucket_size;
+            }
+
+            return PIKA_MOVE(state);
+        }
+    };
+
+    // The sorted ranges of a bucket are moved next to each other in the
+    // buffer and merged pairwise until one sorted range remains
+    struct merge_bucket
+    {
+        template <typename State>
+        void operator()(std::size_t bucket, State& state) const
+        {
+            std::size_t const num_blocks = state.num_blocks;
+            if (num_blocks <= 1) { return; }
+
+            auto* const bucket_first = state.buffer.get() + state.bucket_offsets[bucket];
+            std::vector<std::size_t> run_bounds{0};
+            run_bounds.reserve(num_blocks + 1);
+            for (std::size_t block = 0; block < num_blocks; ++block)
+            {
+                std::size_t const run_begin = state.bucket_bound(block, bucket);
+                std::size_t const run_end = state.bucket_bound(block, bucket + 1);
+                if (run_begin == run_end) { continue; }
+
+                std::move(state.first + run_begin, state.first + run_end,
+                    bucket_first + run_bounds.back());
+                run_bounds.push_back(run_bounds.back() + (run_end - run_begin));
+            }
+
+            while (run_bounds.size() > 2)
+            {
+                std::size_t const num_runs = run_bounds.size() - 1;
+                std::size_t merged_runs = 0;
+                for (std::size_t run = 0; run + 1 < num_runs; run += 2)
+                {
+                    std::inplace_merge(bucket_first + run_bounds[run],
+                        bucket_first + run_bounds[run + 1], bucket_first + run_bounds[run + 2],
+                        state.comp);
+                    run_bounds[++merged_runs] = run_bounds[run + 2];
+                }
+                if (num_runs % 2 == 1) { run_bounds[++merged_runs] = run_bounds[num_runs]; }
+                run_bounds.resize(merged_runs + 1);
+            }
+        }
+    };
+
+    struct move_back_block
+    {
+        template <typename State>
+        void operator()(std::size_t block, State& state) const
+        {
+            std::size_t const num_blocks = state.num_blocks;
+            if (num_blocks <= 1) { return; }
+
+            auto const [begin, end] = detail::get_block(state.n, num_blocks, block);
+            std::move(state.buffer.get() + begin, state.buffer.get() + end, state.first + begin);
+        }
+    };
+
+    struct finish_sort
+    {
+        template <typename State>
+        void operator()(State&&) const
+        {
+        }
+    };
+}    // namespace pika::algorithms::sort_detail
+
+namespace pika::algorithms::experimental {
+    /// Returns a sender which sorts [first, last) with comp on the
+    /// thread_pool_scheduler. The sort is not stable. The sender sends no
+    /// values.
+    ///
+    /// The range is sorted with a sample sort: it is split into blocks
+    /// which are sorted independently, and splitters chosen from regular
+    /// samples of the sorted blocks split the elements into one bucket per
+    /// block. The parts of each bucket are then merged concurrently. The
+    /// buckets are merged into a temporary buffer, so the element type must
+    /// be default constructible.
+    template <typename RandomIt, typename Compare = std::less<>,
+        PIKA_CONCEPT_REQUIRES_(pika::traits::is_random_access_iterator_v<RandomIt>)>
+    auto sort(pika::execution::experimental::thread_pool_scheduler scheduler, RandomIt first,
+        RandomIt last, Compare&& comp = Compare{})
+    {
+        using pika::execution::experimental::then;
+
+        auto const n = static_cast<std::size_t>(std::distance(first, last));
+        auto const num_blocks = detail::get_num_blocks(
+            scheduler, n, sort_detail::min_block_size, sort_detail::blocks_per_thread);
+
+        auto state_sender = then(pika::execution::experimental::schedule(scheduler),
+            sort_detail::make_sort_state<RandomIt, Compare>{
+                first, n, num_blocks, PIKA_FORWARD(Compare, comp)});
+        auto sorted_blocks_sender = then(
+            detail::bulk(scheduler, PIKA_MOVE(state_sender), num_blocks, sort_detail::sort_block{}),
+            sort_detail::choose_splitters{});
+        auto partitioned_sender = then(detail::bulk(scheduler, PIKA_MOVE(sorted_blocks_sender),
+                                           num_blocks, sort_detail::partition_block{}),
+            sort_detail::compute_bucket_offsets{});
+        auto merged_sender = detail::bulk(
+            scheduler, PIKA_MOVE(partitioned_sender), num_blocks, sort_detail::merge_bucket{});
+        return then(detail::bulk(PIKA_MOVE(scheduler), PIKA_MOVE(merged_sender), num_blocks,
+                        sort_detail::move_back_block{}),
+            sort_detail::finish_sort{});
+    }
+}    // namespace pika::algorithms::experimental
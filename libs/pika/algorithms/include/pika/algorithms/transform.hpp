@@ -0,0 +1,86 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/algorithms/detail/blocks.hpp>
+#include <pika/concepts/concepts.hpp>
+#include <pika/execution/algorithms/then.hpp>
+#include <pika/execution_base/sender.hpp>
+#include <pika/executors/thread_pool_scheduler.hpp>
+#include <pika/functional/detail/invoke.hpp>
+#include <pika/iterator_support/traits/is_iterator.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace pika::algorithms::transform_detail {
+    template <typename RandomIt, typename OutputIt, typename F>
+    struct transform_element
+    {
+        RandomIt first;
+        OutputIt d_first;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<F> f;
+
+        void operator()(std::size_t i) { d_first[i] = PIKA_INVOKE(f, first[i]); }
+    };
+
+    template <typename RandomIt1, typename RandomIt2, typename OutputIt, typename F>
+    struct binary_transform_element
+    {
+        RandomIt1 first1;
+        RandomIt2 first2;
+        OutputIt d_first;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<F> f;
+
+        void operator()(std::size_t i) { d_first[i] = PIKA_INVOKE(f, first1[i], first2[i]); }
+    };
+}    // namespace pika::algorithms::transform_detail
+
+namespace pika::algorithms::experimental {
+    /// Returns a sender which writes f(x) for each element x of [first,
+    /// last) to the range beginning at d_first on the thread_pool_scheduler.
+    /// The elements are transformed in an unspecified order and
+    /// concurrently. The sender sends the end of the output range.
+    template <typename RandomIt, typename OutputIt, typename F,
+        PIKA_CONCEPT_REQUIRES_(pika::traits::is_random_access_iterator_v<RandomIt>&&
+                pika::traits::is_random_access_iterator_v<OutputIt>)>
+    auto transform(pika::execution::experimental::thread_pool_scheduler scheduler, RandomIt first,
+        RandomIt last, OutputIt d_first, F&& f)
+    {
+        auto const n = static_cast<std::size_t>(std::distance(first, last));
+        auto sender = pika::execution::experimental::schedule(scheduler);
+        return pika::execution::experimental::then(
+            detail::bulk(PIKA_MOVE(scheduler), PIKA_MOVE(sender), n,
+                transform_detail::transform_element<RandomIt, OutputIt, F>{
+                    first, d_first, PIKA_FORWARD(F, f)}),
+            detail::send_output_end<OutputIt>{std::next(d_first, n)});
+    }
+
+    /// Returns a sender which writes f(x, y) for each pair of elements x and
+    /// y of [first1, last1) and the range beginning at first2 to the range
+    /// beginning at d_first on the thread_pool_scheduler. The elements are
+    /// transformed in an unspecified order and concurrently. The sender
+    /// sends the end of the output range.
+    template <typename RandomIt1, typename RandomIt2, typename OutputIt, typename F,
+        PIKA_CONCEPT_REQUIRES_(pika::traits::is_random_access_iterator_v<RandomIt1>&&
+                pika::traits::is_random_access_iterator_v<RandomIt2>&&
+                    pika::traits::is_random_access_iterator_v<OutputIt>)>
+    auto transform(pika::execution::experimental::thread_pool_scheduler scheduler,
+        RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, OutputIt d_first, F&& f)
+    {
+        auto const n = static_cast<std::size_t>(std::distance(first1, last1));
+        auto sender = pika::execution::experimental::schedule(scheduler);
+        return pika::execution::experimental::then(
+            detail::bulk(PIKA_MOVE(scheduler), PIKA_MOVE(sender), n,
+                transform_detail::binary_transform_element<RandomIt1, RandomIt2, OutputIt, F>{
+                    first1, first2, d_first, PIKA_FORWARD(F, f)}),
+            detail::send_output_end<OutputIt>{std::next(d_first, n)});
+    }
+}    // namespace pika::algorithms::experimental
@@ -0,0 +1,153 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/algorithms.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/testing.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace pa = pika::algorithms::experimental;
+namespace tt = pika::this_thread::experimental;
+
+std::vector<std::size_t> const sizes = {0, 1, 7, 1000, 100000};
+
+void test_for_each()
+{
+    ex::thread_pool_scheduler sched{};
+
+    for (std::size_t n : sizes)
+    {
+        std::vector<int> v(n, 0);
+        tt::sync_wait(pa::for_each(sched, v.begin(), v.end(), [](int& x) { ++x; }));
+        for (int x : v) { PIKA_TEST_EQ(x, 1); }
+    }
+
+    {
+        std::atomic<std::size_t> calls{0};
+        std::vector<int> v(1000);
+        bool exception_thrown = false;
+
+        try
+        {
+            tt::sync_wait(pa::for_each(sched, v.begin(), v.end(), [&](int&) {
+                if (++calls == 10) { throw std::runtime_error("error"); }
+            }));
+            PIKA_TEST(false);
+        }
+        catch (std::runtime_error const& e)
+        {
+            PIKA_TEST_EQ(std::string(e.what()), std::string("error"));
+            exception_thrown = true;
+        }
+
+        PIKA_TEST(exception_thrown);
+    }
+}
+
+void test_transform()
+{
+    ex::thread_pool_scheduler sched{};
+
+    for (std::size_t n : sizes)
+    {
+        std::vector<int> v(n);
+        std::iota(v.begin(), v.end(), 0);
+        std::vector<long> out(n, -1);
+
+        auto const out_end = tt::sync_wait(pa::transform(
+            sched, v.begin(), v.end(), out.begin(), [](int x) { return 2 * long(x); }));
+        PIKA_TEST(out_end == out.end());
+        for (std::size_t i = 0; i < n; ++i) { PIKA_TEST_EQ(out[i], 2 * long(i)); }
+    }
+
+    for (std::size_t n : sizes)
+    {
+        std::vector<int> v1(n);
+        std::iota(v1.begin(), v1.end(), 0);
+        std::vector<int> v2(n, 3);
+        std::vector<int> out(n, -1);
+
+        auto const out_end = tt::sync_wait(pa::transform(sched, v1.begin(), v1.end(), v2.begin(),
+            out.begin(), [](int x, int y) { return x * y; }));
+        PIKA_TEST(out_end == out.end());
+        for (std::size_t i = 0; i < n; ++i) { PIKA_TEST_EQ(out[i], 3 * int(i)); }
+    }
+
+    // In place
+    {
+        std::vector<int> v(1000);
+        std::iota(v.begin(), v.end(), 0);
+        tt::sync_wait(
+            pa::transform(sched, v.begin(), v.end(), v.begin(), [](int x) { return -x; }));
+        for (std::size_t i = 0; i < v.size(); ++i) { PIKA_TEST_EQ(v[i], -int(i)); }
+    }
+}
+
+void test_copy()
+{
+    ex::thread_pool_scheduler sched{};
+
+    for (std::size_t n : sizes)
+    {
+        std::vector<std::string> v(n);
+        for (std::size_t i = 0; i < n; ++i) { v[i] = std::to_string(i); }
+        std::vector<std::string> out(n);
+
+        auto const out_end = tt::sync_wait(pa::copy(sched, v.begin(), v.end(), out.begin()));
+        PIKA_TEST(out_end == out.end());
+        PIKA_TEST(out == v);
+    }
+}
+
+void test_fill()
+{
+    ex::thread_pool_scheduler sched{};
+
+    for (std::size_t n : sizes)
+    {
+        std::vector<double> v(n, 0.0);
+        tt::sync_wait(pa::fill(sched, v.begin(), v.end(), 3.5));
+        for (double x : v) { PIKA_TEST_EQ(x, 3.5); }
+    }
+
+    // A subrange
+    {
+        std::vector<int> v(100, 0);
+        tt::sync_wait(pa::fill(sched, v.begin() + 10, v.begin() + 20, 1));
+        PIKA_TEST_EQ(std::accumulate(v.begin(), v.end(), 0), 10);
+        PIKA_TEST_EQ(v[9], 0);
+        PIKA_TEST_EQ(v[10], 1);
+        PIKA_TEST_EQ(v[19], 1);
+        PIKA_TEST_EQ(v[20], 0);
+    }
+}
+
+int pika_main()
+{
+    test_for_each();
+    test_transform();
+    test_copy();
+    test_fill();
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    PIKA_TEST_EQ_MSG(pika::init(pika_main, argc, argv), 0, "pika main exited with non-zero status");
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/algorithms.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/testing.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace pa = pika::algorithms::experimental;
+namespace tt = pika::this_thread::experimental;
+
+// Large enough for the range to be split into many blocks
+std::vector<std::size_t> const sizes = {0, 1, 7, 4096, 4097, 100000, 1000003};
+
+std::vector<std::int64_t> make_input(std::size_t n)
+{
+    std::vector<std::int64_t> v(n);
+    for (std::size_t i = 0; i < n; ++i) { v[i] = std::int64_t(i % 17) - 5; }
+    return v;
+}
+
+void test_inclusive_scan()
+{
+    ex::thread_pool_scheduler sched{};
+
+    for (std::size_t n : sizes)
+    {
+        auto const v = make_input(n);
+        std::vector<std::int64_t> expected(n);
+        std::inclusive_scan(v.begin(), v.end(), expected.begin());
+
+        std::vector<std::int64_t> out(n);
+        auto const out_end =
+            tt::sync_wait(pa::inclusive_scan(sched, v.begin(), v.end(), out.begin()));
+        PIKA_TEST(out_end == out.end());
+        PIKA_TEST(out == expected);
+    }
+
+    // With an initial value
+    for (std::size_t n : sizes)
+    {
+        auto const v = make_input(n);
+        std::vector<std::int64_t> expected(n);
+        std::inclusive_scan(
+            v.begin(), v.end(), expected.begin(), std::plus<>{}, std::int64_t(42));
+
+        std::vector<std::int64_t> out(n);
+        tt::sync_wait(pa::inclusive_scan(
+            sched, v.begin(), v.end(), out.begin(), std::plus<>{}, std::int64_t(42)));
+        PIKA_TEST(out == expected);
+    }
+
+    // In place
+    for (std::size_t n : sizes)
+    {
+        auto v = make_input(n);
+        std::vector<std::int64_t> expected(n);
+        std::inclusive_scan(v.begin(), v.end(), expected.begin());
+
+        tt::sync_wait(pa::inclusive_scan(sched, v.begin(), v.end(), v.begin()));
+        PIKA_TEST(v == expected);
+    }
+}
+
+void test_exclusive_scan()
+{
+    ex::thread_pool_scheduler sched{};
+
+    for (std::size_t n : sizes)
+    {
+        auto const v = make_input(n);
+        std::vector<std::int64_t> expected(n);
+        std::exclusive_scan(v.begin(), v.end(), expected.begin(), std::int64_t(3));
+
+        std::vector<std::int64_t> out(n);
+        auto const out_end = tt::sync_wait(
+            pa::exclusive_scan(sched, v.begin(), v.end(), out.begin(), std::int64_t(3)));
+        PIKA_TEST(out_end == out.end());
+        PIKA_TEST(out == expected);
+    }
+
+    // In place
+    for (std::size_t n : sizes)
+    {
+        auto v = make_input(n);
+        std::vector<std::int64_t> expected(n);
+        std::exclusive_scan(v.begin(), v.end(), expected.begin(), std::int64_t(0));
+
+        tt::sync_wait(pa::exclusive_scan(sched, v.begin(), v.end(), v.begin(), std::int64_t(0)));
+        PIKA_TEST(v == expected);
+    }
+}
+
+// The scans only require op to be associative, so the order of the
+// elements must be kept when combining them
+void test_non_commutative_scan()
+{
+    ex::thread_pool_scheduler sched{};
+
+    std::size_t const n = 20000;
+    std::vector<std::string> v(n);
+    for (std::size_t i = 0; i < n; ++i) { v[i] = std::string(1, char('a' + i % 26)); }
+
+    auto const concatenate = [](std::string const& a, std::string const& b) { return a + b; };
+
+    {
+        std::vector<std::string> expected(n);
+        std::inclusive_scan(v.begin(), v.end(), expected.begin(), concatenate);
+
+        std::vector<std::string> out(n);
+        tt::sync_wait(pa::inclusive_scan(sched, v.begin(), v.end(), out.begin(), concatenate));
+        PIKA_TEST(out == expected);
+    }
+
+    {
+        std::vector<std::string> expected(n);
+        std::exclusive_scan(
+            v.begin(), v.end(), expected.begin(), std::string("init"), concatenate);
+
+        std::vector<std::string> out(n);
+        tt::sync_wait(pa::exclusive_scan(
+            sched, v.begin(), v.end(), out.begin(), std::string("init"), concatenate));
+        PIKA_TEST(out == expected);
+    }
+}
+
+int pika_main()
+{
+    test_inclusive_scan();
+    test_exclusive_scan();
+    test_non_commutative_scan();
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    PIKA_TEST_EQ_MSG(pika::init(pika_main, argc, argv), 0, "pika main exited with non-zero status");
+
+    return 0;
+}
@@ -0,0 +1,188 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/algorithms.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/testing.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace pa = pika::algorithms::experimental;
+namespace tt = pika::this_thread::experimental;
+
+// Large enough for the range to be split into many blocks
+std::vector<std::size_t> const sizes = {0, 1, 7, 16384, 16385, 100000, 1000003};
+
+void test_sort_random()
+{
+    ex::thread_pool_scheduler sched{};
+    std::mt19937 gen(42);
+
+    for (std::size_t n : sizes)
+    {
+        std::uniform_int_distribution<std::int64_t> dist(-1000000, 1000000);
+        std::vector<std::int64_t> v(n);
+        for (auto& x : v) { x = dist(gen); }
+        auto expected = v;
+        std::sort(expected.begin(), expected.end());
+
+        tt::sync_wait(pa::sort(sched, v.begin(), v.end()));
+        PIKA_TEST(v == expected);
+    }
+}
+
+void test_sort_comparator()
+{
+    ex::thread_pool_scheduler sched{};
+    std::mt19937 gen(43);
+
+    for (std::size_t n : sizes)
+    {
+        std::uniform_int_distribution<std::int64_t> dist(-1000000, 1000000);
+        std::vector<std::int64_t> v(n);
+        for (auto& x : v) { x = dist(gen); }
+        auto expected = v;
+        std::sort(expected.begin(), expected.end(), std::greater<>{});
+
+        tt::sync_wait(pa::sort(sched, v.begin(), v.end(), std::greater<>{}));
+        PIKA_TEST(v == expected);
+    }
+}
+
+// Many equal elements are sorted correctly
+void test_sort_duplicates()
+{
+    ex::thread_pool_scheduler sched{};
+    std::mt19937 gen(44);
+
+    for (std::size_t n : sizes)
+    {
+        std::uniform_int_distribution<int> dist(0, 3);
+        std::vector<int> v(n);
+        for (auto& x : v) { x = dist(gen); }
+        auto expected = v;
+        std::sort(expected.begin(), expected.end());
+
+        tt::sync_wait(pa::sort(sched, v.begin(), v.end()));
+        PIKA_TEST(v == expected);
+    }
+
+    {
+        std::vector<int> v(100000, 7);
+        tt::sync_wait(pa::sort(sched, v.begin(), v.end()));
+        PIKA_TEST(std::all_of(v.begin(), v.end(), [](int x) { return x == 7; }));
+    }
+}
+
+// Equal elements are spread over the buckets, so that no bucket holds much
+// more than two blocks of elements. The steps of the sort are run serially
+// to have a fixed number of blocks.
+void test_sort_duplicates_buckets()
+{
+    namespace sd = pika::algorithms::sort_detail;
+    using iterator = std::vector<int>::iterator;
+
+    std::mt19937 gen(46);
+    constexpr std::size_t num_blocks = 8;
+    constexpr std::size_t n = num_blocks * 10000;
+
+    for (int max_value : {0, 1, 3})
+    {
+        std::uniform_int_distribution<int> dist(0, max_value);
+        std::vector<int> v(n);
+        for (auto& x : v) { x = dist(gen); }
+        auto expected = v;
+        std::sort(expected.begin(), expected.end());
+
+        auto state = sd::make_sort_state<iterator, std::less<>>{v.begin(), n, num_blocks, {}}();
+        for (std::size_t block = 0; block != num_blocks; ++block)
+        {
+            sd::sort_block{}(block, state);
+        }
+        state = sd::choose_splitters{}(std::move(state));
+        for (std::size_t block = 0; block != num_blocks; ++block)
+        {
+            sd::partition_block{}(block, state);
+        }
+        state = sd::compute_bucket_offsets{}(std::move(state));
+        for (std::size_t bucket = 0; bucket != num_blocks; ++bucket)
+        {
+            std::size_t const bucket_size =
+                state.bucket_offsets[bucket + 1] - state.bucket_offsets[bucket];
+            PIKA_TEST_LTE(bucket_size, 2 * n / num_blocks);
+        }
+        for (std::size_t bucket = 0; bucket != num_blocks; ++bucket)
+        {
+            sd::merge_bucket{}(bucket, state);
+        }
+        for (std::size_t block = 0; block != num_blocks; ++block)
+        {
+            sd::move_back_block{}(block, state);
+        }
+        PIKA_TEST(v == expected);
+    }
+}
+
+void test_sort_presorted()
+{
+    ex::thread_pool_scheduler sched{};
+
+    for (std::size_t n : sizes)
+    {
+        std::vector<std::size_t> v(n);
+        for (std::size_t i = 0; i < n; ++i) { v[i] = n - i; }
+        tt::sync_wait(pa::sort(sched, v.begin(), v.end()));
+        PIKA_TEST(std::is_sorted(v.begin(), v.end()));
+
+        tt::sync_wait(pa::sort(sched, v.begin(), v.end()));
+        PIKA_TEST(std::is_sorted(v.begin(), v.end()));
+    }
+}
+
+void test_sort_strings()
+{
+    ex::thread_pool_scheduler sched{};
+    std::mt19937 gen(45);
+
+    std::uniform_int_distribution<int> dist(0, 1000000);
+    std::vector<std::string> v(50000);
+    for (auto& x : v) { x = std::to_string(dist(gen)); }
+    auto expected = v;
+    std::sort(expected.begin(), expected.end());
+
+    tt::sync_wait(pa::sort(sched, v.begin(), v.end()));
+    PIKA_TEST(v == expected);
+}
+
+int pika_main()
+{
+    test_sort_random();
+    test_sort_comparator();
+    test_sort_duplicates();
+    test_sort_duplicates_buckets();
+    test_sort_presorted();
+    test_sort_strings();
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    PIKA_TEST_EQ_MSG(pika::init(pika_main, argc, argv), 0, "pika main exited with non-zero status");
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace pika::detail {
+    ///////////////////////////////////////////////////////////////////////////
+    // An allocator which keeps up to Capacity single-object allocations per
+    // thread for reuse, falling back to Allocator when the cache is empty or
+    // full. Objects allocated on one thread may be deallocated on another
+    // thread. Only stateless allocators are supported, since the cached
+    // memory is shared between all instances of the allocator.
+    template <typename Allocator, std::size_t Capacity = 64>
+    struct thread_local_caching_allocator
+    {
+    private:
+        using traits = std::allocator_traits<Allocator>;
+
+        static_assert(traits::is_always_equal::value && std::is_default_constructible_v<Allocator>,
+            "thread_local_caching_allocator requires a stateless allocator");
+
+        struct cache
+        {
+            std::size_t size = 0;
+            typename traits::pointer objects[Capacity];
+
+            cache() = default;
+            cache(cache const&) = delete;
+            cache& operator=(cache const&) = delete;
+
+            ~cache()
+            {
+                Allocator alloc{};
+                for (std::size_t i = 0; i != size; ++i)
+                {
+                    traits::deallocate(alloc, objects[i], 1);
+                }
+                destroyed() = true;
+            }
+
+            // The cache may be used by thread local or static objects which
+            // are destroyed after the cache. This flag is trivially
+            // destructible and can be checked after the cache is gone.
+            static bool& destroyed() noexcept
+            {
+                static thread_local bool flag = false;
+                return flag;
+            }
+
+            static cache* get() noexcept
+            {
+                if (destroyed()) { return nullptr; }
+                static thread_local cache c;
+                return &c;
+            }
+        };
+
+    public:
+        using value_type = typename traits::value_type;
+        using pointer = typename traits::pointer;
+        using const_pointer = typename traits::const_pointer;
+        using size_type = typename traits::size_type;
+        using difference_type = typename traits::difference_type;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = thread_local_caching_allocator<
+                typename traits::template rebind_alloc<U>, Capacity>;
+        };
+
+        using is_always_equal = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+
+        thread_local_caching_allocator() = default;
+
+        explicit thread_local_caching_allocator(Allocator const&) noexcept {}
+
+        template <typename OtherAllocator>
+        explicit thread_local_caching_allocator(
+            thread_local_caching_allocator<OtherAllocator, Capacity> const&) noexcept
+        {
+        }
+
+        [[nodiscard]] pointer allocate(size_type n)
+        {
+            if (n == 1)
+            {
+                if (cache* c = cache::get(); c != nullptr && c->size != 0)
+                {
+                    return c->objects[--c->size];
+                }
+            }
+
+            Allocator alloc{};
+            return traits::allocate(alloc, n);
+        }
+
+        void deallocate(pointer p, size_type n) noexcept
+        {
+            if (n == 1)
+            {
+                if (cache* c = cache::get(); c != nullptr && c->size != Capacity)
+                {
+                    c->objects[c->size++] = p;
+                    return;
+                }
+            }
+
+            Allocator alloc{};
+            traits::deallocate(alloc, p, n);
+        }
+
+        friend constexpr bool operator==(
+            thread_local_caching_allocator const&, thread_local_caching_allocator const&) noexcept
+        {
+            return true;
+        }
+
+        friend constexpr bool operator!=(
+            thread_local_caching_allocator const&, thread_local_caching_allocator const&) noexcept
+        {
+            return false;
+        }
+    };
+}    // namespace pika::detail
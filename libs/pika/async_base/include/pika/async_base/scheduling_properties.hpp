@@ -34,6 +34,33 @@ namespace pika::execution::experimental {
     {
     } get_hint{};
 
+    inline constexpr struct with_deadline_t final : pika::functional::detail::tag<with_deadline_t>
+    {
+    } with_deadline{};
+
+    inline constexpr struct get_deadline_t final : pika::functional::detail::tag<get_deadline_t>
+    {
+    } get_deadline{};
+
+    inline constexpr struct with_chunk_size_t final
+      : pika::functional::detail::tag<with_chunk_size_t>
+    {
+    } with_chunk_size{};
+
+    inline constexpr struct get_chunk_size_t final : pika::functional::detail::tag<get_chunk_size_t>
+    {
+    } get_chunk_size{};
+
+    inline constexpr struct with_numa_affinity_t final
+      : pika::functional::detail::tag<with_numa_affinity_t>
+    {
+    } with_numa_affinity{};
+
+    inline constexpr struct get_numa_affinity_t final
+      : pika::functional::detail::tag<get_numa_affinity_t>
+    {
+    } get_numa_affinity{};
+
     // with_annotation uses tag_fallback as the base class to allow an
     // out-of-line fallback implementation for executors that don't support
     // annotations by themselves. See annotating_executor.
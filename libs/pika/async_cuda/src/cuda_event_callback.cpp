@@ -318,7 +318,8 @@ namespace pika::cuda::experimental::detail {
 
         PIKA_DETAIL_DP(cud_debug<2>, debug(str<>("enable polling"), pool.get_pool_name()));
         auto* sched = pool.get_scheduler();
-        sched->set_cuda_polling_functions(&pika::cuda::experimental::detail::poll, &get_work_count);
+        sched->add_polling_source(
+            "cuda", {&pika::cuda::experimental::detail::poll, &get_work_count});
     }
 
     // -------------------------------------------------------------
@@ -333,7 +334,7 @@ namespace pika::cuda::experimental::detail {
 #endif
         PIKA_DETAIL_DP(cud_debug<2>, debug(str<>("disable polling"), pool.get_pool_name()));
         auto* sched = pool.get_scheduler();
-        sched->clear_cuda_polling_function();
+        sched->remove_polling_source("cuda");
     }
 
     static std::string polling_pool_name = "default";
@@ -0,0 +1,88 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+
+#include <sys/socket.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pika::async_io::experimental {
+    /// The mechanism used to perform asynchronous I/O operations.
+    enum class io_backend
+    {
+        /// Operations are submitted to an io_uring instance and their
+        /// completions are reaped from the scheduling loop of the pools on
+        /// which polling has been enabled.
+        io_uring,
+        /// Operations are performed with blocking system calls on a small
+        /// dedicated pool of operating system threads.
+        blocking_threads,
+    };
+
+    /// Returns the backend used by this process. The backend is selected the
+    /// first time an I/O operation is started. io_uring is used if pika was
+    /// built with support for it, the kernel supports it, and the
+    /// configuration entry pika.async_io.backend has not been set to
+    /// "blocking_threads".
+    PIKA_EXPORT io_backend get_io_backend();
+}    // namespace pika::async_io::experimental
+
+namespace pika::async_io::experimental::detail {
+    enum class io_operation : std::uint8_t
+    {
+        read,
+        write,
+        accept,
+        connect,
+        fsync,
+    };
+
+    /// Passed as the offset of reads and writes to use and update the
+    /// current file position, e.g. for sockets and pipes.
+    inline constexpr std::uint64_t current_position = std::uint64_t(-1);
+
+    /// An I/O operation submitted to the backend. Requests are intrusive: the
+    /// submitter has to keep the request alive until \a on_complete has been
+    /// called. The result passed to \a on_complete is the non-negative result
+    /// of the system call on success, and the negated errno value on failure.
+    struct io_request
+    {
+        using callback_type = void (*)(io_request&, std::int64_t result) noexcept;
+
+        callback_type on_complete = nullptr;
+        io_operation operation = io_operation::read;
+        int fd = -1;
+        void* data = nullptr;
+        std::size_t size = 0;
+        std::uint64_t offset = current_position;
+        sockaddr* addr = nullptr;
+        socklen_t addrlen = 0;
+        socklen_t* addrlen_ptr = nullptr;
+
+        // Used by the backends to queue requests
+        io_request* next = nullptr;
+    };
+
+    /// Starts the given request. The completion callback may be called
+    /// before this returns.
+    PIKA_EXPORT void submit(io_request& request) noexcept;
+
+    /// Throws if the backend requires polling to complete operations and
+    /// polling is not enabled on any thread pool.
+    PIKA_EXPORT void check_polling_enabled();
+
+    PIKA_EXPORT void register_polling(pika::threads::detail::thread_pool_base& pool);
+    PIKA_EXPORT void unregister_polling(pika::threads::detail::thread_pool_base& pool);
+
+    /// Returns the number of requests which have been submitted but have not
+    /// yet completed.
+    PIKA_EXPORT std::size_t get_work_count();
+}    // namespace pika::async_io::experimental::detail
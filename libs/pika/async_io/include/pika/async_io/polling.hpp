@@ -0,0 +1,48 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/async_io/detail/io_request.hpp>
+#include <pika/runtime/thread_pool_helpers.hpp>
+
+#include <string>
+
+namespace pika::async_io::experimental {
+    /// This RAII helper class enables polling for completed I/O operations on
+    /// the given thread pool (the default pool if no name is given) for a
+    /// scoped block. With the io_uring backend, operations only complete
+    /// while polling is enabled on at least one pool, and operations started
+    /// while it is not enabled on any pool fail with
+    /// pika::error::invalid_status. With the blocking thread backend polling
+    /// is not required, but enabling it keeps the pool busy while operations
+    /// are in flight.
+    struct [[nodiscard]] enable_polling
+    {
+        explicit enable_polling(std::string const& pool_name = "")
+          : pool_name_(pool_name)
+        {
+            detail::register_polling(get_pool());
+        }
+
+        ~enable_polling() { detail::unregister_polling(get_pool()); }
+
+        enable_polling(enable_polling&&) = delete;
+        enable_polling(enable_polling const&) = delete;
+        enable_polling& operator=(enable_polling&&) = delete;
+        enable_polling& operator=(enable_polling const&) = delete;
+
+    private:
+        pika::threads::detail::thread_pool_base& get_pool() const
+        {
+            return pool_name_.empty() ? pika::resource::get_thread_pool(0) :
+                                        pika::resource::get_thread_pool(pool_name_);
+        }
+
+        std::string pool_name_;
+    };
+}    // namespace pika::async_io::experimental
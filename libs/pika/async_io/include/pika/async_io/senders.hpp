@@ -0,0 +1,327 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/async_io/detail/io_request.hpp>
+#include <pika/concepts/concepts.hpp>
+#include <pika/errors/try_catch_exception_ptr.hpp>
+#include <pika/execution_base/completion_scheduler.hpp>
+#include <pika/execution_base/operation_state.hpp>
+#include <pika/execution_base/receiver.hpp>
+#include <pika/execution_base/sender.hpp>
+#include <pika/functional/detail/tag_fallback_invoke.hpp>
+#include <pika/type_support/detail/with_result_of.hpp>
+
+#include <sys/socket.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace pika::async_io::experimental::detail {
+    inline char const* operation_name(io_operation operation) noexcept
+    {
+        switch (operation)
+        {
+        case io_operation::read: return "async_read";
+        case io_operation::write: return "async_write";
+        case io_operation::accept: return "async_accept";
+        case io_operation::connect: return "async_connect";
+        case io_operation::fsync: return "async_fsync";
+        }
+        return "<unknown>";
+    }
+
+    // The I/O request is completed by the backend on an arbitrary thread. The
+    // receiver is then completed on the scheduler of the sender by starting
+    // an operation state of a sender returned by schedule.
+    template <typename Scheduler, typename Receiver, typename... Ts>
+    struct operation_state : io_request
+    {
+        static_assert(sizeof...(Ts) <= 1);
+
+        struct schedule_receiver
+        {
+            using is_receiver = void;
+
+            operation_state& os;
+
+            template <typename Error>
+            friend void tag_invoke(pika::execution::experimental::set_error_t,
+                schedule_receiver&& r, Error&& error) noexcept
+            {
+                pika::execution::experimental::set_error(
+                    PIKA_MOVE(r.os.receiver), PIKA_FORWARD(Error, error));
+            }
+
+            friend void tag_invoke(
+                pika::execution::experimental::set_stopped_t, schedule_receiver&& r) noexcept
+            {
+                pika::execution::experimental::set_stopped(PIKA_MOVE(r.os.receiver));
+            }
+
+            friend void tag_invoke(
+                pika::execution::experimental::set_value_t, schedule_receiver&& r) noexcept
+            {
+                r.os.set_result();
+            }
+
+            friend constexpr pika::execution::experimental::empty_env tag_invoke(
+                pika::execution::experimental::get_env_t, schedule_receiver const&) noexcept
+            {
+                return {};
+            }
+        };
+
+        using schedule_sender_type = decltype(pika::execution::experimental::schedule(
+            std::declval<std::decay_t<Scheduler>&>()));
+        using schedule_operation_state_type =
+            pika::execution::experimental::connect_result_t<schedule_sender_type,
+                schedule_receiver>;
+
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<Scheduler> scheduler;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<Receiver> receiver;
+        std::int64_t result = 0;
+        std::optional<schedule_operation_state_type> schedule_os;
+
+        template <typename Scheduler_, typename Receiver_>
+        operation_state(Scheduler_&& scheduler, io_request const& request, Receiver_&& receiver)
+          : io_request(request)
+          , scheduler(PIKA_FORWARD(Scheduler_, scheduler))
+          , receiver(PIKA_FORWARD(Receiver_, receiver))
+        {
+            on_complete = &operation_state::on_io_complete;
+        }
+
+        operation_state(operation_state&&) = delete;
+        operation_state& operator=(operation_state&&) = delete;
+        operation_state(operation_state const&) = delete;
+        operation_state& operator=(operation_state const&) = delete;
+
+        static void on_io_complete(io_request& request, std::int64_t result) noexcept
+        {
+            auto& os = static_cast<operation_state&>(request);
+            os.result = result;
+
+            pika::detail::try_catch_exception_ptr(
+                [&]() {
+                    os.schedule_os.emplace(pika::detail::with_result_of([&]() {
+                        return pika::execution::experimental::connect(
+                            pika::execution::experimental::schedule(os.scheduler),
+                            schedule_receiver{os});
+                    }));
+                    pika::execution::experimental::start(*os.schedule_os);
+                },
+                [&](std::exception_ptr ep) {
+                    pika::execution::experimental::set_error(PIKA_MOVE(os.receiver), PIKA_MOVE(ep));
+                });
+        }
+
+        void set_result() noexcept
+        {
+            if (result < 0)
+            {
+                pika::execution::experimental::set_error(PIKA_MOVE(receiver),
+                    std::make_exception_ptr(std::system_error(static_cast<int>(-result),
+                        std::system_category(), operation_name(operation))));
+            }
+            else
+            {
+                pika::execution::experimental::set_value(PIKA_MOVE(receiver), Ts(result)...);
+            }
+        }
+
+        friend void tag_invoke(
+            pika::execution::experimental::start_t, operation_state& os) noexcept
+        {
+            pika::detail::try_catch_exception_ptr(
+                [&]() {
+                    check_polling_enabled();
+                    submit(os);
+                },
+                [&](std::exception_ptr ep) {
+                    pika::execution::experimental::set_error(PIKA_MOVE(os.receiver), PIKA_MOVE(ep));
+                });
+        }
+    };
+
+    template <typename Scheduler, typename... Ts>
+    struct io_sender
+    {
+        using is_sender = void;
+
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<Scheduler> scheduler;
+        io_request request;
+
+#if defined(PIKA_HAVE_STDEXEC)
+        using completion_signatures = pika::execution::experimental::completion_signatures<
+            pika::execution::experimental::set_value_t(Ts...),
+            pika::execution::experimental::set_error_t(std::exception_ptr)>;
+#else
+        template <template <typename...> class Tuple, template <typename...> class Variant>
+        using value_types = Variant<Tuple<Ts...>>;
+
+        template <template <typename...> class Variant>
+        using error_types = Variant<std::exception_ptr>;
+
+        static constexpr bool sends_done = false;
+#endif
+
+        template <typename Receiver>
+        friend operation_state<Scheduler, Receiver, Ts...> tag_invoke(
+            pika::execution::experimental::connect_t, io_sender const& s, Receiver&& receiver)
+        {
+            return {s.scheduler, s.request, PIKA_FORWARD(Receiver, receiver)};
+        }
+
+        template <typename Receiver>
+        friend operation_state<Scheduler, Receiver, Ts...> tag_invoke(
+            pika::execution::experimental::connect_t, io_sender&& s, Receiver&& receiver)
+        {
+            return {PIKA_MOVE(s.scheduler), s.request, PIKA_FORWARD(Receiver, receiver)};
+        }
+
+        struct env
+        {
+            PIKA_NO_UNIQUE_ADDRESS std::decay_t<Scheduler> scheduler;
+
+            friend std::decay_t<Scheduler> tag_invoke(
+                pika::execution::experimental::get_completion_scheduler_t<
+                    pika::execution::experimental::set_value_t>,
+                env const& e) noexcept
+            {
+                return e.scheduler;
+            }
+        };
+
+        friend env tag_invoke(pika::execution::experimental::get_env_t, io_sender const& s) noexcept
+        {
+            return {s.scheduler};
+        }
+    };
+
+    template <typename... Ts, typename Scheduler>
+    io_sender<std::decay_t<Scheduler>, Ts...> make_io_sender(
+        Scheduler&& scheduler, io_request const& request)
+    {
+        return {PIKA_FORWARD(Scheduler, scheduler), request};
+    }
+}    // namespace pika::async_io::experimental::detail
+
+namespace pika::async_io::experimental {
+    /// Reads up to size bytes from the file descriptor into data, starting
+    /// at the given offset, or at the current file position if no offset is
+    /// given. The returned sender sends the number of bytes read on the given
+    /// scheduler, or an std::system_error if the read failed.
+    inline constexpr struct async_read_t final
+      : pika::functional::detail::tag_fallback<async_read_t>
+    {
+    private:
+        template <typename Scheduler,
+            PIKA_CONCEPT_REQUIRES_(pika::execution::experimental::is_scheduler_v<Scheduler>)>
+        friend auto tag_fallback_invoke(async_read_t, Scheduler&& scheduler, int fd, void* data,
+            std::size_t size, std::uint64_t offset = detail::current_position)
+        {
+            detail::io_request request;
+            request.operation = detail::io_operation::read;
+            request.fd = fd;
+            request.data = data;
+            request.size = size;
+            request.offset = offset;
+            return detail::make_io_sender<std::size_t>(PIKA_FORWARD(Scheduler, scheduler), request);
+        }
+    } async_read{};
+
+    /// Writes up to size bytes from data to the file descriptor, starting at
+    /// the given offset, or at the current file position if no offset is
+    /// given. The returned sender sends the number of bytes written on the
+    /// given scheduler, or an std::system_error if the write failed.
+    inline constexpr struct async_write_t final
+      : pika::functional::detail::tag_fallback<async_write_t>
+    {
+    private:
+        template <typename Scheduler,
+            PIKA_CONCEPT_REQUIRES_(pika::execution::experimental::is_scheduler_v<Scheduler>)>
+        friend auto tag_fallback_invoke(async_write_t, Scheduler&& scheduler, int fd,
+            void const* data, std::size_t size, std::uint64_t offset = detail::current_position)
+        {
+            detail::io_request request;
+            request.operation = detail::io_operation::write;
+            request.fd = fd;
+            request.data = const_cast<void*>(data);
+            request.size = size;
+            request.offset = offset;
+            return detail::make_io_sender<std::size_t>(PIKA_FORWARD(Scheduler, scheduler), request);
+        }
+    } async_write{};
+
+    /// Accepts a connection on the listening socket. The address of the peer
+    /// is stored in addr if it is not null. The returned sender sends the
+    /// file descriptor of the accepted socket on the given scheduler, or an
+    /// std::system_error if accepting failed.
+    inline constexpr struct async_accept_t final
+      : pika::functional::detail::tag_fallback<async_accept_t>
+    {
+    private:
+        template <typename Scheduler,
+            PIKA_CONCEPT_REQUIRES_(pika::execution::experimental::is_scheduler_v<Scheduler>)>
+        friend auto tag_fallback_invoke(async_accept_t, Scheduler&& scheduler, int fd,
+            sockaddr* addr = nullptr, socklen_t* addrlen = nullptr)
+        {
+            detail::io_request request;
+            request.operation = detail::io_operation::accept;
+            request.fd = fd;
+            request.addr = addr;
+            request.addrlen_ptr = addrlen;
+            return detail::make_io_sender<int>(PIKA_FORWARD(Scheduler, scheduler), request);
+        }
+    } async_accept{};
+
+    /// Connects the socket to the given address. The returned sender
+    /// completes on the given scheduler once the connection has been
+    /// established, or sends an std::system_error if connecting failed.
+    inline constexpr struct async_connect_t final
+      : pika::functional::detail::tag_fallback<async_connect_t>
+    {
+    private:
+        template <typename Scheduler,
+            PIKA_CONCEPT_REQUIRES_(pika::execution::experimental::is_scheduler_v<Scheduler>)>
+        friend auto tag_fallback_invoke(async_connect_t, Scheduler&& scheduler, int fd,
+            sockaddr const* addr, socklen_t addrlen)
+        {
+            detail::io_request request;
+            request.operation = detail::io_operation::connect;
+            request.fd = fd;
+            request.addr = const_cast<sockaddr*>(addr);
+            request.addrlen = addrlen;
+            return detail::make_io_sender<>(PIKA_FORWARD(Scheduler, scheduler), request);
+        }
+    } async_connect{};
+
+    /// Flushes the data and metadata of the file to the storage device. The
+    /// returned sender completes on the given scheduler once the data has
+    /// been flushed, or sends an std::system_error if flushing failed.
+    inline constexpr struct async_fsync_t final
+      : pika::functional::detail::tag_fallback<async_fsync_t>
+    {
+    private:
+        template <typename Scheduler,
+            PIKA_CONCEPT_REQUIRES_(pika::execution::experimental::is_scheduler_v<Scheduler>)>
+        friend auto tag_fallback_invoke(async_fsync_t, Scheduler&& scheduler, int fd)
+        {
+            detail::io_request request;
+            request.operation = detail::io_operation::fsync;
+            request.fd = fd;
+            return detail::make_io_sender<>(PIKA_FORWARD(Scheduler, scheduler), request);
+        }
+    } async_fsync{};
+}    // namespace pika::async_io::experimental
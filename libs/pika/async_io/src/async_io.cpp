@@ -0,0 +1,511 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/async_io/detail/io_request.hpp>
+#include <pika/errors/throw_exception.hpp>
+#include <pika/runtime/config_entry.hpp>
+#include <pika/string_util/from_string.hpp>
+#include <pika/thread_support/spinlock.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#if defined(PIKA_HAVE_IO_URING)
+# include <linux/io_uring.h>
+# include <sys/mman.h>
+# include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pika::async_io::experimental::detail {
+    namespace {
+        using pika::threads::detail::polling_status;
+
+        constexpr char const* polling_source_name = "async_io";
+
+        class backend_base
+        {
+        public:
+            explicit backend_base(io_backend kind) noexcept
+              : kind_(kind)
+            {
+            }
+
+            virtual ~backend_base() = default;
+
+            io_backend kind() const noexcept { return kind_; }
+
+            virtual void submit(io_request& request) noexcept = 0;
+            virtual polling_status poll() noexcept = 0;
+
+            std::size_t get_work_count() const noexcept
+            {
+                return in_flight_.load(std::memory_order_relaxed);
+            }
+
+        protected:
+            void complete(io_request& request, std::int64_t result) noexcept
+            {
+                in_flight_.fetch_sub(1, std::memory_order_relaxed);
+                request.on_complete(request, result);
+            }
+
+            std::atomic<std::size_t> in_flight_{0};
+
+        private:
+            io_backend kind_;
+        };
+
+        // Performs the operation of the request with a blocking system call
+        std::int64_t perform_blocking(io_request& request) noexcept
+        {
+            ssize_t result = -1;
+            switch (request.operation)
+            {
+            case io_operation::read:
+                result = request.offset == current_position ?
+                    ::read(request.fd, request.data, request.size) :
+                    ::pread(request.fd, request.data, request.size, off_t(request.offset));
+                break;
+            case io_operation::write:
+                result = request.offset == current_position ?
+                    ::write(request.fd, request.data, request.size) :
+                    ::pwrite(request.fd, request.data, request.size, off_t(request.offset));
+                break;
+            case io_operation::accept:
+                result = ::accept(request.fd, request.addr, request.addrlen_ptr);
+                break;
+            case io_operation::connect:
+                result = ::connect(request.fd, request.addr, request.addrlen);
+                break;
+            case io_operation::fsync: result = ::fsync(request.fd); break;
+            }
+
+            return result < 0 ? -std::int64_t(errno) : std::int64_t(result);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Performs operations with blocking system calls on a small pool of
+        // operating system threads that is dedicated to I/O. Operations that
+        // may block for a long time, e.g. accepting connections, occupy one of
+        // the threads for the whole time.
+        class blocking_threads_backend final : public backend_base
+        {
+        public:
+            explicit blocking_threads_backend(std::size_t num_threads)
+              : backend_base(io_backend::blocking_threads)
+            {
+                threads_.reserve(num_threads);
+                for (std::size_t i = 0; i != num_threads; ++i)
+                {
+                    threads_.emplace_back([this]() { run(); });
+                }
+            }
+
+            ~blocking_threads_backend() override
+            {
+                {
+                    std::lock_guard<std::mutex> l(mtx_);
+                    stop_ = true;
+                }
+                cond_.notify_all();
+                for (auto& t : threads_) { t.join(); }
+            }
+
+            void submit(io_request& request) noexcept override
+            {
+                in_flight_.fetch_add(1, std::memory_order_relaxed);
+                {
+                    std::lock_guard<std::mutex> l(mtx_);
+                    request.next = nullptr;
+                    if (tail_ != nullptr) { tail_->next = &request; }
+                    else { head_ = &request; }
+                    tail_ = &request;
+                }
+                cond_.notify_one();
+            }
+
+            // Completions are delivered directly from the I/O threads
+            polling_status poll() noexcept override { return polling_status::idle; }
+
+        private:
+            void run()
+            {
+                std::unique_lock<std::mutex> l(mtx_);
+                while (true)
+                {
+                    cond_.wait(l, [&]() { return stop_ || head_ != nullptr; });
+                    if (head_ == nullptr) break;
+
+                    io_request& request = *head_;
+                    head_ = request.next;
+                    if (head_ == nullptr) tail_ = nullptr;
+
+                    l.unlock();
+                    complete(request, perform_blocking(request));
+                    l.lock();
+                }
+            }
+
+            std::mutex mtx_;
+            std::condition_variable cond_;
+            io_request* head_ = nullptr;
+            io_request* tail_ = nullptr;
+            bool stop_ = false;
+            std::vector<std::thread> threads_;
+        };
+
+#if defined(PIKA_HAVE_IO_URING)
+        ///////////////////////////////////////////////////////////////////////
+        // Submits operations to an io_uring instance. Submission takes a
+        // short lock, completions are reaped by whichever worker thread polls
+        // first. liburing is not required, the ring is set up directly with
+        // the system calls.
+        class io_uring_backend final : public backend_base
+        {
+        public:
+            // Returns nullptr if io_uring is not available, e.g. because the
+            // kernel is too old or the system call has been disabled
+            static std::unique_ptr<io_uring_backend> create(unsigned entries)
+            {
+                io_uring_params params;
+                std::memset(&params, 0, sizeof(params));
+
+                int const fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+                if (fd < 0) return nullptr;
+
+                // Reads and writes at the current file position require 5.6,
+                // which is also the first version supporting accept and
+                // connect
+                unsigned const required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_RW_CUR_POS;
+                if ((params.features & required) != required)
+                {
+                    ::close(fd);
+                    return nullptr;
+                }
+
+                std::unique_ptr<io_uring_backend> backend(new io_uring_backend(fd, params));
+                if (!backend->map_rings()) return nullptr;
+                return backend;
+            }
+
+            ~io_uring_backend() override
+            {
+                if (sqes_ != MAP_FAILED) ::munmap(sqes_, sqes_size_);
+                if (rings_ != MAP_FAILED) ::munmap(rings_, rings_size_);
+                ::close(fd_);
+            }
+
+            void submit(io_request& request) noexcept override
+            {
+                in_flight_.fetch_add(1, std::memory_order_relaxed);
+
+                std::lock_guard<pika::detail::spinlock> l(submit_mtx_);
+
+                // Requests are queued if the ring is full, or if queued
+                // requests have to be submitted first to preserve ordering
+                if (overflow_head_ != nullptr || !push(request))
+                {
+                    request.next = nullptr;
+                    if (overflow_tail_ != nullptr) { overflow_tail_->next = &request; }
+                    else { overflow_head_ = &request; }
+                    overflow_tail_ = &request;
+                    return;
+                }
+
+                enter();
+            }
+
+            polling_status poll() noexcept override
+            {
+                std::size_t completed = 0;
+                {
+                    std::unique_lock<pika::detail::spinlock> l(complete_mtx_, std::try_to_lock);
+                    if (!l.owns_lock()) return polling_status::idle;
+
+                    unsigned head = *cq_head_;
+                    unsigned const tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+                    while (head != tail)
+                    {
+                        io_uring_cqe const& cqe = cqes_[head & *cq_mask_];
+                        auto& request = *reinterpret_cast<io_request*>(cqe.user_data);
+                        std::int64_t const result = cqe.res;
+
+                        // Release the slot before the request can be reused
+                        ++head;
+                        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+                        --in_ring_;
+                        complete(request, result);
+                        ++completed;
+                    }
+                }
+
+                // Submit queued requests and retry submissions that failed
+                // transiently
+                if (completed != 0 || pending_.load(std::memory_order_relaxed))
+                {
+                    std::lock_guard<pika::detail::spinlock> l(submit_mtx_);
+                    while (overflow_head_ != nullptr && push(*overflow_head_))
+                    {
+                        overflow_head_ = overflow_head_->next;
+                        if (overflow_head_ == nullptr) overflow_tail_ = nullptr;
+                    }
+                    enter();
+                }
+
+                return completed != 0 ? polling_status::busy : polling_status::idle;
+            }
+
+        private:
+            io_uring_backend(int fd, io_uring_params const& params) noexcept
+              : backend_base(io_backend::io_uring)
+              , fd_(fd)
+              , params_(params)
+            {
+            }
+
+            bool map_rings() noexcept
+            {
+                std::size_t const sq_size =
+                    params_.sq_off.array + params_.sq_entries * sizeof(unsigned);
+                std::size_t const cq_size =
+                    params_.cq_off.cqes + params_.cq_entries * sizeof(io_uring_cqe);
+
+                // The submission and completion rings share a single mapping
+                rings_size_ = (std::max)(sq_size, cq_size);
+                rings_ = ::mmap(nullptr, rings_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+                if (rings_ == MAP_FAILED) return false;
+
+                sqes_size_ = params_.sq_entries * sizeof(io_uring_sqe);
+                sqes_ = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+                if (sqes_ == MAP_FAILED) return false;
+
+                char* const rings = static_cast<char*>(rings_);
+                sq_head_ = reinterpret_cast<unsigned*>(rings + params_.sq_off.head);
+                sq_tail_ = reinterpret_cast<unsigned*>(rings + params_.sq_off.tail);
+                sq_mask_ = reinterpret_cast<unsigned*>(rings + params_.sq_off.ring_mask);
+                sq_array_ = reinterpret_cast<unsigned*>(rings + params_.sq_off.array);
+                cq_head_ = reinterpret_cast<unsigned*>(rings + params_.cq_off.head);
+                cq_tail_ = reinterpret_cast<unsigned*>(rings + params_.cq_off.tail);
+                cq_mask_ = reinterpret_cast<unsigned*>(rings + params_.cq_off.ring_mask);
+                cqes_ = reinterpret_cast<io_uring_cqe*>(rings + params_.cq_off.cqes);
+
+                return true;
+            }
+
+            // Writes a submission queue entry for the request. Returns false
+            // if the submission queue is full or if the completion queue could
+            // overflow. Must be called with submit_mtx_ held.
+            bool push(io_request& request) noexcept
+            {
+                unsigned const tail = *sq_tail_;
+                unsigned const head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+                if (tail - head == params_.sq_entries) return false;
+                if (in_ring_.load(std::memory_order_relaxed) >= params_.cq_entries) return false;
+
+                unsigned const index = tail & *sq_mask_;
+                io_uring_sqe& sqe = static_cast<io_uring_sqe*>(sqes_)[index];
+                std::memset(&sqe, 0, sizeof(sqe));
+                sqe.fd = request.fd;
+                sqe.user_data = reinterpret_cast<std::uint64_t>(&request);
+
+                switch (request.operation)
+                {
+                case io_operation::read:
+                case io_operation::write:
+                    sqe.opcode = request.operation == io_operation::read ? IORING_OP_READ :
+                                                                           IORING_OP_WRITE;
+                    sqe.addr = reinterpret_cast<std::uint64_t>(request.data);
+                    sqe.len = static_cast<std::uint32_t>(
+                        (std::min)(request.size, std::size_t(0x7ffff000)));
+                    sqe.off = request.offset;
+                    break;
+                case io_operation::accept:
+                    sqe.opcode = IORING_OP_ACCEPT;
+                    sqe.addr = reinterpret_cast<std::uint64_t>(request.addr);
+                    sqe.addr2 = reinterpret_cast<std::uint64_t>(request.addrlen_ptr);
+                    break;
+                case io_operation::connect:
+                    sqe.opcode = IORING_OP_CONNECT;
+                    sqe.addr = reinterpret_cast<std::uint64_t>(request.addr);
+                    sqe.off = request.addrlen;
+                    break;
+                case io_operation::fsync: sqe.opcode = IORING_OP_FSYNC; break;
+                }
+
+                sq_array_[index] = index;
+                __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+                ++in_ring_;
+                pending_.store(true, std::memory_order_relaxed);
+                return true;
+            }
+
+            // Hands the entries written since the last call to the kernel.
+            // Must be called with submit_mtx_ held.
+            void enter() noexcept
+            {
+                unsigned const to_submit =
+                    *sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+                if (to_submit == 0)
+                {
+                    pending_.store(false, std::memory_order_relaxed);
+                    return;
+                }
+
+                int const submitted = static_cast<int>(
+                    ::syscall(__NR_io_uring_enter, fd_, to_submit, 0, 0, nullptr, 0));
+
+                // On failure (e.g. EAGAIN or EBUSY) the entries stay in the
+                // ring and are submitted on the next poll
+                pending_.store(submitted < 0 || unsigned(submitted) != to_submit,
+                    std::memory_order_relaxed);
+            }
+
+            int fd_;
+            io_uring_params params_;
+
+            void* rings_ = MAP_FAILED;
+            std::size_t rings_size_ = 0;
+            void* sqes_ = MAP_FAILED;
+            std::size_t sqes_size_ = 0;
+
+            unsigned* sq_head_ = nullptr;
+            unsigned* sq_tail_ = nullptr;
+            unsigned* sq_mask_ = nullptr;
+            unsigned* sq_array_ = nullptr;
+            unsigned* cq_head_ = nullptr;
+            unsigned* cq_tail_ = nullptr;
+            unsigned* cq_mask_ = nullptr;
+            io_uring_cqe* cqes_ = nullptr;
+
+            pika::detail::spinlock submit_mtx_;
+            pika::detail::spinlock complete_mtx_;
+
+            // Requests that did not fit into the ring
+            io_request* overflow_head_ = nullptr;
+            io_request* overflow_tail_ = nullptr;
+
+            // Requests submitted to the ring whose completion has not yet
+            // been reaped, used to never overflow the completion queue
+            std::atomic<unsigned> in_ring_{0};
+
+            // Set if entries may have to be handed to the kernel
+            std::atomic<bool> pending_{false};
+        };
+#endif
+
+        std::unique_ptr<backend_base> create_backend()
+        {
+#if defined(PIKA_HAVE_IO_URING)
+            if (pika::get_config_entry("pika.async_io.backend", "io_uring") ==
+                "io_uring")
+            {
+                auto const queue_depth = pika::detail::from_string<unsigned>(
+                    pika::get_config_entry("pika.async_io.queue_depth", 256), 256);
+                if (auto backend = io_uring_backend::create(queue_depth)) { return backend; }
+            }
+#endif
+
+            auto const num_threads = pika::detail::from_string<std::size_t>(
+                pika::get_config_entry("pika.async_io.blocking_threads", 4), 4);
+            return std::make_unique<blocking_threads_backend>(
+                (std::max)(num_threads, std::size_t(1)));
+        }
+
+        backend_base& get_backend()
+        {
+            // The backend is intentionally never destroyed: blocking threads
+            // may be stuck in system calls that never return, e.g. accept,
+            // and operations may still be in flight at exit
+            static backend_base* backend = create_backend().release();
+            return *backend;
+        }
+
+        polling_status poll() { return get_backend().poll(); }
+
+        // The number of thread pools on which polling is enabled
+        std::atomic<std::size_t> polling_pools{0};
+
+        // The number of enable_polling guards of each thread pool. The
+        // polling source is added by the first guard of a pool and removed
+        // by the last one, since a scheduler holds only one polling source
+        // of a given name.
+        std::mutex polling_mtx;
+        std::map<pika::threads::detail::thread_pool_base*, std::size_t> polling_guards;
+    }    // namespace
+
+    void submit(io_request& request) noexcept
+    {
+        PIKA_ASSERT(request.on_complete != nullptr);
+        get_backend().submit(request);
+    }
+
+    void check_polling_enabled()
+    {
+        // Completions of the io_uring backend are only reaped by polling.
+        // Operations started without polling would never complete.
+        if (get_backend().kind() == io_backend::io_uring &&
+            polling_pools.load(std::memory_order_relaxed) == 0)
+        {
+            PIKA_THROW_EXCEPTION(pika::error::invalid_status,
+                "pika::async_io::experimental::detail::check_polling_enabled",
+                "polling is not enabled on any thread pool, operations of the io_uring backend "
+                "can not complete (use pika::async_io::experimental::enable_polling)");
+        }
+    }
+
+    std::size_t get_work_count() { return get_backend().get_work_count(); }
+
+    void register_polling(pika::threads::detail::thread_pool_base& pool)
+    {
+        std::lock_guard<std::mutex> l(polling_mtx);
+        if (polling_guards[&pool]++ == 0)
+        {
+            pool.get_scheduler()->add_polling_source(
+                polling_source_name, {&poll, &get_work_count});
+            polling_pools.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void unregister_polling(pika::threads::detail::thread_pool_base& pool)
+    {
+        std::lock_guard<std::mutex> l(polling_mtx);
+        auto it = polling_guards.find(&pool);
+        PIKA_ASSERT(it != polling_guards.end() && it->second != 0);
+        if (--it->second == 0)
+        {
+            polling_guards.erase(it);
+            pool.get_scheduler()->remove_polling_source(polling_source_name);
+            polling_pools.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+}    // namespace pika::async_io::experimental::detail
+
+namespace pika::async_io::experimental {
+    io_backend get_io_backend() { return detail::get_backend().kind(); }
+}    // namespace pika::async_io::experimental
@@ -0,0 +1,221 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark measures the throughput of the asynchronous I/O senders. It
+// writes and reads a local file with a configurable number of operations in
+// flight, and streams data over a loopback TCP connection. Compare the
+// backends by running it with --pika:ini=pika.async_io.backend=io_uring and
+// --pika:ini=pika.async_io.backend=blocking_threads.
+
+#include <pika/async_io.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/modules/timing.hpp>
+#include <pika/runtime.hpp>
+#include <pika/testing/performance.hpp>
+
+#include <fmt/format.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace io = pika::async_io::experimental;
+namespace po = pika::program_options;
+namespace tt = pika::this_thread::experimental;
+
+using pika::chrono::detail::high_resolution_timer;
+
+// Runs operations on consecutive blocks of the file, keeping at most
+// in_flight of them in flight, and returns the elapsed time
+template <typename F>
+double run_blocks(std::size_t total_size, std::size_t block_size, std::size_t in_flight, F&& f)
+{
+    high_resolution_timer timer;
+
+    std::size_t const num_blocks = total_size / block_size;
+    for (std::size_t first = 0; first < num_blocks; first += in_flight)
+    {
+        std::size_t const last = (std::min)(first + in_flight, num_blocks);
+
+        std::vector<ex::unique_any_sender<std::size_t>> senders;
+        senders.reserve(last - first);
+        for (std::size_t i = first; i != last; ++i) { senders.push_back(f(i)); }
+
+        for (auto n : tt::sync_wait(ex::when_all_vector(std::move(senders))))
+        {
+            if (n != block_size) { throw std::runtime_error("short read or write"); }
+        }
+    }
+
+    return timer.elapsed();
+}
+
+std::pair<double, double> file_throughput(
+    std::string const& directory, std::size_t total_size, std::size_t block_size,
+    std::size_t in_flight)
+{
+    ex::thread_pool_scheduler sched{};
+
+    std::string path = directory + "/pika_async_io_throughput_XXXXXX";
+    int const fd = ::mkstemp(path.data());
+    if (fd < 0) { throw std::runtime_error("could not create " + path); }
+    ::unlink(path.c_str());
+
+    std::vector<char> buffer(in_flight * block_size, 'x');
+
+    double const write_s = run_blocks(total_size, block_size, in_flight, [&](std::size_t i) {
+        return io::async_write(sched, fd, buffer.data() + (i % in_flight) * block_size,
+            block_size, i * block_size);
+    });
+    tt::sync_wait(io::async_fsync(sched, fd));
+
+    double const read_s = run_blocks(total_size, block_size, in_flight, [&](std::size_t i) {
+        return io::async_read(
+            sched, fd, buffer.data() + (i % in_flight) * block_size, block_size, i * block_size);
+    });
+
+    ::close(fd);
+    return {write_s, read_s};
+}
+
+double socket_throughput(std::size_t total_size, std::size_t message_size)
+{
+    ex::thread_pool_scheduler sched{};
+
+    int const listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrlen = sizeof(addr);
+    if (listener < 0 || ::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listener, 1) != 0 ||
+        ::getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &addrlen) != 0)
+    {
+        throw std::runtime_error("could not create a loopback listener");
+    }
+
+    int const client = ::socket(AF_INET, SOCK_STREAM, 0);
+    auto server = tt::sync_wait(ex::when_all(io::async_accept(sched, listener),
+        io::async_connect(sched, client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr))));
+
+    std::vector<char> send_buffer(message_size, 'x');
+    std::vector<char> receive_buffer(message_size);
+
+    high_resolution_timer timer;
+
+    // The sender and the receiver run concurrently, each of them keeping one
+    // operation in flight
+    auto sender = ex::schedule(sched) | ex::then([&, client = client]() {
+        std::size_t sent = 0;
+        while (sent < total_size)
+        {
+            sent += tt::sync_wait(io::async_write(sched, client, send_buffer.data(),
+                (std::min)(message_size, total_size - sent)));
+        }
+    });
+    auto receiver = ex::schedule(sched) | ex::then([&, server = server]() {
+        std::size_t received = 0;
+        while (received < total_size)
+        {
+            std::size_t const n = tt::sync_wait(
+                io::async_read(sched, server, receive_buffer.data(), receive_buffer.size()));
+            if (n == 0) { throw std::runtime_error("connection closed"); }
+            received += n;
+        }
+    });
+    tt::sync_wait(ex::when_all(std::move(sender), std::move(receiver)));
+
+    double const elapsed = timer.elapsed();
+
+    ::close(client);
+    ::close(server);
+    ::close(listener);
+    return elapsed;
+}
+
+int pika_main(po::variables_map& vm)
+{
+    std::size_t const mib = 1024 * 1024;
+    auto const file_size = vm["file-size-mb"].as<std::size_t>() * mib;
+    auto const block_size = vm["block-size-kb"].as<std::size_t>() * 1024;
+    auto const in_flight = vm["in-flight"].as<std::size_t>();
+    auto const socket_size = vm["socket-size-mb"].as<std::size_t>() * mib;
+    auto const message_size = vm["message-size-kb"].as<std::size_t>() * 1024;
+    auto const directory = vm["directory"].as<std::string>();
+    auto const perftest_json = vm["perftest-json"].as<bool>();
+
+    io::enable_polling polling;
+
+    char const* backend =
+        io::get_io_backend() == io::io_backend::io_uring ? "io_uring" : "blocking_threads";
+
+    auto const [write_s, read_s] = file_throughput(directory, file_size, block_size, in_flight);
+    double const socket_s = socket_throughput(socket_size, message_size);
+
+    auto const to_mib_per_s = [](std::size_t size, double s) { return double(size) / mib / s; };
+
+    if (perftest_json)
+    {
+        pika::util::detail::json_perf_times t;
+        t.add(fmt::format("async_io_throughput - {} - file write", backend), write_s);
+        t.add(fmt::format("async_io_throughput - {} - file read", backend), read_s);
+        t.add(fmt::format("async_io_throughput - {} - loopback socket", backend), socket_s);
+        std::cout << t;
+    }
+    else
+    {
+        fmt::print("backend,threads,block_size,in_flight,file_write_mib_s,file_read_mib_s,"
+                   "message_size,socket_mib_s\n");
+        fmt::print("{},{},{},{},{},{},{},{}\n", backend, pika::get_num_worker_threads(),
+            block_size, in_flight, to_mib_per_s(file_size, write_s),
+            to_mib_per_s(file_size, read_s), message_size, to_mib_per_s(socket_size, socket_s));
+    }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    po::options_description cmdline("usage: " PIKA_APPLICATION_STRING " [options]");
+
+    // clang-format off
+    cmdline.add_options()
+        ("file-size-mb", po::value<std::size_t>()->default_value(256),
+         "size of the file written and read in MiB")
+        ("block-size-kb", po::value<std::size_t>()->default_value(64),
+         "size of the file reads and writes in KiB")
+        ("in-flight", po::value<std::size_t>()->default_value(32),
+         "maximum number of file operations in flight")
+        ("socket-size-mb", po::value<std::size_t>()->default_value(256),
+         "amount of data sent over the loopback connection in MiB")
+        ("message-size-kb", po::value<std::size_t>()->default_value(64),
+         "size of the socket reads and writes in KiB")
+        ("directory", po::value<std::string>()->default_value("/tmp"),
+         "directory in which the file is created")
+        ("perftest-json", po::bool_switch(),
+         "print final timings in json format for use with performance CI")
+        // clang-format on
+        ;
+
+    pika::init_params init_args;
+    init_args.desc_cmdline = cmdline;
+
+    return pika::init(pika_main, argc, argv, init_args);
+}
@@ -0,0 +1,266 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/async_io.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/runtime.hpp>
+#include <pika/runtime/config_entry.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace io = pika::async_io::experimental;
+namespace tt = pika::this_thread::experimental;
+
+std::vector<char> make_data(std::size_t size)
+{
+    std::vector<char> data(size);
+    for (std::size_t i = 0; i != size; ++i) { data[i] = static_cast<char>('a' + i % 26); }
+    return data;
+}
+
+void test_file()
+{
+    ex::thread_pool_scheduler sched{};
+
+    char path[] = "/tmp/pika_async_io_XXXXXX";
+    int const fd = ::mkstemp(path);
+    PIKA_TEST(fd >= 0);
+    ::unlink(path);
+
+    auto const data = make_data(4096);
+
+    // Explicit offsets
+    {
+        auto written = tt::sync_wait(io::async_write(sched, fd, data.data(), data.size(), 0));
+        PIKA_TEST_EQ(written, data.size());
+        tt::sync_wait(io::async_fsync(sched, fd));
+
+        std::vector<char> buffer(data.size());
+        auto read = tt::sync_wait(io::async_read(sched, fd, buffer.data(), buffer.size(), 0));
+        PIKA_TEST_EQ(read, data.size());
+        PIKA_TEST(buffer == data);
+
+        read = tt::sync_wait(io::async_read(sched, fd, buffer.data(), 100, 4000));
+        PIKA_TEST_EQ(read, std::size_t(96));
+        PIKA_TEST(std::equal(buffer.begin(), buffer.begin() + 96, data.begin() + 4000));
+    }
+
+    // The current file position is used without an offset
+    {
+        PIKA_TEST_EQ(::lseek(fd, 1024, SEEK_SET), off_t(1024));
+        std::vector<char> buffer(1024);
+        auto read = tt::sync_wait(io::async_read(sched, fd, buffer.data(), buffer.size()));
+        PIKA_TEST_EQ(read, std::size_t(1024));
+        PIKA_TEST(std::equal(buffer.begin(), buffer.end(), data.begin() + 1024));
+        PIKA_TEST_EQ(::lseek(fd, 0, SEEK_CUR), off_t(2048));
+    }
+
+    // Many concurrent operations
+    {
+        std::vector<char> buffer(data.size());
+        std::vector<ex::unique_any_sender<std::size_t>> senders;
+        for (std::size_t i = 0; i != 64; ++i)
+        {
+            senders.push_back(io::async_read(sched, fd, buffer.data() + i * 64, 64, i * 64));
+        }
+        auto results = tt::sync_wait(ex::when_all_vector(std::move(senders)));
+        for (auto r : results) { PIKA_TEST_EQ(r, std::size_t(64)); }
+        PIKA_TEST(buffer == data);
+    }
+
+    // The receiver is completed on the given scheduler
+    {
+        auto on_pika_thread = tt::sync_wait(io::async_fsync(sched, fd) |
+            ex::then([]() { return pika::this_thread::get_id() != pika::thread::id(); }));
+        PIKA_TEST(on_pika_thread);
+    }
+
+    ::close(fd);
+}
+
+void test_error()
+{
+    ex::thread_pool_scheduler sched{};
+
+    char buffer[16];
+    bool exception_thrown = false;
+    try
+    {
+        tt::sync_wait(io::async_read(sched, -1, buffer, sizeof(buffer), 0));
+        PIKA_TEST(false);
+    }
+    catch (std::system_error const& e)
+    {
+        PIKA_TEST_EQ(e.code().value(), EBADF);
+        exception_thrown = true;
+    }
+    PIKA_TEST(exception_thrown);
+}
+
+void test_socket()
+{
+    ex::thread_pool_scheduler sched{};
+
+    int const listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    PIKA_TEST(listener >= 0);
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    PIKA_TEST_EQ(::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    PIKA_TEST_EQ(::listen(listener, 1), 0);
+
+    socklen_t addrlen = sizeof(addr);
+    PIKA_TEST_EQ(::getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &addrlen), 0);
+
+    int const client = ::socket(AF_INET, SOCK_STREAM, 0);
+    PIKA_TEST(client >= 0);
+
+    sockaddr_in peer;
+    socklen_t peerlen = sizeof(peer);
+    auto server = tt::sync_wait(ex::when_all(
+        io::async_accept(sched, listener, reinterpret_cast<sockaddr*>(&peer), &peerlen),
+        io::async_connect(sched, client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr))));
+    PIKA_TEST(server >= 0);
+    PIKA_TEST_EQ(int(peer.sin_family), AF_INET);
+
+    auto const data = make_data(1000);
+    std::vector<char> buffer(data.size());
+    std::size_t received = 0;
+    auto written = tt::sync_wait(io::async_write(sched, client, data.data(), data.size()));
+    PIKA_TEST_EQ(written, data.size());
+    while (received != data.size())
+    {
+        auto read = tt::sync_wait(io::async_read(
+            sched, server, buffer.data() + received, buffer.size() - received));
+        PIKA_TEST(read != 0);
+        received += read;
+    }
+    PIKA_TEST(buffer == data);
+
+    // A closed connection reads as zero bytes
+    ::close(client);
+    auto read = tt::sync_wait(io::async_read(sched, server, buffer.data(), buffer.size()));
+    PIKA_TEST_EQ(read, std::size_t(0));
+
+    ::close(server);
+    ::close(listener);
+}
+
+// Operations of the io_uring backend fail instead of never completing if
+// polling is not enabled on any pool
+void test_polling_not_enabled()
+{
+    if (io::get_io_backend() != io::io_backend::io_uring) return;
+
+    ex::thread_pool_scheduler sched{};
+
+    auto data = make_data(16);
+    int fds[2];
+    PIKA_TEST_EQ(::pipe(fds), 0);
+
+    bool exception_thrown = false;
+    try
+    {
+        tt::sync_wait(io::async_write(sched, fds[1], data.data(), data.size()));
+        PIKA_TEST(false);
+    }
+    catch (pika::exception const& e)
+    {
+        PIKA_TEST(e.get_error() == pika::error::invalid_status);
+        exception_thrown = true;
+    }
+    PIKA_TEST(exception_thrown);
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+// Polling stays enabled until the last of nested enable_polling guards on a
+// pool is destroyed
+void test_nested_polling()
+{
+    ex::thread_pool_scheduler sched{};
+
+    auto data = make_data(16);
+    int fds[2];
+    PIKA_TEST_EQ(::pipe(fds), 0);
+
+    {
+        io::enable_polling outer;
+        {
+            io::enable_polling inner;
+        }
+
+        auto written = tt::sync_wait(io::async_write(sched, fds[1], data.data(), data.size()));
+        PIKA_TEST_EQ(written, data.size());
+
+        std::vector<char> buffer(data.size());
+        auto read = tt::sync_wait(io::async_read(sched, fds[0], buffer.data(), buffer.size()));
+        PIKA_TEST_EQ(read, data.size());
+        PIKA_TEST(buffer == data);
+    }
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+
+    // The last guard disabled polling again
+    test_polling_not_enabled();
+}
+
+int pika_main()
+{
+    auto const backend = io::get_io_backend();
+    std::cout << "backend: "
+              << (backend == io::io_backend::io_uring ? "io_uring" : "blocking_threads")
+              << std::endl;
+    if (pika::get_config_entry("pika.async_io.backend", "") == "blocking_threads")
+    {
+        PIKA_TEST(backend == io::io_backend::blocking_threads);
+    }
+
+    test_polling_not_enabled();
+    test_nested_polling();
+
+    io::enable_polling polling;
+
+    test_file();
+    test_error();
+    test_socket();
+
+    PIKA_TEST_EQ(io::detail::get_work_count(), std::size_t(0));
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    PIKA_TEST_EQ_MSG(pika::init(pika_main, argc, argv), 0, "pika main exited with non-zero status");
+
+    return 0;
+}
@@ -597,8 +597,8 @@ namespace pika::mpi::experimental {
                         mpi::experimental::get_completion_mode()));
             }
             auto* sched = pool.get_scheduler();
-            sched->set_mpi_polling_functions(
-                &pika::mpi::experimental::detail::poll, &get_work_count);
+            sched->add_polling_source(
+                "mpi", {&pika::mpi::experimental::detail::poll, &get_work_count});
         }
 
         // -------------------------------------------------------------
@@ -622,7 +622,7 @@ namespace pika::mpi::experimental {
 #endif
             PIKA_DETAIL_DP(mpi_debug<5>, debug(str<>("disable polling")));
             auto* sched = pool.get_scheduler();
-            sched->clear_mpi_polling_function();
+            sched->remove_polling_source("mpi");
         }
 
         int comm_world_size() { return detail::mpi_data_.size_; }
@@ -0,0 +1,184 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/concurrency/cache_line_data.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pika::concurrency::detail {
+    /// \brief A work-stealing deque with a single owner and multiple thieves.
+    ///
+    /// The owner pushes and pops items at the bottom of the deque (LIFO)
+    /// without read-modify-write operations except when racing with a thief
+    /// for the last item. Other threads steal items from the top of the deque
+    /// (FIFO). The deque grows when it is full; buffers which have been
+    /// replaced are kept until the deque is destroyed since thieves may still
+    /// be reading from them.
+    ///
+    /// This is the deque of D. Chase and Y. Lev, "Dynamic Circular
+    /// Work-Stealing Deque" (SPAA 2005), with the memory orderings of N. M. Lê
+    /// et al., "Correct and Efficient Work-Stealing for Weak Memory Models"
+    /// (PPoPP 2013).
+    template <typename T>
+    class chase_lev_deque
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+            "chase_lev_deque requires trivially copyable items (e.g. pointers)");
+
+        class buffer
+        {
+        public:
+            explicit buffer(std::int64_t capacity)
+              : mask_(capacity - 1)
+              , items_(new std::atomic<T>[std::size_t(capacity)])
+            {
+                PIKA_ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0);
+            }
+
+            std::int64_t capacity() const noexcept { return mask_ + 1; }
+
+            T load(std::int64_t i) const noexcept
+            {
+                return items_[std::size_t(i & mask_)].load(std::memory_order_relaxed);
+            }
+
+            void store(std::int64_t i, T t) noexcept
+            {
+                items_[std::size_t(i & mask_)].store(t, std::memory_order_relaxed);
+            }
+
+            std::unique_ptr<buffer> grow(std::int64_t bottom, std::int64_t top) const
+            {
+                auto b = std::make_unique<buffer>(2 * capacity());
+                for (std::int64_t i = top; i != bottom; ++i) { b->store(i, load(i)); }
+                return b;
+            }
+
+        private:
+            std::int64_t mask_;
+            std::unique_ptr<std::atomic<T>[]> items_;
+        };
+
+    public:
+        explicit chase_lev_deque(std::int64_t initial_capacity = 256)
+        {
+            // Round up to a power of two
+            std::int64_t capacity = 1;
+            while (capacity < initial_capacity) { capacity *= 2; }
+
+            buffers_.push_back(std::make_unique<buffer>(capacity));
+            buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+            top_.data_.store(0, std::memory_order_relaxed);
+            bottom_.data_.store(0, std::memory_order_relaxed);
+        }
+
+        chase_lev_deque(chase_lev_deque&&) = delete;
+        chase_lev_deque& operator=(chase_lev_deque&&) = delete;
+        chase_lev_deque(chase_lev_deque const&) = delete;
+        chase_lev_deque& operator=(chase_lev_deque const&) = delete;
+
+        /// \brief Push an item to the bottom of the deque. May only be called
+        ///        by the owner.
+        void push(T t)
+        {
+            std::int64_t const b = bottom_.data_.load(std::memory_order_relaxed);
+            std::int64_t const t_ = top_.data_.load(std::memory_order_acquire);
+            buffer* a = buffer_.load(std::memory_order_relaxed);
+
+            if (b - t_ > a->capacity() - 1)
+            {
+                buffers_.push_back(a->grow(b, t_));
+                a = buffers_.back().get();
+                buffer_.store(a, std::memory_order_release);
+            }
+
+            a->store(b, t);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom_.data_.store(b + 1, std::memory_order_relaxed);
+        }
+
+        /// \brief Pop the most recently pushed item from the bottom of the
+        ///        deque. May only be called by the owner.
+        std::optional<T> pop() noexcept
+        {
+            std::int64_t const b = bottom_.data_.load(std::memory_order_relaxed) - 1;
+            buffer* a = buffer_.load(std::memory_order_relaxed);
+            bottom_.data_.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t t = top_.data_.load(std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                // empty
+                bottom_.data_.store(b + 1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+
+            T item = a->load(b);
+            if (t == b)
+            {
+                // Last item, race with thieves
+                bool const won = top_.data_.compare_exchange_strong(
+                    t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                bottom_.data_.store(b + 1, std::memory_order_relaxed);
+                if (!won) { return std::nullopt; }
+            }
+            return item;
+        }
+
+        /// \brief Steal the least recently pushed item from the top of the
+        ///        deque. May be called by any thread. Returns an empty
+        ///        optional if the deque is empty or if another thread took
+        ///        the item first.
+        std::optional<T> steal() noexcept
+        {
+            std::int64_t t = top_.data_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t const b = bottom_.data_.load(std::memory_order_acquire);
+
+            if (t >= b) { return std::nullopt; }
+
+            buffer* a = buffer_.load(std::memory_order_acquire);
+            T item = a->load(t);
+            if (!top_.data_.compare_exchange_strong(
+                    t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return std::nullopt;
+            }
+            return item;
+        }
+
+        /// \brief Return the approximate number of items in the deque.
+        std::int64_t size() const noexcept
+        {
+            std::int64_t const b = bottom_.data_.load(std::memory_order_relaxed);
+            std::int64_t const t = top_.data_.load(std::memory_order_relaxed);
+            return b > t ? b - t : 0;
+        }
+
+        bool empty() const noexcept { return size() == 0; }
+
+    private:
+        // Thieves only touch top_, the owner mostly touches bottom_
+        cache_aligned_data<std::atomic<std::int64_t>> top_;
+        cache_aligned_data<std::atomic<std::int64_t>> bottom_;
+        std::atomic<buffer*> buffer_;
+
+        // Only modified by the owner when growing
+        std::vector<std::unique_ptr<buffer>> buffers_;
+    };
+}    // namespace pika::concurrency::detail
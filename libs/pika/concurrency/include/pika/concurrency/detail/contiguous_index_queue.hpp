@@ -13,6 +13,7 @@
 #include <cstdint>
 #include <optional>
 #include <type_traits>
+#include <utility>
 
 namespace pika::concurrency::detail {
     /// \brief A concurrent queue which can only hold contiguous ranges of
@@ -49,6 +50,16 @@ namespace pika::concurrency::detail {
 
             constexpr range decrement_last() noexcept { return range{first, last - 1}; }
 
+            constexpr range increment_first(T count) noexcept
+            {
+                return range{last - first < count ? last : T(first + count), last};
+            }
+
+            constexpr range decrement_last(T count) noexcept
+            {
+                return range{first, last - first < count ? first : T(last - count)};
+            }
+
             constexpr bool empty() noexcept { return first >= last; }
         };
 
@@ -153,6 +164,48 @@ namespace pika::concurrency::detail {
             return std::make_optional(index);
         }
 
+        /// \brief Attempt to pop up to count items from the left of the queue.
+        ///
+        /// Attempt to pop up to count items from the left (beginning) of the
+        /// queue. The popped items are returned as the half-open range
+        /// [first, last). If no items are left std::nullopt is returned.
+        constexpr std::optional<std::pair<T, T>> pop_left(T count) noexcept
+        {
+            PIKA_ASSERT(count > 0);
+
+            range desired_range{0, 0};
+            range expected_range = current_range.data_.load(std::memory_order_relaxed);
+
+            do {
+                if (expected_range.empty()) { return std::nullopt; }
+
+                desired_range = expected_range.increment_first(count);
+            } while (!current_range.data_.compare_exchange_weak(expected_range, desired_range));
+
+            return std::make_optional(std::make_pair(expected_range.first, desired_range.first));
+        }
+
+        /// \brief Attempt to pop up to count items from the right of the queue.
+        ///
+        /// Attempt to pop up to count items from the right (end) of the
+        /// queue. The popped items are returned as the half-open range
+        /// [first, last). If no items are left std::nullopt is returned.
+        constexpr std::optional<std::pair<T, T>> pop_right(T count) noexcept
+        {
+            PIKA_ASSERT(count > 0);
+
+            range desired_range{0, 0};
+            range expected_range = current_range.data_.load(std::memory_order_relaxed);
+
+            do {
+                if (expected_range.empty()) { return std::nullopt; }
+
+                desired_range = expected_range.decrement_last(count);
+            } while (!current_range.data_.compare_exchange_weak(expected_range, desired_range));
+
+            return std::make_optional(std::make_pair(desired_range.last, expected_range.last));
+        }
+
         constexpr bool empty() noexcept
         {
             return current_range.data_.load(std::memory_order_relaxed).empty();
@@ -0,0 +1,90 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/concurrency/detail/chase_lev_deque.hpp>
+#include <pika/testing.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
+
+using deque_type = pika::concurrency::detail::chase_lev_deque<std::uint64_t>;
+
+void test_basic()
+{
+    deque_type d(4);
+    PIKA_TEST(d.empty());
+    PIKA_TEST(!d.pop());
+    PIKA_TEST(!d.steal());
+
+    // Pushing more items than the initial capacity grows the deque
+    for (std::uint64_t i = 0; i != 10; ++i) { d.push(i); }
+    PIKA_TEST_EQ(d.size(), std::int64_t(10));
+
+    // The owner pops in LIFO order, thieves steal in FIFO order
+    // NOLINTBEGIN(bugprone-unchecked-optional-access)
+    PIKA_TEST_EQ(d.pop().value(), std::uint64_t(9));
+    PIKA_TEST_EQ(d.steal().value(), std::uint64_t(0));
+    PIKA_TEST_EQ(d.pop().value(), std::uint64_t(8));
+    PIKA_TEST_EQ(d.steal().value(), std::uint64_t(1));
+    // NOLINTEND(bugprone-unchecked-optional-access)
+
+    std::uint64_t remaining = 0;
+    while (d.pop()) { ++remaining; }
+    PIKA_TEST_EQ(remaining, std::uint64_t(6));
+    PIKA_TEST(d.empty());
+    PIKA_TEST(!d.steal());
+}
+
+// Every item pushed by the owner is taken exactly once, either by the owner or
+// by one of the thieves
+void test_concurrent(std::size_t num_thieves, std::uint64_t num_items)
+{
+    deque_type d(2);
+    std::vector<std::atomic<int>> taken(num_items);
+    for (auto& t : taken) { t = 0; }
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> thieves;
+    for (std::size_t i = 0; i != num_thieves; ++i)
+    {
+        thieves.emplace_back([&] {
+            while (!done.load())
+            {
+                if (auto item = d.steal()) { ++taken[*item]; }
+            }
+            while (auto item = d.steal()) { ++taken[*item]; }
+        });
+    }
+
+    for (std::uint64_t i = 0; i != num_items; ++i)
+    {
+        d.push(i);
+        if (i % 3 == 0)
+        {
+            if (auto item = d.pop()) { ++taken[*item]; }
+        }
+    }
+    while (auto item = d.pop()) { ++taken[*item]; }
+
+    done = true;
+    for (auto& t : thieves) { t.join(); }
+
+    for (auto& t : taken) { PIKA_TEST_EQ(t.load(), 1); }
+    PIKA_TEST(d.empty());
+}
+
+int main()
+{
+    test_basic();
+    test_concurrent(1, 100000);
+    test_concurrent(4, 100000);
+
+    return pika::detail::report_errors();
+}
@@ -94,6 +94,39 @@ void test_basic()
         PIKA_TEST(!q.pop_left());
         PIKA_TEST(!q.pop_right());
     }
+
+    {
+        // Popping ranges should give us at most the requested number of
+        // indices from each end.
+        using range = std::pair<std::uint32_t, std::uint32_t>;
+        pika::concurrency::detail::contiguous_index_queue<> q{3, 10};
+
+        std::optional<range> curr = q.pop_left(2);
+        PIKA_TEST(curr);
+        // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+        PIKA_TEST(curr.value() == range(3, 5));
+
+        curr = q.pop_right(3);
+        PIKA_TEST(curr);
+        // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+        PIKA_TEST(curr.value() == range(7, 10));
+
+        curr = q.pop_left(4);
+        PIKA_TEST(curr);
+        // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+        PIKA_TEST(curr.value() == range(5, 7));
+
+        PIKA_TEST(q.empty());
+        PIKA_TEST(!q.pop_left(1));
+        PIKA_TEST(!q.pop_right(1));
+
+        q.reset(3, 10);
+        curr = q.pop_right(100);
+        PIKA_TEST(curr);
+        // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+        PIKA_TEST(curr.value() == range(3, 10));
+        PIKA_TEST(q.empty());
+    }
 }
 
 enum class pop_mode
@@ -231,6 +231,17 @@ namespace pika::threads::coroutines {
                 }
             }
 
+            void trim_stack() noexcept
+            {
+#if defined(_POSIX_VERSION)
+                if (ctx_)
+                {
+                    void* limit = static_cast<char*>(stack_pointer_) - stack_size_;
+                    posix::trim_stack(limit, stack_size_);
+                }
+#endif
+            }
+
             void rebind_stack()
             {
                 if (ctx_)
@@ -364,6 +364,11 @@ namespace pika::threads::coroutines {
                 }
             }
 
+            void trim_stack() noexcept
+            {
+                if (m_stack) { posix::trim_stack(m_stack, static_cast<std::size_t>(m_stack_size)); }
+            }
+
             void rebind_stack()
             {
                 if (m_stack)
@@ -276,6 +276,8 @@ namespace pika::threads::coroutines {
 
             constexpr void reset_stack() noexcept {}
 
+            constexpr void trim_stack() noexcept {}
+
             void rebind_stack() noexcept
             {
 #if defined(PIKA_HAVE_COROUTINE_COUNTERS)
@@ -76,6 +76,15 @@
 namespace pika::threads::coroutines::detail::posix {
     PIKA_EXPORT extern bool use_guard_pages;
 
+    // Controls whether stacks are carved from large slabs instead of being
+    // mapped separately, whether the slabs are advised for transparent huge
+    // pages, whether each stack in a slab gets its own guard page, and which
+    // stack size (if any) is pre-faulted
+    PIKA_EXPORT extern bool use_stack_arena;
+    PIKA_EXPORT extern bool use_stack_arena_huge_pages;
+    PIKA_EXPORT extern bool use_stack_arena_guard_per_stack;
+    PIKA_EXPORT extern std::size_t stack_arena_prefault_size;
+
 # if defined(PIKA_HAVE_THREAD_STACK_MMAP) && defined(_POSIX_MAPPED_FILES) && _POSIX_MAPPED_FILES > 0
 
     inline void* to_stack_with_guard_page(void* stack)
@@ -119,8 +128,19 @@ namespace pika::threads::coroutines::detail::posix {
         return size;
     }
 
+    // Stacks of the arena are carved from slabs of about 2MB. If guard pages
+    // are enabled there is one guard page below the lowest stack of each
+    // slab, or optionally one guard page per stack. Freed stacks are reused
+    // for stacks of the same size and empty slabs are unmapped.
+    PIKA_EXPORT void* alloc_arena_stack(std::size_t size);
+
+    // Returns false if the stack was not allocated from the arena
+    PIKA_EXPORT bool free_arena_stack(void* stack, std::size_t size);
+
     inline void* alloc_stack(std::size_t size)
     {
+        if (use_stack_arena) { return alloc_arena_stack(size); }
+
         void* real_stack = ::mmap(nullptr, stack_size_with_guard_page(size), PROT_READ | PROT_WRITE,
 #  if defined(__APPLE__)
             MAP_PRIVATE | MAP_ANON | MAP_NORESERVE,
@@ -184,8 +204,20 @@ namespace pika::threads::coroutines::detail::posix {
         return false;
     }
 
+    // Unlike reset_stack this releases the pages unconditionally. Frames
+    // which skip the watermark, e.g. large arrays on the stack, may have
+    // touched deeper pages without overwriting it. The first page is kept as
+    // it holds the watermark and the initial context. Trimming only releases
+    // memory early, so a failure is ignored and the pages stay resident.
+    inline void trim_stack(void* stack, std::size_t size) noexcept
+    {
+        [[maybe_unused]] int r = ::madvise(stack, size - EXEC_PAGESIZE, MADV_DONTNEED);
+    }
+
     inline void free_stack(void* stack, std::size_t size)
     {
+        if (free_arena_stack(stack, size)) { return; }
+
         int r = ::munmap(to_stack_with_guard_page(stack), stack_size_with_guard_page(size));
         if (r != 0)
         {
@@ -223,6 +255,8 @@ namespace pika::threads::coroutines::detail::posix {
 
     inline bool reset_stack(void* /* stack */, std::size_t /* size */) { return false; }
 
+    inline void trim_stack(void* /* stack */, std::size_t /* size */) noexcept {}    // no-op
+
     inline void free_stack(void* stack, std::size_t /* size */)
     {
         delete[] static_cast<stack_aligner*>(stack);
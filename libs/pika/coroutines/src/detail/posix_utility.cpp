@@ -10,10 +10,284 @@
     defined(__APPLE__)
 # include <pika/coroutines/detail/posix_utility.hpp>
 
+# include <algorithm>
+# include <atomic>
+# include <cstddef>
+# include <cstdint>
+# include <map>
+# include <mutex>
+# include <utility>
+# include <vector>
+
 namespace pika::threads::coroutines::detail ::posix {
     ///////////////////////////////////////////////////////////////////////
     // this global (urghhh) variable is used to control whether guard pages
     // will be used or not
     PIKA_EXPORT bool use_guard_pages = true;
+
+    PIKA_EXPORT bool use_stack_arena = false;
+    PIKA_EXPORT bool use_stack_arena_huge_pages = false;
+    PIKA_EXPORT bool use_stack_arena_guard_per_stack = false;
+    PIKA_EXPORT std::size_t stack_arena_prefault_size = 0;
+
+# if defined(PIKA_HAVE_THREAD_STACK_MMAP) && defined(_POSIX_MAPPED_FILES) && _POSIX_MAPPED_FILES > 0
+    namespace {
+        // The size of a transparent huge page on x86-64 and on aarch64 with 4k
+        // base pages. Slabs are multiples of this size.
+        constexpr std::size_t slab_alignment = std::size_t(2) << 20;
+
+        struct stack_slab
+        {
+            char* begin = nullptr;
+            char* end = nullptr;
+
+            // The size of each slot, i.e. a stack and its guard page if each
+            // stack has one
+            std::size_t slot_size = 0;
+
+            // Slots past next have never been handed out
+            char* next = nullptr;
+            std::vector<void*> free;
+            std::size_t live = 0;
+            bool available = true;
+
+            bool full() const noexcept { return free.empty() && next == end; }
+        };
+
+        struct stack_arena
+        {
+            std::mutex mtx;
+
+            // Slabs with free slots, by stack size
+            std::map<std::size_t, std::vector<stack_slab*>> available;
+
+            // Maps the start of each slab to the slab
+            std::map<char*, stack_slab> slabs;
+
+            std::atomic<bool> used{false};
+        };
+
+        // The arena is intentionally leaked: stacks may be freed during static
+        // destruction
+        stack_arena& get_stack_arena()
+        {
+            static stack_arena* arena = new stack_arena;
+            return *arena;
+        }
+
+        [[noreturn]] void throw_arena_error(char const* what)
+        {
+            std::string error_message = std::string(what) +
+                " for a stack arena slab failed with errno " + std::to_string(errno) + " (" +
+                std::strerror(errno) + ")";
+            throw std::runtime_error(error_message);
+        }
+
+        void* map_slab_memory(std::size_t size)
+        {
+            void* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+#  if defined(__APPLE__)
+                MAP_PRIVATE | MAP_ANON | MAP_NORESERVE,
+#  elif defined(__FreeBSD__)
+                MAP_PRIVATE | MAP_ANON,
+#  else
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+#  endif
+                -1, 0);
+            if (memory == MAP_FAILED) { throw_arena_error("mmap"); }
+            return memory;
+        }
+
+        // Unmaps memory of a slab that could not be set up completely and
+        // throws. errno is preserved for the error message.
+        [[noreturn]] void unmap_and_throw_arena_error(char const* what, char* begin, char* end)
+        {
+            int const error = errno;
+            ::munmap(begin, std::size_t(end - begin));
+            errno = error;
+            throw_arena_error(what);
+        }
+
+        // Maps a new slab for stacks of the given size. If guard pages are
+        // enabled there is a single guard page below the lowest stack of the
+        // slab, so that a slab takes a single memory mapping in addition to
+        // the guard page. Only with use_stack_arena_guard_per_stack is every
+        // stack preceded by its own guard page. Only if huge pages are
+        // requested are the stacks of the slab aligned and advised for
+        // transparent huge pages, which is not effective with a guard page
+        // per stack.
+        stack_slab map_slab(std::size_t stack_size)
+        {
+            std::size_t const slab_guard_size =
+                use_guard_pages && !use_stack_arena_guard_per_stack ? EXEC_PAGESIZE : 0;
+            std::size_t const stack_guard_size =
+                use_guard_pages && use_stack_arena_guard_per_stack ? EXEC_PAGESIZE : 0;
+            std::size_t const slot_size = stack_size + stack_guard_size;
+            std::size_t const stacks_size =
+                ((std::max)(slot_size, slab_alignment) / slot_size) * slot_size;
+
+            // The stacks of the slab are in [stacks_begin, end), the guard
+            // page of the slab is in [begin, stacks_begin)
+            char* begin = nullptr;
+            char* stacks_begin = nullptr;
+            if (use_stack_arena_huge_pages)
+            {
+                std::size_t const aligned_size =
+                    (stacks_size + slab_alignment - 1) & ~(slab_alignment - 1);
+                std::size_t const reserved_size = slab_guard_size + aligned_size + slab_alignment;
+
+                char* const reserved_begin = static_cast<char*>(map_slab_memory(reserved_size));
+                char* const reserved_end = reserved_begin + reserved_size;
+                stacks_begin = reinterpret_cast<char*>(
+                    (reinterpret_cast<std::uintptr_t>(reserved_begin + slab_guard_size) +
+                        slab_alignment - 1) &
+                    ~(slab_alignment - 1));
+                begin = stacks_begin - slab_guard_size;
+                char* const end = stacks_begin + stacks_size;
+
+                // Release the parts of the reservation that were only needed
+                // for alignment
+                if (begin != reserved_begin &&
+                    ::munmap(reserved_begin, std::size_t(begin - reserved_begin)) != 0)
+                {
+                    unmap_and_throw_arena_error("munmap", reserved_begin, reserved_end);
+                }
+                if (end != reserved_end && ::munmap(end, std::size_t(reserved_end - end)) != 0)
+                {
+                    unmap_and_throw_arena_error("munmap", begin, reserved_end);
+                }
+
+#  if defined(MADV_HUGEPAGE)
+                // This is only a hint, the slab is still usable if the kernel
+                // does not support transparent huge pages
+                ::madvise(stacks_begin, stacks_size, MADV_HUGEPAGE);
+#  endif
+            }
+            else
+            {
+                begin = static_cast<char*>(map_slab_memory(slab_guard_size + stacks_size));
+                stacks_begin = begin + slab_guard_size;
+            }
+
+            char* const end = stacks_begin + stacks_size;
+            if (slab_guard_size != 0 && ::mprotect(begin, slab_guard_size, PROT_NONE) != 0)
+            {
+                unmap_and_throw_arena_error("mprotect", begin, end);
+            }
+
+            for (char* slot = stacks_begin; slot != end; slot += slot_size)
+            {
+                if (stack_guard_size != 0 && ::mprotect(slot, stack_guard_size, PROT_NONE) != 0)
+                {
+                    unmap_and_throw_arena_error("mprotect", begin, end);
+                }
+
+                // The pages are faulted in after the huge page advice has
+                // been given, MAP_POPULATE would fault in regular pages
+                if (stack_size == stack_arena_prefault_size)
+                {
+                    char* const stack = slot + stack_guard_size;
+#  if defined(MADV_POPULATE_WRITE)
+                    if (::madvise(stack, stack_size, MADV_POPULATE_WRITE) != 0)
+#  endif
+                    {
+                        for (char* p = stack; p < stack + stack_size; p += EXEC_PAGESIZE)
+                        {
+                            *static_cast<char volatile*>(p) = 0;
+                        }
+                    }
+                }
+            }
+
+            stack_slab slab;
+            slab.begin = begin;
+            slab.end = end;
+            slab.slot_size = slot_size;
+            slab.next = stacks_begin;
+            return slab;
+        }
+    }    // namespace
+
+    void* alloc_arena_stack(std::size_t size)
+    {
+        PIKA_ASSERT(size != 0 && size % EXEC_PAGESIZE == 0);
+
+        stack_arena& arena = get_stack_arena();
+
+        std::lock_guard<std::mutex> l(arena.mtx);
+        auto& available = arena.available[size];
+
+        if (available.empty())
+        {
+            stack_slab slab = map_slab(size);
+            auto it = arena.slabs.emplace(slab.begin, std::move(slab)).first;
+            arena.used.store(true, std::memory_order_relaxed);
+            available.push_back(&it->second);
+        }
+
+        stack_slab& slab = *available.back();
+        void* stack = nullptr;
+        if (!slab.free.empty())
+        {
+            stack = slab.free.back();
+            slab.free.pop_back();
+        }
+        else
+        {
+            stack = slab.next + (slab.slot_size - size);
+            slab.next += slab.slot_size;
+        }
+
+        ++slab.live;
+        if (slab.full())
+        {
+            slab.available = false;
+            available.pop_back();
+        }
+
+        return stack;
+    }
+
+    bool free_arena_stack(void* stack, std::size_t size)
+    {
+        stack_arena& arena = get_stack_arena();
+        if (!arena.used.load(std::memory_order_relaxed)) { return false; }
+
+        std::lock_guard<std::mutex> l(arena.mtx);
+
+        char* const p = static_cast<char*>(stack);
+        auto it = arena.slabs.upper_bound(p);
+        if (it == arena.slabs.begin()) { return false; }
+        --it;
+
+        stack_slab& slab = it->second;
+        if (p >= slab.end) { return false; }
+
+        PIKA_ASSERT(slab.live != 0);
+        slab.free.push_back(stack);
+        --slab.live;
+
+        auto& available = arena.available[size];
+        if (!slab.available)
+        {
+            slab.available = true;
+            available.push_back(&slab);
+        }
+
+        // Empty slabs are released, except for the last one with free slots
+        // of this size to avoid mapping and unmapping a slab repeatedly
+        if (slab.live == 0 && available.size() > 1)
+        {
+            available.erase(std::find(available.begin(), available.end(), &slab));
+            if (::munmap(slab.begin, std::size_t(slab.end - slab.begin)) != 0)
+            {
+                throw_arena_error("munmap");
+            }
+            arena.slabs.erase(it);
+        }
+
+        return true;
+    }
+# endif
 }    // namespace pika::threads::coroutines::detail::posix
 #endif
@@ -102,6 +102,8 @@ namespace pika {
         out_of_range = 36,
         /// Equivalent to std::length_error
         length_error = 37,
+        /// An operation did not complete before its deadline
+        timed_out = 38,
 
         /// \cond NOINTERNAL
         last_error,
@@ -152,6 +154,7 @@ namespace pika {
             /* 35 */ "task_block_not_active",
             /* 36 */ "out_of_range",
             /* 37 */ "length_error",
+            /* 38 */ "timed_out",
 
             /*    */ ""};
 
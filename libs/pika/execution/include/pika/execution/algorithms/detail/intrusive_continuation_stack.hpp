@@ -0,0 +1,95 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace pika::execution::experimental::detail {
+    // A continuation which is stored in an intrusive_continuation_stack. The
+    // node is meant to be embedded in an operation state so that registering
+    // the continuation does not allocate.
+    struct intrusive_continuation
+    {
+        intrusive_continuation* next = nullptr;
+        void (*continue_operation)(intrusive_continuation*) noexcept = nullptr;
+    };
+
+    // A lock-free stack of continuations waiting for an operation to complete.
+    // Continuations are pushed until complete is called, which swaps in a
+    // sentinel and runs the continuations in the order in which they were
+    // added. Continuations added after completion run immediately.
+    class intrusive_continuation_stack
+    {
+    public:
+        intrusive_continuation_stack() = default;
+        intrusive_continuation_stack(intrusive_continuation_stack&&) = delete;
+        intrusive_continuation_stack& operator=(intrusive_continuation_stack&&) = delete;
+        intrusive_continuation_stack(intrusive_continuation_stack const&) = delete;
+        intrusive_continuation_stack& operator=(intrusive_continuation_stack const&) = delete;
+
+        bool completed() const noexcept
+        {
+            return head.load(std::memory_order_acquire) == completed_marker();
+        }
+
+        // Adds a continuation, or runs it immediately if complete has already
+        // been called. The owner of the stack must not be accessed after the
+        // continuation has been added, since it may run concurrently.
+        void add(intrusive_continuation* continuation) noexcept
+        {
+            intrusive_continuation* old_head = head.load(std::memory_order_acquire);
+            do {
+                if (old_head == completed_marker())
+                {
+                    continuation->continue_operation(continuation);
+                    return;
+                }
+                continuation->next = old_head;
+            } while (!head.compare_exchange_weak(
+                old_head, continuation, std::memory_order_release, std::memory_order_acquire));
+        }
+
+        // Marks the stack as completed and runs all continuations added so
+        // far. Must be called at most once.
+        void complete() noexcept
+        {
+            intrusive_continuation* continuations =
+                head.exchange(completed_marker(), std::memory_order_acq_rel);
+            PIKA_ASSERT(continuations != completed_marker());
+
+            // The stack holds the continuations in reverse order
+            intrusive_continuation* reversed = nullptr;
+            while (continuations != nullptr)
+            {
+                intrusive_continuation* next = continuations->next;
+                continuations->next = reversed;
+                reversed = continuations;
+                continuations = next;
+            }
+
+            while (reversed != nullptr)
+            {
+                // The continuation may destroy the node
+                intrusive_continuation* next = reversed->next;
+                reversed->continue_operation(reversed);
+                reversed = next;
+            }
+        }
+
+    private:
+        static intrusive_continuation* completed_marker() noexcept
+        {
+            return reinterpret_cast<intrusive_continuation*>(std::uintptr_t(1));
+        }
+
+        std::atomic<intrusive_continuation*> head{nullptr};
+    };
+}    // namespace pika::execution::experimental::detail
@@ -0,0 +1,185 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/concepts/concepts.hpp>
+#include <pika/execution/algorithms/detail/partial_algorithm.hpp>
+#include <pika/execution/algorithms/then.hpp>
+#include <pika/execution_base/completion_scheduler.hpp>
+#include <pika/execution_base/sender.hpp>
+#include <pika/functional/detail/invoke.hpp>
+#include <pika/functional/detail/tag_priority_invoke.hpp>
+
+#include <type_traits>
+#include <utility>
+
+namespace pika::reduce_detail {
+    // Reduces the elements serially on the thread that the predecessor
+    // sender completes on. This is used when the completion scheduler of
+    // the predecessor sender does not customize the reduction.
+    template <typename Shape, typename T, typename ReduceOp, typename F>
+    struct transform_reduce_serial
+    {
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<Shape> shape;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<T> init;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<ReduceOp> op;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<F> f;
+
+        template <typename... Ts>
+        std::decay_t<T> operator()(Ts&&... ts)
+        {
+            std::decay_t<T> result = PIKA_MOVE(init);
+            for (std::decay_t<Shape> i = 0; i < shape; ++i)
+            {
+                result = PIKA_INVOKE(op, PIKA_MOVE(result), PIKA_INVOKE(f, i, ts...));
+            }
+            return result;
+        }
+    };
+
+    template <typename Shape, typename T, typename ReduceOp, typename F>
+    struct reduce_serial
+    {
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<Shape> shape;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<T> identity;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<ReduceOp> op;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<F> f;
+
+        template <typename... Ts>
+        std::decay_t<T> operator()(Ts&&... ts)
+        {
+            std::decay_t<T> result = PIKA_MOVE(identity);
+            for (std::decay_t<Shape> i = 0; i < shape; ++i) { PIKA_INVOKE(f, result, i, ts...); }
+            return result;
+        }
+    };
+}    // namespace pika::reduce_detail
+
+namespace pika::execution::experimental {
+    /// Reduces the indices [0, shape) to a single value which is sent on
+    /// completion. f is called as f(i, ts...) with the values ts sent by the
+    /// predecessor sender and returns the value for index i. The values are
+    /// combined with op and init, in an unspecified order, so op should be
+    /// associative and commutative.
+    ///
+    /// The thread_pool_scheduler reduces in parallel, otherwise the
+    /// reduction runs serially on the completion scheduler of the
+    /// predecessor sender.
+    inline constexpr struct transform_reduce_t final
+      : pika::functional::detail::tag_priority<transform_reduce_t>
+    {
+    private:
+#if !defined(PIKA_HAVE_STDEXEC)
+        // clang-format off
+        template <typename Sender, typename Shape, typename T, typename ReduceOp, typename F,
+            PIKA_CONCEPT_REQUIRES_(
+                is_sender_v<Sender> &&
+                pika::execution::experimental::detail::
+                    is_completion_scheduler_tag_invocable_v<
+                        pika::execution::experimental::set_value_t, Sender,
+                        transform_reduce_t, Shape, T, ReduceOp, F>)>
+        // clang-format on
+        friend constexpr PIKA_FORCEINLINE auto tag_override_invoke(transform_reduce_t,
+            Sender&& sender, Shape const& shape, T&& init, ReduceOp&& op, F&& f)
+        {
+            auto scheduler = pika::execution::experimental::get_completion_scheduler<
+                pika::execution::experimental::set_value_t>(
+                pika::execution::experimental::get_env(sender));
+            return pika::functional::detail::tag_invoke(transform_reduce_t{}, PIKA_MOVE(scheduler),
+                PIKA_FORWARD(Sender, sender), shape, PIKA_FORWARD(T, init),
+                PIKA_FORWARD(ReduceOp, op), PIKA_FORWARD(F, f));
+        }
+#endif
+
+        // clang-format off
+        template <typename Sender, typename Shape, typename T, typename ReduceOp, typename F,
+            PIKA_CONCEPT_REQUIRES_(
+                is_sender_v<Sender> &&
+                std::is_integral_v<std::decay_t<Shape>>
+            )>
+        // clang-format on
+        friend constexpr PIKA_FORCEINLINE auto tag_fallback_invoke(transform_reduce_t,
+            Sender&& sender, Shape const& shape, T&& init, ReduceOp&& op, F&& f)
+        {
+            return pika::execution::experimental::then(PIKA_FORWARD(Sender, sender),
+                reduce_detail::transform_reduce_serial<Shape, T, ReduceOp, F>{shape,
+                    PIKA_FORWARD(T, init), PIKA_FORWARD(ReduceOp, op), PIKA_FORWARD(F, f)});
+        }
+
+        template <typename Shape, typename T, typename ReduceOp, typename F>
+        friend constexpr PIKA_FORCEINLINE auto
+        tag_fallback_invoke(transform_reduce_t, Shape&& shape, T&& init, ReduceOp&& op, F&& f)
+        {
+            return detail::partial_algorithm<transform_reduce_t, Shape, T, ReduceOp, F>{
+                PIKA_FORWARD(Shape, shape), PIKA_FORWARD(T, init), PIKA_FORWARD(ReduceOp, op),
+                PIKA_FORWARD(F, f)};
+        }
+    } transform_reduce{};
+
+    /// Reduces the indices [0, shape) to a single value which is sent on
+    /// completion. f is called as f(acc, i, ts...) with the values ts sent
+    /// by the predecessor sender and accumulates the value for index i into
+    /// the partial result acc. Each partial result starts as a copy of
+    /// identity, and the partial results are combined with op in an
+    /// unspecified order. identity should thus be the identity of op, and op
+    /// should be associative and commutative. Accumulating in place avoids
+    /// creating a value per index, e.g. when reducing into a histogram.
+    ///
+    /// The thread_pool_scheduler reduces in parallel, otherwise the
+    /// reduction runs serially on the completion scheduler of the
+    /// predecessor sender.
+    inline constexpr struct reduce_t final : pika::functional::detail::tag_priority<reduce_t>
+    {
+    private:
+#if !defined(PIKA_HAVE_STDEXEC)
+        // clang-format off
+        template <typename Sender, typename Shape, typename T, typename ReduceOp, typename F,
+            PIKA_CONCEPT_REQUIRES_(
+                is_sender_v<Sender> &&
+                pika::execution::experimental::detail::
+                    is_completion_scheduler_tag_invocable_v<
+                        pika::execution::experimental::set_value_t, Sender,
+                        reduce_t, Shape, T, ReduceOp, F>)>
+        // clang-format on
+        friend constexpr PIKA_FORCEINLINE auto tag_override_invoke(reduce_t, Sender&& sender,
+            Shape const& shape, T&& identity, ReduceOp&& op, F&& f)
+        {
+            auto scheduler = pika::execution::experimental::get_completion_scheduler<
+                pika::execution::experimental::set_value_t>(
+                pika::execution::experimental::get_env(sender));
+            return pika::functional::detail::tag_invoke(reduce_t{}, PIKA_MOVE(scheduler),
+                PIKA_FORWARD(Sender, sender), shape, PIKA_FORWARD(T, identity),
+                PIKA_FORWARD(ReduceOp, op), PIKA_FORWARD(F, f));
+        }
+#endif
+
+        // clang-format off
+        template <typename Sender, typename Shape, typename T, typename ReduceOp, typename F,
+            PIKA_CONCEPT_REQUIRES_(
+                is_sender_v<Sender> &&
+                std::is_integral_v<std::decay_t<Shape>>
+            )>
+        // clang-format on
+        friend constexpr PIKA_FORCEINLINE auto tag_fallback_invoke(
+            reduce_t, Sender&& sender, Shape const& shape, T&& identity, ReduceOp&& op, F&& f)
+        {
+            return pika::execution::experimental::then(PIKA_FORWARD(Sender, sender),
+                reduce_detail::reduce_serial<Shape, T, ReduceOp, F>{shape,
+                    PIKA_FORWARD(T, identity), PIKA_FORWARD(ReduceOp, op), PIKA_FORWARD(F, f)});
+        }
+
+        template <typename Shape, typename T, typename ReduceOp, typename F>
+        friend constexpr PIKA_FORCEINLINE auto
+        tag_fallback_invoke(reduce_t, Shape&& shape, T&& identity, ReduceOp&& op, F&& f)
+        {
+            return detail::partial_algorithm<reduce_t, Shape, T, ReduceOp, F>{
+                PIKA_FORWARD(Shape, shape), PIKA_FORWARD(T, identity), PIKA_FORWARD(ReduceOp, op),
+                PIKA_FORWARD(F, f)};
+        }
+    } reduce{};
+}    // namespace pika::execution::experimental
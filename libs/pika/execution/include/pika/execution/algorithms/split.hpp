@@ -16,17 +16,15 @@
 # include <pika/allocator_support/traits/is_allocator.hpp>
 # include <pika/assert.hpp>
 # include <pika/concepts/concepts.hpp>
-# include <pika/concurrency/spinlock.hpp>
-# include <pika/datastructures/detail/small_vector.hpp>
 # include <pika/datastructures/variant.hpp>
 # include <pika/execution/algorithms/detail/helpers.hpp>
+# include <pika/execution/algorithms/detail/intrusive_continuation_stack.hpp>
 # include <pika/execution/algorithms/detail/partial_algorithm.hpp>
 # include <pika/execution_base/operation_state.hpp>
 # include <pika/execution_base/receiver.hpp>
 # include <pika/execution_base/sender.hpp>
 # include <pika/functional/bind_front.hpp>
 # include <pika/functional/detail/tag_fallback_invoke.hpp>
-# include <pika/functional/unique_function.hpp>
 # include <pika/memory/intrusive_ptr.hpp>
 # include <pika/thread_support/atomic_count.hpp>
 # include <pika/type_support/detail/with_result_of.hpp>
@@ -36,7 +34,6 @@
 # include <cstddef>
 # include <exception>
 # include <memory>
-# include <mutex>
 # include <optional>
 # include <tuple>
 # include <type_traits>
@@ -121,11 +118,8 @@ namespace pika::split_detail {
             using allocator_type =
                 typename std::allocator_traits<Allocator>::template rebind_alloc<shared_state>;
             PIKA_NO_UNIQUE_ADDRESS allocator_type alloc;
-            using mutex_type = pika::concurrency::detail::spinlock;
-            mutex_type mtx;
             pika::detail::atomic_count reference_count{0};
             std::atomic<bool> start_called{false};
-            std::atomic<bool> predecessor_done{false};
 
             using operation_state_type = std::decay_t<
                 pika::execution::experimental::connect_result_t<Sender, split_receiver>>;
@@ -155,8 +149,9 @@ namespace pika::split_detail {
                 error_type, value_type>
                 v;
 
-            using continuation_type = pika::util::detail::unique_function<void()>;
-            pika::detail::small_vector<continuation_type, 1> continuations;
+            // The operation states of the split senders waiting for the
+            // predecessor to complete
+            pika::execution::experimental::detail::intrusive_continuation_stack continuations;
 
             struct split_receiver
             {
@@ -257,102 +252,9 @@ namespace pika::split_detail {
                 // shared state by now.
                 os.reset();
 
-                predecessor_done = true;
-
-                {
-                    // We require taking the lock here to synchronize with
-                    // threads attempting to add continuations to the vector
-                    // of continuations. However, it is enough to take it
-                    // once and release it immediately.
-                    //
-                    // Without the lock we may not see writes to the vector.
-                    // With the lock threads attempting to add continuations
-                    // will either:
-                    // - See predecessor_done = true in which case they will
-                    //   call the continuation directly without adding it to
-                    //   the vector of continuations. Accessing the vector
-                    //   below without the lock is safe in this case because
-                    //   the vector is not modified.
-                    // - See predecessor_done = false and proceed to take
-                    //   the lock. If they see predecessor_done after taking
-                    //   the lock they can again release the lock and call
-                    //   the continuation directly. Accessing the vector
-                    //   without the lock is again safe because the vector
-                    //   is not modified.
-                    // - See predecessor_done = false and proceed to take
-                    //   the lock. If they see predecessor_done is still
-                    //   false after taking the lock, they will proceed to
-                    //   add a continuation to the vector. Since they keep
-                    //   the lock they can safely write to the vector. This
-                    //   thread will not proceed past the lock until they
-                    //   have finished writing to the vector.
-                    //
-                    // Importantly, once this thread has taken and released
-                    // this lock, threads attempting to add continuations to
-                    // the vector must see predecessor_done = true after
-                    // taking the lock in their threads and will not add
-                    // continuations to the vector.
-                    std::lock_guard<mutex_type> l{mtx};
-                }
-
-                if (!continuations.empty())
-                {
-                    for (auto const& continuation : continuations) { continuation(); }
-                    continuations.clear();
-                }
-            }
-
-            template <typename Receiver>
-            void add_continuation(Receiver& receiver) = delete;
-
-            template <typename Receiver>
-            void add_continuation(Receiver&& receiver)
-            {
-                if (predecessor_done)
-                {
-                    // If we read predecessor_done here it means that one of
-                    // set_error/set_stopped/set_value has been called and
-                    // values/errors have been stored into the shared state.
-                    // We can trigger the continuation directly.
-                    // TODO: Should this preserve the scheduler? It does not
-                    // if we call set_* inline.
-                    pika::detail::visit(
-                        stopped_error_value_visitor<Receiver>{PIKA_FORWARD(Receiver, receiver)}, v);
-                }
-                else
-                {
-                    // If predecessor_done is false, we have to take the
-                    // lock to potentially add the continuation to the
-                    // vector of continuations.
-                    std::unique_lock<mutex_type> l{mtx};
-
-                    if (predecessor_done)
-                    {
-                        // By the time the lock has been taken,
-                        // predecessor_done might already be true and we can
-                        // release the lock early and call the continuation
-                        // directly again.
-                        l.unlock();
-                        pika::detail::visit(
-                            stopped_error_value_visitor<Receiver>{PIKA_FORWARD(Receiver, receiver)},
-                            v);
-                    }
-                    else
-                    {
-                        // If predecessor_done is still false, we add the
-                        // continuation to the vector of continuations. This
-                        // has to be done while holding the lock, since
-                        // other threads may also try to add continuations
-                        // to the vector and the vector is not threadsafe in
-                        // itself. The continuation will be called later
-                        // when set_error/set_stopped/set_value is called.
-                        continuations.emplace_back(
-                            [this, receiver = PIKA_FORWARD(Receiver, receiver)]() mutable {
-                                pika::detail::visit(
-                                    stopped_error_value_visitor<Receiver>{PIKA_MOVE(receiver)}, v);
-                            });
-                    }
-                }
+                // Any operation states which attempt to add themselves to
+                // the continuations after this point will run immediately.
+                continuations.complete();
             }
 
             void start() & noexcept
@@ -403,14 +305,16 @@ namespace pika::split_detail {
         split_sender_type& operator=(split_sender_type&&) = default;
 
         template <typename Receiver>
-        struct operation_state
+        struct operation_state : pika::execution::experimental::detail::intrusive_continuation
         {
             PIKA_NO_UNIQUE_ADDRESS std::decay_t<Receiver> receiver;
             pika::intrusive_ptr<shared_state> state;
 
             template <typename Receiver_>
             operation_state(Receiver_&& receiver, pika::intrusive_ptr<shared_state> state)
-              : receiver(PIKA_FORWARD(Receiver_, receiver))
+              : pika::execution::experimental::detail::intrusive_continuation{nullptr,
+                    &operation_state::continue_operation}
+              , receiver(PIKA_FORWARD(Receiver_, receiver))
               , state(PIKA_MOVE(state))
             {
             }
@@ -420,11 +324,25 @@ namespace pika::split_detail {
             operation_state(operation_state const&) = delete;
             operation_state& operator=(operation_state const&) = delete;
 
+            static void continue_operation(
+                pika::execution::experimental::detail::intrusive_continuation* c) noexcept
+            {
+                // If we get here one of set_error/set_stopped/set_value has
+                // been called and values/errors have been stored into the
+                // shared state.
+                // TODO: Should this preserve the scheduler? It does not
+                // if we call set_* inline.
+                auto& os = static_cast<operation_state&>(*c);
+                pika::detail::visit(typename shared_state::template stopped_error_value_visitor<
+                                        std::decay_t<Receiver>>{PIKA_MOVE(os.receiver)},
+                    os.state->v);
+            }
+
             friend void tag_invoke(
                 pika::execution::experimental::start_t, operation_state& os) noexcept
             {
                 os.state->start();
-                os.state->add_continuation(PIKA_MOVE(os.receiver));
+                os.state->continuations.add(&os);
             }
         };
 
@@ -13,26 +13,23 @@
 #include <pika/allocator_support/traits/is_allocator.hpp>
 #include <pika/assert.hpp>
 #include <pika/concepts/concepts.hpp>
-#include <pika/concurrency/spinlock.hpp>
 #include <pika/datastructures/variant.hpp>
 #include <pika/execution/algorithms/detail/helpers.hpp>
+#include <pika/execution/algorithms/detail/intrusive_continuation_stack.hpp>
 #include <pika/execution/algorithms/detail/partial_algorithm.hpp>
 #include <pika/execution_base/operation_state.hpp>
 #include <pika/execution_base/receiver.hpp>
 #include <pika/execution_base/sender.hpp>
 #include <pika/functional/detail/tag_fallback_invoke.hpp>
-#include <pika/functional/unique_function.hpp>
 #include <pika/memory/intrusive_ptr.hpp>
 #include <pika/thread_support/atomic_count.hpp>
 #include <pika/type_support/detail/with_result_of.hpp>
 #include <pika/type_support/pack.hpp>
 
-#include <array>
 #include <atomic>
 #include <cstddef>
 #include <exception>
 #include <memory>
-#include <mutex>
 #include <optional>
 #include <tuple>
 #include <type_traits>
@@ -59,11 +56,8 @@ namespace pika::split_tuple_detail {
         using allocator_type =
             typename std::allocator_traits<Allocator>::template rebind_alloc<shared_state>;
         PIKA_NO_UNIQUE_ADDRESS allocator_type alloc;
-        using mutex_type = pika::concurrency::detail::spinlock;
-        mutex_type mtx;
         pika::detail::atomic_count reference_count{0};
         std::atomic<bool> start_called{false};
-        std::atomic<bool> predecessor_done{false};
 
         using operation_state_type = std::decay_t<
             pika::execution::experimental::connect_result_t<Sender, split_tuple_receiver>>;
@@ -105,9 +99,9 @@ namespace pika::split_tuple_detail {
             error_type, value_type>
             v;
 
-        using continuation_type = pika::util::detail::unique_function<void()>;
-
-        std::array<continuation_type, std::tuple_size_v<value_type>> continuations;
+        // The operation states of the split_tuple senders that have been
+        // started before the predecessor completed
+        pika::execution::experimental::detail::intrusive_continuation_stack continuations;
 
         struct split_tuple_receiver
         {
@@ -229,110 +223,10 @@ namespace pika::split_tuple_detail {
             // shared state by now.
             os.reset();
 
-            predecessor_done = true;
-
-            {
-                // We require taking the lock here to synchronize with
-                // threads attempting to add continuations to the vector
-                // of continuations. However, it is enough to take it
-                // once and release it immediately.
-                //
-                // Without the lock we may not see writes to the vector.
-                // With the lock threads attempting to add continuations
-                // will either:
-                // - See predecessor_done = true in which case they will
-                //   call the continuation directly without adding it to
-                //   the vector of continuations. Accessing the vector
-                //   below without the lock is safe in this case because
-                //   the vector is not modified.
-                // - See predecessor_done = false and proceed to take
-                //   the lock. If they see predecessor_done after taking
-                //   the lock they can again release the lock and call
-                //   the continuation directly. Accessing the vector
-                //   without the lock is again safe because the vector
-                //   is not modified.
-                // - See predecessor_done = false and proceed to take
-                //   the lock. If they see predecessor_done is still
-                //   false after taking the lock, they will proceed to
-                //   add a continuation to the vector. Since they keep
-                //   the lock they can safely write to the vector. This
-                //   thread will not proceed past the lock until they
-                //   have finished writing to the vector.
-                //
-                // Importantly, once this thread has taken and released
-                // this lock, threads attempting to add continuations to
-                // the vector must see predecessor_done = true after
-                // taking the lock in their threads and will not add
-                // continuations to the vector.
-                std::lock_guard<mutex_type> l{mtx};
-            }
-
-            if (!continuations.empty())
-            {
-                // We move the continuations to a local variable to
-                // release them once all continuations have been called.
-                // We cannot call clear on continuations after the loop
-                // because the shared state may already be released by
-                // the last continuation to run.
-                auto continuations_local = PIKA_MOVE(continuations);
-                for (auto const& continuation : continuations_local)
-                {
-                    if (continuation) { continuation(); }
-                }
-            }
-        }
-
-        template <std::size_t Index, typename Receiver>
-        void add_continuation(Receiver& receiver) = delete;
-
-        template <std::size_t Index, typename Receiver>
-        void add_continuation(Receiver&& receiver)
-        {
-            if (predecessor_done)
-            {
-                // If we read predecessor_done here it means that one of
-                // set_error/set_stopped/set_value has been called and
-                // values/errors have been stored into the shared state.
-                // We can trigger the continuation directly.
-                pika::detail::visit(
-                    stopped_error_value_visitor<Index, Receiver>{PIKA_FORWARD(Receiver, receiver)},
-                    v);
-            }
-            else
-            {
-                // If predecessor_done is false, we have to take the
-                // lock to potentially add the continuation to the
-                // vector of continuations.
-                std::unique_lock<mutex_type> l{mtx};
-
-                if (predecessor_done)
-                {
-                    // By the time the lock has been taken,
-                    // predecessor_done might already be true and we can
-                    // release the lock early and call the continuation
-                    // directly again.
-                    l.unlock();
-                    pika::detail::visit(stopped_error_value_visitor<Index, Receiver>{PIKA_FORWARD(
-                                            Receiver, receiver)},
-                        v);
-                }
-                else
-                {
-                    // If predecessor_done is still false, we add the
-                    // continuation to the vector of continuations. This
-                    // has to be done while holding the lock, since
-                    // other threads may also try to add continuations
-                    // to the vector and the vector is not threadsafe in
-                    // itself. The continuation will be called later
-                    // when set_error/set_stopped/set_value is called.
-                    continuations[Index] = [this,
-                                               receiver =
-                                                   PIKA_FORWARD(Receiver, receiver)]() mutable {
-                        pika::detail::visit(
-                            stopped_error_value_visitor<Index, Receiver>{PIKA_MOVE(receiver)}, v);
-                    };
-                }
-            }
+            // Any continuations added after this point will run
+            // immediately. The shared state may be released by the last
+            // continuation to run.
+            continuations.complete();
         }
 
         void start() & noexcept
@@ -442,14 +336,16 @@ namespace pika::split_tuple_detail {
         split_tuple_sender_type& operator=(split_tuple_sender_type&&) = default;
 
         template <typename Receiver>
-        struct operation_state
+        struct operation_state : pika::execution::experimental::detail::intrusive_continuation
         {
             PIKA_NO_UNIQUE_ADDRESS std::decay_t<Receiver> receiver;
             pika::intrusive_ptr<shared_state_type> state;
 
             template <typename Receiver_>
             operation_state(Receiver_&& receiver, pika::intrusive_ptr<shared_state_type> state)
-              : receiver(PIKA_FORWARD(Receiver_, receiver))
+              : pika::execution::experimental::detail::intrusive_continuation{nullptr,
+                    &operation_state::continue_operation}
+              , receiver(PIKA_FORWARD(Receiver_, receiver))
               , state(PIKA_MOVE(state))
             {
             }
@@ -459,11 +355,24 @@ namespace pika::split_tuple_detail {
             operation_state(operation_state const&) = delete;
             operation_state& operator=(operation_state const&) = delete;
 
+            static void continue_operation(
+                pika::execution::experimental::detail::intrusive_continuation* c) noexcept
+            {
+                // If we get here one of set_error/set_stopped/set_value has
+                // been called and values/errors have been stored into the
+                // shared state.
+                auto& os = static_cast<operation_state&>(*c);
+                pika::detail::visit(
+                    typename shared_state_type::template stopped_error_value_visitor<Index,
+                        std::decay_t<Receiver>>{PIKA_MOVE(os.receiver)},
+                    os.state->v);
+            }
+
             friend void tag_invoke(
                 pika::execution::experimental::start_t, operation_state& os) noexcept
             {
                 os.state->start();
-                os.state->template add_continuation<Index>(PIKA_MOVE(os.receiver));
+                os.state->continuations.add(&os);
             }
         };
 
@@ -0,0 +1,333 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/concepts/concepts.hpp>
+#include <pika/errors/exception.hpp>
+#include <pika/execution/algorithms/detail/partial_algorithm.hpp>
+#include <pika/execution/stop_token_queries.hpp>
+#include <pika/execution/timed_scheduler.hpp>
+#include <pika/execution_base/operation_state.hpp>
+#include <pika/execution_base/receiver.hpp>
+#include <pika/execution_base/sender.hpp>
+#include <pika/functional/detail/tag_fallback_invoke.hpp>
+#include <pika/memory/intrusive_ptr.hpp>
+#include <pika/synchronization/stop_token.hpp>
+#include <pika/timing/steady_clock.hpp>
+#include <pika/type_support/detail/with_result_of.hpp>
+#include <pika/type_support/pack.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace pika::timeout_detail {
+    // The environment of the two senders raced by timeout. Stop is requested
+    // through the stop token as soon as either of them completes, or if stop
+    // is requested through the environment of the receiver of timeout.
+    struct env
+    {
+        pika::stop_token stop_token;
+
+        friend pika::stop_token tag_invoke(
+            pika::execution::experimental::get_stop_token_t, env const& e) noexcept
+        {
+            return e.stop_token;
+        }
+    };
+
+    // The state shared between the predecessor sender and the timer. It is
+    // kept alive until both have completed, since the loser of the race may
+    // complete long after the receiver of timeout has been completed.
+    template <typename Sender, typename Scheduler, typename Receiver>
+    struct shared_state
+    {
+        template <typename Derived>
+        struct receiver_base
+        {
+            using is_receiver = void;
+
+            shared_state* state;
+
+            friend env tag_invoke(
+                pika::execution::experimental::get_env_t, Derived const& r) noexcept
+            {
+                return {r.state->stop_source.get_token()};
+            }
+        };
+
+        struct sender_receiver : receiver_base<sender_receiver>
+        {
+            template <typename Error>
+            friend void tag_invoke(pika::execution::experimental::set_error_t,
+                sender_receiver&& r, Error&& error) noexcept
+            {
+                r.state->complete([&](auto& receiver) {
+                    pika::execution::experimental::set_error(
+                        PIKA_MOVE(receiver), PIKA_FORWARD(Error, error));
+                });
+            }
+
+            friend void tag_invoke(
+                pika::execution::experimental::set_stopped_t, sender_receiver&& r) noexcept
+            {
+                r.state->complete([](auto& receiver) {
+                    pika::execution::experimental::set_stopped(PIKA_MOVE(receiver));
+                });
+            }
+
+            template <typename... Ts>
+            friend void tag_invoke(pika::execution::experimental::set_value_t,
+                sender_receiver&& r, Ts&&... ts) noexcept
+            {
+                r.state->complete([&](auto& receiver) {
+                    pika::execution::experimental::set_value(
+                        PIKA_MOVE(receiver), PIKA_FORWARD(Ts, ts)...);
+                });
+            }
+        };
+
+        struct timer_receiver : receiver_base<timer_receiver>
+        {
+            template <typename Error>
+            friend void tag_invoke(pika::execution::experimental::set_error_t,
+                timer_receiver&& r, Error&& error) noexcept
+            {
+                r.state->complete([&](auto& receiver) {
+                    pika::execution::experimental::set_error(
+                        PIKA_MOVE(receiver), PIKA_FORWARD(Error, error));
+                });
+            }
+
+            friend void tag_invoke(
+                pika::execution::experimental::set_stopped_t, timer_receiver&& r) noexcept
+            {
+                r.state->complete([](auto& receiver) {
+                    pika::execution::experimental::set_stopped(PIKA_MOVE(receiver));
+                });
+            }
+
+            friend void tag_invoke(
+                pika::execution::experimental::set_value_t, timer_receiver&& r) noexcept
+            {
+                r.state->complete([](auto& receiver) {
+                    pika::execution::experimental::set_error(PIKA_MOVE(receiver),
+                        std::make_exception_ptr(pika::exception(pika::error::timed_out,
+                            "the sender did not complete before the deadline")));
+                });
+            }
+        };
+
+        using timer_sender_type =
+            std::invoke_result_t<pika::execution::experimental::schedule_after_t, Scheduler,
+                pika::chrono::steady_duration const&>;
+        using sender_operation_state_type =
+            pika::execution::experimental::connect_result_t<Sender, sender_receiver>;
+        using timer_operation_state_type =
+            pika::execution::experimental::connect_result_t<timer_sender_type, timer_receiver>;
+
+        struct on_stop_requested
+        {
+            shared_state& state;
+
+            void operator()() noexcept { state.stop_source.request_stop(); }
+        };
+
+        using receiver_stop_token_type =
+            pika::execution::experimental::detail::receiver_stop_token_t<Receiver>;
+
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<Receiver> receiver;
+        pika::stop_source stop_source;
+        std::optional<pika::execution::experimental::stop_callback_for_t<receiver_stop_token_type,
+            on_stop_requested>>
+            stop_callback;
+        std::atomic<bool> completed{false};
+        std::atomic<std::size_t> reference_count{0};
+        std::optional<sender_operation_state_type> sender_os;
+        std::optional<timer_operation_state_type> timer_os;
+
+        template <typename Sender_, typename Receiver_>
+        shared_state(Sender_&& sender, Scheduler const& scheduler,
+            pika::chrono::steady_duration const& rel_time, Receiver_&& receiver)
+          : receiver(PIKA_FORWARD(Receiver_, receiver))
+        {
+            sender_os.emplace(pika::detail::with_result_of([&]() {
+                return pika::execution::experimental::connect(
+                    PIKA_FORWARD(Sender_, sender), sender_receiver{{this}});
+            }));
+            timer_os.emplace(pika::detail::with_result_of([&]() {
+                return pika::execution::experimental::connect(
+                    pika::execution::experimental::schedule_after(scheduler, rel_time),
+                    timer_receiver{{this}});
+            }));
+        }
+
+        shared_state(shared_state&&) = delete;
+        shared_state(shared_state const&) = delete;
+        shared_state& operator=(shared_state&&) = delete;
+        shared_state& operator=(shared_state const&) = delete;
+
+        // Only the first of the two operations to complete completes the
+        // receiver, the other one is asked to stop.
+        template <typename F>
+        void complete(F&& f) noexcept
+        {
+            if (!completed.exchange(true, std::memory_order_acq_rel))
+            {
+                stop_callback.reset();
+                stop_source.request_stop();
+                PIKA_FORWARD(F, f)(receiver);
+            }
+
+            intrusive_ptr_release(this);
+        }
+
+        void start() noexcept
+        {
+            // Each of the operations keeps the state alive until it completes
+            reference_count.fetch_add(2, std::memory_order_relaxed);
+
+            stop_callback.emplace(
+                pika::execution::experimental::detail::get_receiver_stop_token(receiver),
+                on_stop_requested{*this});
+
+            // The state can only be released by the timer once it has been
+            // started, after which it must no longer be accessed here
+            pika::execution::experimental::start(*sender_os);
+            pika::execution::experimental::start(*timer_os);
+        }
+
+        friend void intrusive_ptr_add_ref(shared_state* p)
+        {
+            p->reference_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        friend void intrusive_ptr_release(shared_state* p)
+        {
+            if (p->reference_count.fetch_sub(1, std::memory_order_acq_rel) == 1) { delete p; }
+        }
+    };
+
+    template <typename Sender, typename Scheduler, typename Receiver>
+    struct operation_state
+    {
+        pika::intrusive_ptr<shared_state<Sender, Scheduler, Receiver>> state;
+
+        friend void tag_invoke(
+            pika::execution::experimental::start_t, operation_state& os) noexcept
+        {
+            os.state->start();
+        }
+    };
+
+    template <typename Sender, typename Scheduler>
+    struct timeout_sender_impl
+    {
+        struct timeout_sender_type;
+    };
+
+    template <typename Sender, typename Scheduler>
+    using timeout_sender = typename timeout_sender_impl<Sender, Scheduler>::timeout_sender_type;
+
+    template <typename Sender, typename Scheduler>
+    struct timeout_sender_impl<Sender, Scheduler>::timeout_sender_type
+    {
+        using is_sender = void;
+
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<Sender> sender;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<Scheduler> scheduler;
+        pika::chrono::steady_duration rel_time;
+
+#if defined(PIKA_HAVE_STDEXEC)
+        using completion_signatures =
+            pika::execution::experimental::make_completion_signatures<Sender,
+                pika::execution::experimental::empty_env,
+                pika::execution::experimental::completion_signatures<
+                    pika::execution::experimental::set_error_t(std::exception_ptr),
+                    pika::execution::experimental::set_stopped_t()>>;
+#else
+        template <template <typename...> class Tuple, template <typename...> class Variant>
+        using value_types = typename pika::execution::experimental::sender_traits<
+            Sender>::template value_types<Tuple, Variant>;
+
+        template <template <typename...> class Variant>
+        using error_types = pika::util::detail::unique_t<
+            pika::util::detail::prepend_t<typename pika::execution::experimental::sender_traits<
+                                              Sender>::template error_types<Variant>,
+                std::exception_ptr>>;
+
+        // The timer completes with set_stopped if stop is requested before
+        // the deadline
+        static constexpr bool sends_done = true;
+#endif
+
+        template <typename Receiver>
+        friend auto tag_invoke(pika::execution::experimental::connect_t,
+            timeout_sender_type&& s, Receiver&& receiver)
+        {
+            using state_type =
+                shared_state<std::decay_t<Sender>, std::decay_t<Scheduler>, Receiver>;
+            return operation_state<std::decay_t<Sender>, std::decay_t<Scheduler>, Receiver>{
+                new state_type(PIKA_MOVE(s.sender), s.scheduler, s.rel_time,
+                    PIKA_FORWARD(Receiver, receiver))};
+        }
+
+        template <typename Receiver>
+        friend auto tag_invoke(pika::execution::experimental::connect_t,
+            timeout_sender_type const& s, Receiver&& receiver)
+        {
+            using state_type =
+                shared_state<std::decay_t<Sender> const&, std::decay_t<Scheduler>, Receiver>;
+            return operation_state<std::decay_t<Sender> const&, std::decay_t<Scheduler>,
+                Receiver>{
+                new state_type(
+                    s.sender, s.scheduler, s.rel_time, PIKA_FORWARD(Receiver, receiver))};
+        }
+
+        friend constexpr decltype(auto) tag_invoke(
+            pika::execution::experimental::get_env_t, timeout_sender_type const& s) noexcept
+        {
+            return pika::execution::experimental::get_env(s.sender);
+        }
+    };
+}    // namespace pika::timeout_detail
+
+namespace pika::execution::experimental {
+    /// timeout races the given sender against a timer of the given timed
+    /// scheduler. If the sender completes first its completion is forwarded.
+    /// If the deadline passes first, the receiver is completed with
+    /// set_error(std::exception_ptr) holding a pika::exception with the error
+    /// code pika::error::timed_out. The loser of the race is asked to stop
+    /// through the stop token of its environment.
+    ///
+    /// Note that a sender that does not support cancellation keeps running
+    /// after the timeout. Its result is discarded.
+    inline constexpr struct timeout_t final : pika::functional::detail::tag_fallback<timeout_t>
+    {
+    private:
+        template <typename Sender, typename Scheduler,
+            PIKA_CONCEPT_REQUIRES_(is_sender_v<Sender>&& is_timed_scheduler_v<Scheduler>)>
+        friend constexpr PIKA_FORCEINLINE auto tag_fallback_invoke(timeout_t, Sender&& sender,
+            Scheduler&& scheduler, pika::chrono::steady_duration const& rel_time)
+        {
+            return timeout_detail::timeout_sender<Sender, Scheduler>{PIKA_FORWARD(Sender, sender),
+                PIKA_FORWARD(Scheduler, scheduler), rel_time};
+        }
+
+        template <typename Scheduler, PIKA_CONCEPT_REQUIRES_(is_timed_scheduler_v<Scheduler>)>
+        friend constexpr PIKA_FORCEINLINE auto tag_fallback_invoke(
+            timeout_t, Scheduler&& scheduler, pika::chrono::steady_duration const& rel_time)
+        {
+            return detail::partial_algorithm<timeout_t, Scheduler, pika::chrono::steady_duration>{
+                PIKA_FORWARD(Scheduler, scheduler), rel_time};
+        }
+    } timeout{};
+}    // namespace pika::execution::experimental
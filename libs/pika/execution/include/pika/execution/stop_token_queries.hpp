@@ -0,0 +1,108 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#if defined(PIKA_HAVE_STDEXEC)
+# include <pika/execution_base/stdexec_forward.hpp>
+#else
+# include <pika/concepts/concepts.hpp>
+# include <pika/execution_base/sender.hpp>
+# include <pika/functional/tag_invoke.hpp>
+#endif
+
+#include <type_traits>
+#include <utility>
+
+#if !defined(PIKA_HAVE_STDEXEC)
+namespace pika::execution::experimental {
+    /// A stop token for which stop can never be requested. This is the stop
+    /// token of environments that don't provide one.
+    struct never_stop_token
+    {
+        template <typename Callback>
+        struct callback_type
+        {
+            template <typename CB>
+            explicit callback_type(never_stop_token, CB&&) noexcept
+            {
+            }
+        };
+
+        static constexpr bool stop_requested() noexcept { return false; }
+        static constexpr bool stop_possible() noexcept { return false; }
+
+        friend constexpr bool operator==(never_stop_token, never_stop_token) noexcept
+        {
+            return true;
+        }
+
+        friend constexpr bool operator!=(never_stop_token, never_stop_token) noexcept
+        {
+            return false;
+        }
+    };
+
+    namespace stop_token_queries_detail {
+        struct get_stop_token_t
+        {
+            template <typename Env,
+                PIKA_CONCEPT_REQUIRES_(pika::functional::detail::is_nothrow_tag_invocable_v<
+                    get_stop_token_t, Env const&>)>
+            constexpr auto PIKA_STATIC_CALL_OPERATOR(Env const& env) noexcept
+            {
+                return pika::functional::detail::tag_invoke(get_stop_token_t{}, env);
+            }
+
+            template <typename Env,
+                PIKA_CONCEPT_REQUIRES_(!pika::functional::detail::is_nothrow_tag_invocable_v<
+                                       get_stop_token_t, Env const&>)>
+            constexpr never_stop_token PIKA_STATIC_CALL_OPERATOR(Env const&) noexcept
+            {
+                return {};
+            }
+        };
+    }    // namespace stop_token_queries_detail
+
+    using stop_token_queries_detail::get_stop_token_t;
+
+    inline constexpr get_stop_token_t get_stop_token{};
+
+    template <typename T>
+    using stop_token_of_t = std::decay_t<decltype(get_stop_token(std::declval<T>()))>;
+
+    template <typename Token, typename Callback>
+    using stop_callback_for_t = typename Token::template callback_type<Callback>;
+}    // namespace pika::execution::experimental
+#endif
+
+namespace pika::execution::experimental::detail {
+    /// Returns the stop token from the environment of the given receiver.
+    /// Without stdexec receivers are not required to provide an environment,
+    /// in which case stop can never be requested.
+    template <typename Receiver>
+    auto get_receiver_stop_token(Receiver const& receiver) noexcept
+    {
+#if defined(PIKA_HAVE_STDEXEC)
+        return get_stop_token(get_env(receiver));
+#else
+        if constexpr (pika::functional::detail::is_tag_invocable_v<get_env_t, Receiver const&>)
+        {
+            return get_stop_token(get_env(receiver));
+        }
+        else
+        {
+            PIKA_UNUSED(receiver);
+            return never_stop_token{};
+        }
+#endif
+    }
+
+    template <typename Receiver>
+    using receiver_stop_token_t =
+        std::decay_t<decltype(get_receiver_stop_token(std::declval<Receiver const&>()))>;
+}    // namespace pika::execution::experimental::detail
@@ -0,0 +1,53 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/concepts/concepts.hpp>
+#include <pika/execution_base/sender.hpp>
+#include <pika/functional/detail/tag_fallback_invoke.hpp>
+#include <pika/functional/tag_invoke.hpp>
+#include <pika/timing/steady_clock.hpp>
+
+#include <type_traits>
+#include <utility>
+
+namespace pika::execution::experimental {
+    /// schedule_at is a customization point object for timed schedulers.
+    /// `schedule_at(scheduler, time_point)` returns a sender which completes
+    /// on an execution resource of the scheduler, no earlier than the given
+    /// point in time. Senders returned by timed schedulers may complete with
+    /// set_stopped if stop is requested through the stop token of the
+    /// environment of the receiver they are connected to.
+    inline constexpr struct schedule_at_t final : pika::functional::detail::tag<schedule_at_t>
+    {
+    } schedule_at{};
+
+    /// schedule_after is a customization point object for timed schedulers.
+    /// `schedule_after(scheduler, duration)` returns a sender which completes
+    /// on an execution resource of the scheduler, no earlier than the given
+    /// duration from now. If the scheduler does not customize schedule_after
+    /// it is equivalent to scheduling at the corresponding point in time with
+    /// schedule_at.
+    inline constexpr struct schedule_after_t final
+      : pika::functional::detail::tag_fallback<schedule_after_t>
+    {
+    private:
+        template <typename Scheduler,
+            PIKA_CONCEPT_REQUIRES_(std::is_invocable_v<schedule_at_t, Scheduler,
+                pika::chrono::steady_time_point const&>)>
+        friend constexpr PIKA_FORCEINLINE auto tag_fallback_invoke(schedule_after_t,
+            Scheduler&& scheduler, pika::chrono::steady_duration const& rel_time)
+        {
+            return schedule_at(PIKA_FORWARD(Scheduler, scheduler), rel_time.from_now());
+        }
+    } schedule_after{};
+
+    template <typename Scheduler>
+    inline constexpr bool is_timed_scheduler_v = std::is_invocable_v<schedule_at_t, Scheduler,
+        pika::chrono::steady_time_point const&>;
+}    // namespace pika::execution::experimental
@@ -0,0 +1,88 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark measures the overhead of connecting many consumers to the
+// same split sender. For each number of consumers the predecessor is started
+// on a worker thread while the consumers are being started, so that
+// continuations are registered concurrently with completion.
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/modules/timing.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+using pika::chrono::detail::high_resolution_timer;
+
+int pika_main(pika::program_options::variables_map& vm)
+{
+    std::uint64_t const iterations = vm["iterations"].as<std::uint64_t>();
+    std::uint64_t const max_consumers = vm["max-consumers"].as<std::uint64_t>();
+
+    ex::thread_pool_scheduler sched{};
+
+    for (std::uint64_t consumers = 1; consumers <= max_consumers; consumers *= 2)
+    {
+        std::atomic<std::uint64_t> sum{0};
+
+        high_resolution_timer timer;
+        for (std::uint64_t i = 0; i < iterations; ++i)
+        {
+            auto s = ex::schedule(sched) | ex::then([i] { return i; }) | ex::split();
+
+            std::vector<ex::unique_any_sender<>> senders;
+            senders.reserve(consumers);
+            for (std::uint64_t j = 0; j < consumers; ++j)
+            {
+                senders.emplace_back(s | ex::then([&sum](std::uint64_t x) {
+                    sum.fetch_add(x, std::memory_order_relaxed);
+                }));
+            }
+            tt::sync_wait(ex::when_all_vector(std::move(senders)));
+        }
+        double const elapsed = timer.elapsed();
+
+        if (sum != consumers * iterations * (iterations - 1) / 2)
+        {
+            std::cerr << "unexpected sum " << sum << "\n";
+        }
+
+        std::cout << "consumers " << consumers << ", iterations " << iterations << ", in "
+                  << elapsed << " s : " << (1e6 * elapsed / (iterations * consumers))
+                  << " us/consumer\n";
+    }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    pika::program_options::options_description cmdline(
+        "usage: " PIKA_APPLICATION_STRING " [options]");
+
+    // clang-format off
+    cmdline.add_options()
+        ("iterations", pika::program_options::value<std::uint64_t>()->default_value(1000),
+         "number of split senders per number of consumers")
+        ("max-consumers", pika::program_options::value<std::uint64_t>()->default_value(1024),
+         "the largest number of consumers connected to a split sender");
+    // clang-format on
+
+    pika::init_params init_args;
+    init_args.desc_cmdline = cmdline;
+
+    return pika::init(pika_main, argc, argv, init_args);
+}
@@ -0,0 +1,115 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/modules/execution.hpp>
+#include <pika/testing.hpp>
+
+#include <pika/execution_base/tests/algorithm_test_utils.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+
+int main()
+{
+    // transform_reduce success path
+    {
+        std::atomic<bool> set_value_called{false};
+        auto s = ex::transform_reduce(ex::just(), 10, 5, std::plus<>{}, [](int i) { return i; });
+        auto f = [](int x) { PIKA_TEST_EQ(x, 50); };
+        auto r = callback_receiver<decltype(f)>{f, set_value_called};
+        auto os = ex::connect(std::move(s), std::move(r));
+        ex::start(os);
+        PIKA_TEST(set_value_called);
+    }
+
+    {
+        std::atomic<bool> set_value_called{false};
+        auto s = ex::just(std::vector<int>{1, 2, 3}) |
+            ex::transform_reduce(3, std::string("x"), std::plus<>{},
+                [](std::size_t i, std::vector<int>& v) { return std::to_string(v[i]); });
+        auto f = [](std::string x) { PIKA_TEST_EQ(x, std::string("x123")); };
+        auto r = callback_receiver<decltype(f)>{f, set_value_called};
+        auto os = ex::connect(std::move(s), std::move(r));
+        ex::start(os);
+        PIKA_TEST(set_value_called);
+    }
+
+    // An empty shape sends init
+    {
+        std::atomic<bool> set_value_called{false};
+        auto s = ex::transform_reduce(ex::just(), 0, 42, std::plus<>{}, [](int i) { return i; });
+        auto f = [](int x) { PIKA_TEST_EQ(x, 42); };
+        auto r = callback_receiver<decltype(f)>{f, set_value_called};
+        auto os = ex::connect(std::move(s), std::move(r));
+        ex::start(os);
+        PIKA_TEST(set_value_called);
+    }
+
+    // reduce success path
+    {
+        std::atomic<bool> set_value_called{false};
+        auto s = ex::reduce(ex::just(3), 10, 0, std::plus<>{},
+            [](int& acc, int i, int factor) { acc += factor * i; });
+        auto f = [](int x) { PIKA_TEST_EQ(x, 135); };
+        auto r = callback_receiver<decltype(f)>{f, set_value_called};
+        auto os = ex::connect(std::move(s), std::move(r));
+        ex::start(os);
+        PIKA_TEST(set_value_called);
+    }
+
+    {
+        std::atomic<bool> set_value_called{false};
+        auto s = ex::just() |
+            ex::reduce(10, std::vector<int>(2, 0),
+                [](std::vector<int> a, std::vector<int> const& b) {
+                    for (std::size_t i = 0; i < a.size(); ++i) { a[i] += b[i]; }
+                    return a;
+                },
+                [](std::vector<int>& histogram, int i) { ++histogram[i % 2]; });
+        auto f = [](std::vector<int> x) {
+            PIKA_TEST_EQ(x[0], 5);
+            PIKA_TEST_EQ(x[1], 5);
+        };
+        auto r = callback_receiver<decltype(f)>{f, set_value_called};
+        auto os = ex::connect(std::move(s), std::move(r));
+        ex::start(os);
+        PIKA_TEST(set_value_called);
+    }
+
+    // Failure path
+    {
+        std::atomic<bool> set_error_called{false};
+        auto s = ex::transform_reduce(ex::just(), 10, 0, std::plus<>{}, [](int i) {
+            if (i == 3) { throw std::runtime_error("error"); }
+            return i;
+        });
+        auto r = error_callback_receiver<decltype(check_exception_ptr)>{
+            check_exception_ptr, set_error_called};
+        auto os = ex::connect(std::move(s), std::move(r));
+        ex::start(os);
+        PIKA_TEST(set_error_called);
+    }
+
+    {
+        std::atomic<bool> set_error_called{false};
+        auto s = ex::reduce(error_sender{}, 10, 0, std::plus<>{}, [](int&, int) {});
+        auto r = error_callback_receiver<decltype(check_exception_ptr)>{
+            check_exception_ptr, set_error_called};
+        auto os = ex::connect(std::move(s), std::move(r));
+        ex::start(os);
+        PIKA_TEST(set_error_called);
+    }
+
+    return pika::detail::report_errors();
+}
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <pika/allocator_support/thread_local_caching_allocator.hpp>
 #include <pika/assert.hpp>
 #include <pika/errors/error.hpp>
 #include <pika/errors/throw_exception.hpp>
@@ -14,6 +15,7 @@
 #include <pika/execution_base/sender.hpp>
 #include <pika/type_support/pack.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 #include <exception>
@@ -35,10 +37,22 @@
 # pragma GCC diagnostic ignored "-Warray-bounds"
 #endif
 
-// SBO is currently disabled as it seems to be buggy in certain use cases. It can still be
-// explicitly forced to on by defining PIKA_DETAIL_ENABLE_ANY_SENDER_SBO.
-
 namespace pika::detail {
+    // SBO is currently disabled by default as it seems to be buggy in certain use cases. It can
+    // still be explicitly forced to on by defining PIKA_DETAIL_ENABLE_ANY_SENDER_SBO. While it is
+    // disabled the default storage types have no embedded storage and all type-erased objects use
+    // the pooled heap storage. basic_any_sender and basic_unique_any_sender with a non-zero
+    // embedded storage size use SBO regardless.
+    constexpr std::size_t get_default_sbo_size(std::size_t size) noexcept
+    {
+#if defined(PIKA_DETAIL_ENABLE_ANY_SENDER_SBO)
+        return size;
+#else
+        (void) size;
+        return 0;
+#endif
+    }
+
     template <typename T>
     struct empty_vtable_type
     {
@@ -83,34 +97,118 @@ namespace pika::detail {
         return &empty;
     }
 #endif
+    // Objects which don't fit in the embedded storage of the storage types
+    // below are allocated in blocks of a few size classes. The blocks of
+    // each size class are cached per thread, so that objects of different
+    // types but similar sizes reuse the same memory. Objects larger than the
+    // largest size class, or with extended alignment, are allocated
+    // directly with the allocator.
+    inline constexpr std::size_t sbo_heap_min_size_class = 64;
+    inline constexpr std::size_t sbo_heap_max_size_class = 2048;
+
+    constexpr std::size_t get_sbo_heap_size_class(std::size_t size) noexcept
+    {
+        std::size_t size_class = sbo_heap_min_size_class;
+        while (size_class < size) { size_class *= 2; }
+        return size_class;
+    }
+
+    template <std::size_t Size, std::size_t Alignment>
+    struct alignas(Alignment) sbo_heap_block
+    {
+        unsigned char data[Size];
+    };
+
+    // Allocates and deallocates the memory of a heap-allocated object. It is
+    // stored alongside the object so that the memory can be deallocated, and
+    // the object copied, without knowing the type of the object.
+    struct sbo_heap_vtable
+    {
+        void* (*allocate)();
+        void (*deallocate)(void*) noexcept;
+    };
+
+    template <typename Block, typename Allocator>
+    void* allocate_sbo_heap_block()
+    {
+        using allocator_type =
+            typename std::allocator_traits<Allocator>::template rebind_alloc<Block>;
+        allocator_type alloc{};
+        return std::allocator_traits<allocator_type>::allocate(alloc, 1);
+    }
+
+    template <typename Block, typename Allocator>
+    void deallocate_sbo_heap_block(void* p) noexcept
+    {
+        using allocator_type =
+            typename std::allocator_traits<Allocator>::template rebind_alloc<Block>;
+        allocator_type alloc{};
+        std::allocator_traits<allocator_type>::deallocate(alloc, static_cast<Block*>(p), 1);
+    }
+
+    template <typename Impl, typename Allocator>
+    sbo_heap_vtable const* get_sbo_heap_vtable() noexcept
+    {
+        if constexpr (sizeof(Impl) <= sbo_heap_max_size_class &&
+            alignof(Impl) <= alignof(std::max_align_t))
+        {
+            using block_type =
+                sbo_heap_block<get_sbo_heap_size_class(sizeof(Impl)), alignof(std::max_align_t)>;
+            using allocator_type = thread_local_caching_allocator<
+                typename std::allocator_traits<Allocator>::template rebind_alloc<block_type>>;
+            static constexpr sbo_heap_vtable vtable{
+                &allocate_sbo_heap_block<block_type, allocator_type>,
+                &deallocate_sbo_heap_block<block_type, allocator_type>};
+            return &vtable;
+        }
+        else
+        {
+            using block_type = sbo_heap_block<sizeof(Impl), alignof(Impl)>;
+            static constexpr sbo_heap_vtable vtable{&allocate_sbo_heap_block<block_type, Allocator>,
+                &deallocate_sbo_heap_block<block_type, Allocator>};
+            return &vtable;
+        }
+    }
+
     template <typename Base, std::size_t EmbeddedStorageSize,
-        std::size_t AlignmentSize = sizeof(void*)>
+        std::size_t AlignmentSize = sizeof(void*),
+        typename Allocator = std::allocator<unsigned char>>
     class copyable_sbo_storage;
 
+    // Allocator is used for objects which don't fit in the embedded storage.
+    // Since the cached blocks are shared between all instances of the
+    // allocator, only stateless allocators are supported.
     template <typename Base, std::size_t EmbeddedStorageSize,
-        std::size_t AlignmentSize = sizeof(void*)>
+        std::size_t AlignmentSize = sizeof(void*),
+        typename Allocator = std::allocator<unsigned char>>
     class movable_sbo_storage
     {
     protected:
         using base_type = Base;
+        using allocator_type = Allocator;
         static constexpr std::size_t embedded_storage_size = EmbeddedStorageSize;
         static constexpr std::size_t alignment_size = AlignmentSize;
 
+        struct heap_storage_type
+        {
+            void* memory;
+            sbo_heap_vtable const* vtable;
+        };
+
         // The union has two members:
         // - embedded_storage: Embedded storage size array used for types that
         //   are at most embedded_storage_size bytes large, and require at most
-        //   alignment_size alignment.
-        // - heap_storage: A pointer to base_type that is used when objects
-        //   don't fit in the embedded storage.
-#if defined(PIKA_DETAIL_ENABLE_ANY_SENDER_SBO)
+        //   alignment_size alignment. With an embedded_storage_size of zero
+        //   the embedded storage is never used.
+        // - heap_storage: The memory and the vtable used to allocate and
+        //   deallocate it when objects don't fit in the embedded storage.
         union
         {
-            std::aligned_storage_t<embedded_storage_size, alignment_size> embedded_storage;
-#endif
-            base_type* heap_storage = nullptr;
-#if defined(PIKA_DETAIL_ENABLE_ANY_SENDER_SBO)
+            std::aligned_storage_t<(std::max)(embedded_storage_size, sizeof(heap_storage_type)),
+                alignment_size>
+                embedded_storage;
+            heap_storage_type heap_storage = {nullptr, nullptr};
         };
-#endif
         base_type* object = const_cast<base_type*>(get_empty_vtable<base_type>());
 
         // Returns true when it's safe to use the embedded storage, i.e.
@@ -118,22 +216,14 @@ namespace pika::detail {
         template <typename Impl>
         static constexpr bool can_use_embedded_storage()
         {
-#if defined(PIKA_DETAIL_ENABLE_ANY_SENDER_SBO)
             constexpr bool fits_storage = sizeof(std::decay_t<Impl>) <= embedded_storage_size;
             constexpr bool sufficiently_aligned = alignof(std::decay_t<Impl>) <= alignment_size;
             return fits_storage && sufficiently_aligned;
-#else
-            return false;
-#endif
         }
 
         bool using_embedded_storage() const noexcept
         {
-#if defined(PIKA_DETAIL_ENABLE_ANY_SENDER_SBO)
             return object == reinterpret_cast<base_type const*>(&embedded_storage);
-#else
-            return false;
-#endif
         }
 
         void reset_vtable() { object = const_cast<base_type*>(get_empty_vtable<base_type>()); }
@@ -142,13 +232,11 @@ namespace pika::detail {
         {
             PIKA_ASSERT(!empty());
 
-#if defined(PIKA_DETAIL_ENABLE_ANY_SENDER_SBO)
-            if (using_embedded_storage()) { get().~base_type(); }
-            else
-#endif
+            get().~base_type();
+            if (!using_embedded_storage())
             {
-                delete heap_storage;
-                heap_storage = nullptr;
+                heap_storage.vtable->deallocate(heap_storage.memory);
+                heap_storage = {nullptr, nullptr};
             }
 
             reset_vtable();
@@ -162,27 +250,27 @@ namespace pika::detail {
 
             if (!other.empty())
             {
-#if defined(PIKA_DETAIL_ENABLE_ANY_SENDER_SBO)
                 if (other.using_embedded_storage())
                 {
                     auto p = reinterpret_cast<base_type*>(&embedded_storage);
                     other.get().move_into(p);
                     object = p;
+                    // The moved-from object still has to be destroyed
+                    other.release();
                 }
                 else
-#endif
                 {
                     heap_storage = other.heap_storage;
-                    other.heap_storage = nullptr;
-                    object = heap_storage;
+                    object = other.object;
+                    other.heap_storage = {nullptr, nullptr};
+                    other.reset_vtable();
                 }
-
-                other.reset_vtable();
             }
         }
 
         template <typename T>
-        void move_assign(copyable_sbo_storage<T, embedded_storage_size, alignment_size>&& other)
+        void move_assign(
+            copyable_sbo_storage<T, embedded_storage_size, alignment_size, allocator_type>&& other)
         {
             static_assert(std::is_base_of_v<base_type, T>);
 
@@ -191,22 +279,21 @@ namespace pika::detail {
 
             if (!other.empty())
             {
-#if defined(PIKA_DETAIL_ENABLE_ANY_SENDER_SBO)
                 if (other.using_embedded_storage())
                 {
                     auto p = reinterpret_cast<base_type*>(&embedded_storage);
                     other.get().move_into(p);
                     object = p;
+                    // The moved-from object still has to be destroyed
+                    other.release();
                 }
                 else
-#endif
                 {
-                    heap_storage = other.heap_storage;
-                    other.heap_storage = nullptr;
-                    object = heap_storage;
+                    heap_storage = {other.heap_storage.memory, other.heap_storage.vtable};
+                    object = other.object;
+                    other.heap_storage = {nullptr, nullptr};
+                    other.reset_vtable();
                 }
-
-                other.reset_vtable();
             }
         }
 
@@ -222,7 +309,7 @@ namespace pika::detail {
 
         template <typename T>
         explicit movable_sbo_storage(
-            copyable_sbo_storage<T, embedded_storage_size, alignment_size>&& other)
+            copyable_sbo_storage<T, embedded_storage_size, alignment_size, allocator_type>&& other)
         {
             static_assert(std::is_base_of_v<base_type, T>);
 
@@ -241,8 +328,8 @@ namespace pika::detail {
         }
 
         template <typename T>
-        movable_sbo_storage&
-        operator=(copyable_sbo_storage<T, embedded_storage_size, alignment_size>&& other)
+        movable_sbo_storage& operator=(
+            copyable_sbo_storage<T, embedded_storage_size, alignment_size, allocator_type>&& other)
         {
             static_assert(std::is_base_of_v<base_type, T>);
 
@@ -269,7 +356,6 @@ namespace pika::detail {
         {
             if (!empty()) { release(); }
 
-#if defined(PIKA_DETAIL_ENABLE_ANY_SENDER_SBO)
             if constexpr (can_use_embedded_storage<Impl>())
             {
                 Impl* p = reinterpret_cast<Impl*>(&embedded_storage);
@@ -277,10 +363,19 @@ namespace pika::detail {
                 object = p;
             }
             else
-#endif
             {
-                heap_storage = new Impl(PIKA_FORWARD(Ts, ts)...);
-                object = heap_storage;
+                sbo_heap_vtable const* vtable = get_sbo_heap_vtable<Impl, allocator_type>();
+                void* memory = vtable->allocate();
+                try
+                {
+                    object = new (memory) Impl(PIKA_FORWARD(Ts, ts)...);
+                }
+                catch (...)
+                {
+                    vtable->deallocate(memory);
+                    throw;
+                }
+                heap_storage = {memory, vtable};
             }
         }
 
@@ -290,20 +385,21 @@ namespace pika::detail {
         }
     };
 
-    template <typename Base, std::size_t EmbeddedStorageSize, std::size_t AlignmentSize>
+    template <typename Base, std::size_t EmbeddedStorageSize, std::size_t AlignmentSize,
+        typename Allocator>
     class copyable_sbo_storage
-      : public movable_sbo_storage<Base, EmbeddedStorageSize, AlignmentSize>
+      : public movable_sbo_storage<Base, EmbeddedStorageSize, AlignmentSize, Allocator>
     {
-        template <typename Base2, std::size_t EmbeddedStorageSize2, std::size_t AlignmentSize2>
+        template <typename Base2, std::size_t EmbeddedStorageSize2, std::size_t AlignmentSize2,
+            typename Allocator2>
         friend class movable_sbo_storage;
 
-        using storage_base_type = movable_sbo_storage<Base, EmbeddedStorageSize, AlignmentSize>;
+        using storage_base_type =
+            movable_sbo_storage<Base, EmbeddedStorageSize, AlignmentSize, Allocator>;
 
         using typename storage_base_type::base_type;
 
-#if defined(PIKA_DETAIL_ENABLE_ANY_SENDER_SBO)
         using storage_base_type::embedded_storage;
-#endif
         using storage_base_type::heap_storage;
         using storage_base_type::object;
         using storage_base_type::release;
@@ -316,7 +412,6 @@ namespace pika::detail {
 
             if (!other.empty())
             {
-#if defined(PIKA_DETAIL_ENABLE_ANY_SENDER_SBO)
                 if (other.using_embedded_storage())
                 {
                     base_type* p = reinterpret_cast<base_type*>(&embedded_storage);
@@ -324,10 +419,22 @@ namespace pika::detail {
                     object = p;
                 }
                 else
-#endif
                 {
-                    heap_storage = other.get().clone();
-                    object = heap_storage;
+                    // The copy is allocated in the same size class as the
+                    // original
+                    sbo_heap_vtable const* vtable = other.heap_storage.vtable;
+                    void* memory = vtable->allocate();
+                    try
+                    {
+                        other.get().clone_into(memory);
+                    }
+                    catch (...)
+                    {
+                        vtable->deallocate(memory);
+                        throw;
+                    }
+                    heap_storage = {memory, vtable};
+                    object = reinterpret_cast<base_type*>(memory);
                 }
             }
         }
@@ -406,7 +513,8 @@ namespace pika::execution::experimental::detail {
         using base_type = detail::any_operation_state_base;
         template <typename Sender, typename Receiver>
         using impl_type = detail::any_operation_state_impl<Sender, Receiver>;
-        using storage_type = pika::detail::movable_sbo_storage<base_type, 8 * sizeof(void*)>;
+        using storage_type = pika::detail::movable_sbo_storage<base_type,
+            pika::detail::get_default_sbo_size(8 * sizeof(void*))>;
 
         storage_type storage{};
 
@@ -511,7 +619,8 @@ namespace pika::execution::experimental::detail {
         using base_type = detail::any_receiver_base<Ts...>;
         template <typename Receiver>
         using impl_type = detail::any_receiver_impl<Receiver, Ts...>;
-        using storage_type = pika::detail::movable_sbo_storage<base_type, 4 * sizeof(void*)>;
+        using storage_type = pika::detail::movable_sbo_storage<base_type,
+            pika::detail::get_default_sbo_size(4 * sizeof(void*))>;
 
         storage_type storage{};
 
@@ -598,7 +707,6 @@ namespace pika::execution::experimental::detail {
     template <typename... Ts>
     struct any_sender_base : public unique_any_sender_base<Ts...>
     {
-        virtual any_sender_base* clone() const = 0;
         virtual void clone_into(void* p) const = 0;
         using unique_any_sender_base<Ts...>::connect;
         virtual any_operation_state connect(any_receiver<Ts...>&& receiver) const& = 0;
@@ -622,8 +730,6 @@ namespace pika::execution::experimental::detail {
     {
         void move_into(void*) override { PIKA_UNREACHABLE; }
 
-        any_sender_base<Ts...>* clone() const override { PIKA_UNREACHABLE; }
-
         void clone_into(void*) const override { PIKA_UNREACHABLE; }
 
         bool empty() const noexcept override { return true; }
@@ -678,8 +784,6 @@ namespace pika::execution::experimental::detail {
 
         void move_into(void* p) override { new (p) any_sender_impl(PIKA_MOVE(sender)); }
 
-        any_sender_base<Ts...>* clone() const override { return new any_sender_impl(sender); }
-
         void clone_into(void* p) const override { new (p) any_sender_impl(sender); }
 
         any_operation_state connect(any_receiver<Ts...>&& receiver) const& override
@@ -720,11 +824,29 @@ namespace pika::execution::experimental {
     }    // namespace detail
 #endif
 
-    template <typename... Ts>
-    class any_sender;
-
-    template <typename... Ts>
-    class unique_any_sender
+    /// The size of the embedded storage of any_sender and unique_any_sender.
+    /// Senders which don't fit in the embedded storage are allocated from
+    /// per-thread pools of a few size classes on the heap. The size is zero,
+    /// i.e. all senders are allocated on the heap, unless
+    /// PIKA_DETAIL_ENABLE_ANY_SENDER_SBO is defined.
+    inline constexpr std::size_t any_sender_default_embedded_storage_size =
+        pika::detail::get_default_sbo_size(4 * sizeof(void*));
+
+    template <std::size_t EmbeddedStorageSize, typename... Ts>
+    class basic_any_sender;
+
+    /// A type-erased sender which sends values of types Ts, with
+    /// EmbeddedStorageSize bytes of embedded storage for the erased sender.
+    /// A larger embedded storage avoids heap allocations for larger senders
+    /// at the cost of a larger basic_unique_any_sender. A sender in the
+    /// embedded storage is moved when the basic_unique_any_sender is moved.
+    ///
+    /// Senders on the heap are always allocated with std::allocator through
+    /// the per-thread pools. The allocator of the underlying storage is not
+    /// exposed since it would have to follow the parameter pack Ts, and since
+    /// only stateless allocators can share the pools.
+    template <std::size_t EmbeddedStorageSize, typename... Ts>
+    class basic_unique_any_sender
 #if !defined(PIKA_HAVE_CXX20_TRIVIAL_VIRTUAL_DESTRUCTOR)
       : private detail::any_sender_static_empty_vtable_helper<Ts...>
 #endif
@@ -734,43 +856,51 @@ namespace pika::execution::experimental {
         using base_type = detail::unique_any_sender_base<Ts...>;
         template <typename Sender>
         using impl_type = detail::unique_any_sender_impl<Sender, Ts...>;
-        using storage_type = pika::detail::movable_sbo_storage<base_type, 4 * sizeof(void*)>;
+        using storage_type = pika::detail::movable_sbo_storage<base_type, EmbeddedStorageSize>;
 
         storage_type storage{};
 
+        // Senders derived from basic_unique_any_sender are moved, and r-values
+        // of senders derived from basic_any_sender have their storage moved,
+        // instead of being wrapped in another type-erased sender
+        template <typename Sender>
+        static constexpr bool is_wrapped_sender_v =
+            !std::is_base_of_v<basic_unique_any_sender, std::decay_t<Sender>> &&
+            !(std::is_base_of_v<basic_any_sender<EmbeddedStorageSize, Ts...>,
+                  std::decay_t<Sender>> &&
+                !std::is_lvalue_reference_v<Sender>);
+
     public:
         using is_sender = void;
-        unique_any_sender() = default;
+        basic_unique_any_sender() = default;
 
-        template <typename Sender,
-            typename = std::enable_if_t<!std::is_same_v<std::decay_t<Sender>, unique_any_sender>>>
-        unique_any_sender(Sender&& sender)
+        template <typename Sender, typename = std::enable_if_t<is_wrapped_sender_v<Sender>>>
+        basic_unique_any_sender(Sender&& sender)
         {
             storage.template store<impl_type<Sender>>(PIKA_FORWARD(Sender, sender));
         }
 
-        template <typename Sender,
-            typename = std::enable_if_t<!std::is_same_v<std::decay_t<Sender>, unique_any_sender>>>
-        unique_any_sender& operator=(Sender&& sender)
+        template <typename Sender, typename = std::enable_if_t<is_wrapped_sender_v<Sender>>>
+        basic_unique_any_sender& operator=(Sender&& sender)
         {
             storage.template store<impl_type<Sender>>(PIKA_FORWARD(Sender, sender));
             return *this;
         }
 
-        ~unique_any_sender() noexcept = default;
-        unique_any_sender(unique_any_sender&&) = default;
-        unique_any_sender(unique_any_sender const&) = delete;
-        unique_any_sender& operator=(unique_any_sender&&) = default;
-        unique_any_sender& operator=(unique_any_sender const&) = delete;
+        ~basic_unique_any_sender() noexcept = default;
+        basic_unique_any_sender(basic_unique_any_sender&&) = default;
+        basic_unique_any_sender(basic_unique_any_sender const&) = delete;
+        basic_unique_any_sender& operator=(basic_unique_any_sender&&) = default;
+        basic_unique_any_sender& operator=(basic_unique_any_sender const&) = delete;
 
         // cppcheck-suppress noExplicitConstructor
-        unique_any_sender(any_sender<Ts...>&& other)
+        basic_unique_any_sender(basic_any_sender<EmbeddedStorageSize, Ts...>&& other)
           : storage(PIKA_MOVE(other.storage))
         {
             other.reset();
         }
 
-        unique_any_sender& operator=(any_sender<Ts...>&& other)
+        basic_unique_any_sender& operator=(basic_any_sender<EmbeddedStorageSize, Ts...>&& other)
         {
             storage = PIKA_MOVE(other.storage);
             other.reset();
@@ -792,7 +922,7 @@ namespace pika::execution::experimental {
 
         template <typename R>
         friend detail::any_operation_state
-        tag_invoke(pika::execution::experimental::connect_t, unique_any_sender&& s, R&& r)
+        tag_invoke(pika::execution::experimental::connect_t, basic_unique_any_sender&& s, R&& r)
         {
             // We first move the storage to a temporary variable so that this
             // any_sender is empty after this connect. Doing
@@ -805,7 +935,7 @@ namespace pika::execution::experimental {
 
         template <typename R>
         friend detail::any_operation_state
-        tag_invoke(pika::execution::experimental::connect_t, unique_any_sender const&, R&&)
+        tag_invoke(pika::execution::experimental::connect_t, basic_unique_any_sender const&, R&&)
         {
             static_assert(sizeof(R) == 0,
                 "Are you missing a std::move? unique_any_sender is not copyable and thus not "
@@ -817,7 +947,7 @@ namespace pika::execution::experimental {
         template <typename Sender>
         void reset(Sender&& sender)
         {
-            if constexpr (std::is_same_v<std::decay_t<Sender>, unique_any_sender>)
+            if constexpr (std::is_base_of_v<basic_unique_any_sender, std::decay_t<Sender>>)
             {
                 *this = std::forward<Sender>(sender);
             }
@@ -831,8 +961,10 @@ namespace pika::execution::experimental {
         explicit operator bool() const noexcept { return !empty(); }
     };
 
-    template <typename... Ts>
-    class any_sender
+    /// A copyable type-erased sender which sends values of types Ts, with
+    /// EmbeddedStorageSize bytes of embedded storage for the erased sender.
+    template <std::size_t EmbeddedStorageSize, typename... Ts>
+    class basic_any_sender
 #if !defined(PIKA_HAVE_CXX20_TRIVIAL_VIRTUAL_DESTRUCTOR)
       : private detail::any_sender_static_empty_vtable_helper<Ts...>
 #endif
@@ -842,19 +974,20 @@ namespace pika::execution::experimental {
         using base_type = detail::any_sender_base<Ts...>;
         template <typename Sender>
         using impl_type = detail::any_sender_impl<Sender, Ts...>;
-        using storage_type = pika::detail::copyable_sbo_storage<base_type, 4 * sizeof(void*)>;
+        using storage_type = pika::detail::copyable_sbo_storage<base_type, EmbeddedStorageSize>;
 
         storage_type storage{};
 
-        friend unique_any_sender<Ts...>;
+        friend basic_unique_any_sender<EmbeddedStorageSize, Ts...>;
 
     public:
         using is_sender = void;
-        any_sender() = default;
+        basic_any_sender() = default;
 
         template <typename Sender,
-            typename = std::enable_if_t<!std::is_same_v<std::decay_t<Sender>, any_sender>>>
-        any_sender(Sender&& sender)
+            typename =
+                std::enable_if_t<!std::is_base_of_v<basic_any_sender, std::decay_t<Sender>>>>
+        basic_any_sender(Sender&& sender)
         {
             static_assert(std::is_copy_constructible_v<std::decay_t<Sender>>,
                 "any_sender requires the given sender to be copy constructible. Ensure the used "
@@ -864,8 +997,9 @@ namespace pika::execution::experimental {
         }
 
         template <typename Sender,
-            typename = std::enable_if_t<!std::is_same_v<std::decay_t<Sender>, any_sender>>>
-        any_sender& operator=(Sender&& sender)
+            typename =
+                std::enable_if_t<!std::is_base_of_v<basic_any_sender, std::decay_t<Sender>>>>
+        basic_any_sender& operator=(Sender&& sender)
         {
             static_assert(std::is_copy_constructible_v<std::decay_t<Sender>>,
                 "any_sender requires the given sender to be copy constructible. Ensure the used "
@@ -875,11 +1009,11 @@ namespace pika::execution::experimental {
             return *this;
         }
 
-        ~any_sender() noexcept = default;
-        any_sender(any_sender&&) = default;
-        any_sender(any_sender const&) = default;
-        any_sender& operator=(any_sender&&) = default;
-        any_sender& operator=(any_sender const&) = default;
+        ~basic_any_sender() noexcept = default;
+        basic_any_sender(basic_any_sender&&) = default;
+        basic_any_sender(basic_any_sender const&) = default;
+        basic_any_sender& operator=(basic_any_sender&&) = default;
+        basic_any_sender& operator=(basic_any_sender const&) = default;
 
         template <template <typename...> class Tuple, template <typename...> class Variant>
         using value_types = Variant<Tuple<Ts...>>;
@@ -896,14 +1030,14 @@ namespace pika::execution::experimental {
 
         template <typename R>
         friend detail::any_operation_state
-        tag_invoke(pika::execution::experimental::connect_t, any_sender const& s, R&& r)
+        tag_invoke(pika::execution::experimental::connect_t, basic_any_sender const& s, R&& r)
         {
             return s.storage.get().connect(detail::any_receiver<Ts...>{PIKA_FORWARD(R, r)});
         }
 
         template <typename R>
         friend detail::any_operation_state
-        tag_invoke(pika::execution::experimental::connect_t, any_sender&& s, R&& r)
+        tag_invoke(pika::execution::experimental::connect_t, basic_any_sender&& s, R&& r)
         {
             // We first move the storage to a temporary variable so that this
             // any_sender is empty after this connect. Doing
@@ -917,7 +1051,7 @@ namespace pika::execution::experimental {
         template <typename Sender>
         void reset(Sender&& sender)
         {
-            if constexpr (std::is_same_v<std::decay_t<Sender>, any_sender>)
+            if constexpr (std::is_base_of_v<basic_any_sender, std::decay_t<Sender>>)
             {
                 *this = std::forward<Sender>(sender);
             }
@@ -938,6 +1072,49 @@ namespace pika::execution::experimental {
         explicit operator bool() const noexcept { return !empty(); }
     };
 
+    /// A basic_unique_any_sender with the default embedded storage size.
+    template <typename... Ts>
+    class unique_any_sender
+      : public basic_unique_any_sender<any_sender_default_embedded_storage_size, Ts...>
+    {
+        using base_type = basic_unique_any_sender<any_sender_default_embedded_storage_size, Ts...>;
+
+    public:
+        unique_any_sender() = default;
+
+        // The constructor is not inherited so that Ts can be deduced with
+        // class template argument deduction
+        template <typename Sender,
+            typename = std::enable_if_t<!std::is_base_of_v<base_type, std::decay_t<Sender>>>>
+        unique_any_sender(Sender&& sender)
+          : base_type(PIKA_FORWARD(Sender, sender))
+        {
+        }
+
+        using base_type::operator=;
+    };
+
+    /// A basic_any_sender with the default embedded storage size.
+    template <typename... Ts>
+    class any_sender : public basic_any_sender<any_sender_default_embedded_storage_size, Ts...>
+    {
+        using base_type = basic_any_sender<any_sender_default_embedded_storage_size, Ts...>;
+
+    public:
+        any_sender() = default;
+
+        // The constructor is not inherited so that Ts can be deduced with
+        // class template argument deduction
+        template <typename Sender,
+            typename = std::enable_if_t<!std::is_base_of_v<base_type, std::decay_t<Sender>>>>
+        any_sender(Sender&& sender)
+          : base_type(PIKA_FORWARD(Sender, sender))
+        {
+        }
+
+        using base_type::operator=;
+    };
+
     namespace detail {
         template <template <typename...> class AnySender, typename Sender>
         auto make_any_sender_impl(Sender&& sender)
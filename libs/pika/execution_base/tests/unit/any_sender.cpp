@@ -13,7 +13,9 @@
 
 #include <pika/execution_base/tests/algorithm_test_utils.hpp>
 
+#include <array>
 #include <atomic>
+#include <cstddef>
 #include <exception>
 #include <stdexcept>
 #include <string>
@@ -793,6 +795,136 @@ void test_any_sender_to_unique_any_sender(F&& f, Ts&&... ts)
     check_exception(std::move(as6));
 }
 
+// Returns senders of different sizes, which are stored in different size
+// classes or allocated directly on the heap
+template <std::size_t PaddingSize>
+auto padded_just(int x)
+{
+    return ex::just(x) | ex::then([padding = std::array<unsigned char, PaddingSize + 1>{}](int x) {
+        return x + padding[0];
+    });
+}
+
+struct alignas(32) overaligned_int
+{
+    int x;
+};
+
+template <std::size_t EmbeddedStorageSize, typename Sender>
+void test_storage(Sender&& s)
+{
+    // Repeatedly allocate and deallocate the same sizes to reuse cached
+    // memory
+    for (int i = 0; i < 3; ++i)
+    {
+        ex::basic_any_sender<EmbeddedStorageSize, int> as1{s};
+        auto as2 = as1;
+        ex::basic_unique_any_sender<EmbeddedStorageSize, int> as3{std::move(as1)};
+        ex::basic_unique_any_sender<EmbeddedStorageSize, int> as4{as2};
+
+        PIKA_TEST(as1.empty());
+        PIKA_TEST_EQ(tt::sync_wait(as2), 42);
+        PIKA_TEST_EQ(tt::sync_wait(std::move(as2)), 42);
+        PIKA_TEST_EQ(tt::sync_wait(std::move(as3)), 42);
+        PIKA_TEST_EQ(tt::sync_wait(std::move(as4)), 42);
+    }
+}
+
+void test_storage()
+{
+    auto overaligned_just =
+        ex::just(overaligned_int{42}) | ex::then([](overaligned_int const& x) { return x.x; });
+
+    test_storage<ex::any_sender_default_embedded_storage_size>(padded_just<0>(42));
+    test_storage<ex::any_sender_default_embedded_storage_size>(padded_just<100>(42));
+    test_storage<ex::any_sender_default_embedded_storage_size>(padded_just<1000>(42));
+    test_storage<ex::any_sender_default_embedded_storage_size>(padded_just<10000>(42));
+    test_storage<ex::any_sender_default_embedded_storage_size>(overaligned_just);
+
+    // A larger embedded storage fits the smaller senders, the larger and the
+    // over-aligned senders are still allocated on the heap
+    test_storage<256>(padded_just<0>(42));
+    test_storage<256>(padded_just<100>(42));
+    test_storage<256>(padded_just<1000>(42));
+    test_storage<256>(overaligned_just);
+}
+
+// Counts the moves and the live objects of a callable. A sender in the
+// embedded storage is moved along with the type-erased sender, while a sender
+// on the heap is not.
+struct move_counting_f
+{
+    std::size_t* moves;
+    std::ptrdiff_t* live;
+
+    move_counting_f(std::size_t* moves, std::ptrdiff_t* live)
+      : moves(moves)
+      , live(live)
+    {
+        ++*live;
+    }
+
+    move_counting_f(move_counting_f&& other)
+      : moves(other.moves)
+      , live(other.live)
+    {
+        ++*moves;
+        ++*live;
+    }
+
+    move_counting_f(move_counting_f const& other)
+      : moves(other.moves)
+      , live(other.live)
+    {
+        ++*live;
+    }
+
+    move_counting_f& operator=(move_counting_f&&) = delete;
+    move_counting_f& operator=(move_counting_f const&) = delete;
+
+    ~move_counting_f() { --*live; }
+
+    int operator()(int x) const { return x; }
+};
+
+template <std::size_t EmbeddedStorageSize>
+void test_embedded_storage(bool expect_embedded)
+{
+    std::size_t moves = 0;
+    std::ptrdiff_t live = 0;
+
+    {
+        ex::basic_any_sender<EmbeddedStorageSize, int> as1{
+            ex::just(42) | ex::then(move_counting_f{&moves, &live})};
+        auto as2 = as1;
+
+        moves = 0;
+        ex::basic_any_sender<EmbeddedStorageSize, int> as3{std::move(as1)};
+        PIKA_TEST_EQ(moves != 0, expect_embedded);
+        PIKA_TEST(as1.empty());
+
+        moves = 0;
+        ex::basic_unique_any_sender<EmbeddedStorageSize, int> as4{std::move(as2)};
+        ex::basic_unique_any_sender<EmbeddedStorageSize, int> as5{std::move(as4)};
+        PIKA_TEST_EQ(moves != 0, expect_embedded);
+        PIKA_TEST(as2.empty());
+        PIKA_TEST(as4.empty());
+
+        PIKA_TEST_EQ(tt::sync_wait(as3), 42);
+        PIKA_TEST_EQ(tt::sync_wait(std::move(as3)), 42);
+        PIKA_TEST_EQ(tt::sync_wait(std::move(as5)), 42);
+    }
+
+    // Moved-from senders in the embedded storage are also destroyed
+    PIKA_TEST_EQ(live, 0);
+}
+
+void test_embedded_storage()
+{
+    test_embedded_storage<0>(false);
+    test_embedded_storage<256>(true);
+}
+
 int main()
 {
     // We can only wrap copyable senders in any_sender
@@ -891,6 +1023,10 @@ int main()
     // Test using {unique_,}any_sender with a just sender of a const reference
     test_const_reference();
 
+    // Embedded storage sizes and heap storage
+    test_storage();
+    test_embedded_storage();
+
     // Test construction of unique_any_sender from any_sender
     test_any_sender_to_unique_any_sender<sender>([] {});
     test_any_sender_to_unique_any_sender<sender, int>([](int x) { PIKA_TEST_EQ(x, 42); }, 42);
@@ -0,0 +1,94 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/execution_base/agent_base.hpp>
+#include <pika/execution_base/context_base.hpp>
+#include <pika/execution_base/this_thread.hpp>
+#include <pika/timing/steady_clock.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+namespace pika::execution::experimental::detail {
+    /// The execution agent of a sender operation which runs as a stackless
+    /// task on the stack of a worker thread. A stackless task can't be
+    /// suspended, so the agent blocks or spins the worker thread like the
+    /// agent of a plain OS thread does. It also records that the operation
+    /// tried to suspend, so that later operations of the same type run as
+    /// stackful threads instead.
+    struct stackless_agent final : pika::execution::detail::agent_base
+    {
+        explicit stackless_agent(std::atomic<bool>& may_suspend) noexcept
+          : may_suspend_(may_suspend)
+          , agent_(pika::execution::detail::get_default_agent())
+        {
+        }
+
+        std::string description() const override { return agent_.description(); }
+
+        pika::execution::detail::context_base const& context() const override
+        {
+            return agent_.context();
+        }
+
+        void yield(char const* desc) override
+        {
+            fall_back();
+            agent_.yield(desc);
+        }
+
+        void yield_k(std::size_t k, char const* desc) override
+        {
+            fall_back();
+            agent_.yield_k(k, desc);
+        }
+
+        void spin_k(std::size_t k, char const* desc) override { agent_.spin_k(k, desc); }
+
+        void suspend(char const* desc) override
+        {
+            fall_back();
+            agent_.suspend(desc);
+        }
+
+        // resume and abort are called from the context which wakes up this
+        // agent, so they are forwarded to the agent of the worker thread
+        // captured on construction
+        void resume(char const* desc) override { agent_.resume(desc); }
+
+        void abort(char const* desc) override { agent_.abort(desc); }
+
+        void sleep_for(
+            pika::chrono::steady_duration const& sleep_duration, char const* desc) override
+        {
+            fall_back();
+            agent_.sleep_for(sleep_duration, desc);
+        }
+
+        void sleep_until(
+            pika::chrono::steady_time_point const& sleep_time, char const* desc) override
+        {
+            fall_back();
+            agent_.sleep_until(sleep_time, desc);
+        }
+
+    private:
+        void fall_back() noexcept
+        {
+            if (!may_suspend_.load(std::memory_order_relaxed))
+            {
+                may_suspend_.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        std::atomic<bool>& may_suspend_;
+        pika::execution::detail::agent_base& agent_;
+    };
+}    // namespace pika::execution::experimental::detail
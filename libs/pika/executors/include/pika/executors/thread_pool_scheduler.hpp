@@ -13,15 +13,27 @@
 #include <pika/errors/try_catch_exception_ptr.hpp>
 #include <pika/execution/algorithms/execute.hpp>
 #include <pika/execution/algorithms/schedule_from.hpp>
+#include <pika/execution/stop_token_queries.hpp>
+#include <pika/execution/timed_scheduler.hpp>
 #include <pika/execution_base/receiver.hpp>
 #include <pika/execution_base/sender.hpp>
+#include <pika/execution_base/this_thread.hpp>
+#include <pika/executors/detail/stackless_agent.hpp>
 #include <pika/threading_base/annotated_function.hpp>
+#include <pika/threading_base/detail/timer_wheel.hpp>
 #include <pika/threading_base/register_thread.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
+#include <pika/threading_base/scheduler_mode.hpp>
 #include <pika/threading_base/scoped_annotation.hpp>
 #include <pika/threading_base/thread_description.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+#include <pika/timing/steady_clock.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <exception>
+#include <optional>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -39,7 +51,9 @@ namespace pika::execution::experimental {
         bool operator==(thread_pool_scheduler const& rhs) const noexcept
         {
             return pool_ == rhs.pool_ && priority_ == rhs.priority_ &&
-                stacksize_ == rhs.stacksize_ && schedulehint_ == rhs.schedulehint_;
+                stacksize_ == rhs.stacksize_ && schedulehint_ == rhs.schedulehint_ &&
+                deadline_ == rhs.deadline_ && chunk_size_ == rhs.chunk_size_ &&
+                numa_affinity_ == rhs.numa_affinity_;
         }
 
         bool operator!=(thread_pool_scheduler const& rhs) const noexcept { return !(*this == rhs); }
@@ -95,6 +109,60 @@ namespace pika::execution::experimental {
             return scheduler.schedulehint_;
         }
 
+        // support with_deadline property, the deadline is only taken into
+        // account by schedulers which order threads by deadline
+        friend thread_pool_scheduler tag_invoke(pika::execution::experimental::with_deadline_t,
+            thread_pool_scheduler const& scheduler,
+            std::chrono::steady_clock::time_point deadline)
+        {
+            auto sched_with_deadline = scheduler;
+            sched_with_deadline.deadline_ = deadline;
+            return sched_with_deadline;
+        }
+
+        friend std::chrono::steady_clock::time_point tag_invoke(
+            pika::execution::experimental::get_deadline_t, thread_pool_scheduler const& scheduler)
+        {
+            return scheduler.deadline_;
+        }
+
+        // support with_chunk_size property, the number of elements bulk
+        // hands to a worker thread at a time. With the default of 0 bulk
+        // chooses the chunk size adaptively from the time it takes to
+        // process the first chunks.
+        friend thread_pool_scheduler tag_invoke(pika::execution::experimental::with_chunk_size_t,
+            thread_pool_scheduler const& scheduler, std::size_t chunk_size)
+        {
+            auto sched_with_chunk_size = scheduler;
+            sched_with_chunk_size.chunk_size_ = chunk_size;
+            return sched_with_chunk_size;
+        }
+
+        friend std::size_t tag_invoke(
+            pika::execution::experimental::get_chunk_size_t, thread_pool_scheduler const& scheduler)
+        {
+            return scheduler.chunk_size_;
+        }
+
+        // support with_numa_affinity property. With NUMA affinity bulk
+        // assigns the same chunks to the same worker threads every time it
+        // is called with the same shape, keeping the chunks of a NUMA
+        // domain together, and worker threads steal chunks from worker
+        // threads in the same NUMA domain first.
+        friend thread_pool_scheduler tag_invoke(pika::execution::experimental::with_numa_affinity_t,
+            thread_pool_scheduler const& scheduler, bool numa_affinity)
+        {
+            auto sched_with_numa_affinity = scheduler;
+            sched_with_numa_affinity.numa_affinity_ = numa_affinity;
+            return sched_with_numa_affinity;
+        }
+
+        friend bool tag_invoke(pika::execution::experimental::get_numa_affinity_t,
+            thread_pool_scheduler const& scheduler)
+        {
+            return scheduler.numa_affinity_;
+        }
+
         // support with_annotation property
         friend constexpr thread_pool_scheduler tag_invoke(
             pika::execution::experimental::with_annotation_t,
@@ -123,14 +191,40 @@ namespace pika::execution::experimental {
 
         template <typename F>
         void execute(F&& f, char const* fallback_annotation) const
+        {
+            execute(PIKA_FORWARD(F, f), fallback_annotation, stacksize_);
+        }
+
+        template <typename F>
+        void execute(F&& f, char const* fallback_annotation,
+            pika::execution::thread_stacksize stacksize) const
         {
             pika::detail::thread_description desc(f, fallback_annotation);
             threads::detail::thread_init_data data(
                 threads::detail::make_thread_function_nullary(PIKA_FORWARD(F, f)), desc, priority_,
-                schedulehint_, stacksize_);
+                schedulehint_, stacksize);
+            data.deadline = deadline_;
             threads::detail::register_work(data, pool_);
         }
 
+        // Returns true if the continuation of schedule() should run as a
+        // stackless task. This is only done if the stack size was not changed
+        // from the default and if operations of the same type have not tried
+        // to suspend before.
+        bool run_stackless(std::atomic<bool> const& may_suspend) const
+        {
+            if (stacksize_ != pika::execution::thread_stacksize::small_ ||
+                may_suspend.load(std::memory_order_relaxed))
+            {
+                return false;
+            }
+
+            auto const* scheduler = pool_->get_scheduler();
+            return scheduler != nullptr &&
+                scheduler->has_scheduler_mode(
+                    pika::threads::scheduler_mode::enable_stackless_senders);
+        }
+
         template <typename F>
         friend void tag_invoke(execute_t, thread_pool_scheduler const& sched, F&& f)
         {
@@ -159,10 +253,26 @@ namespace pika::execution::experimental {
             operation_state& operator=(operation_state&&) = delete;
             operation_state& operator=(operation_state const&) = delete;
 
+            // Set when an operation of this type tried to suspend while
+            // running as a stackless task
+            static inline std::atomic<bool> may_suspend{false};
+
             friend void tag_invoke(start_t, operation_state& os) noexcept
             {
                 pika::detail::try_catch_exception_ptr(
                     [&]() {
+                        if (os.scheduler.run_stackless(may_suspend))
+                        {
+                            os.scheduler.execute(
+                                [receiver = PIKA_MOVE(os.receiver)]() mutable {
+                                    detail::stackless_agent agent(may_suspend);
+                                    pika::execution::this_thread::detail::reset_agent ctx(agent);
+                                    pika::execution::experimental::set_value(PIKA_MOVE(receiver));
+                                },
+                                os.fallback_annotation, pika::execution::thread_stacksize::nostack);
+                            return;
+                        }
+
                         os.scheduler.execute(
                             [receiver = PIKA_MOVE(os.receiver)]() mutable {
                                 pika::execution::experimental::set_value(PIKA_MOVE(receiver));
@@ -247,6 +357,218 @@ namespace pika::execution::experimental {
             return {sched};
         }
 
+        // The operation state of senders returned by schedule_at and
+        // schedule_after. The operation state is registered with the timer
+        // wheel of the scheduler of the thread pool, which is advanced by the
+        // worker threads of the pool. No additional OS threads are involved.
+        // When the timer expires a new task is spawned to complete the
+        // receiver. If stop is requested before that, the timer is cancelled
+        // and the receiver is completed with set_stopped on the thread
+        // requesting stop.
+        template <typename Scheduler, typename Receiver>
+        struct timed_operation_state : pika::threads::detail::timer_wheel_entry
+        {
+            using stop_token_type =
+                pika::execution::experimental::detail::receiver_stop_token_t<Receiver>;
+
+            struct on_stop_requested
+            {
+                timed_operation_state& os;
+
+                void operator()() noexcept { os.stop(); }
+            };
+
+            std::decay_t<Scheduler> scheduler;
+            PIKA_NO_UNIQUE_ADDRESS std::decay_t<Receiver> receiver;
+            pika::chrono::steady_clock::time_point abs_time;
+            pika::chrono::steady_clock::duration rel_time;
+            bool relative;
+            char const* fallback_annotation;
+
+            std::optional<pika::execution::experimental::stop_callback_for_t<stop_token_type,
+                on_stop_requested>>
+                stop_callback;
+            std::exception_ptr error;
+            bool stopped = false;
+
+            // The receiver is completed by whoever finishes last: the call to
+            // start or the expiry (or cancellation) of the timer
+            std::atomic<int> pending{2};
+
+            template <typename Scheduler_, typename Receiver_>
+            timed_operation_state(Scheduler_&& scheduler, Receiver_&& receiver,
+                pika::chrono::steady_clock::time_point abs_time,
+                pika::chrono::steady_clock::duration rel_time, bool relative,
+                char const* fallback_annotation)
+              : pika::threads::detail::timer_wheel_entry(&on_expire)
+              , scheduler(PIKA_FORWARD(Scheduler_, scheduler))
+              , receiver(PIKA_FORWARD(Receiver_, receiver))
+              , abs_time(abs_time)
+              , rel_time(rel_time)
+              , relative(relative)
+              , fallback_annotation(fallback_annotation)
+            {
+                PIKA_ASSERT(fallback_annotation != nullptr);
+            }
+
+            timed_operation_state(timed_operation_state&&) = delete;
+            timed_operation_state(timed_operation_state const&) = delete;
+            timed_operation_state& operator=(timed_operation_state&&) = delete;
+            timed_operation_state& operator=(timed_operation_state const&) = delete;
+
+            pika::threads::detail::scheduler_base& get_scheduler_base()
+            {
+                auto* sched = scheduler.get_thread_pool()->get_scheduler();
+                PIKA_ASSERT(sched != nullptr);
+                return *sched;
+            }
+
+            void finish() noexcept
+            {
+                if (pending.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+                stop_callback.reset();
+                if (stopped)
+                {
+                    pika::execution::experimental::set_stopped(PIKA_MOVE(receiver));
+                }
+                else if (error)
+                {
+                    pika::execution::experimental::set_error(
+                        PIKA_MOVE(receiver), PIKA_MOVE(error));
+                }
+                else { pika::execution::experimental::set_value(PIKA_MOVE(receiver)); }
+            }
+
+            void expire() noexcept
+            {
+                pika::detail::try_catch_exception_ptr(
+                    [&]() {
+                        scheduler.execute([this]() { finish(); }, fallback_annotation);
+                    },
+                    [&](std::exception_ptr ep) {
+                        error = PIKA_MOVE(ep);
+                        finish();
+                    });
+            }
+
+            // Called by the timer wheel, which is advanced by the scheduling
+            // loop. Only spawn a task here instead of running the continuation
+            // inline.
+            static void on_expire(pika::threads::detail::timer_wheel_entry& entry) noexcept
+            {
+                static_cast<timed_operation_state&>(entry).expire();
+            }
+
+            void stop() noexcept
+            {
+                // If the timer has already expired the receiver will be
+                // completed with set_value
+                if (get_scheduler_base().get_timer_wheel().cancel(*this))
+                {
+                    stopped = true;
+                    finish();
+                }
+            }
+
+            friend void tag_invoke(start_t, timed_operation_state& os) noexcept
+            {
+                auto stop_token =
+                    pika::execution::experimental::detail::get_receiver_stop_token(os.receiver);
+                if (stop_token.stop_requested())
+                {
+                    pika::execution::experimental::set_stopped(PIKA_MOVE(os.receiver));
+                    return;
+                }
+
+                auto const deadline = os.relative ?
+                    pika::chrono::steady_duration(os.rel_time).from_now() :
+                    os.abs_time;
+                if (deadline <= pika::chrono::steady_clock::now()) { os.expire(); }
+                else
+                {
+                    auto& sched = os.get_scheduler_base();
+                    if (sched.get_timer_wheel().schedule(os, deadline))
+                    {
+                        sched.do_some_work(std::size_t(-1));
+                    }
+                }
+
+                // The timer is armed before the callback is registered so
+                // that a stop request is never missed
+                os.stop_callback.emplace(PIKA_MOVE(stop_token), on_stop_requested{os});
+                os.finish();
+            }
+        };
+
+        template <typename Scheduler>
+        struct timed_sender
+        {
+            using is_sender = void;
+
+            PIKA_NO_UNIQUE_ADDRESS std::decay_t<Scheduler> scheduler;
+            pika::chrono::steady_clock::time_point abs_time;
+            pika::chrono::steady_clock::duration rel_time;
+            bool relative;
+
+            // See sender for why the annotation is retrieved here
+            char const* fallback_annotation = scheduler.get_fallback_annotation();
+
+            template <template <typename...> class Tuple, template <typename...> class Variant>
+            using value_types = Variant<Tuple<>>;
+
+            template <template <typename...> class Variant>
+            using error_types = Variant<std::exception_ptr>;
+
+            static constexpr bool sends_done = true;
+
+            using completion_signatures = pika::execution::experimental::completion_signatures<
+                pika::execution::experimental::set_value_t(),
+                pika::execution::experimental::set_error_t(std::exception_ptr),
+                pika::execution::experimental::set_stopped_t()>;
+
+            template <typename Receiver>
+            friend timed_operation_state<Scheduler, Receiver>
+            tag_invoke(connect_t, timed_sender const& s, Receiver&& receiver)
+            {
+                return {s.scheduler, PIKA_FORWARD(Receiver, receiver), s.abs_time, s.rel_time,
+                    s.relative, s.fallback_annotation};
+            }
+
+            struct env
+            {
+                PIKA_NO_UNIQUE_ADDRESS std::decay_t<Scheduler> scheduler;
+
+                friend std::decay_t<Scheduler> tag_invoke(
+                    pika::execution::experimental::get_completion_scheduler_t<
+                        pika::execution::experimental::set_value_t>,
+                    env const& e) noexcept
+                {
+                    return e.scheduler;
+                }
+            };
+
+            friend env tag_invoke(
+                pika::execution::experimental::get_env_t, timed_sender const& s) noexcept
+            {
+                return {s.scheduler};
+            }
+        };
+
+        friend timed_sender<thread_pool_scheduler> tag_invoke(
+            schedule_at_t, thread_pool_scheduler const& sched,
+            pika::chrono::steady_time_point const& abs_time)
+        {
+            return {sched, abs_time.value(), {}, false};
+        }
+
+        friend timed_sender<thread_pool_scheduler> tag_invoke(
+            schedule_after_t, thread_pool_scheduler const& sched,
+            pika::chrono::steady_duration const& rel_time)
+        {
+            return {sched, {}, rel_time.value(), true};
+        }
+
         // We customize schedule_from to customize transfer. We want transfer to
         // take the annotation from the calling context of transfer if needed
         // and available. If we don't customize schedule_from the schedule
@@ -317,6 +639,10 @@ namespace pika::execution::experimental {
         pika::execution::thread_priority priority_ = pika::execution::thread_priority::normal;
         pika::execution::thread_stacksize stacksize_ = pika::execution::thread_stacksize::small_;
         pika::execution::thread_schedule_hint schedulehint_{};
+        std::chrono::steady_clock::time_point deadline_ =
+            std::chrono::steady_clock::time_point::max();
+        std::size_t chunk_size_ = 0;
+        bool numa_affinity_ = false;
         char const* annotation_ = nullptr;
         /// \endcond
     };
@@ -30,10 +30,14 @@
 #include <pika/threading_base/thread_description.hpp>
 #include <pika/threading_base/thread_num_tss.hpp>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
+#include <limits>
+#include <numeric>
 #include <optional>
 #include <string>
 #include <tuple>
@@ -56,7 +60,30 @@ namespace pika::thread_pool_bulk_detail {
     /// thread (the completion scheduler is a thread_pool_scheduler;
     /// otherwise the customization defined in this file is not chosen) it
     /// will be reused as one of the worker threads.
-    template <typename Sender, typename Shape, typename F>
+    ///
+    /// Unless the scheduler has a chunk size set with with_chunk_size, the
+    /// chunks are made small and each worker thread times the first chunk it
+    /// processes. It then pops the remaining chunks in batches which take
+    /// roughly adaptive_batch_duration to process. The worker thread
+    /// calling set_value times its first chunk before spawning the other
+    /// pika threads, and only spawns as many as the estimated total work
+    /// can keep busy for adaptive_min_task_duration each.
+    ///
+    /// With the with_numa_affinity property set on the scheduler, the
+    /// queues are ordered by the NUMA domain of their worker threads before
+    /// the chunks are divided among them, and a pika thread is spawned for
+    /// every queue regardless of the estimated work. Every bulk with the
+    /// same shape and chunk size thus assigns the same chunks to the same
+    /// worker threads, and memory first touched in one bulk is mostly
+    /// accessed from the same NUMA domain in the next. Worker threads steal
+    /// from the queues of the same NUMA domain before the others.
+    ///
+    /// If WithWorkerThread is true, f is passed the index of the queue that
+    /// the calling pika thread is responsible for before the index in the
+    /// shape. No two pika threads run f with the same queue index
+    /// concurrently, so f can keep per-worker state without
+    /// synchronization.
+    template <typename Sender, typename Shape, typename F, bool WithWorkerThread = false>
     class thread_pool_bulk_sender
     {
     private:
@@ -153,27 +180,58 @@ namespace pika::thread_pool_bulk_detail {
                 struct set_value_loop_visitor
                 {
                     operation_state* const op_state;
-                    task_function const* const task_f;
+                    task_function* const task_f;
 
                     void operator()(pika::detail::monostate const&) const { PIKA_UNREACHABLE; }
 
-                    // Perform the work in one chunk indexed by index.  The
-                    // index represents a range of indices (iterators) in
+                    // Perform the work in the chunks [first, last). The
+                    // chunks represent a range of indices (iterators) in
                     // the given shape.
                     template <typename Ts>
-                    void do_work_chunk(Ts& ts, std::uint32_t const index) const
+                    void do_work_chunks(
+                        Ts& ts, std::uint32_t const first, std::uint32_t const last) const
                     {
-                        auto const i_begin = static_cast<shape_type>(index) *
+                        auto const i_begin = static_cast<shape_type>(first) *
                             static_cast<shape_type>(task_f->chunk_size);
-                        auto const i_end = (std::min)((static_cast<shape_type>(index) + 1) *
+                        auto const i_end = (std::min)(static_cast<shape_type>(last) *
                                 static_cast<shape_type>(task_f->chunk_size),
                             task_f->n);
                         for (auto i = i_begin; i < i_end; ++i)
                         {
-                            std::apply(pika::util::detail::bind_front(op_state->f, i), ts);
+                            if constexpr (WithWorkerThread)
+                            {
+                                std::apply(pika::util::detail::bind_front(
+                                               op_state->f, task_f->worker_thread, i),
+                                    ts);
+                            }
+                            else
+                            {
+                                std::apply(pika::util::detail::bind_front(op_state->f, i), ts);
+                            }
                         }
                     }
 
+                    // Perform the work in the first chunk of the queue
+                    // owned by worker_thread and choose the batch size for
+                    // the remaining chunks from the time it took.
+                    template <typename Ts>
+                    void do_first_chunk(Ts& ts) const
+                    {
+                        auto& local_queue = op_state->queues[task_f->worker_thread].data_;
+
+                        std::optional<std::uint32_t> index = local_queue.pop_left();
+                        if (!index)
+                        {
+                            task_f->batch_size = 1;
+                            return;
+                        }
+
+                        auto const start = std::chrono::steady_clock::now();
+                        // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+                        do_work_chunks(ts, *index, *index + 1);
+                        task_f->set_chunk_duration(std::chrono::steady_clock::now() - start);
+                    }
+
                     // Visit the values sent from the predecessor sender.
                     // This function first tries to handle all chunks in the
                     // queue owned by worker_thread. It then tries to steal
@@ -185,29 +243,82 @@ namespace pika::thread_pool_bulk_detail {
                     {
                         auto& local_queue = op_state->queues[task_f->worker_thread].data_;
 
+                        if (task_f->batch_size == 0) { do_first_chunk(ts); }
+                        std::uint32_t const batch_size = task_f->batch_size;
+
                         // Handle local queue first
-                        std::optional<std::uint32_t> index;
-                        while ((index = local_queue.pop_left()))
+                        std::optional<std::pair<std::uint32_t, std::uint32_t>> chunks;
+                        while ((chunks = local_queue.pop_left(batch_size)))
                         {
                             // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
-                            do_work_chunk(ts, *index);
+                            do_work_chunks(ts, chunks->first, chunks->second);
                         }
 
-                        // Then steal from neighboring queues
+                        // Then steal from neighboring queues. With NUMA
+                        // affinity the queues in the same NUMA domain are
+                        // visited first.
+                        auto const& numa_domains = op_state->numa_domains;
+                        bool const prefer_same_domain = !numa_domains.empty() &&
+                            task_f->worker_thread < op_state->num_worker_threads;
                         for (std::uint32_t offset = 1; offset < op_state->num_worker_threads;
                              ++offset)
                         {
                             std::size_t neighbor_worker_thread =
                                 (task_f->worker_thread + offset) % op_state->num_worker_threads;
-                            auto& neighbor_queue = op_state->queues[neighbor_worker_thread].data_;
+                            if (!prefer_same_domain ||
+                                numa_domains[neighbor_worker_thread] ==
+                                    numa_domains[task_f->worker_thread])
+                            {
+                                steal_chunks(ts, neighbor_worker_thread, batch_size);
+                            }
+                        }
 
-                            while ((index = neighbor_queue.pop_right()))
+                        if (prefer_same_domain)
+                        {
+                            for (std::uint32_t offset = 1; offset < op_state->num_worker_threads;
+                                 ++offset)
                             {
-                                // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
-                                do_work_chunk(ts, *index);
+                                std::size_t neighbor_worker_thread =
+                                    (task_f->worker_thread + offset) % op_state->num_worker_threads;
+                                if (numa_domains[neighbor_worker_thread] !=
+                                    numa_domains[task_f->worker_thread])
+                                {
+                                    steal_chunks(ts, neighbor_worker_thread, batch_size);
+                                }
                             }
                         }
                     }
+
+                    // Process chunks from the end of the queue owned by
+                    // another worker thread until it is empty.
+                    template <typename Ts>
+                    void steal_chunks(Ts& ts, std::size_t const neighbor_worker_thread,
+                        std::uint32_t const batch_size) const
+                    {
+                        auto& neighbor_queue = op_state->queues[neighbor_worker_thread].data_;
+
+                        std::optional<std::pair<std::uint32_t, std::uint32_t>> chunks;
+                        while ((chunks = neighbor_queue.pop_right(batch_size)))
+                        {
+                            // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+                            do_work_chunks(ts, chunks->first, chunks->second);
+                        }
+                    }
+                };
+
+                struct first_chunk_visitor
+                {
+                    set_value_loop_visitor const loop_visitor;
+
+                    void operator()(pika::detail::monostate const&) const { PIKA_UNREACHABLE; }
+
+                    template <typename Ts,
+                        typename = std::enable_if_t<
+                            !std::is_same_v<std::decay_t<Ts>, pika::detail::monostate>>>
+                    void operator()(Ts& ts) const
+                    {
+                        loop_visitor.do_first_chunk(ts);
+                    }
                 };
 
                 struct set_value_end_loop_visitor
@@ -239,13 +350,43 @@ namespace pika::thread_pool_bulk_detail {
                     std::decay_t<Shape> const n;
                     std::uint32_t const chunk_size;
                     std::uint32_t const worker_thread;
+                    // The number of chunks popped from a queue at a time.
+                    // Zero if it should be chosen by timing the first chunk.
+                    std::uint32_t batch_size;
+                    // The time it took to process the first chunk, if it
+                    // was timed
+                    std::optional<std::chrono::nanoseconds> chunk_duration = std::nullopt;
+
+                    void set_chunk_duration(std::chrono::nanoseconds const duration)
+                    {
+                        chunk_duration = duration;
+                        batch_size = get_batch_size(duration);
+                    }
 
                     // Visit the values sent by the predecessor sender.
-                    void do_work() const
+                    void do_work()
                     {
                         pika::detail::visit(set_value_loop_visitor{op_state, this}, op_state->ts);
                     }
 
+                    // Process and time only the first chunk of the local
+                    // queue. Any exception is stored to be handled once
+                    // all worker threads have finished.
+                    void do_first_chunk()
+                    {
+                        try
+                        {
+                            pika::scoped_annotation ann(op_state->f);
+                            pika::detail::visit(
+                                first_chunk_visitor{set_value_loop_visitor{op_state, this}},
+                                op_state->ts);
+                        }
+                        catch (...)
+                        {
+                            store_exception();
+                        }
+                    }
+
                     // Store an exception and mark that an exception was
                     // thrown in the operation state. This function assumes
                     // that there is a current exception.
@@ -311,36 +452,66 @@ namespace pika::thread_pool_bulk_detail {
 
                 // Compute a chunk size given a number of worker threads and
                 // a total number of items n. Returns a power-of-2 chunk
-                // size that produces at most 8 and at least 4 chunks per
-                // worker thread.
-                static constexpr std::uint32_t get_chunk_size(
-                    std::uint32_t const num_threads, std::decay_t<Shape> const n)
+                // size that produces at most chunks_per_thread and at least
+                // chunks_per_thread / 2 chunks per worker thread.
+                static constexpr std::uint32_t get_chunk_size(std::uint32_t const num_threads,
+                    std::decay_t<Shape> const n, std::uint32_t const chunks_per_thread)
                 {
                     std::uint32_t chunk_size = 1;
-                    while (chunk_size * num_threads * 8 < static_cast<std::uint32_t>(n))
+                    while (chunk_size * num_threads * chunks_per_thread <
+                        static_cast<std::uint32_t>(n))
                     {
                         chunk_size *= 2;
                     }
                     return chunk_size;
                 }
 
-                // Initialize a queue for a worker thread.
+                // Compute the number of chunks to pop from a queue at a
+                // time, given the time it took to process one chunk.
+                static std::uint32_t get_batch_size(std::chrono::nanoseconds const chunk_duration)
+                {
+                    if (chunk_duration >= adaptive_batch_duration) { return 1; }
+                    if (chunk_duration.count() <= 0) { return max_adaptive_batch_size; }
+                    return static_cast<std::uint32_t>((std::min)(
+                        static_cast<std::int64_t>(adaptive_batch_duration / chunk_duration),
+                        static_cast<std::int64_t>(max_adaptive_batch_size)));
+                }
+
+                // Compute the number of pika threads, including the
+                // calling one, which should share num_chunks chunks
+                // taking chunk_duration each.
+                static std::size_t get_num_tasks(std::chrono::nanoseconds const chunk_duration,
+                    std::uint32_t const num_chunks, std::size_t const num_threads)
+                {
+                    auto const total_duration = chunk_duration * num_chunks;
+                    auto const num_tasks =
+                        static_cast<std::size_t>(total_duration / adaptive_min_task_duration);
+                    return (std::clamp)(num_tasks, std::size_t(1), num_threads);
+                }
+
+                // Initialize a queue for a worker thread. The chunks are
+                // divided evenly among the queues in the order of the
+                // worker threads, or in the order of their NUMA domains with
+                // NUMA affinity.
                 void init_queue(std::uint32_t const worker_thread, std::uint32_t const num_chunks)
                 {
                     auto& queue = op_state->queues[worker_thread].data_;
+                    std::size_t const position = op_state->queue_positions.empty() ?
+                        worker_thread :
+                        op_state->queue_positions[worker_thread];
                     auto const part_begin = static_cast<std::uint32_t>(
-                        (worker_thread * num_chunks) / op_state->num_worker_threads);
+                        (position * num_chunks) / op_state->num_worker_threads);
                     auto const part_end = static_cast<std::uint32_t>(
-                        ((worker_thread + 1) * num_chunks) / op_state->num_worker_threads);
+                        ((position + 1) * num_chunks) / op_state->num_worker_threads);
                     queue.reset(part_begin, part_end);
                 }
 
                 // Spawn a task which will process a number of chunks. If
                 // the queue contains no chunks no task will be spawned.
                 void do_work_task(std::decay_t<Shape> const n, std::uint32_t const chunk_size,
-                    std::uint32_t const worker_thread) const
+                    std::uint32_t const worker_thread, std::uint32_t const batch_size) const
                 {
-                    task_function task_f{this->op_state, n, chunk_size, worker_thread};
+                    task_function task_f{this->op_state, n, chunk_size, worker_thread, batch_size};
 
                     auto& queue = op_state->queues[worker_thread].data_;
                     if (queue.empty())
@@ -376,14 +547,12 @@ namespace pika::thread_pool_bulk_detail {
                     threads::detail::register_work(data, op_state->scheduler.get_thread_pool());
                 }
 
-                // Do the work on the worker thread that called set_value
-                // from the predecessor sender. This thread participates in
-                // the work and does not need a new task since it already
-                // runs on a task.
-                void do_work_local(std::decay_t<Shape> n, std::uint32_t chunk_size,
-                    std::uint32_t worker_thread) const
+                // Signal that the worker thread will not get a task. Its
+                // chunks are stolen by the other worker threads.
+                void skip_work_task(std::decay_t<Shape> const n, std::uint32_t const chunk_size,
+                    std::uint32_t const worker_thread) const
                 {
-                    task_function{this->op_state, n, chunk_size, worker_thread}();
+                    task_function{this->op_state, n, chunk_size, worker_thread, 1}.finish();
                 }
 
                 template <typename... Ts>
@@ -398,10 +567,19 @@ namespace pika::thread_pool_bulk_detail {
                         return;
                     }
 
-                    // Calculate chunk size and number of chunks
-                    auto const chunk_size =
-                        get_chunk_size(r.op_state->num_worker_threads, r.op_state->shape);
-                    auto const num_chunks = (r.op_state->shape + chunk_size - 1) / chunk_size;
+                    // Calculate chunk size and number of chunks. Adaptive
+                    // chunking starts from small chunks which are later
+                    // popped in batches.
+                    auto const fixed_chunk_size =
+                        pika::execution::experimental::get_chunk_size(r.op_state->scheduler);
+                    bool const adaptive = fixed_chunk_size == 0;
+                    auto const chunk_size = adaptive ?
+                        get_chunk_size(r.op_state->num_worker_threads, r.op_state->shape,
+                            adaptive_chunks_per_thread) :
+                        static_cast<std::uint32_t>((std::min)(fixed_chunk_size,
+                            static_cast<std::size_t>((std::numeric_limits<std::uint32_t>::max)())));
+                    auto const num_chunks = static_cast<std::uint32_t>(
+                        (r.op_state->shape + chunk_size - 1) / chunk_size);
 
                     // Store sent values in the operation state
                     r.op_state->ts.template emplace<std::tuple<std::decay_t<Ts>...>>(
@@ -410,26 +588,61 @@ namespace pika::thread_pool_bulk_detail {
                     // Initialize the queues for all worker threads so that
                     // worker threads can start stealing immediately when
                     // they start.
+                    bool const numa_affinity =
+                        pika::execution::experimental::get_numa_affinity(r.op_state->scheduler);
+                    if (numa_affinity) { r.op_state->init_numa_domains(); }
                     for (std::size_t worker_thread = 0;
                          worker_thread < r.op_state->num_worker_threads; ++worker_thread)
                     {
                         r.init_queue(worker_thread, num_chunks);
                     }
 
-                    // Spawn the worker threads for all except the local queue.
+                    // The worker thread that called set_value from the
+                    // predecessor sender participates in the work and does
+                    // not need a new task since it already runs on a task.
+                    // With adaptive chunking it first times one chunk to
+                    // decide how many other tasks are worth spawning. With
+                    // NUMA affinity all tasks are spawned so that no chunks
+                    // have to be stolen from queues without a task.
+                    auto const num_worker_threads = r.op_state->num_worker_threads;
                     auto const local_worker_thread = pika::get_local_worker_thread_num();
-                    for (std::size_t worker_thread = 0;
-                         worker_thread < r.op_state->num_worker_threads; ++worker_thread)
+                    std::uint32_t const batch_size = adaptive ? 0 : 1;
+                    task_function local_task{r.op_state, r.op_state->shape, chunk_size,
+                        static_cast<std::uint32_t>(local_worker_thread), batch_size};
+
+                    std::size_t num_tasks = num_worker_threads;
+                    if (adaptive && local_worker_thread < num_worker_threads)
+                    {
+                        local_task.do_first_chunk();
+                        if (local_task.chunk_duration && !numa_affinity)
+                        {
+                            num_tasks = get_num_tasks(
+                                *local_task.chunk_duration, num_chunks, num_worker_threads);
+                        }
+                    }
+
+                    // Spawn the worker threads for all except the local
+                    // queue, starting with the closest neighbors of the
+                    // local worker thread.
+                    for (std::size_t worker_thread = 0; worker_thread < num_worker_threads;
+                         ++worker_thread)
                     {
                         // The queue for the local thread is handled later
                         // inline.
                         if (worker_thread == local_worker_thread) { continue; }
 
-                        r.do_work_task(r.op_state->shape, chunk_size, worker_thread);
+                        if ((worker_thread + num_worker_threads - local_worker_thread) %
+                                num_worker_threads <
+                            num_tasks)
+                        {
+                            r.do_work_task(
+                                r.op_state->shape, chunk_size, worker_thread, batch_size);
+                        }
+                        else { r.skip_work_task(r.op_state->shape, chunk_size, worker_thread); }
                     }
 
                     // Handle the queue for the local thread.
-                    r.do_work_local(r.op_state->shape, chunk_size, local_worker_thread);
+                    local_task();
                 }
 
                 friend constexpr pika::execution::experimental::empty_env tag_invoke(
@@ -439,6 +652,18 @@ namespace pika::thread_pool_bulk_detail {
                 }
             };
 
+            // The number of chunks per worker thread for adaptive chunking
+            static constexpr std::uint32_t adaptive_chunks_per_thread = 64;
+            // The time a batch of chunks should take to process with
+            // adaptive chunking
+            static constexpr std::chrono::nanoseconds adaptive_batch_duration{
+                std::chrono::microseconds(20)};
+            static constexpr std::uint32_t max_adaptive_batch_size = 1024;
+            // The minimum estimated time a spawned pika thread should work
+            // with adaptive chunking
+            static constexpr std::chrono::nanoseconds adaptive_min_task_duration{
+                std::chrono::microseconds(20)};
+
             using operation_state_type =
                 pika::execution::experimental::connect_result_t<Sender, bulk_receiver>;
 
@@ -458,6 +683,11 @@ namespace pika::thread_pool_bulk_detail {
                 ts;
             std::atomic<bool> exception_thrown{false};
             std::optional<std::exception_ptr> exception;
+            // With NUMA affinity, the NUMA domain of each worker thread and
+            // the position of each worker thread when ordered by NUMA
+            // domain. Both are empty otherwise.
+            std::vector<std::size_t> numa_domains;
+            std::vector<std::size_t> queue_positions;
 
             template <typename Sender_, typename Shape_, typename F_, typename Receiver_>
             operation_state(pika::execution::experimental::thread_pool_scheduler scheduler,
@@ -471,6 +701,34 @@ namespace pika::thread_pool_bulk_detail {
             {
             }
 
+            // Look up the NUMA domain of each worker thread and order the
+            // worker threads by NUMA domain, keeping the order of worker
+            // threads within a NUMA domain.
+            void init_numa_domains()
+            {
+                if (!numa_domains.empty()) { return; }
+
+                auto* pool = scheduler.get_thread_pool();
+                numa_domains.resize(num_worker_threads);
+                for (std::size_t worker_thread = 0; worker_thread < num_worker_threads;
+                     ++worker_thread)
+                {
+                    numa_domains[worker_thread] = pool->get_numa_domain(worker_thread);
+                }
+
+                std::vector<std::size_t> order(num_worker_threads);
+                std::iota(order.begin(), order.end(), std::size_t(0));
+                std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) {
+                    return numa_domains[a] < numa_domains[b];
+                });
+
+                queue_positions.resize(num_worker_threads);
+                for (std::size_t position = 0; position < num_worker_threads; ++position)
+                {
+                    queue_positions[order[position]] = position;
+                }
+            }
+
             friend void tag_invoke(
                 pika::execution::experimental::start_t, operation_state& os) noexcept
             {
@@ -0,0 +1,197 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/concepts/concepts.hpp>
+#include <pika/concurrency/cache_line_data.hpp>
+#include <pika/execution/algorithms/reduce.hpp>
+#include <pika/execution/algorithms/then.hpp>
+#include <pika/executors/thread_pool_scheduler.hpp>
+#include <pika/executors/thread_pool_scheduler_bulk.hpp>
+#include <pika/functional/bind_front.hpp>
+#include <pika/functional/detail/invoke.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pika::thread_pool_reduce_detail {
+    template <typename T>
+    using partials_type =
+        std::vector<pika::concurrency::detail::cache_aligned_data<std::optional<T>>>;
+
+    /// The values sent by the predecessor sender together with one partial
+    /// result per worker thread of the bulk doing the reduction. The partial
+    /// results are kept on separate cache lines since each is updated by a
+    /// different worker thread.
+    template <typename T, typename... Ts>
+    struct reduce_state
+    {
+        std::tuple<Ts...> ts;
+        partials_type<T> partials;
+    };
+
+    template <typename T>
+    struct make_reduce_state
+    {
+        std::size_t num_worker_threads;
+
+        template <typename... Ts>
+        reduce_state<T, std::decay_t<Ts>...> operator()(Ts&&... ts)
+        {
+            return {{PIKA_FORWARD(Ts, ts)...}, partials_type<T>(num_worker_threads)};
+        }
+    };
+
+    // Combine the partial results pairwise in a tree, leaving the result
+    // in the first partial result.
+    template <typename T, typename ReduceOp>
+    std::optional<T> combine_partials(partials_type<T>& partials, ReduceOp& op)
+    {
+        std::size_t const num_partials = partials.size();
+        for (std::size_t stride = 1; stride < num_partials; stride *= 2)
+        {
+            for (std::size_t i = 0; i + stride < num_partials; i += 2 * stride)
+            {
+                auto& left = partials[i].data_;
+                auto& right = partials[i + stride].data_;
+                if (!right) { continue; }
+                if (left) { left = PIKA_INVOKE(op, PIKA_MOVE(*left), PIKA_MOVE(*right)); }
+                else { left = PIKA_MOVE(right); }
+            }
+        }
+
+        if (num_partials == 0) { return std::nullopt; }
+        return PIKA_MOVE(partials[0].data_);
+    }
+
+    // The bulk function of transform_reduce, combining the value for index
+    // i with the partial result of the worker thread
+    template <typename T, typename ReduceOp, typename F>
+    struct transform_reduce_accumulate
+    {
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<ReduceOp> op;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<F> f;
+
+        template <typename Shape, typename... Ts>
+        void operator()(std::uint32_t worker_thread, Shape i, reduce_state<T, Ts...>& state)
+        {
+            PIKA_ASSERT(worker_thread < state.partials.size());
+            auto& partial = state.partials[worker_thread].data_;
+            T value = std::apply(pika::util::detail::bind_front(f, i), state.ts);
+            if (partial) { partial = PIKA_INVOKE(op, PIKA_MOVE(*partial), PIKA_MOVE(value)); }
+            else { partial.emplace(PIKA_MOVE(value)); }
+        }
+    };
+
+    template <typename T, typename ReduceOp>
+    struct transform_reduce_finish
+    {
+        PIKA_NO_UNIQUE_ADDRESS T init;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<ReduceOp> op;
+
+        template <typename... Ts>
+        T operator()(reduce_state<T, Ts...>&& state)
+        {
+            std::optional<T> result = combine_partials(state.partials, op);
+            if (!result) { return PIKA_MOVE(init); }
+            return PIKA_INVOKE(op, PIKA_MOVE(init), PIKA_MOVE(*result));
+        }
+    };
+
+    // The bulk function of reduce, accumulating the value for index i into
+    // the partial result of the worker thread
+    template <typename T, typename F>
+    struct reduce_accumulate
+    {
+        PIKA_NO_UNIQUE_ADDRESS T identity;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<F> f;
+
+        template <typename Shape, typename... Ts>
+        void operator()(std::uint32_t worker_thread, Shape i, reduce_state<T, Ts...>& state)
+        {
+            PIKA_ASSERT(worker_thread < state.partials.size());
+            auto& partial = state.partials[worker_thread].data_;
+            if (!partial) { partial.emplace(identity); }
+            std::apply([&](auto&... ts) { PIKA_INVOKE(f, *partial, i, ts...); }, state.ts);
+        }
+    };
+
+    template <typename T, typename ReduceOp>
+    struct reduce_finish
+    {
+        PIKA_NO_UNIQUE_ADDRESS T identity;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<ReduceOp> op;
+
+        template <typename... Ts>
+        T operator()(reduce_state<T, Ts...>&& state)
+        {
+            std::optional<T> result = combine_partials(state.partials, op);
+            if (!result) { return PIKA_MOVE(identity); }
+            return PIKA_MOVE(*result);
+        }
+    };
+
+    // Run accumulate with the bulk of the thread_pool_scheduler, giving
+    // each worker thread its own partial result, and combine the partial
+    // results with finish once all worker threads are done.
+    template <typename T, typename Sender, typename Shape, typename Accumulate, typename Finish>
+    auto reduce(pika::execution::experimental::thread_pool_scheduler scheduler, Sender&& sender,
+        Shape const& shape, Accumulate&& accumulate, Finish&& finish)
+    {
+        auto const num_worker_threads = scheduler.get_thread_pool()->get_os_thread_count();
+        auto state_sender = pika::execution::experimental::then(
+            PIKA_FORWARD(Sender, sender), make_reduce_state<T>{num_worker_threads});
+
+        return pika::execution::experimental::then(
+            thread_pool_bulk_detail::thread_pool_bulk_sender<decltype(state_sender), Shape,
+                std::decay_t<Accumulate>, true>{PIKA_MOVE(scheduler), PIKA_MOVE(state_sender),
+                shape, PIKA_FORWARD(Accumulate, accumulate)},
+            PIKA_FORWARD(Finish, finish));
+    }
+}    // namespace pika::thread_pool_reduce_detail
+
+namespace pika::execution::experimental {
+    template <typename Sender, typename Shape, typename T, typename ReduceOp, typename F,
+        PIKA_CONCEPT_REQUIRES_(std::is_integral_v<std::decay_t<Shape>>)>
+    auto tag_invoke(transform_reduce_t, thread_pool_scheduler scheduler, Sender&& sender,
+        Shape const& shape, T&& init, ReduceOp&& op, F&& f)
+    {
+        using value_type = std::decay_t<T>;
+        // The accumulation copies op before it is moved into the final
+        // step, so it can not be created in the argument list
+        auto accumulate =
+            thread_pool_reduce_detail::transform_reduce_accumulate<value_type, ReduceOp, F>{
+                op, PIKA_FORWARD(F, f)};
+        return thread_pool_reduce_detail::reduce<value_type>(PIKA_MOVE(scheduler),
+            PIKA_FORWARD(Sender, sender), shape, PIKA_MOVE(accumulate),
+            thread_pool_reduce_detail::transform_reduce_finish<value_type, ReduceOp>{
+                PIKA_FORWARD(T, init), PIKA_FORWARD(ReduceOp, op)});
+    }
+
+    template <typename Sender, typename Shape, typename T, typename ReduceOp, typename F,
+        PIKA_CONCEPT_REQUIRES_(std::is_integral_v<std::decay_t<Shape>>)>
+    auto tag_invoke(reduce_t, thread_pool_scheduler scheduler, Sender&& sender, Shape const& shape,
+        T&& identity, ReduceOp&& op, F&& f)
+    {
+        using value_type = std::decay_t<T>;
+        // The accumulation copies identity before it is moved into the
+        // final step, so it can not be created in the argument list
+        auto accumulate = thread_pool_reduce_detail::reduce_accumulate<value_type, F>{
+            identity, PIKA_FORWARD(F, f)};
+        return thread_pool_reduce_detail::reduce<value_type>(PIKA_MOVE(scheduler),
+            PIKA_FORWARD(Sender, sender), shape, PIKA_MOVE(accumulate),
+            thread_pool_reduce_detail::reduce_finish<value_type, ReduceOp>{
+                PIKA_FORWARD(T, identity), PIKA_FORWARD(ReduceOp, op)});
+    }
+}    // namespace pika::execution::experimental
@@ -0,0 +1,137 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This test checks that with scheduler_mode::enable_stackless_senders the
+// continuations of thread_pool_scheduler::schedule() run as stackless tasks,
+// and that operations which tried to suspend run as stackful threads
+// afterwards.
+
+#include <pika/execution.hpp>
+#include <pika/execution_base/this_thread.hpp>
+#include <pika/init.hpp>
+#include <pika/runtime.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+#include <pika/threading_base/thread_data.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+bool is_stackless() { return pika::threads::detail::get_self_id_data()->is_stackless(); }
+
+void test_stackless()
+{
+    PIKA_TEST_EQ(tt::sync_wait(ex::schedule(ex::thread_pool_scheduler{}) | ex::then([] {
+        PIKA_TEST(is_stackless());
+        return 42;
+    })),
+        42);
+
+    // Continuations transferred to the scheduler
+    std::size_t count = 0;
+    auto increment = [&] {
+        PIKA_TEST(is_stackless());
+        ++count;
+    };
+    tt::sync_wait(ex::schedule(ex::thread_pool_scheduler{}) | ex::then(increment) |
+        ex::transfer(ex::thread_pool_scheduler{}) | ex::then(increment) |
+        ex::transfer(ex::thread_pool_scheduler{}) | ex::then(increment));
+    PIKA_TEST_EQ(count, std::size_t(3));
+
+    // Errors are propagated as usual
+    bool exception_thrown = false;
+    try
+    {
+        tt::sync_wait(ex::schedule(ex::thread_pool_scheduler{}) |
+            ex::then([] { throw std::runtime_error("error"); }));
+    }
+    catch (std::runtime_error const& e)
+    {
+        PIKA_TEST_EQ(std::string(e.what()), std::string("error"));
+        exception_thrown = true;
+    }
+    PIKA_TEST(exception_thrown);
+}
+
+void test_explicit_stacksize()
+{
+    // Continuations on schedulers with an explicit stack size keep running
+    // as stackful threads
+    auto sched = ex::with_stacksize(
+        ex::thread_pool_scheduler{}, pika::execution::thread_stacksize::medium);
+    tt::sync_wait(ex::schedule(sched) | ex::then([] { PIKA_TEST(!is_stackless()); }));
+}
+
+template <typename F>
+auto suspending_sender(bool& stackless, F f)
+{
+    return ex::schedule(ex::thread_pool_scheduler{}) | ex::then([&stackless, f] {
+        stackless = is_stackless();
+        f();
+    });
+}
+
+template <typename F>
+void test_fallback(F f)
+{
+    // The first operation runs as a stackless task and blocks the worker
+    // thread
+    bool stackless = false;
+    tt::sync_wait(suspending_sender(stackless, f));
+    PIKA_TEST(stackless);
+
+    // Operations of the same type run as stackful threads from then on
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        stackless = true;
+        tt::sync_wait(suspending_sender(stackless, f));
+        PIKA_TEST(!stackless);
+    }
+}
+
+void test_fallback()
+{
+    test_fallback([] { pika::execution::this_thread::detail::yield(); });
+
+    // The public functions of pika::this_thread yield and sleep like the
+    // execution agent does
+    test_fallback([] { pika::this_thread::yield(); });
+    test_fallback([] {
+        auto const start = std::chrono::steady_clock::now();
+        pika::this_thread::sleep_for(std::chrono::milliseconds(10));
+        PIKA_TEST(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(10));
+    });
+    test_fallback([] {
+        auto const until = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+        pika::this_thread::sleep_until(until);
+        PIKA_TEST(std::chrono::steady_clock::now() >= until);
+    });
+}
+
+int pika_main()
+{
+    pika::threads::add_scheduler_mode(pika::threads::scheduler_mode::enable_stackless_senders);
+
+    test_stackless();
+    test_explicit_stacksize();
+    test_fallback();
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv), 0);
+
+    return pika::detail::report_errors();
+}
@@ -8,15 +8,20 @@
 #include <pika/execution.hpp>
 #include <pika/init.hpp>
 #include <pika/mutex.hpp>
+#include <pika/stop_token.hpp>
 #include <pika/testing.hpp>
 #include <pika/thread.hpp>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <exception>
+#include <functional>
+#include <numeric>
 #include <stdexcept>
 #include <string>
 #include <thread>
@@ -1240,6 +1245,61 @@ void test_bulk()
         for (int i = 0; i < n; ++i) { PIKA_TEST_EQ(v_out[i], i); }
     }
 
+    // Explicit chunk sizes, including ones larger than the shape
+    for (std::size_t chunk_size : {1, 3, 100})
+    {
+        auto sched = ex::with_chunk_size(ex::thread_pool_scheduler{}, chunk_size);
+        PIKA_TEST_EQ(ex::get_chunk_size(sched), chunk_size);
+
+        for (int n : ns)
+        {
+            std::vector<int> v(n, 0);
+
+            tt::sync_wait(ex::schedule(sched) | ex::bulk(n, [&](int i) { ++v[i]; }));
+
+            for (int i = 0; i < n; ++i) { PIKA_TEST_EQ(v[i], 1); }
+        }
+    }
+
+    // Adaptive chunking with many cheap elements
+    {
+        PIKA_TEST_EQ(ex::get_chunk_size(ex::thread_pool_scheduler{}), std::size_t(0));
+
+        int const n = 100000;
+        std::vector<int> v(n, 0);
+
+        tt::sync_wait(
+            ex::schedule(ex::thread_pool_scheduler{}) | ex::bulk(n, [&](int i) { ++v[i]; }));
+
+        PIKA_TEST(std::all_of(v.begin(), v.end(), [](int x) { return x == 1; }));
+    }
+
+    // NUMA affinity, with adaptive and explicit chunk sizes
+    {
+        PIKA_TEST(!ex::get_numa_affinity(ex::thread_pool_scheduler{}));
+        auto sched = ex::with_numa_affinity(ex::thread_pool_scheduler{}, true);
+        PIKA_TEST(ex::get_numa_affinity(sched));
+        PIKA_TEST(sched != ex::thread_pool_scheduler{});
+        PIKA_TEST(!ex::get_numa_affinity(ex::with_numa_affinity(sched, false)));
+
+        for (auto const& s : {sched, ex::with_chunk_size(sched, 7)})
+        {
+            for (int n : ns)
+            {
+                std::vector<int> v(n, 0);
+
+                // Running the same bulk twice touches each element once per
+                // bulk
+                for (int r = 0; r < 2; ++r)
+                {
+                    tt::sync_wait(ex::schedule(s) | ex::bulk(n, [&](int i) { ++v[i]; }));
+                }
+
+                for (int i = 0; i < n; ++i) { PIKA_TEST_EQ(v[i], 2); }
+            }
+        }
+    }
+
     // l-value reference sender
     for (int n : ns)
     {
@@ -1305,6 +1365,63 @@ void test_bulk()
     }
 }
 
+void test_reduce()
+{
+    std::vector<int> const ns = {0, 1, 10, 43, 100000};
+
+    for (int n : ns)
+    {
+        std::int64_t const expected = std::int64_t(n) * (n - 1) / 2 + 7;
+
+        auto result = tt::sync_wait(ex::schedule(ex::thread_pool_scheduler{}) |
+            ex::transform_reduce(n, std::int64_t(7), std::plus<>{},
+                [](int i) { return std::int64_t(i); }));
+        PIKA_TEST_EQ(result, expected);
+
+        // With explicit chunk sizes and the values sent by the predecessor
+        for (std::size_t chunk_size : {1, 3})
+        {
+            std::vector<int> v(n);
+            std::iota(v.begin(), v.end(), 0);
+            result = tt::sync_wait(
+                ex::transfer_just(ex::with_chunk_size(ex::thread_pool_scheduler{}, chunk_size),
+                    std::move(v)) |
+                ex::transform_reduce(n, std::int64_t(7), std::plus<>{},
+                    [](int i, std::vector<int>& v) { return std::int64_t(v[i]); }));
+            PIKA_TEST_EQ(result, expected);
+        }
+
+        auto histogram = tt::sync_wait(ex::schedule(ex::thread_pool_scheduler{}) |
+            ex::reduce(n, std::vector<int>(3, 0),
+                [](std::vector<int> a, std::vector<int> const& b) {
+                    for (std::size_t i = 0; i < a.size(); ++i) { a[i] += b[i]; }
+                    return a;
+                },
+                [](std::vector<int>& h, int i) { ++h[i % 3]; }));
+        PIKA_TEST_EQ(histogram.size(), std::size_t(3));
+        PIKA_TEST_EQ(histogram[0] + histogram[1] + histogram[2], n);
+        PIKA_TEST_EQ(histogram[0], (n + 2) / 3);
+    }
+
+    {
+        bool exception_thrown = false;
+        try
+        {
+            tt::sync_wait(ex::schedule(ex::thread_pool_scheduler{}) |
+                ex::transform_reduce(10, 0, std::plus<>{}, [](int i) {
+                    if (i == 3) { throw std::runtime_error("error"); }
+                    return i;
+                }));
+        }
+        catch (std::runtime_error const& e)
+        {
+            exception_thrown = true;
+            PIKA_TEST_EQ(std::string(e.what()), std::string("error"));
+        }
+        PIKA_TEST(exception_thrown);
+    }
+}
+
 void test_completion_scheduler()
 {
     {
@@ -1469,6 +1586,245 @@ void test_split_tuple()
     }
 }
 
+void test_schedule_after()
+{
+    ex::thread_pool_scheduler sched{};
+    auto const duration = std::chrono::milliseconds(10);
+
+    {
+        auto const start = std::chrono::steady_clock::now();
+        tt::sync_wait(ex::schedule_after(sched, duration));
+        PIKA_TEST(std::chrono::steady_clock::now() - start >= duration);
+    }
+
+    {
+        auto const start = std::chrono::steady_clock::now();
+        auto result =
+            tt::sync_wait(ex::schedule_after(sched, duration) | ex::then([]() { return 42; }));
+        PIKA_TEST_EQ(result, 42);
+        PIKA_TEST(std::chrono::steady_clock::now() - start >= duration);
+    }
+
+    // The duration is measured from when the operation state is started
+    {
+        auto s = ex::schedule_after(sched, duration);
+        pika::this_thread::sleep_for(duration);
+        auto const start = std::chrono::steady_clock::now();
+        tt::sync_wait(std::move(s));
+        PIKA_TEST(std::chrono::steady_clock::now() - start >= duration);
+    }
+
+    {
+        tt::sync_wait(ex::schedule_after(sched, std::chrono::milliseconds(0)));
+        tt::sync_wait(ex::schedule_after(sched, std::chrono::milliseconds(-10)));
+    }
+}
+
+void test_schedule_at()
+{
+    ex::thread_pool_scheduler sched{};
+
+    {
+        auto const deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+        tt::sync_wait(ex::schedule_at(sched, deadline));
+        PIKA_TEST(std::chrono::steady_clock::now() >= deadline);
+    }
+
+    {
+        auto const deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+        auto result = tt::sync_wait(ex::schedule_at(sched, deadline) |
+            ex::then([]() { return pika::this_thread::get_id(); }));
+        PIKA_TEST_NEQ(result, pika::thread::id());
+        PIKA_TEST(std::chrono::steady_clock::now() >= deadline);
+    }
+
+    // Deadlines in the past complete immediately
+    {
+        tt::sync_wait(ex::schedule_at(sched, std::chrono::steady_clock::now()));
+        tt::sync_wait(ex::schedule_at(
+            sched, std::chrono::steady_clock::now() - std::chrono::milliseconds(10)));
+    }
+
+    {
+        auto snd = ex::schedule_at(sched, std::chrono::steady_clock::now());
+        auto completion_sched = ex::get_completion_scheduler<ex::set_value_t>(ex::get_env(snd));
+        PIKA_TEST(completion_sched == sched);
+    }
+}
+
+struct stop_token_env
+{
+    pika::stop_token token;
+
+    friend pika::stop_token tag_invoke(ex::get_stop_token_t, stop_token_env const& env) noexcept
+    {
+        return env.token;
+    }
+};
+
+struct stopped_receiver
+{
+    pika::stop_token token;
+    pika::mutex& mtx;
+    pika::condition_variable& cond;
+    bool& stopped;
+    bool& executed;
+
+    template <typename E>
+    friend void tag_invoke(ex::set_error_t, stopped_receiver&&, E&&) noexcept
+    {
+        PIKA_TEST(false);
+    }
+
+    friend void tag_invoke(ex::set_stopped_t, stopped_receiver&& r) noexcept
+    {
+        std::lock_guard l{r.mtx};
+        r.stopped = true;
+        r.executed = true;
+        r.cond.notify_one();
+    }
+
+    template <typename... Ts>
+    friend void tag_invoke(ex::set_value_t, stopped_receiver&& r, Ts&&...) noexcept
+    {
+        std::lock_guard l{r.mtx};
+        r.executed = true;
+        r.cond.notify_one();
+    }
+
+    friend stop_token_env tag_invoke(ex::get_env_t, stopped_receiver const& r) noexcept
+    {
+        return {r.token};
+    }
+};
+
+void test_schedule_after_stop()
+{
+    ex::thread_pool_scheduler sched{};
+
+    // Stop requested while the timer is armed
+    {
+        pika::stop_source ss;
+        pika::mutex mtx;
+        pika::condition_variable cond;
+        bool stopped{false};
+        bool executed{false};
+
+        auto const start = std::chrono::steady_clock::now();
+        auto os = ex::connect(ex::schedule_after(sched, std::chrono::seconds(10)),
+            stopped_receiver{ss.get_token(), mtx, cond, stopped, executed});
+        ex::start(os);
+        ss.request_stop();
+
+        {
+            std::unique_lock l{mtx};
+            cond.wait(l, [&]() { return executed; });
+        }
+
+        PIKA_TEST(stopped);
+        PIKA_TEST(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+    }
+
+    // Stop requested before the operation state is started
+    {
+        pika::stop_source ss;
+        pika::mutex mtx;
+        pika::condition_variable cond;
+        bool stopped{false};
+        bool executed{false};
+
+        ss.request_stop();
+        auto os = ex::connect(ex::schedule_at(sched, std::chrono::steady_clock::now()),
+            stopped_receiver{ss.get_token(), mtx, cond, stopped, executed});
+        ex::start(os);
+
+        {
+            std::unique_lock l{mtx};
+            cond.wait(l, [&]() { return executed; });
+        }
+
+        PIKA_TEST(stopped);
+    }
+
+    // Stop requested after the timer has expired has no effect
+    {
+        pika::stop_source ss;
+        pika::mutex mtx;
+        pika::condition_variable cond;
+        bool stopped{false};
+        bool executed{false};
+
+        auto os = ex::connect(ex::schedule_after(sched, std::chrono::milliseconds(1)),
+            stopped_receiver{ss.get_token(), mtx, cond, stopped, executed});
+        ex::start(os);
+
+        {
+            std::unique_lock l{mtx};
+            cond.wait(l, [&]() { return executed; });
+        }
+
+        ss.request_stop();
+        PIKA_TEST(!stopped);
+    }
+}
+
+void test_timeout()
+{
+    ex::thread_pool_scheduler sched{};
+
+    // The sender completes before the deadline
+    {
+        auto result = tt::sync_wait(ex::schedule(sched) | ex::then([]() { return 42; }) |
+            ex::timeout(sched, std::chrono::seconds(10)));
+        PIKA_TEST_EQ(result, 42);
+    }
+
+    {
+        auto result = tt::sync_wait(ex::timeout(
+            ex::just(custom_type_non_default_constructible_non_copyable{42}), sched,
+            std::chrono::seconds(10)));
+        PIKA_TEST_EQ(result.x, 42);
+    }
+
+    // Errors of the sender are forwarded
+    {
+        bool exception_thrown = false;
+        try
+        {
+            tt::sync_wait(ex::schedule(sched) |
+                ex::then([]() { throw std::runtime_error("error"); }) |
+                ex::timeout(sched, std::chrono::seconds(10)));
+            PIKA_TEST(false);
+        }
+        catch (std::runtime_error const& e)
+        {
+            PIKA_TEST_EQ(std::string(e.what()), std::string("error"));
+            exception_thrown = true;
+        }
+        PIKA_TEST(exception_thrown);
+    }
+
+    // The deadline passes before the sender completes. The timer of the
+    // sender is stopped so that the test does not wait for it to expire.
+    {
+        auto const start = std::chrono::steady_clock::now();
+        bool exception_thrown = false;
+        try
+        {
+            tt::sync_wait(ex::schedule_after(sched, std::chrono::seconds(10)) |
+                ex::timeout(sched, std::chrono::milliseconds(10)));
+            PIKA_TEST(false);
+        }
+        catch (pika::exception const& e)
+        {
+            PIKA_TEST_EQ(e.get_error(), pika::error::timed_out);
+            exception_thrown = true;
+        }
+        PIKA_TEST(exception_thrown);
+        PIKA_TEST(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+    }
+}
+
 void test_scheduler_queries()
 {
     PIKA_TEST(ex::get_forward_progress_guarantee(ex::thread_pool_scheduler{}) ==
@@ -1503,10 +1859,15 @@ int pika_main()
     test_let_error();
     test_detach();
     test_bulk();
+    test_reduce();
     test_drop_value();
     test_split_tuple();
     test_completion_scheduler();
     test_scheduler_queries();
+    test_schedule_after();
+    test_schedule_at();
+    test_schedule_after_stop();
+    test_timeout();
 
     pika::finalize();
     return EXIT_SUCCESS;
@@ -113,6 +113,15 @@ namespace pika {
 #if defined(__linux) || defined(linux) || defined(__linux__) || defined(__FreeBSD__)
             threads::coroutines::detail::posix::use_guard_pages =
                 cmdline.rtcfg_.use_stack_guard_pages();
+            threads::coroutines::detail::posix::use_stack_arena = cmdline.rtcfg_.use_stack_arena();
+            threads::coroutines::detail::posix::use_stack_arena_huge_pages =
+                cmdline.rtcfg_.use_huge_pages_for_stack_arena();
+            threads::coroutines::detail::posix::use_stack_arena_guard_per_stack =
+                cmdline.rtcfg_.use_guard_page_per_stack_for_stack_arena();
+            threads::coroutines::detail::posix::stack_arena_prefault_size =
+                cmdline.rtcfg_.prefault_stack_arena() ?
+                static_cast<std::size_t>(cmdline.rtcfg_.get_default_stack_size()) :
+                0;
 #endif
 #ifdef PIKA_HAVE_VERIFY_LOCKS
             if (cmdline.rtcfg_.enable_lock_detection())
@@ -8,7 +8,7 @@
 // initiating full shutdown.
 
 #include <pika/config.hpp>
-#include <pika/future.hpp>
+#include <pika/execution.hpp>
 #include <pika/init.hpp>
 #include <pika/testing.hpp>
 #include <pika/thread.hpp>
@@ -16,9 +16,12 @@
 #include <chrono>
 #include <cstdlib>
 
+namespace ex = pika::execution::experimental;
+
 int pika_main()
 {
-    pika::apply([] { pika::this_thread::sleep_for(std::chrono::milliseconds(500)); });
+    ex::execute(ex::thread_pool_scheduler{},
+        [] { pika::this_thread::sleep_for(std::chrono::milliseconds(500)); });
 
     pika::finalize();
     return EXIT_SUCCESS;
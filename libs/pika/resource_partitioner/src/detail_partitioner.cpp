@@ -122,6 +122,8 @@ namespace pika::resource::detail {
         case resource::abp_priority_fifo: sched = "abp_priority_fifo"; break;
         case resource::abp_priority_lifo: sched = "abp_priority_lifo"; break;
         case resource::shared_priority: sched = "shared_priority"; break;
+        case resource::work_stealing: sched = "work_stealing"; break;
+        case resource::deadline: sched = "deadline"; break;
         }
 
         os << "\"" << sched << "\" is running on PUs : \n";
@@ -435,6 +437,14 @@ namespace pika::resource::detail {
         {
             default_scheduler = scheduling_policy::shared_priority;
         }
+        else if (0 == std::string("work-stealing").find(default_scheduler_str))
+        {
+            default_scheduler = scheduling_policy::work_stealing;
+        }
+        else if (0 == std::string("deadline").find(default_scheduler_str))
+        {
+            default_scheduler = scheduling_policy::deadline;
+        }
         else
         {
             throw pika::detail::command_line_error(
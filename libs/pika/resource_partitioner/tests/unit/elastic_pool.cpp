@@ -0,0 +1,121 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This test checks that the elastic_pool_controller suspends processing units
+// of an idle pool, resumes them when tasks queue up, and resumes all of them
+// when it is destroyed.
+
+#include <pika/chrono.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/modules/resource_partitioner.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+#include <pika/thread_pools/elastic_pool_controller.hpp>
+#include <pika/threading_base/scheduler_mode.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+
+std::size_t const max_threads =
+    (std::min)(std::size_t(4), std::size_t(pika::threads::detail::hardware_concurrency()));
+
+template <typename F>
+bool wait_for(F&& f)
+{
+    pika::chrono::detail::high_resolution_timer t;
+    while (!f())
+    {
+        if (t.elapsed() > 10.0) { return false; }
+        pika::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+int pika_main()
+{
+    pika::threads::detail::thread_pool_base& tp = pika::resource::get_thread_pool("default");
+    std::size_t const num_threads = tp.get_os_thread_count();
+
+    if (num_threads < 2)
+    {
+        pika::finalize();
+        return EXIT_SUCCESS;
+    }
+
+    {
+        pika::threads::detail::elastic_pool_parameters params;
+        params.min_threads = 1;
+        params.interval = std::chrono::milliseconds(1);
+        params.stable_samples = 3;
+
+        pika::threads::detail::elastic_pool_controller controller(tp, params);
+
+        // An idle pool shrinks to the minimum number of processing units
+        PIKA_TEST(wait_for([&] { return controller.get_num_suspended() == num_threads - 1; }));
+        PIKA_TEST_EQ(tp.get_active_os_thread_count(), std::size_t(1));
+
+        // A backlog of tasks makes the pool grow again
+        constexpr std::size_t num_tasks = 10000;
+        std::atomic<std::size_t> executed{0};
+        for (std::size_t i = 0; i < num_tasks; ++i)
+        {
+            ex::execute(ex::thread_pool_scheduler{&tp}, [&] {
+                pika::chrono::detail::high_resolution_timer t;
+                while (t.elapsed() < 100e-6) {}
+                ++executed;
+            });
+        }
+
+        PIKA_TEST(wait_for([&] { return controller.get_num_suspended() < num_threads - 1; }));
+        PIKA_TEST(wait_for([&] { return executed == num_tasks; }));
+    }
+
+    // Destroying the controller resumes all processing units
+    PIKA_TEST_EQ(tp.get_active_os_thread_count(), num_threads);
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+void test_scheduler(int argc, char* argv[], pika::resource::scheduling_policy scheduler)
+{
+    pika::init_params init_args;
+
+    using ::pika::threads::scheduler_mode;
+    init_args.cfg = {"pika.os_threads=" + std::to_string(max_threads)};
+    init_args.rp_callback = [scheduler](auto& rp, pika::program_options::variables_map const&) {
+        rp.create_thread_pool(
+            "default", scheduler, scheduler_mode::default_mode | scheduler_mode::enable_elasticity);
+    };
+
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv, init_args), 0);
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<pika::resource::scheduling_policy> schedulers = {
+        pika::resource::scheduling_policy::local,
+        pika::resource::scheduling_policy::local_priority_fifo,
+#if defined(PIKA_HAVE_CXX11_STD_ATOMIC_128BIT)
+        pika::resource::scheduling_policy::local_priority_lifo,
+        pika::resource::scheduling_policy::abp_priority_fifo,
+        pika::resource::scheduling_policy::abp_priority_lifo,
+#endif
+    };
+
+    for (auto const scheduler : schedulers) { test_scheduler(argc, argv, scheduler); }
+
+    return pika::detail::report_errors();
+}
@@ -71,6 +71,8 @@ int main(int argc, char* argv[])
         pika::resource::scheduling_policy::static_,
         pika::resource::scheduling_policy::static_priority,
         pika::resource::scheduling_policy::shared_priority,
+        pika::resource::scheduling_policy::work_stealing,
+        pika::resource::scheduling_policy::deadline,
     };
 
     for (auto const scheduler : schedulers) { test_scheduler(argc, argv, scheduler); }
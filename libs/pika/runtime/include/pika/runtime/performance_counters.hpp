@@ -0,0 +1,141 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file pika/runtime/performance_counters.hpp
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/functional/function.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pika/config/warnings_prefix.hpp>
+
+namespace pika::performance_counters {
+    /// The value of a counter at the time it was queried
+    struct counter_value
+    {
+        std::string name;
+        std::int64_t value;
+    };
+
+    /// A counter returns its current value. If reset is true the counter
+    /// should restart counting from zero after returning its value.
+    /// Counters which can not be reset ignore the argument.
+    using counter_function_type = util::detail::function<std::int64_t(bool /* reset */)>;
+
+    /// Adds a counter with the given name, replacing any counter previously
+    /// added with the same name. Counter names are hierarchical paths, e.g.
+    /// \a /threads{default/worker#3}/idle-loop-count.
+    ///
+    /// The pika runtime adds the following counters for each thread pool,
+    /// both for each worker thread (\a /threads{<pool>/worker#<n>}) and for
+    /// the whole pool (\a /threads{<pool>/total}):
+    ///  - \a count/{all,active,pending,suspended,staged,terminated}: the
+    ///    number of threads in the given state
+    ///  - \a queue-length: the number of threads waiting to run
+    ///  - \a idle-loop-count and \a busy-loop-count: the number of
+    ///    iterations of the scheduling loop without and with work
+    ///  - \a time/overall: the time spent running the scheduling loop, in
+    ///    nanoseconds
+    ///  - \a deadline-misses: the number of threads which started after
+    ///    their deadline
+    ///  - \a idle-rate, \a creation-idle-rate and \a cleanup-idle-rate (in
+    ///    0.01%, if enabled at configuration time)
+    ///  - \a count/cumulative, \a count/cumulative-phases, \a
+    ///    time/cumulative, \a time/cumulative-overhead, \a time/average, \a
+    ///    time/average-phase, \a time/average-overhead and \a
+    ///    time/average-phase-overhead (if cumulative counts are enabled at
+    ///    configuration time)
+    ///  - \a wait-time/pending and \a wait-time/staged (if enabled at
+    ///    configuration time)
+    ///  - \a count/pending-misses, \a count/pending-accesses, \a
+    ///    count/stolen-from-pending, \a count/stolen-to-pending, \a
+    ///    count/stolen-from-staged and \a count/stolen-to-staged (if enabled
+    ///    at configuration time)
+    ///
+    /// The counters \a utilization (the percentage of worker threads running
+    /// a thread) and \a idle-cores are only available for the whole pool.
+    PIKA_EXPORT void add_counter(std::string name, counter_function_type f);
+
+    /// Removes the counter with the given name. Returns false if no such
+    /// counter was added.
+    PIKA_EXPORT bool remove_counter(std::string const& name);
+
+    /// Returns the names of the counters matching the given pattern, in
+    /// lexicographical order. A \a * in the pattern matches any sequence of
+    /// characters.
+    PIKA_EXPORT std::vector<std::string> get_counter_names(std::string const& pattern = "*");
+
+    /// Returns a snapshot of the counters matching the given pattern, in
+    /// lexicographical order of their names. If reset is true the counters
+    /// are reset after their values have been read.
+    PIKA_EXPORT std::vector<counter_value> query_counters(
+        std::string const& pattern = "*", bool reset = false);
+
+    enum class counter_format
+    {
+        /// One line per sample, with a header line naming the counters
+        csv,
+        /// One JSON object per sample and line
+        json
+    };
+
+    /// Periodically writes the values of the counters matching a pattern to
+    /// a stream from a separate OS thread. The set of counters written in
+    /// CSV format is fixed by the first sample.
+    class PIKA_EXPORT counter_sampler
+    {
+    public:
+        counter_sampler(std::ostream& os, std::chrono::milliseconds interval,
+            std::string pattern = "*", counter_format format = counter_format::csv,
+            bool reset = false);
+        ~counter_sampler();
+
+        PIKA_NON_COPYABLE(counter_sampler);
+
+        /// Writes a last sample and stops sampling.
+        void stop();
+
+    private:
+        void run();
+        void sample();
+
+        std::ostream& os_;
+        std::chrono::milliseconds const interval_;
+        std::string const pattern_;
+        counter_format const format_;
+        bool const reset_;
+        std::chrono::steady_clock::time_point const start_;
+        std::vector<std::string> columns_;
+
+        std::mutex mtx_;
+        std::condition_variable cond_;
+        bool stop_requested_ = false;
+        std::thread thread_;
+    };
+}    // namespace pika::performance_counters
+
+namespace pika::performance_counters::detail {
+    /// Adds the counters of the given thread pool and its worker threads
+    PIKA_EXPORT void add_thread_pool_counters(
+        threads::detail::thread_pool_base& pool, std::size_t num_threads);
+
+    /// Removes the counters added by add_thread_pool_counters
+    PIKA_EXPORT void remove_thread_pool_counters();
+}    // namespace pika::performance_counters::detail
+
+#include <pika/config/warnings_suffix.hpp>
@@ -27,6 +27,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <exception>
+#include <iosfwd>
 #include <list>
 #include <map>
 #include <memory>
@@ -38,6 +39,10 @@
 #include <pika/config/warnings_prefix.hpp>
 
 ///////////////////////////////////////////////////////////////////////////////
+namespace pika::performance_counters {
+    class counter_sampler;
+}    // namespace pika::performance_counters
+
 namespace pika {
     namespace detail {
         ///////////////////////////////////////////////////////////////////////
@@ -389,6 +394,10 @@ namespace pika {
         notification_policy_type notifier_;
         std::unique_ptr<pika::threads::detail::thread_manager> thread_manager_;
 
+        // writes the counters periodically if pika.counters.file is set
+        std::unique_ptr<std::ostream> counter_stream_;
+        std::unique_ptr<performance_counters::counter_sampler> counter_sampler_;
+
     private:
         /// \brief Helper function to stop the runtime.
         ///
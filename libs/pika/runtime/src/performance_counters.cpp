@@ -0,0 +1,402 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/runtime/performance_counters.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pika::performance_counters {
+    namespace {
+        struct counter_registry
+        {
+            std::mutex mtx;
+            std::map<std::string, counter_function_type> counters;
+        };
+
+        counter_registry& get_counter_registry()
+        {
+            static counter_registry registry;
+            return registry;
+        }
+
+        // Matches name against a pattern in which '*' matches any sequence of
+        // characters
+        bool matches(std::string const& pattern, std::string const& name)
+        {
+            std::size_t p = 0;
+            std::size_t n = 0;
+            std::size_t star = std::string::npos;
+            std::size_t star_n = 0;
+
+            while (n < name.size())
+            {
+                if (p < pattern.size() && pattern[p] == '*')
+                {
+                    star = p++;
+                    star_n = n;
+                }
+                else if (p < pattern.size() && pattern[p] == name[n])
+                {
+                    ++p;
+                    ++n;
+                }
+                else if (star != std::string::npos)
+                {
+                    p = star + 1;
+                    n = ++star_n;
+                }
+                else { return false; }
+            }
+
+            while (p < pattern.size() && pattern[p] == '*') { ++p; }
+            return p == pattern.size();
+        }
+
+        // Escapes quotes and backslashes in counter names for the CSV and
+        // JSON output
+        std::string escape(std::string const& name)
+        {
+            std::string escaped;
+            for (char c : name)
+            {
+                if (c == '"' || c == '\\') { escaped += '\\'; }
+                escaped += c;
+            }
+            return escaped;
+        }
+    }    // namespace
+
+    void add_counter(std::string name, counter_function_type f)
+    {
+        auto& registry = get_counter_registry();
+        std::lock_guard<std::mutex> l(registry.mtx);
+        registry.counters.insert_or_assign(std::move(name), std::move(f));
+    }
+
+    bool remove_counter(std::string const& name)
+    {
+        auto& registry = get_counter_registry();
+        std::lock_guard<std::mutex> l(registry.mtx);
+        return registry.counters.erase(name) != 0;
+    }
+
+    std::vector<std::string> get_counter_names(std::string const& pattern)
+    {
+        auto& registry = get_counter_registry();
+        std::lock_guard<std::mutex> l(registry.mtx);
+
+        std::vector<std::string> names;
+        for (auto const& c : registry.counters)
+        {
+            if (matches(pattern, c.first)) { names.push_back(c.first); }
+        }
+        return names;
+    }
+
+    std::vector<counter_value> query_counters(std::string const& pattern, bool reset)
+    {
+        auto& registry = get_counter_registry();
+        std::lock_guard<std::mutex> l(registry.mtx);
+
+        std::vector<counter_value> values;
+        for (auto& c : registry.counters)
+        {
+            if (matches(pattern, c.first)) { values.push_back({c.first, c.second(reset)}); }
+        }
+        return values;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    counter_sampler::counter_sampler(std::ostream& os, std::chrono::milliseconds interval,
+        std::string pattern, counter_format format, bool reset)
+      : os_(os)
+      , interval_(interval)
+      , pattern_(std::move(pattern))
+      , format_(format)
+      , reset_(reset)
+      , start_(std::chrono::steady_clock::now())
+      , thread_(&counter_sampler::run, this)
+    {
+    }
+
+    counter_sampler::~counter_sampler() { stop(); }
+
+    void counter_sampler::stop()
+    {
+        {
+            std::lock_guard<std::mutex> l(mtx_);
+            if (stop_requested_) { return; }
+            stop_requested_ = true;
+        }
+        cond_.notify_all();
+
+        thread_.join();
+        sample();
+    }
+
+    void counter_sampler::run()
+    {
+        std::unique_lock<std::mutex> l(mtx_);
+        auto next = std::chrono::steady_clock::now() + interval_;
+        while (!cond_.wait_until(l, next, [&] { return stop_requested_; }))
+        {
+            sample();
+            next += interval_;
+        }
+    }
+
+    void counter_sampler::sample()
+    {
+        auto const values = query_counters(pattern_, reset_);
+        double const time =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+
+        std::string line;
+        if (format_ == counter_format::csv)
+        {
+            if (columns_.empty())
+            {
+                line = "time";
+                for (auto const& v : values)
+                {
+                    columns_.push_back(v.name);
+                    line += fmt::format(",\"{}\"", escape(v.name));
+                }
+                line += '\n';
+            }
+
+            // Counters which have been removed since the first sample are
+            // left empty
+            line += fmt::format("{}", time);
+            auto it = values.begin();
+            for (auto const& column : columns_)
+            {
+                while (it != values.end() && it->name < column) { ++it; }
+                if (it != values.end() && it->name == column)
+                {
+                    line += fmt::format(",{}", it->value);
+                }
+                else { line += ','; }
+            }
+            line += '\n';
+        }
+        else
+        {
+            line = fmt::format("{{\"time\":{},\"counters\":{{", time);
+            bool first = true;
+            for (auto const& v : values)
+            {
+                line += fmt::format("{}\"{}\":{}", first ? "" : ",", escape(v.name), v.value);
+                first = false;
+            }
+            line += "}}\n";
+        }
+
+        os_ << line << std::flush;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    namespace detail {
+        namespace {
+            using threads::detail::thread_pool_base;
+            using threads::detail::thread_schedule_state;
+
+            struct pool_counter
+            {
+                char const* name;
+                std::int64_t (*get)(thread_pool_base&, std::size_t, bool);
+            };
+
+            template <thread_schedule_state State>
+            std::int64_t get_thread_count(thread_pool_base& pool, std::size_t num, bool reset)
+            {
+                return pool.get_thread_count(
+                    State, execution::thread_priority::default_, num, reset);
+            }
+
+            // Counters available for each worker thread and for the whole pool
+            // (with the worker thread number std::size_t(-1))
+            pool_counter const worker_counters[] = {
+                {"count/all", &get_thread_count<thread_schedule_state::unknown>},
+                {"count/active", &get_thread_count<thread_schedule_state::active>},
+                {"count/pending", &get_thread_count<thread_schedule_state::pending>},
+                {"count/suspended", &get_thread_count<thread_schedule_state::suspended>},
+                {"count/staged", &get_thread_count<thread_schedule_state::staged>},
+                {"count/terminated", &get_thread_count<thread_schedule_state::terminated>},
+                {"queue-length",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_queue_length(n, r);
+                    }},
+                {"idle-loop-count",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_idle_loop_count(n, r);
+                    }},
+                {"busy-loop-count",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_busy_loop_count(n, r);
+                    }},
+                {"time/overall",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_cumulative_duration(n, r);
+                    }},
+                {"deadline-misses",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_num_deadline_misses(n, r);
+                    }},
+#if defined(PIKA_HAVE_THREAD_IDLE_RATES)
+                {"idle-rate",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.avg_idle_rate(n, r);
+                    }},
+# if defined(PIKA_HAVE_THREAD_CREATION_AND_CLEANUP_RATES)
+                {"creation-idle-rate",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.avg_creation_idle_rate(n, r);
+                    }},
+                {"cleanup-idle-rate",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.avg_cleanup_idle_rate(n, r);
+                    }},
+# endif
+#endif
+#if defined(PIKA_HAVE_THREAD_CUMULATIVE_COUNTS)
+                {"count/cumulative",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_executed_threads(n, r);
+                    }},
+                {"count/cumulative-phases",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_executed_thread_phases(n, r);
+                    }},
+                {"time/cumulative",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_cumulative_thread_duration(n, r);
+                    }},
+                {"time/cumulative-overhead",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_cumulative_thread_overhead(n, r);
+                    }},
+                {"time/average",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_thread_duration(n, r);
+                    }},
+                {"time/average-phase",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_thread_phase_duration(n, r);
+                    }},
+                {"time/average-overhead",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_thread_overhead(n, r);
+                    }},
+                {"time/average-phase-overhead",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_thread_phase_overhead(n, r);
+                    }},
+#endif
+#if defined(PIKA_HAVE_THREAD_QUEUE_WAITTIME)
+                {"wait-time/pending",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_average_thread_wait_time(n, r);
+                    }},
+                {"wait-time/staged",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_average_task_wait_time(n, r);
+                    }},
+#endif
+#if defined(PIKA_HAVE_THREAD_STEALING_COUNTS)
+                {"count/pending-misses",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_num_pending_misses(n, r);
+                    }},
+                {"count/pending-accesses",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_num_pending_accesses(n, r);
+                    }},
+                {"count/stolen-from-pending",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_num_stolen_from_pending(n, r);
+                    }},
+                {"count/stolen-to-pending",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_num_stolen_to_pending(n, r);
+                    }},
+                {"count/stolen-from-staged",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_num_stolen_from_staged(n, r);
+                    }},
+                {"count/stolen-to-staged",
+                    [](thread_pool_base& p, std::size_t n, bool r) {
+                        return p.get_num_stolen_to_staged(n, r);
+                    }},
+#endif
+            };
+
+            // Counters available only for the whole pool
+            pool_counter const pool_counters[] = {
+                {"utilization",
+                    [](thread_pool_base& p, std::size_t, bool) {
+                        return p.get_scheduler_utilization();
+                    }},
+                {"idle-cores",
+                    [](thread_pool_base& p, std::size_t, bool) { return p.get_idle_core_count(); }},
+            };
+
+            constexpr char const* thread_pool_counter_prefix = "/threads{";
+
+            void add_pool_counter(
+                thread_pool_base& pool, std::string const& instance, pool_counter const& c,
+                std::size_t num)
+            {
+                add_counter(fmt::format("{}{}/{}}}/{}", thread_pool_counter_prefix,
+                                pool.get_pool_name(), instance, c.name),
+                    [&pool, get = c.get, num](bool reset) { return get(pool, num, reset); });
+            }
+        }    // namespace
+
+        void add_thread_pool_counters(thread_pool_base& pool, std::size_t num_threads)
+        {
+            for (auto const& c : worker_counters)
+            {
+                add_pool_counter(pool, "total", c, std::size_t(-1));
+                for (std::size_t i = 0; i < num_threads; ++i)
+                {
+                    add_pool_counter(pool, fmt::format("worker#{}", i), c, i);
+                }
+            }
+
+            for (auto const& c : pool_counters)
+            {
+                add_pool_counter(pool, "total", c, std::size_t(-1));
+            }
+        }
+
+        void remove_thread_pool_counters()
+        {
+            auto& registry = get_counter_registry();
+            std::lock_guard<std::mutex> l(registry.mtx);
+
+            auto it = registry.counters.lower_bound(thread_pool_counter_prefix);
+            while (it != registry.counters.end() &&
+                it->first.compare(0, std::char_traits<char>::length(thread_pool_counter_prefix),
+                    thread_pool_counter_prefix) == 0)
+            {
+                it = registry.counters.erase(it);
+            }
+        }
+    }    // namespace detail
+}    // namespace pika::performance_counters
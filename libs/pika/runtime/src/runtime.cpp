@@ -23,6 +23,7 @@
 #include <pika/runtime/custom_exception_info.hpp>
 #include <pika/runtime/debugging.hpp>
 #include <pika/runtime/os_thread_type.hpp>
+#include <pika/runtime/performance_counters.hpp>
 #include <pika/runtime/runtime.hpp>
 #include <pika/runtime/runtime_fwd.hpp>
 #include <pika/runtime/shutdown_function.hpp>
@@ -32,10 +33,12 @@
 #include <pika/runtime/thread_mapper.hpp>
 #include <pika/string_util/from_string.hpp>
 #include <pika/thread_support/set_thread_name.hpp>
+#include <pika/threading_base/detail/task_trace.hpp>
 #include <pika/threading_base/external_timer.hpp>
 #include <pika/threading_base/scheduler_mode.hpp>
 #include <pika/threading_base/thread_helpers.hpp>
 #include <pika/topology/topology.hpp>
+#include <pika/util/get_entry_as.hpp>
 #include <pika/version.hpp>
 
 #if defined(PIKA_HAVE_GPU_SUPPORT)
@@ -60,6 +63,7 @@
 #include <cstdint>
 #include <cstring>
 #include <exception>
+#include <fstream>
 #include <functional>
 #include <iomanip>
 #include <iostream>
@@ -189,6 +193,81 @@ namespace pika {
             exit_called = true;
             std::exit(-1);
         }
+
+        // Starts recording task trace events if pika.trace.file is set
+        void start_task_trace(pika::util::runtime_configuration const& cfg)
+        {
+            if (cfg.get_entry("pika.trace.file", "").empty()) { return; }
+
+            std::string const format = cfg.get_entry("pika.trace.format", "chrome");
+            if (format != "chrome" && format != "perfetto")
+            {
+                PIKA_THROW_EXCEPTION(pika::error::bad_parameter, "start_task_trace",
+                    "invalid pika.trace.format: {} (valid values are chrome and perfetto)",
+                    format);
+            }
+
+            threads::detail::enable_task_trace(
+                pika::detail::get_entry_as<std::size_t>(cfg, "pika.trace.buffer_size", 65536));
+        }
+
+        // Starts writing the counters to pika.counters.file, if set. The
+        // special file name - writes the counters to the standard output.
+        std::unique_ptr<performance_counters::counter_sampler> start_counter_sampler(
+            pika::util::runtime_configuration const& cfg, std::unique_ptr<std::ostream>& stream)
+        {
+            std::string const filename = cfg.get_entry("pika.counters.file", "");
+            if (filename.empty()) { return nullptr; }
+
+            std::string const format = cfg.get_entry("pika.counters.format", "csv");
+            if (format != "csv" && format != "json")
+            {
+                PIKA_THROW_EXCEPTION(pika::error::bad_parameter, "start_counter_sampler",
+                    "invalid pika.counters.format: {} (valid values are csv and json)", format);
+            }
+
+            std::ostream* os = &std::cout;
+            if (filename != "-")
+            {
+                stream = std::make_unique<std::ofstream>(filename);
+                if (!*stream)
+                {
+                    PIKA_THROW_EXCEPTION(pika::error::bad_parameter, "start_counter_sampler",
+                        "could not open {} to write the counters", filename);
+                }
+                os = stream.get();
+            }
+
+            return std::make_unique<performance_counters::counter_sampler>(*os,
+                std::chrono::milliseconds(
+                    pika::detail::get_entry_as<std::int64_t>(cfg, "pika.counters.interval", 1000)),
+                cfg.get_entry("pika.counters.names", "*"),
+                format == "json" ? performance_counters::counter_format::json :
+                                   performance_counters::counter_format::csv,
+                pika::detail::get_entry_as<int>(cfg, "pika.counters.reset", 0) != 0);
+        }
+
+        // Writes the recorded task trace events to pika.trace.file
+        void write_task_trace(pika::util::runtime_configuration const& cfg)
+        {
+            std::string const filename = cfg.get_entry("pika.trace.file", "");
+            if (filename.empty()) { return; }
+
+            threads::detail::disable_task_trace();
+
+            std::ofstream out(filename, std::ios::binary);
+            if (!out)
+            {
+                std::cerr << "pika: could not open " << filename << " to write the task trace\n";
+                return;
+            }
+
+            if (cfg.get_entry("pika.trace.format", "chrome") == "perfetto")
+            {
+                threads::detail::write_task_trace_perfetto(out);
+            }
+            else { threads::detail::write_task_trace_chrome(out); }
+        }
     }    // namespace detail
 
     ///////////////////////////////////////////////////////////////////////////
@@ -318,6 +397,14 @@ namespace pika {
             // this initializes the used_processing_units_ mask
             thread_manager_->init();
 
+            // make the statistics of all pools available as counters
+            auto const& rp = resource::get_partitioner();
+            for (std::size_t i = 0; i != rp.get_num_pools(); ++i)
+            {
+                performance_counters::detail::add_thread_pool_counters(
+                    thread_manager_->get_pool(rp.get_pool_name(i)), rp.get_num_threads(i));
+            }
+
             // copy over all startup functions registered so far
             for (startup_function_type& f : detail::global_pre_startup_functions)
             {
@@ -358,10 +445,17 @@ namespace pika {
     {
         LRT_(debug).format("~runtime(entering)");
 
+        // write the last sample of the counters while the pools still exist
+        counter_sampler_.reset();
+        counter_stream_.reset();
+        performance_counters::detail::remove_thread_pool_counters();
+
         // stop all services
         thread_manager_->stop();
         LRT_(debug).format("~runtime(finished)");
 
+        detail::write_task_trace(rtcfg_);
+
         LPROGRESS_;
 
         // allow to reuse instance number if this was the only instance
@@ -1144,9 +1238,13 @@ namespace pika {
         // registered startup callbacks.
         init_tss_helper("main-thread", os_thread_type::main_thread, 0, 0, "", "", false);
 
+        detail::start_task_trace(rtcfg_);
+
         // start the thread manager
         thread_manager_->run();
         lbt_ << "(1st stage) runtime::start: started thread_manager";
+
+        counter_sampler_ = detail::start_counter_sampler(rtcfg_, counter_stream_);
         // }}}
 
         // {{{ launch main
@@ -0,0 +1,146 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This test checks that counters can be added, queried and reset, that the
+// statistics of the thread pools are available as counters, and that the
+// counter sampler writes CSV and JSON.
+
+#include <pika/init.hpp>
+#include <pika/runtime/performance_counters.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace pc = pika::performance_counters;
+
+char const* const counters_file = "performance_counters_test.csv";
+
+std::size_t count_lines(std::string const& s)
+{
+    return static_cast<std::size_t>(std::count(s.begin(), s.end(), '\n'));
+}
+
+void test_custom_counter()
+{
+    std::atomic<std::int64_t> count{0};
+    pc::add_counter("/test{custom}/count", [&](bool reset) {
+        return reset ? count.exchange(0) : count.load();
+    });
+
+    count = 42;
+    auto values = pc::query_counters("/test{custom}/count");
+    PIKA_TEST_EQ(values.size(), std::size_t(1));
+    PIKA_TEST_EQ(values[0].name, std::string("/test{custom}/count"));
+    PIKA_TEST_EQ(values[0].value, std::int64_t(42));
+
+    // Reading a counter with reset returns the value before the reset
+    PIKA_TEST_EQ(pc::query_counters("/test{custom}/count", true)[0].value, std::int64_t(42));
+    PIKA_TEST_EQ(pc::query_counters("/test{custom}/count")[0].value, std::int64_t(0));
+
+    PIKA_TEST(pc::remove_counter("/test{custom}/count"));
+    PIKA_TEST(!pc::remove_counter("/test{custom}/count"));
+    PIKA_TEST(pc::query_counters("/test{custom}/count").empty());
+}
+
+void test_thread_pool_counters()
+{
+    auto const total = pc::get_counter_names("/threads{default/total}/*");
+    for (char const* name : {"count/all", "queue-length", "idle-loop-count", "busy-loop-count",
+             "time/overall", "utilization", "idle-cores"})
+    {
+        PIKA_TEST(std::find(total.begin(), total.end(),
+                      std::string("/threads{default/total}/") + name) != total.end());
+    }
+
+    // Each worker thread has the same counters as the whole pool, except for
+    // the ones which are only available for the pool
+    auto const worker = pc::get_counter_names("/threads{default/worker#0}/*");
+    PIKA_TEST_EQ(worker.size() + 2, total.size());
+    PIKA_TEST_EQ(pc::get_counter_names("/threads{default/worker#*}/time/overall").size(),
+        pika::get_num_worker_threads());
+
+    // This thread is running
+    auto const active = pc::query_counters("/threads{default/total}/count/active");
+    PIKA_TEST_EQ(active.size(), std::size_t(1));
+    PIKA_TEST_LTE(std::int64_t(1), active[0].value);
+}
+
+void test_sampler(pc::counter_format format)
+{
+    pc::add_counter("/test{sampler}/constant", [](bool) { return std::int64_t(7); });
+
+    std::ostringstream os;
+    {
+        pc::counter_sampler sampler(os, std::chrono::milliseconds(10), "/test{sampler}/*", format);
+        pika::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    pc::remove_counter("/test{sampler}/constant");
+
+    std::string const output = os.str();
+    // At least one periodic sample and the last one written when stopping
+    PIKA_TEST_LTE(std::size_t(2), count_lines(output));
+    if (format == pc::counter_format::csv)
+    {
+        PIKA_TEST_EQ(output.find("time,\"/test{sampler}/constant\"\n"), std::size_t(0));
+        PIKA_TEST_NEQ(output.find(",7\n"), std::string::npos);
+    }
+    else
+    {
+        PIKA_TEST_EQ(output.find("{\"time\":"), std::size_t(0));
+        PIKA_TEST_NEQ(output.find("\"counters\":{\"/test{sampler}/constant\":7}}\n"),
+            std::string::npos);
+    }
+}
+
+int pika_main()
+{
+    test_custom_counter();
+    test_thread_pool_counters();
+    test_sampler(pc::counter_format::csv);
+    test_sampler(pc::counter_format::json);
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    std::remove(counters_file);
+
+    pika::init_params init_args;
+    init_args.cfg = {std::string("pika.counters.file=") + counters_file,
+        "pika.counters.interval=10", "pika.counters.names=/threads{default/total}/*"};
+
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv, init_args), 0);
+
+    // The runtime samples the counters while running and when it stops
+    {
+        std::ifstream in(counters_file);
+        std::string const csv(std::istreambuf_iterator<char>(in), {});
+        PIKA_TEST_EQ(csv.find("time,"), std::size_t(0));
+        PIKA_TEST_NEQ(csv.find("\"/threads{default/total}/idle-loop-count\""), std::string::npos);
+        PIKA_TEST_LTE(std::size_t(2), count_lines(csv));
+    }
+    std::remove(counters_file);
+
+    // The counters of the thread pools are removed with the runtime
+    PIKA_TEST(pc::get_counter_names("/threads{*").empty());
+
+    return pika::detail::report_errors();
+}
@@ -68,6 +68,14 @@ namespace pika::util {
 
 #if defined(__linux) || defined(linux) || defined(__linux__) || defined(__FreeBSD__)
         bool use_stack_guard_pages() const;
+
+        // Carve stacks from slabs, optionally advising them for transparent
+        // huge pages, protecting a guard page per stack instead of per slab,
+        // and pre-faulting the slabs for the default stack size
+        bool use_stack_arena() const;
+        bool use_huge_pages_for_stack_arena() const;
+        bool use_guard_page_per_stack_for_stack_arena() const;
+        bool prefault_stack_arena() const;
 #endif
 
         // return trace_depth for stack-backtraces
@@ -159,7 +159,14 @@ namespace pika::util {
 #if defined(__linux) || defined(linux) || defined(__linux__) ||                \
     defined(__FreeBSD__)
             "use_guard_pages = ${PIKA_USE_GUARD_PAGES:0}",
+            "arena = ${PIKA_STACK_ARENA:0}",
+            "arena_huge_pages = ${PIKA_STACK_ARENA_HUGE_PAGES:0}",
+            "arena_guard_per_stack = ${PIKA_STACK_ARENA_GUARD_PER_STACK:0}",
+            "arena_prefault = ${PIKA_STACK_ARENA_PREFAULT:0}",
 #endif
+            "cache_magazine_size = ${PIKA_STACK_CACHE_MAGAZINE_SIZE:64}",
+            "cache_high_water_mark = ${PIKA_STACK_CACHE_HIGH_WATER_MARK:-1}",
+            "cache_trim_interval = ${PIKA_STACK_CACHE_TRIM_INTERVAL:1000}",
 
             "[pika.thread_queue]",
             "max_thread_count = ${PIKA_THREAD_QUEUE_MAX_THREAD_COUNT:" PIKA_PP_STRINGIZE(
@@ -189,6 +196,25 @@ namespace pika::util {
             "${PIKA_THREAD_QUEUE_INIT_THREADS_COUNT:" PIKA_PP_STRINGIZE(
                 PIKA_PP_EXPAND(PIKA_THREAD_QUEUE_INIT_THREADS_COUNT)) "}",
 
+            "[pika.counters]",
+            "file = ${PIKA_COUNTERS_FILE:}",
+            "format = ${PIKA_COUNTERS_FORMAT:csv}",
+            "interval = ${PIKA_COUNTERS_INTERVAL:1000}",
+            "names = ${PIKA_COUNTERS_NAMES:*}",
+            "reset = ${PIKA_COUNTERS_RESET:0}",
+
+            "[pika.trace]",
+            "file = ${PIKA_TRACE_FILE:}",
+            "format = ${PIKA_TRACE_FORMAT:chrome}",
+            "buffer_size = ${PIKA_TRACE_BUFFER_SIZE:65536}",
+
+#if defined(PIKA_HAVE_ASYNC_IO)
+            "[pika.async_io]",
+            "backend = ${PIKA_ASYNC_IO_BACKEND:io_uring}",
+            "queue_depth = ${PIKA_ASYNC_IO_QUEUE_DEPTH:256}",
+            "blocking_threads = ${PIKA_ASYNC_IO_BLOCKING_THREADS:4}",
+
+#endif
             "[pika.commandline]",
 
             // allow for unknown options to be passed through
@@ -546,6 +572,42 @@ namespace pika::util {
         }
         return true;    // default is true
     }
+
+    bool runtime_configuration::use_stack_arena() const
+    {
+        if (pika::detail::section const* sec = get_section("pika.stacks"); nullptr != sec)
+        {
+            return pika::detail::get_entry_as<int>(*sec, "arena", 0) != 0;
+        }
+        return false;
+    }
+
+    bool runtime_configuration::use_huge_pages_for_stack_arena() const
+    {
+        if (pika::detail::section const* sec = get_section("pika.stacks"); nullptr != sec)
+        {
+            return pika::detail::get_entry_as<int>(*sec, "arena_huge_pages", 0) != 0;
+        }
+        return false;
+    }
+
+    bool runtime_configuration::use_guard_page_per_stack_for_stack_arena() const
+    {
+        if (pika::detail::section const* sec = get_section("pika.stacks"); nullptr != sec)
+        {
+            return pika::detail::get_entry_as<int>(*sec, "arena_guard_per_stack", 0) != 0;
+        }
+        return false;
+    }
+
+    bool runtime_configuration::prefault_stack_arena() const
+    {
+        if (pika::detail::section const* sec = get_section("pika.stacks"); nullptr != sec)
+        {
+            return pika::detail::get_entry_as<int>(*sec, "arena_prefault", 0) != 0;
+        }
+        return false;
+    }
 #endif
 
     std::ptrdiff_t runtime_configuration::init_small_stack_size() const
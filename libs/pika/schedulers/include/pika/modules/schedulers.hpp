@@ -8,8 +8,10 @@
 
 #include <pika/config.hpp>
 
+#include <pika/schedulers/deadline_queue_scheduler.hpp>
 #include <pika/schedulers/local_priority_queue_scheduler.hpp>
 #include <pika/schedulers/local_queue_scheduler.hpp>
 #include <pika/schedulers/shared_priority_queue_scheduler.hpp>
 #include <pika/schedulers/static_priority_queue_scheduler.hpp>
 #include <pika/schedulers/static_queue_scheduler.hpp>
+#include <pika/schedulers/work_stealing_scheduler.hpp>
@@ -0,0 +1,405 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/affinity/affinity_data.hpp>
+#include <pika/assert.hpp>
+#include <pika/modules/errors.hpp>
+#include <pika/modules/logging.hpp>
+#include <pika/schedulers/local_queue_scheduler.hpp>
+#include <pika/schedulers/lockfree_queue_backends.hpp>
+#include <pika/threading_base/detail/global_activity_count.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
+#include <pika/threading_base/thread_data.hpp>
+#include <pika/topology/topology.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <pika/config/warnings_prefix.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace pika::threads::detail {
+    ///////////////////////////////////////////////////////////////////////////
+    /// The deadline_queue_scheduler runs threads with a deadline in earliest
+    /// deadline first order. Each worker thread keeps a binary heap of
+    /// runnable threads ordered by deadline, and takes the most urgent thread
+    /// from it before looking at threads without a deadline. Idle worker
+    /// threads steal the most urgent thread out of all other heaps. Threads
+    /// get a deadline through the with_deadline property of
+    /// thread_pool_scheduler.
+    ///
+    /// Threads without a deadline, threads which yield and threads which are
+    /// created suspended go through the queues of the underlying
+    /// local_queue_scheduler. These queues are checked periodically before
+    /// the heap so that they can not be starved by threads with a deadline.
+    /// Thread objects for the heaps are created eagerly, so once a heap holds
+    /// max_thread_count threads new threads are staged in the shared queue
+    /// instead, to bound the number of allocated stacks.
+    ///
+    /// A thread which starts running after its deadline counts as a deadline
+    /// miss, see get_num_deadline_misses. Each thread is counted at most
+    /// once, when it first starts: resuming a suspended thread late is not a
+    /// miss.
+    template <typename Mutex = std::mutex, typename PendingQueuing = lockfree_fifo,
+        typename StagedQueuing = lockfree_fifo, typename TerminatedQueuing = lockfree_fifo>
+    class PIKA_EXPORT deadline_queue_scheduler
+      : public local_queue_scheduler<Mutex, PendingQueuing, StagedQueuing, TerminatedQueuing>
+    {
+    public:
+        using base_type =
+            local_queue_scheduler<Mutex, PendingQueuing, StagedQueuing, TerminatedQueuing>;
+        using typename base_type::init_parameter_type;
+        using typename base_type::thread_queue_type;
+
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using thread_repr = typename threads::detail::thread_id_ref_type::thread_repr;
+
+        // The heap is not checked first every this many calls to
+        // get_next_thread
+        static constexpr std::uint32_t shared_queue_check_interval = 61;
+
+        // Value of worker_data::earliest when the heap is empty
+        static constexpr clock_type::rep no_deadline =
+            clock_type::time_point::max().time_since_epoch().count();
+
+        struct heap_entry
+        {
+            clock_type::time_point deadline;
+            std::uint64_t sequence;
+            thread_repr* thrd;
+            // false if the thread has already started running, so that a
+            // deadline miss is counted only once per thread
+            bool first_run;
+
+            // Threads with the same deadline run in the order they were
+            // scheduled
+            friend bool operator>(heap_entry const& lhs, heap_entry const& rhs) noexcept
+            {
+                return lhs.deadline > rhs.deadline ||
+                    (lhs.deadline == rhs.deadline && lhs.sequence > rhs.sequence);
+            }
+        };
+
+        struct worker_data
+        {
+            Mutex mtx;
+            std::vector<heap_entry> heap;
+            std::uint64_t sequence = 0;
+
+            // Deadline of the most urgent thread in the heap and the size of
+            // the heap, read without the lock by other worker threads
+            std::atomic<clock_type::rep> earliest{no_deadline};
+            std::atomic<std::int64_t> size{0};
+
+            std::atomic<std::int64_t> num_deadline_misses{0};
+
+            // Only accessed by the owning worker thread
+            std::uint32_t tick = 0;
+        };
+
+    public:
+        deadline_queue_scheduler(
+            init_parameter_type const& init, bool deferred_initialization = true)
+          : base_type(init, deferred_initialization)
+          , max_local_thread_count_(init.thread_queue_init_.max_thread_count_)
+        {
+            workers_.reserve(init.num_queues_);
+            for (std::size_t i = 0; i != init.num_queues_; ++i)
+            {
+                workers_.push_back(std::make_unique<worker_data>());
+            }
+        }
+
+        static std::string get_scheduler_name() { return "deadline_queue_scheduler"; }
+
+        ///////////////////////////////////////////////////////////////////////
+        // create a new thread and schedule it if the initial state is equal to
+        // pending
+        void create_thread(threads::detail::thread_init_data& data,
+            threads::detail::thread_id_ref_type* id, error_code& ec) override
+        {
+            if (data.deadline == clock_type::time_point::max() ||
+                data.initial_state != threads::detail::thread_schedule_state::pending)
+            {
+                base_type::create_thread(data, id, ec);
+                return;
+            }
+
+            std::unique_lock<scheduler_base::pu_mutex_type> l;
+            std::size_t const num_thread =
+                this->select_active_pu(l, select_worker(data.schedulehint));
+
+            if (workers_[num_thread]->size.load(std::memory_order_relaxed) >=
+                max_local_thread_count_)
+            {
+                if (l.owns_lock()) { l.unlock(); }
+                base_type::create_thread(data, id, ec);
+                return;
+            }
+
+            pika::threads::detail::increment_global_activity_count();
+
+            // thread has not been created yet
+            if (id) *id = threads::detail::invalid_thread_id;
+
+            if (data.stacksize == execution::thread_stacksize::current)
+            {
+                data.stacksize = threads::detail::get_self_stacksize_enum();
+            }
+
+            threads::detail::thread_id_ref_type thrd;
+            if (!this->queues_[num_thread]->create_thread_now(data, thrd, ec))
+            {
+                pika::threads::detail::decrement_global_activity_count();
+                return;
+            }
+
+            LTM_(debug)
+                .format("deadline_queue_scheduler::create_thread: pool({}), scheduler({}), "
+                        "worker_thread({}), thread({})",
+                    *this->get_parent_pool(), *this, num_thread, thrd)
+#ifdef PIKA_HAVE_THREAD_DESCRIPTION
+                .format(", description({})", data.description)
+#endif
+                ;
+
+            // return the thread_id_ref of the newly created thread
+            if (id) { *id = thrd; }
+            push(*workers_[num_thread], data.deadline, thrd.detach(), true);
+
+            if (&ec != &throws) ec = make_success_code();
+        }
+
+        /// Return the next thread to be executed, return false if none is
+        /// available
+        bool get_next_thread(std::size_t num_thread, bool running,
+            threads::detail::thread_id_ref_type& thrd, bool enable_stealing) override
+        {
+            PIKA_ASSERT(num_thread < workers_.size());
+
+            worker_data& w = *workers_[num_thread];
+
+            if (++w.tick % shared_queue_check_interval == 0 &&
+                base_type::get_next_thread(num_thread, running, thrd, enable_stealing))
+            {
+                return true;
+            }
+
+            if (pop(w, w, thrd)) { return true; }
+
+#if !defined(PIKA_HAVE_THREAD_SANITIZER)
+            if (running && enable_stealing && steal_most_urgent(num_thread, thrd))
+            {
+                return true;
+            }
+#endif
+
+            return base_type::get_next_thread(num_thread, running, thrd, enable_stealing);
+        }
+
+        /// Schedule the passed thread
+        void schedule_thread(threads::detail::thread_id_ref_type thrd,
+            execution::thread_schedule_hint schedulehint, bool allow_fallback,
+            execution::thread_priority priority = execution::thread_priority::normal) override
+        {
+            threads::detail::thread_data* data = get_thread_id_data(thrd);
+            if (!data->has_deadline())
+            {
+                base_type::schedule_thread(PIKA_MOVE(thrd), schedulehint, allow_fallback, priority);
+                return;
+            }
+
+            PIKA_ASSERT(data->get_scheduler_base() == this);
+
+            if (schedulehint.mode != execution::thread_schedule_hint_mode::thread)
+            {
+                allow_fallback = false;
+            }
+
+            std::unique_lock<scheduler_base::pu_mutex_type> l;
+            std::size_t const num_thread =
+                this->select_active_pu(l, select_worker(schedulehint), allow_fallback);
+
+            LTM_(debug).format("deadline_queue_scheduler::schedule_thread: pool({}), "
+                               "scheduler({}), worker_thread({}), thread({}), description({})",
+                *this->get_parent_pool(), *this, num_thread, data->get_thread_id(),
+                data->get_description());
+
+            // detach the thread from the id_ref without decrementing the
+            // reference count
+            push(*workers_[num_thread], data->get_deadline(), thrd.detach(), false);
+        }
+
+        // schedule_thread_last is inherited: threads which yield go to the
+        // back of the shared queue of the worker thread, as they would run
+        // again immediately if they were put back in the heap.
+
+        ///////////////////////////////////////////////////////////////////////
+        // This returns the current length of the queues (work items and new items)
+        std::int64_t get_queue_length(std::size_t num_thread = std::size_t(-1)) const override
+        {
+            std::int64_t count = base_type::get_queue_length(num_thread);
+            if (std::size_t(-1) != num_thread)
+            {
+                PIKA_ASSERT(num_thread < workers_.size());
+                return count + workers_[num_thread]->size.load(std::memory_order_relaxed);
+            }
+
+            for (auto const& w : workers_) { count += w->size.load(std::memory_order_relaxed); }
+            return count;
+        }
+
+        // Queries whether a given core is idle
+        bool is_core_idle(std::size_t num_thread) const override
+        {
+            return workers_[num_thread]->size.load(std::memory_order_relaxed) == 0 &&
+                base_type::is_core_idle(num_thread);
+        }
+
+        std::int64_t get_num_deadline_misses(std::size_t num_thread, bool reset) override
+        {
+            std::int64_t num_misses = 0;
+            for (std::size_t i = 0; i != workers_.size(); ++i)
+            {
+                if (num_thread != std::size_t(-1) && num_thread != i) { continue; }
+                num_misses += reset ?
+                    workers_[i]->num_deadline_misses.exchange(0, std::memory_order_relaxed) :
+                    workers_[i]->num_deadline_misses.load(std::memory_order_relaxed);
+            }
+            return num_misses;
+        }
+
+    private:
+        // Returns the worker thread given by the hint, or the next worker
+        // thread in round robin order if there is no hint
+        std::size_t select_worker(execution::thread_schedule_hint schedulehint)
+        {
+            std::size_t const num_workers = workers_.size();
+            if (schedulehint.mode == execution::thread_schedule_hint_mode::thread)
+            {
+                return std::size_t(schedulehint.hint) % num_workers;
+            }
+            return this->curr_queue_++ % num_workers;
+        }
+
+        void push(
+            worker_data& w, clock_type::time_point deadline, thread_repr* thrd, bool first_run)
+        {
+            std::lock_guard<Mutex> l(w.mtx);
+            w.heap.push_back(heap_entry{deadline, w.sequence++, thrd, first_run});
+            std::push_heap(w.heap.begin(), w.heap.end(), std::greater<>{});
+            update(w);
+        }
+
+        // Takes the most urgent thread from the heap of w, counting a deadline
+        // miss for the worker thread which runs it if its deadline has passed
+        // and it has not run before
+        bool pop(worker_data& w, worker_data& runner, threads::detail::thread_id_ref_type& thrd)
+        {
+            if (w.size.load(std::memory_order_relaxed) == 0) { return false; }
+
+            clock_type::time_point deadline;
+            bool first_run;
+            {
+                std::lock_guard<Mutex> l(w.mtx);
+                if (w.heap.empty()) { return false; }
+
+                std::pop_heap(w.heap.begin(), w.heap.end(), std::greater<>{});
+                deadline = w.heap.back().deadline;
+                first_run = w.heap.back().first_run;
+                thrd.reset(w.heap.back().thrd, false);    // do not addref!
+                w.heap.pop_back();
+                update(w);
+            }
+
+            if (first_run && deadline < clock_type::now())
+            {
+                runner.num_deadline_misses.fetch_add(1, std::memory_order_relaxed);
+            }
+            return true;
+        }
+
+        // Publishes the deadline of the most urgent thread and the size of
+        // the heap, has to be called with the lock of the heap held
+        static void update(worker_data& w)
+        {
+            w.earliest.store(w.heap.empty() ? no_deadline :
+                                              w.heap.front().deadline.time_since_epoch().count(),
+                std::memory_order_relaxed);
+            w.size.store(std::int64_t(w.heap.size()), std::memory_order_relaxed);
+        }
+
+        // Steals the thread with the earliest deadline out of the heaps of
+        // all other worker threads
+        bool steal_most_urgent(std::size_t num_thread, threads::detail::thread_id_ref_type& thrd)
+        {
+            bool const numa_stealing =
+                this->has_scheduler_mode(scheduler_mode::enable_stealing_numa);
+
+            std::size_t victim = std::size_t(-1);
+            clock_type::rep earliest = no_deadline;
+            for (std::size_t idx = 0; idx != workers_.size(); ++idx)
+            {
+                if (idx == num_thread) { continue; }
+
+                if (!numa_stealing &&
+                    !::pika::threads::detail::test(this->numa_domain_masks_[num_thread],
+                        this->affinity_data_.get_pu_num(idx)))    //-V600
+                {
+                    continue;
+                }
+
+                clock_type::rep const e = workers_[idx]->earliest.load(std::memory_order_relaxed);
+                if (e < earliest)
+                {
+                    earliest = e;
+                    victim = idx;
+                }
+            }
+
+            if (victim == std::size_t(-1) ||
+                !pop(*workers_[victim], *workers_[num_thread], thrd))
+            {
+                return false;
+            }
+
+            this->queues_[victim]->increment_num_stolen_from_pending();
+            this->queues_[num_thread]->increment_num_stolen_to_pending();
+            return true;
+        }
+
+        std::int64_t max_local_thread_count_;
+        std::vector<std::unique_ptr<worker_data>> workers_;
+    };
+}    // namespace pika::threads::detail
+
+template <typename Mutex, typename PendingQueuing, typename StagedQueuing,
+    typename TerminatedQueuing>
+struct fmt::formatter<pika::threads::detail::deadline_queue_scheduler<Mutex, PendingQueuing,
+    StagedQueuing, TerminatedQueuing>> : fmt::formatter<pika::threads::detail::scheduler_base>
+{
+    template <typename FormatContext>
+    auto format(pika::threads::detail::scheduler_base const& scheduler, FormatContext& ctx)
+    {
+        return fmt::formatter<pika::threads::detail::scheduler_base>::format(scheduler, ctx);
+    }
+};
+
+#include <pika/config/warnings_suffix.hpp>
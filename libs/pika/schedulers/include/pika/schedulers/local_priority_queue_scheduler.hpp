@@ -16,6 +16,7 @@
 #include <pika/modules/logging.hpp>
 #include <pika/schedulers/deadlock_detection.hpp>
 #include <pika/schedulers/lockfree_queue_backends.hpp>
+#include <pika/schedulers/stealing_victims.hpp>
 #include <pika/schedulers/thread_queue.hpp>
 #include <pika/threading_base/detail/global_activity_count.hpp>
 #include <pika/threading_base/scheduler_base.hpp>
@@ -23,6 +24,7 @@
 #include <pika/threading_base/thread_num_tss.hpp>
 #include <pika/threading_base/thread_queue_init_parameters.hpp>
 #include <pika/topology/topology.hpp>
+#include <pika/util/get_and_reset_value.hpp>
 
 #include <fmt/format.h>
 
@@ -35,6 +37,7 @@
 #include <mutex>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <pika/config/warnings_prefix.hpp>
@@ -51,6 +54,10 @@ namespace pika::threads::detail {
     /// High priority threads are executed by the first N OS threads before any
     /// other work is executed. Low priority threads are executed by the last
     /// OS thread whenever no other work is available.
+    /// Idle OS threads steal half of the queue of another OS thread at a time.
+    /// Victims are probed by distance (same core, same last level cache, same
+    /// NUMA domain, other NUMA domains), and randomly within each distance so
+    /// that idle OS threads do not all probe the same victims.
     template <typename Mutex = std::mutex, typename PendingQueuing = lockfree_fifo,
         typename StagedQueuing = lockfree_fifo, typename TerminatedQueuing = lockfree_fifo>
     class PIKA_EXPORT local_priority_queue_scheduler : public scheduler_base
@@ -109,7 +116,7 @@ namespace pika::threads::detail {
           , low_priority_queue_(init.num_queues_ - 1, thread_queue_init_)
           , queues_(num_queues_)
           , high_priority_queues_(num_queues_)
-          , victim_threads_(num_queues_)
+          , stealing_data_(num_queues_)
         {
             if (!deferred_initialization)
             {
@@ -381,6 +388,30 @@ namespace pika::threads::detail {
             }
             return num_stolen_threads;
         }
+
+        std::int64_t get_num_steal_successes(std::size_t num_thread, bool reset) override
+        {
+            std::int64_t num_steals = 0;
+            for (std::size_t i = 0; i != num_queues_; ++i)
+            {
+                if (num_thread != std::size_t(-1) && num_thread != i) { continue; }
+                num_steals += ::pika::detail::get_and_reset_value(
+                    stealing_data_[i].data_.num_steal_successes_, reset);
+            }
+            return num_steals;
+        }
+
+        std::int64_t get_num_steal_failures(std::size_t num_thread, bool reset) override
+        {
+            std::int64_t num_steals = 0;
+            for (std::size_t i = 0; i != num_queues_; ++i)
+            {
+                if (num_thread != std::size_t(-1) && num_thread != i) { continue; }
+                num_steals += ::pika::detail::get_and_reset_value(
+                    stealing_data_[i].data_.num_steal_failures_, reset);
+            }
+            return num_steals;
+        }
 #endif
 
         ///////////////////////////////////////////////////////////////////////
@@ -547,27 +578,36 @@ namespace pika::threads::detail {
 #if !defined(PIKA_HAVE_THREAD_SANITIZER)
             if (enable_stealing)
             {
-                for (std::size_t idx : victim_threads_[num_thread].data_)
-                {
-                    PIKA_ASSERT(idx != num_thread);
+                auto pending_queue_length = [&](std::size_t idx) {
+                    return queues_[idx].data_->get_pending_queue_length(std::memory_order_relaxed);
+                };
 
+                auto steal = [&](std::size_t idx) {
                     if (idx < num_high_priority_queues_ && num_thread < num_high_priority_queues_)
                     {
                         thread_queue_type* q = high_priority_queues_[idx].data_;
-                        if (q->get_next_thread(thrd, running, true))
+                        if (std::size_t stolen =
+                                this_high_priority_queue->steal_pending_threads(q, thrd))
                         {
-                            q->increment_num_stolen_from_pending();
-                            this_high_priority_queue->increment_num_stolen_to_pending();
+                            q->increment_num_stolen_from_pending(stolen);
+                            this_high_priority_queue->increment_num_stolen_to_pending(stolen);
                             return true;
                         }
                     }
 
-                    if (queues_[idx].data_->get_next_thread(thrd, running, true))
+                    thread_queue_type* q = queues_[idx].data_;
+                    if (std::size_t stolen = this_queue->steal_pending_threads(q, thrd))
                     {
-                        queues_[idx].data_->increment_num_stolen_from_pending();
-                        this_queue->increment_num_stolen_to_pending();
+                        q->increment_num_stolen_from_pending(stolen);
+                        this_queue->increment_num_stolen_to_pending(stolen);
                         return true;
                     }
+                    return false;
+                };
+
+                if (stealing_data_[num_thread].data_.steal(pending_queue_length, steal))
+                {
+                    return true;
                 }
             }
 
@@ -991,32 +1031,41 @@ namespace pika::threads::detail {
 
             if (enable_stealing)
             {
-                for (std::size_t idx : victim_threads_[num_thread].data_)
-                {
-                    PIKA_ASSERT(idx != num_thread);
+                auto staged_queue_length = [&](std::size_t idx) {
+                    return queues_[idx].data_->get_staged_queue_length(std::memory_order_relaxed);
+                };
 
+                auto steal = [&](std::size_t idx) {
                     if (idx < num_high_priority_queues_ && num_thread < num_high_priority_queues_)
                     {
                         thread_queue_type* q = high_priority_queues_[idx].data_;
-                        result =
-                            this_high_priority_queue->wait_or_add_new(true, added, q) && result;
+                        result = this_high_priority_queue->wait_or_add_new(
+                                     true, added, q, false, true) &&
+                            result;
 
                         if (0 != added)
                         {
                             q->increment_num_stolen_from_staged(added);
                             this_high_priority_queue->increment_num_stolen_to_staged(added);
-                            return result;
+                            return true;
                         }
                     }
 
-                    result = this_queue->wait_or_add_new(true, added, queues_[idx].data_) && result;
+                    thread_queue_type* q = queues_[idx].data_;
+                    result = this_queue->wait_or_add_new(true, added, q, false, true) && result;
 
                     if (0 != added)
                     {
-                        queues_[idx].data_->increment_num_stolen_from_staged(added);
+                        q->increment_num_stolen_from_staged(added);
                         this_queue->increment_num_stolen_to_staged(added);
-                        return result;
+                        return true;
                     }
+                    return false;
+                };
+
+                if (stealing_data_[num_thread].data_.steal(staged_queue_length, steal))
+                {
+                    return result;
                 }
             }
 
@@ -1091,24 +1140,28 @@ namespace pika::threads::detail {
             std::size_t num_threads = num_queues_;
             auto const& topo = ::pika::threads::detail::get_topology();
 
-            // get NUMA domain masks of all queues...
+            // get NUMA domain, cache, and core masks of all queues...
             std::vector<::pika::threads::detail::mask_type> numa_masks(num_threads);
+            std::vector<::pika::threads::detail::mask_type> cache_masks(num_threads);
             std::vector<::pika::threads::detail::mask_type> core_masks(num_threads);
             for (std::size_t i = 0; i != num_threads; ++i)
             {
                 std::size_t num_pu = affinity_data_.get_pu_num(i);
                 numa_masks[i] = topo.get_numa_node_affinity_mask(num_pu);
+                cache_masks[i] = topo.get_cache_affinity_mask(num_pu);
                 core_masks[i] = topo.get_core_affinity_mask(num_pu);
             }
 
             // iterate over the number of threads again to determine where to
             // steal from
             std::ptrdiff_t radius = std::lround(static_cast<double>(num_threads) / 2.0);
-            victim_threads_[num_thread].data_.reserve(num_threads);
+            stealing_victims& sd = stealing_data_[num_thread].data_;
+            sd.reset(num_thread, num_threads);
 
             std::size_t num_pu = affinity_data_.get_pu_num(num_thread);
             ::pika::threads::detail::mask_cref_type pu_mask = topo.get_thread_affinity_mask(num_pu);
             ::pika::threads::detail::mask_cref_type numa_mask = numa_masks[num_thread];
+            ::pika::threads::detail::mask_cref_type cache_mask = cache_masks[num_thread];
             ::pika::threads::detail::mask_cref_type core_mask = core_masks[num_thread];
 
             // we allow the thread on the boundary of the NUMA domain to steal
@@ -1132,19 +1185,17 @@ namespace pika::threads::detail {
                         static_cast<std::ptrdiff_t>(num_threads);
                     if (left < 0) left = static_cast<std::ptrdiff_t>(num_threads) + left;
 
-                    if (f(std::size_t(left)))
-                    {
-                        victim_threads_[num_thread].data_.push_back(static_cast<std::size_t>(left));
-                    }
+                    if (f(std::size_t(left))) { sd.add(static_cast<std::size_t>(left)); }
 
                     std::size_t right = (num_thread + i) % num_threads;
-                    if (f(right)) { victim_threads_[num_thread].data_.push_back(right); }
+                    if (f(right)) { sd.add(right); }
                 }
                 if ((num_threads % 2) == 0)
                 {
                     std::size_t right = (num_thread + i) % num_threads;
-                    if (f(right)) { victim_threads_[num_thread].data_.push_back(right); }
+                    if (f(right)) { sd.add(right); }
                 }
+                sd.end_group();
             };
 
             // check for threads which share the same core...
@@ -1152,9 +1203,17 @@ namespace pika::threads::detail {
                 return ::pika::threads::detail::any(core_mask & core_masks[other_num_thread]);
             });
 
+            // check for threads which share the same last level cache...
+            iterate([&](std::size_t other_num_thread) {
+                return !::pika::threads::detail::any(core_mask & core_masks[other_num_thread]) &&
+                    ::pika::threads::detail::any(cache_mask & cache_masks[other_num_thread]) &&
+                    ::pika::threads::detail::any(numa_mask & numa_masks[other_num_thread]);
+            });
+
             // check for threads which share the same NUMA domain...
             iterate([&](std::size_t other_num_thread) {
                 return !::pika::threads::detail::any(core_mask & core_masks[other_num_thread]) &&
+                    !::pika::threads::detail::any(cache_mask & cache_masks[other_num_thread]) &&
                     ::pika::threads::detail::any(numa_mask & numa_masks[other_num_thread]);
             });
 
@@ -1208,8 +1267,9 @@ namespace pika::threads::detail {
         std::vector<pika::concurrency::detail::cache_line_data<thread_queue_type*>> queues_;
         std::vector<pika::concurrency::detail::cache_line_data<thread_queue_type*>>
             high_priority_queues_;
-        std::vector<pika::concurrency::detail::cache_line_data<std::vector<std::size_t>>>
-            victim_threads_;
+
+        // The victims of each OS thread
+        std::vector<pika::concurrency::detail::cache_line_data<stealing_victims>> stealing_data_;
     };
 }    // namespace pika::threads::detail
 
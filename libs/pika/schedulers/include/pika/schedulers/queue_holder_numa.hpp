@@ -141,6 +141,66 @@ namespace pika::threads::detail {
             return false;
         }
 
+        // ----------------------------------------------------------------
+        // steal up to half of the ready HP threads of queue qidx, the
+        // remaining stolen threads are moved to the receiver
+        bool steal_next_thread_HP(
+            ThreadQueue* receiver, std::size_t qidx, threads::detail::thread_id_ref_type& thrd)
+        {
+            std::size_t const stolen = receiver->steal_next_threads_HP(queues_[qidx], thrd);
+            if (stolen == 0) return false;
+
+            pika::detail::nq_deb.debug(debug::detail::str<>("HP steal_next"), "stolen",
+                debug::detail::dec<>(stolen), "D", debug::detail::dec<2>(domain_), "Q",
+                debug::detail::dec<3>(qidx), typename ThreadQueue::queue_data_print(queues_[qidx]),
+                debug::detail::threadinfo<threads::detail::thread_id_ref_type*>(&thrd));
+            return true;
+        }
+
+        // ----------------------------------------------------------------
+        // steal up to half of the ready NP/LP threads of queue qidx, the
+        // remaining stolen threads are moved to the receiver
+        bool steal_next_thread(
+            ThreadQueue* receiver, std::size_t qidx, threads::detail::thread_id_ref_type& thrd)
+        {
+            std::size_t const stolen = receiver->steal_next_threads(queues_[qidx], thrd);
+            if (stolen == 0) return false;
+
+            pika::detail::nq_deb.debug(debug::detail::str<>("steal_next"), "stolen",
+                debug::detail::dec<>(stolen), "D", debug::detail::dec<2>(domain_), "Q",
+                debug::detail::dec<3>(qidx), typename ThreadQueue::queue_data_print(queues_[qidx]),
+                debug::detail::threadinfo<threads::detail::thread_id_ref_type*>(&thrd));
+            return true;
+        }
+
+        // ----------------------------------------------------------------
+        // convert up to half of the staged HP tasks of queue qidx into
+        // threads on the receiver
+        bool steal_new_HP(ThreadQueue* receiver, std::size_t qidx, std::size_t& added)
+        {
+            added = receiver->steal_new_HP(queues_[qidx]);
+            if (added == 0) return false;
+
+            pika::detail::nq_deb.debug(debug::detail::str<>("HP steal_new"), "added",
+                debug::detail::dec<>(added), "D", debug::detail::dec<2>(domain_), "Q",
+                debug::detail::dec<3>(qidx), typename ThreadQueue::queue_data_print(queues_[qidx]));
+            return true;
+        }
+
+        // ----------------------------------------------------------------
+        // convert up to half of the staged NP/LP tasks of queue qidx into
+        // threads on the receiver
+        bool steal_new(ThreadQueue* receiver, std::size_t qidx, std::size_t& added)
+        {
+            added = receiver->steal_new(queues_[qidx]);
+            if (added == 0) return false;
+
+            pika::detail::nq_deb.debug(debug::detail::str<>("steal_new"), "added",
+                debug::detail::dec<>(added), "D", debug::detail::dec<2>(domain_), "Q",
+                debug::detail::dec<3>(qidx), typename ThreadQueue::queue_data_print(queues_[qidx]));
+            return true;
+        }
+
         // ----------------------------------------------------------------
         bool add_new_HP(ThreadQueue* receiver, std::size_t qidx, std::size_t& added, bool stealing,
             bool allow_stealing)
@@ -20,6 +20,7 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cmath>
 #include <cstddef>
@@ -522,6 +523,13 @@ namespace pika::threads::detail {
         // ----------------------------------------------------------------
         static void deallocate(threads::detail::thread_data* p) { p->destroy(); }
 
+        // ----------------------------------------------------------------
+        // half of the staged tasks of a queue, but at least one
+        static std::int64_t half_staged(QueueType* q)
+        {
+            return (std::max)(std::int64_t(1), std::int64_t(q->get_queue_length_staged() / 2));
+        }
+
         // ----------------------------------------------------------------
         void add_to_thread_map(threads::detail::thread_id_type tid)
         {
@@ -671,6 +679,57 @@ namespace pika::threads::detail {
             return 0;
         }
 
+        // ----------------------------------------------------------------
+        // steal up to half of the ready HP threads of the victim, bound
+        // threads are never stolen
+        std::size_t steal_next_threads_HP(
+            thread_holder_type* victim, threads::detail::thread_id_ref_type& thrd)
+        {
+            if (!hp_queue_) return 0;
+            return hp_queue_->steal_next_threads(victim->hp_queue_, thrd);
+        }
+
+        // ----------------------------------------------------------------
+        // steal up to half of the ready NP or LP threads of the victim
+        std::size_t steal_next_threads(
+            thread_holder_type* victim, threads::detail::thread_id_ref_type& thrd)
+        {
+            std::size_t stolen = np_queue_->steal_next_threads(victim->np_queue_, thrd);
+            if (stolen > 0) return stolen;
+
+            if (lp_queue_) { stolen = lp_queue_->steal_next_threads(victim->lp_queue_, thrd); }
+            return stolen;
+        }
+
+        // ----------------------------------------------------------------
+        // convert up to half of the staged HP tasks of the victim into
+        // threads on our own queue
+        std::size_t steal_new_HP(thread_holder_type* victim)
+        {
+            if (!owns_hp_queue()) return 0;
+            return hp_queue_->add_new(half_staged(victim->hp_queue_), victim->hp_queue_, true);
+        }
+
+        // ----------------------------------------------------------------
+        // convert up to half of the staged NP or LP tasks of the victim into
+        // threads on our own queues
+        std::size_t steal_new(thread_holder_type* victim)
+        {
+            std::size_t added;
+            if (owns_np_queue())
+            {
+                added = np_queue_->add_new(half_staged(victim->np_queue_), victim->np_queue_, true);
+                if (added > 0) return added;
+            }
+
+            if (owns_lp_queue())
+            {
+                added = lp_queue_->add_new(half_staged(victim->lp_queue_), victim->lp_queue_, true);
+                if (added > 0) return added;
+            }
+            return 0;
+        }
+
         // ----------------------------------------------------------------
         inline std::size_t get_queue_length()
         {
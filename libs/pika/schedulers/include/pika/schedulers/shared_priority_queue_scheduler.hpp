@@ -12,12 +12,14 @@
 
 #include <pika/config.hpp>
 #include <pika/assert.hpp>
+#include <pika/concurrency/cache_line_data.hpp>
 #include <pika/debugging/print.hpp>
 #include <pika/execution_base/this_thread.hpp>
 #include <pika/functional/function.hpp>
 #include <pika/modules/errors.hpp>
 #include <pika/schedulers/queue_holder_numa.hpp>
 #include <pika/schedulers/queue_holder_thread.hpp>
+#include <pika/schedulers/stealing_victims.hpp>
 #include <pika/schedulers/thread_queue_mc.hpp>
 #include <pika/threading_base/detail/global_activity_count.hpp>
 #include <pika/threading_base/print.hpp>
@@ -26,6 +28,7 @@
 #include <pika/threading_base/thread_num_tss.hpp>
 #include <pika/threading_base/thread_queue_init_parameters.hpp>
 #include <pika/topology/topology.hpp>
+#include <pika/util/get_and_reset_value.hpp>
 
 #include <fmt/format.h>
 
@@ -137,6 +140,7 @@ namespace pika::threads::detail {
 
         explicit shared_priority_queue_scheduler(init_parameter const& init)
           : scheduler_base(init.num_worker_threads_, init.description_, init.thread_queue_init_)
+          , stealing_data_(init.num_worker_threads_)
           , d_lookup_(pika::threads::detail::hardware_concurrency())
           , q_lookup_(pika::threads::detail::hardware_concurrency())
 #ifdef PIKA_DETAIL_SHARED_PRIORITY_SCHEDULER_LINUX
@@ -420,141 +424,77 @@ namespace pika::threads::detail {
         /// to be tweaked according to needs.
         /// One is called for high priority tasks, the other for normal/low
         /// since high priority tasks on other queues take precedence to
-        /// local tasks of lower priority
+        /// local tasks of lower priority.
+        /// The function objects are called with stealing == false for the
+        /// queues of this thread, and with stealing == true to steal from
+        /// the queues of one victim into the receiver. Victims are probed
+        /// by distance, see stealing_victims.
         template <typename T>
         // NOLINTBEGIN(bugprone-easily-swappable-parameters)
         bool steal_by_function(std::size_t domain, std::size_t q_index, bool steal_numa,
-            bool steal_core, thread_holder_type* origin, T& var, const char* prefix,
-            util::detail::function<bool(
-                std::size_t, std::size_t, thread_holder_type*, T&, bool, bool)>
+            bool steal_core, thread_holder_type* receiver, T& var, const char* prefix,
+            util::detail::function<bool(std::size_t, std::size_t, thread_holder_type*, T&, bool)>
                 operation_HP,
-            util::detail::function<bool(
-                std::size_t, std::size_t, thread_holder_type*, T&, bool, bool)>
+            util::detail::function<bool(std::size_t, std::size_t, thread_holder_type*, T&, bool)>
                 operation)
         // NOLINTEND(bugprone-easily-swappable-parameters)
         {
             using namespace pika::debug::detail;
-            bool result;
 
-            // All stealing disabled
-            if (!steal_core)
+            // try the queues on this thread first, in order BP,HP,NP,LP, unless
+            // high priority tasks of other threads take precedence
+            bool const local_first = !steal_core || !steal_hp_first_;
+            if (local_first &&
+                (operation_HP(domain, q_index, receiver, var, false) ||
+                    operation(domain, q_index, receiver, var, false)))
             {
-                // try only the queues on this thread, in order BP,HP,NP,LP
-                result = operation_HP(domain, q_index, origin, var, false, false);
-                result = result || operation(domain, q_index, origin, var, false, false);
-                if (result)
-                {
-                    PIKA_DETAIL_DP(spq_deb<7>,
-                        debug(str<>(prefix), "local no stealing", "D", dec<2>(domain), "Q",
-                            dec<3>(q_index)));
-                    return result;
-                }
+                PIKA_DETAIL_DP(spq_deb<7>,
+                    debug(str<>(prefix), "local taken", "D", dec<2>(domain), "Q", dec<3>(q_index)));
+                return true;
             }
-            // High priority tasks first
-            else if (steal_hp_first_)
+
+            // All stealing disabled
+            if (!steal_core) return false;
+
+            // the victims of other numa domains are in the last group
+            std::size_t const max_groups = steal_numa ? std::size_t(-1) : victim_groups_numa;
+            stealing_victims& victims = stealing_data_[local_thread_number()].data_;
+
+            auto queue_length = [&](std::size_t victim) {
+                return numa_holder_[d_lookup_[victim]]
+                    .thread_queue(q_lookup_[victim])
+                    ->get_queue_length();
+            };
+            auto steal_HP = [&](std::size_t victim) {
+                return operation_HP(d_lookup_[victim], q_lookup_[victim], receiver, var, true);
+            };
+            auto steal = [&](std::size_t victim) {
+                return operation(d_lookup_[victim], q_lookup_[victim], receiver, var, true);
+            };
+
+            bool result;
+            if (steal_hp_first_)
             {
-                for (std::size_t d = 0; d < num_domains_; ++d)
-                {
-                    std::size_t dom = fast_mod(domain + d, num_domains_);
-                    q_index = fast_mod(q_index, q_counts_[dom]);
-                    result = operation_HP(dom, q_index, origin, var, (d > 0), true);
-                    if (result)
-                    {
-                        PIKA_DETAIL_DP(spq_deb<5>,
-                            debug(str<>(prefix), "scheduler_mode::steal_high_priority_first BP/HP",
-                                (d == 0 ? "taken" : "stolen"), "D", dec<2>(domain), "Q",
-                                dec<3>(q_index)));
-                        return result;
-                    }
-                    // if no numa stealing, skip other domains
-                    if (!steal_numa) break;
-                }
-                for (std::size_t d = 0; d < num_domains_; ++d)
-                {
-                    std::size_t dom = fast_mod(domain + d, num_domains_);
-                    q_index = fast_mod(q_index, q_counts_[dom]);
-                    result = operation(dom, q_index, origin, var, (d > 0), true);
-                    if (result)
-                    {
-                        PIKA_DETAIL_DP(spq_deb<5>,
-                            debug(str<>(prefix), "scheduler_mode::steal_high_priority_first NP/LP",
-                                (d == 0 ? "taken" : "stolen"), "D", dec<2>(domain), "Q",
-                                dec<3>(q_index)));
-                        return result;
-                    }
-                    // if no numa stealing, skip other domains
-                    if (!steal_numa) break;
-                }
+                result = operation_HP(domain, q_index, receiver, var, false) ||
+                    victims.steal(queue_length, steal_HP, max_groups) ||
+                    operation(domain, q_index, receiver, var, false) ||
+                    victims.steal(queue_length, steal, max_groups);
             }
             else /*scheduler_mode::steal_after_local*/
             {
-                // do this local core/queue
-                result = operation_HP(domain, q_index, origin, var, false, false);
-                result = result || operation(domain, q_index, origin, var, false, false);
-                if (result)
-                {
-                    PIKA_DETAIL_DP(spq_deb<5>,
-                        debug(str<>(prefix), "scheduler_mode::steal_after_local local taken", "D",
-                            dec<2>(domain), "Q", dec<3>(q_index)));
-                    return result;
-                }
-
-                if (steal_core)
-                {
-                    if (q_counts_[domain] > 1)
-                    {
-                        // steal from other cores on this numa domain?
-                        // use q+1 to avoid testing the same local queue again
-                        q_index = fast_mod((q_index + 1), q_counts_[domain]);
-                        result = operation_HP(domain, q_index, origin, var, true, true);
-                        result = result || operation(domain, q_index, origin, var, true, true);
-                        if (result)
-                        {
-                            PIKA_DETAIL_DP(spq_deb<5>,
-                                debug(str<>(prefix), "scheduler_mode::steal_after_local this numa",
-                                    "stolen", "D", dec<2>(domain), "Q", dec<3>(q_index)));
-                            return result;
-                        }
-                    }
-                }
+                result = victims.steal(
+                    queue_length,
+                    [&](std::size_t victim) { return steal_HP(victim) || steal(victim); },
+                    max_groups);
+            }
 
-                if (steal_numa)
-                {
-                    // try other numa domains BP/HP
-                    for (std::size_t d = 1; d < num_domains_; ++d)
-                    {
-                        std::size_t dom = fast_mod(domain + d, num_domains_);
-                        q_index = fast_mod(q_index, q_counts_[dom]);
-                        result = operation_HP(dom, q_index, origin, var, true, true);
-                        if (result)
-                        {
-                            PIKA_DETAIL_DP(spq_deb<5>,
-                                debug(str<>(prefix),
-                                    "scheduler_mode::steal_after_local other numa BP/HP",
-                                    (d == 0 ? "taken" : "stolen"), "D", dec<2>(domain), "Q",
-                                    dec<3>(q_index)));
-                            return result;
-                        }
-                    }
-                    // try other numa domains NP/LP
-                    for (std::size_t d = 1; d < num_domains_; ++d)
-                    {
-                        std::size_t dom = fast_mod(domain + d, num_domains_);
-                        q_index = fast_mod(q_index, q_counts_[dom]);
-                        result = operation(dom, q_index, origin, var, true, true);
-                        if (result)
-                        {
-                            PIKA_DETAIL_DP(spq_deb<5>,
-                                debug(str<>(prefix),
-                                    "scheduler_mode::steal_after_local other numa NP/LP",
-                                    (d == 0 ? "taken" : "stolen"), "D", dec<2>(domain), "Q",
-                                    dec<3>(q_index)));
-                            return result;
-                        }
-                    }
-                }
+            if (result)
+            {
+                PIKA_DETAIL_DP(spq_deb<5>,
+                    debug(str<>(prefix), steal_hp_first_ ? "steal_hp_first" : "steal_after_local",
+                        "D", dec<2>(domain), "Q", dec<3>(q_index)));
             }
-            return false;
+            return result;
         }
 
         /// Return the next thread to be executed,
@@ -579,27 +519,34 @@ namespace pika::threads::detail {
             PIKA_DETAIL_DP(spq_deb<5>, timed(getnext, dec<>(this_thread)));
 
             auto get_next_thread_function_HP =
-                [&](std::size_t domain, std::size_t q_index, thread_holder_type* /* receiver */,
-                    threads::detail::thread_id_ref_type& thrd, bool stealing, bool allow_stealing) {
-                    return numa_holder_[domain].get_next_thread_HP(
-                        q_index, thrd, stealing, allow_stealing);
+                [&](std::size_t domain, std::size_t q_index, thread_holder_type* receiver,
+                    threads::detail::thread_id_ref_type& thrd, bool stealing) {
+                    if (stealing)
+                    {
+                        return numa_holder_[domain].steal_next_thread_HP(receiver, q_index, thrd);
+                    }
+                    return numa_holder_[domain].get_next_thread_HP(q_index, thrd, false, false);
                 };
 
             auto get_next_thread_function =
-                [&](std::size_t domain, std::size_t q_index, thread_holder_type* /* receiver */,
-                    threads::detail::thread_id_ref_type& thrd, bool stealing, bool allow_stealing) {
-                    return numa_holder_[domain].get_next_thread(
-                        q_index, thrd, stealing, allow_stealing);
+                [&](std::size_t domain, std::size_t q_index, thread_holder_type* receiver,
+                    threads::detail::thread_id_ref_type& thrd, bool stealing) {
+                    if (stealing)
+                    {
+                        return numa_holder_[domain].steal_next_thread(receiver, q_index, thrd);
+                    }
+                    return numa_holder_[domain].get_next_thread(q_index, thrd, false, false);
                 };
 
             std::size_t domain = d_lookup_[this_thread];
             std::size_t q_index = q_lookup_[this_thread];
+            thread_holder_type* receiver = numa_holder_[domain].queues_[q_index];
 
             // first try a high priority task, allow stealing
             // if stealing of HP tasks is 'on', this will be fine
             // but send a null function for normal tasks
             bool result = steal_by_function<threads::detail::thread_id_ref_type>(domain, q_index,
-                numa_stealing_, core_stealing_, nullptr, thrd, "SBF-get_next_thread",
+                numa_stealing_, core_stealing_, receiver, thrd, "SBF-get_next_thread",
                 get_next_thread_function_HP, get_next_thread_function);
 
             if (result) return result;
@@ -634,16 +581,19 @@ namespace pika::threads::detail {
 
             auto add_new_function_HP = [&](std::size_t domain, std::size_t q_index,
                                            thread_holder_type* receiver, std::size_t& added,
-                                           bool stealing, bool allow_stealing) {
-                return numa_holder_[domain].add_new_HP(
-                    receiver, q_index, added, stealing, allow_stealing);
+                                           bool stealing) {
+                if (stealing)
+                {
+                    return numa_holder_[domain].steal_new_HP(receiver, q_index, added);
+                }
+                return numa_holder_[domain].add_new_HP(receiver, q_index, added, false, false);
             };
 
             auto add_new_function = [&](std::size_t domain, std::size_t q_index,
                                         thread_holder_type* receiver, std::size_t& added,
-                                        bool stealing, bool allow_stealing) {
-                return numa_holder_[domain].add_new(
-                    receiver, q_index, added, stealing, allow_stealing);
+                                        bool stealing) {
+                if (stealing) { return numa_holder_[domain].steal_new(receiver, q_index, added); }
+                return numa_holder_[domain].add_new(receiver, q_index, added, false, false);
             };
 
             std::size_t domain = d_lookup_[this_thread];
@@ -1147,6 +1097,36 @@ namespace pika::threads::detail {
                 std::this_thread::yield();
             }
 
+            // the victims for stealing, grouped by distance: the threads
+            // sharing a cache on this numa domain, the other threads on this
+            // numa domain, and the threads on other numa domains
+            auto pu_num = [&](std::size_t local_id) {
+                return affinity_data_.get_pu_num(local_to_global_thread_index(local_id));
+            };
+            mask_type const cache_mask = topo.get_cache_affinity_mask(pu_num(local_thread));
+            std::vector<bool> shares_cache(num_workers_);
+            for (std::size_t local_id = 0; local_id != num_workers_; ++local_id)
+            {
+                shares_cache[local_id] = ::pika::threads::detail::any(
+                    cache_mask & topo.get_cache_affinity_mask(pu_num(local_id)));
+            }
+
+            std::size_t const domain = d_lookup_[local_thread];
+            stealing_victims& victims = stealing_data_[local_thread].data_;
+            victims.reset(local_thread, num_workers_);
+            for (int group = 0; group != victim_groups_numa + 1; ++group)
+            {
+                for (std::size_t local_id = 0; local_id != num_workers_; ++local_id)
+                {
+                    if (local_id == local_thread) continue;
+
+                    int const victim_group =
+                        d_lookup_[local_id] != domain ? 2 : (shares_cache[local_id] ? 0 : 1);
+                    if (victim_group == group) { victims.add(local_id); }
+                }
+                victims.end_group();
+            }
+
             lock.lock();
             if (!debug_init_)
             {
@@ -1204,6 +1184,30 @@ namespace pika::threads::detail {
 #endif
 
 #ifdef PIKA_HAVE_THREAD_STEALING_COUNTS
+        std::int64_t get_num_steal_successes(std::size_t num_thread, bool reset) override
+        {
+            std::int64_t num_steals = 0;
+            for (std::size_t i = 0; i != num_workers_; ++i)
+            {
+                if (num_thread != std::size_t(-1) && num_thread != i) { continue; }
+                num_steals += ::pika::detail::get_and_reset_value(
+                    stealing_data_[i].data_.num_steal_successes_, reset);
+            }
+            return num_steals;
+        }
+
+        std::int64_t get_num_steal_failures(std::size_t num_thread, bool reset) override
+        {
+            std::int64_t num_steals = 0;
+            for (std::size_t i = 0; i != num_workers_; ++i)
+            {
+                if (num_thread != std::size_t(-1) && num_thread != i) { continue; }
+                num_steals += ::pika::detail::get_and_reset_value(
+                    stealing_data_[i].data_.num_steal_failures_, reset);
+            }
+            return num_steals;
+        }
+
         std::int64_t get_num_pending_misses(std::size_t /* num */, bool /* reset */) override
         {
             PIKA_THROW_EXCEPTION(pika::error::invalid_status,
@@ -1290,6 +1294,11 @@ namespace pika::threads::detail {
         // one item per numa domain of a container for queues on that domain
         std::array<numa_queues, PIKA_HAVE_MAX_NUMA_DOMAIN_COUNT> numa_holder_;
 
+        // the victims of each worker thread, the victims on other numa
+        // domains are in the last of the groups
+        static constexpr int victim_groups_numa = 2;
+        std::vector<pika::concurrency::detail::cache_line_data<stealing_victims>> stealing_data_;
+
         // lookups for local thread_num into arrays
         std::vector<std::size_t> d_lookup_;    // numa domain
         std::vector<std::size_t> q_lookup_;    // queue on domain
@@ -60,6 +60,8 @@ namespace pika::threads::detail {
             // this scheduler does not support stealing or numa stealing
             mode = scheduler_mode(mode & ~scheduler_mode::enable_stealing);
             mode = scheduler_mode(mode & ~scheduler_mode::enable_stealing_numa);
+            // threads are resumed on the worker thread they were suspended on
+            mode = scheduler_mode(mode & ~scheduler_mode::enable_next_thread_slot);
             scheduler_base::set_scheduler_mode(mode);
         }
 
@@ -0,0 +1,115 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace pika::threads::detail {
+    /// The victims of a worker thread, grouped by distance from the closest to
+    /// the furthest. Victims are identified by an index which is interpreted
+    /// by the scheduler. steal probes one group at a time. Within a group the
+    /// victim with the longer queue out of two random choices is probed first
+    /// (power of two choices), followed by the remaining victims of the group
+    /// starting at a random offset, so that idle worker threads do not all
+    /// probe the same victims.
+    ///
+    /// Only the owning worker thread may call reset, add, end_group, and
+    /// steal.
+    struct stealing_victims
+    {
+        void reset(std::size_t num_thread, std::size_t max_victims)
+        {
+            victims_.clear();
+            victims_.reserve(max_victims);
+            group_ends_.clear();
+            random_state_ = 0x9e37'79b9'7f4a'7c15ull * (num_thread + 1);
+        }
+
+        void add(std::size_t victim) { victims_.push_back(victim); }
+
+        // Ends the current group, empty groups are allowed
+        void end_group() { group_ends_.push_back(victims_.size()); }
+
+        // Calls steal with the victims of the first max_groups groups until it
+        // returns true. queue_length returns the queue length of a victim used
+        // for the power of two choices.
+        template <typename QueueLength, typename Steal>
+        bool steal(QueueLength&& queue_length, Steal&& steal,
+            std::size_t max_groups = std::size_t(-1))
+        {
+            auto probe = [&](std::size_t victim) {
+                bool const stolen = steal(victim);
+#ifdef PIKA_HAVE_THREAD_STEALING_COUNTS
+                (stolen ? num_steal_successes_ : num_steal_failures_)
+                    .fetch_add(1, std::memory_order_relaxed);
+#endif
+                return stolen;
+            };
+
+            std::size_t begin = 0;
+            std::size_t const num_groups = (std::min)(max_groups, group_ends_.size());
+            for (std::size_t g = 0; g != num_groups; ++g)
+            {
+                std::size_t const end = group_ends_[g];
+                std::size_t const n = end - begin;
+                std::size_t const* victims = victims_.data() + begin;
+                begin = end;
+
+                if (n == 0) { continue; }
+
+                std::size_t first = random() % n;
+                std::size_t second = first;
+                if (n > 1)
+                {
+                    second = (first + 1 + random() % (n - 1)) % n;
+                    if (queue_length(victims[second]) > queue_length(victims[first]))
+                    {
+                        std::swap(first, second);
+                    }
+                }
+
+                if (probe(victims[first])) { return true; }
+                if (second != first && probe(victims[second])) { return true; }
+
+                for (std::size_t i = 1; i != n; ++i)
+                {
+                    std::size_t const j = (first + i) % n;
+                    if (j != second && probe(victims[j])) { return true; }
+                }
+            }
+
+            return false;
+        }
+
+#ifdef PIKA_HAVE_THREAD_STEALING_COUNTS
+        std::atomic<std::int64_t> num_steal_successes_{0};
+        std::atomic<std::int64_t> num_steal_failures_{0};
+#endif
+
+    private:
+        std::size_t random() noexcept
+        {
+            // xorshift64
+            random_state_ ^= random_state_ << 13;
+            random_state_ ^= random_state_ >> 7;
+            random_state_ ^= random_state_ << 17;
+            return static_cast<std::size_t>(random_state_);
+        }
+
+        std::vector<std::size_t> victims_;
+        std::vector<std::size_t> group_ends_;
+        std::uint64_t random_state_ = 1;
+    };
+}    // namespace pika::threads::detail
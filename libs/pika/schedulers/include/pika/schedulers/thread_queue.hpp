@@ -18,11 +18,13 @@
 #include <pika/schedulers/maintain_queue_wait_times.hpp>
 #include <pika/schedulers/queue_helpers.hpp>
 #include <pika/thread_support/unlock_guard.hpp>
+#include <pika/threading_base/detail/thread_data_cache.hpp>
 #include <pika/threading_base/scheduler_base.hpp>
 #include <pika/threading_base/thread_data.hpp>
 #include <pika/threading_base/thread_data_stackful.hpp>
 #include <pika/threading_base/thread_data_stackless.hpp>
 #include <pika/threading_base/thread_queue_init_parameters.hpp>
+#include <pika/topology/topology.hpp>
 #include <pika/util/get_and_reset_value.hpp>
 
 #ifdef PIKA_HAVE_THREAD_CREATION_AND_CLEANUP_RATES
@@ -31,6 +33,7 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstddef>
@@ -154,18 +157,29 @@ namespace pika::threads::detail {
             // ASAN gets confused by reusing threads/stacks
 # if !defined(PIKA_HAVE_ADDRESS_SANITIZER)
 
-            // Check for an unused thread object.
+            // Check for an unused thread object, refilling the magazine from
+            // the depot of our NUMA domain if it is empty.
+            if (heap->empty()) { refill_thread_heap(*heap, stacksize); }
+
             if (!heap->empty())
             {
                 // Take ownership of the thread object and rebind it.
                 thrd = heap->back();
                 heap->pop_back();
-                threads::detail::get_thread_id_data(thrd)->rebind(data);
+
+                auto* p = threads::detail::get_thread_id_data(thrd);
+                p->set_queue(this);
+                p->rebind(data);
+
+                thread_cache_->record_hit(numa_domain_);
             }
             else
 # endif
 #endif
             {
+#if defined(PIKA_HAVE_THREAD_STACK_MMAP) && !defined(PIKA_HAVE_ADDRESS_SANITIZER)
+                thread_cache_->record_miss(numa_domain_);
+#endif
                 pika::detail::unlock_guard<Lock> ull(lk);
 
                 // Allocate a new thread object.
@@ -251,7 +265,7 @@ namespace pika::threads::detail {
 
         ///////////////////////////////////////////////////////////////////////
         bool add_new_always(std::size_t& added, thread_queue* addfrom,
-            std::unique_lock<mutex_type>& lk, bool steal = false)
+            std::unique_lock<mutex_type>& lk, bool steal = false, bool steal_half = false)
         {
             PIKA_ASSERT(lk.owns_lock());
 
@@ -288,6 +302,23 @@ namespace pika::threads::detail {
                 else { return false; }
             }
 
+            // if requested, take up to half of the staged tasks of the other
+            // queue at once (as far as max_thread_count allows) so that the
+            // thief does not have to come back for every max_add_new_count
+            // tasks
+            if (steal_half && addfrom != this)
+            {
+                std::int64_t const half = (std::max)(std::int64_t(1),
+                    addfrom->new_tasks_count_.data_.load(std::memory_order_relaxed) / 2);
+                if (add_count < 0) { add_count = half; }
+                else
+                {
+                    std::int64_t const room = parameters_.max_thread_count_ -
+                        static_cast<std::int64_t>(thread_map_.size());
+                    add_count = (std::min)(half, (std::max)(add_count, room));
+                }
+            }
+
             std::size_t addednew = add_new(add_count, addfrom, lk, steal);
             added += addednew;
             return addednew != 0;
@@ -298,24 +329,39 @@ namespace pika::threads::detail {
         {
             std::ptrdiff_t stacksize = threads::detail::get_thread_id_data(thrd)->get_stack_size();
 
-            if (stacksize == parameters_.small_stacksize_) { thread_heap_small_.push_back(thrd); }
-            else if (stacksize == parameters_.medium_stacksize_)
-            {
-                thread_heap_medium_.push_back(thrd);
-            }
-            else if (stacksize == parameters_.large_stacksize_)
-            {
-                thread_heap_large_.push_back(thrd);
-            }
-            else if (stacksize == parameters_.huge_stacksize_)
+            thread_heap_type* heap = nullptr;
+            if (stacksize == parameters_.small_stacksize_) { heap = &thread_heap_small_; }
+            else if (stacksize == parameters_.medium_stacksize_) { heap = &thread_heap_medium_; }
+            else if (stacksize == parameters_.large_stacksize_) { heap = &thread_heap_large_; }
+            else if (stacksize == parameters_.huge_stacksize_) { heap = &thread_heap_huge_; }
+            else if (stacksize == parameters_.nostack_stacksize_) { heap = &thread_heap_nostack_; }
+            else
             {
-                thread_heap_huge_.push_back(thrd);
+                PIKA_ASSERT_MSG(false, fmt::format("Invalid stack size {}", stacksize));
+                return;
             }
-            else if (stacksize == parameters_.nostack_stacksize_)
+
+            heap->push_back(thrd);
+
+            // Hand the least recently used half of a full magazine over to the
+            // depot so that other queues can reuse the objects
+            std::size_t const magazine_size = thread_cache_->get_magazine_size();
+            if (heap->size() > magazine_size)
             {
-                thread_heap_nostack_.push_back(thrd);
+                std::size_t const count = heap->size() - magazine_size / 2;
+                thread_cache_->give(numa_domain_, stacksize, heap->data(), count);
+                heap->erase(heap->begin(), heap->begin() + count);
             }
-            else { PIKA_ASSERT_MSG(false, fmt::format("Invalid stack size {}", stacksize)); }
+        }
+
+        void refill_thread_heap(thread_heap_type& heap, std::ptrdiff_t stacksize)
+        {
+            PIKA_ASSERT(heap.empty());
+
+            std::size_t const count =
+                (std::max)(thread_cache_->get_magazine_size() / 2, std::size_t(1));
+            heap.resize(count);
+            heap.resize(thread_cache_->take(numa_domain_, stacksize, heap.data(), count));
         }
 #endif
 
@@ -392,6 +438,10 @@ namespace pika::threads::detail {
         bool cleanup_terminated(bool delete_all = false)
         {
 #ifdef PIKA_HAVE_THREAD_STACK_MMAP
+            // This is called with delete_all set from the idle path of the
+            // scheduling loop
+            if (delete_all) { thread_cache_->trim_if_due(); }
+
             if (terminated_items_count_.load(std::memory_order_acquire) == 0) return true;
 
             if (delete_all)
@@ -435,6 +485,9 @@ namespace pika::threads::detail {
           , thread_heap_large_()
           , thread_heap_huge_()
           , thread_heap_nostack_()
+          , thread_cache_(
+                threads::detail::thread_data_cache::get(make_cache_parameters(parameters)))
+          , numa_domain_(0)
 #ifdef PIKA_HAVE_THREAD_CREATION_AND_CLEANUP_RATES
           , add_new_time_(0)
           , cleanup_terminated_time_(0)
@@ -454,6 +507,22 @@ namespace pika::threads::detail {
 
         static void deallocate(threads::detail::thread_data* p) { p->destroy(); }
 
+        static threads::detail::thread_data_cache::parameters make_cache_parameters(
+            thread_queue_init_parameters const& parameters)
+        {
+            threads::detail::thread_data_cache::parameters params;
+            params.magazine_size = static_cast<std::size_t>(
+                (std::max)(parameters.stack_cache_magazine_size_, std::int64_t(1)));
+            if (parameters.stack_cache_high_water_mark_ >= 0)
+            {
+                params.high_water_mark =
+                    static_cast<std::size_t>(parameters.stack_cache_high_water_mark_);
+            }
+            params.trim_interval = std::chrono::milliseconds(
+                (std::max)(parameters.stack_cache_trim_interval_, std::int64_t(0)));
+            return params;
+        }
+
         ~thread_queue()
         {
             for (auto t : thread_heap_small_) deallocate(threads::detail::get_thread_id_data(t));
@@ -585,6 +654,41 @@ namespace pika::threads::detail {
         constexpr void increment_num_stolen_to_staged(std::size_t /* num */ = 1) {}
 #endif
 
+        ///////////////////////////////////////////////////////////////////////
+        // Create a new thread object and add it to the map of threads without
+        // scheduling it. This is used by schedulers which keep runnable threads
+        // in their own queues. Returns false if the thread could not be
+        // created.
+        bool create_thread_now(threads::detail::thread_init_data& data,
+            threads::detail::thread_id_ref_type& thrd, error_code& ec)
+        {
+            // The mutex can not be locked while a new thread is getting
+            // created, as it might have that the current pika thread gets
+            // suspended.
+            std::unique_lock<mutex_type> lk(mtx_);
+
+            create_thread_object(thrd, data, lk);
+
+            // add a new entry in the map for this thread
+            std::pair<thread_map_type::iterator, bool> p = thread_map_.insert(thrd.noref());
+
+            if (PIKA_UNLIKELY(!p.second))
+            {
+                lk.unlock();
+                PIKA_THROWS_IF(ec, pika::error::out_of_memory, "thread_queue::create_thread",
+                    "Couldn't add new thread to the map of threads");
+                return false;
+            }
+            ++thread_map_count_;
+
+            // this thread has to be in the map now
+            PIKA_ASSERT(thread_map_.find(thrd.noref()) != thread_map_.end());
+            PIKA_ASSERT(
+                &threads::detail::get_thread_id_data(thrd)->get_queue<thread_queue>() == this);
+
+            return true;
+        }
+
         ///////////////////////////////////////////////////////////////////////
         // create a new thread and schedule it if the initial state is equal to
         // pending
@@ -603,57 +707,30 @@ namespace pika::threads::detail {
 
             if (data.run_now)
             {
+                bool schedule_now =
+                    data.initial_state == threads::detail::thread_schedule_state::pending;
+
                 threads::detail::thread_id_ref_type thrd;
+                if (!create_thread_now(data, thrd, ec)) { return; }
 
-                // The mutex can not be locked while a new thread is getting
-                // created, as it might have that the current pika thread gets
-                // suspended.
+                // push the new thread in the pending thread queue
+                if (schedule_now)
                 {
-                    std::unique_lock<mutex_type> lk(mtx_);
-
-                    bool schedule_now =
-                        data.initial_state == threads::detail::thread_schedule_state::pending;
-
-                    create_thread_object(thrd, data, lk);
-
-                    // add a new entry in the map for this thread
-                    std::pair<thread_map_type::iterator, bool> p = thread_map_.insert(thrd.noref());
-
-                    if (PIKA_UNLIKELY(!p.second))
-                    {
-                        lk.unlock();
-                        PIKA_THROWS_IF(ec, pika::error::out_of_memory,
-                            "thread_queue::create_thread",
-                            "Couldn't add new thread to the map of threads");
-                        return;
-                    }
-                    ++thread_map_count_;
-
-                    // this thread has to be in the map now
-                    PIKA_ASSERT(thread_map_.find(thrd.noref()) != thread_map_.end());
-                    PIKA_ASSERT(
-                        &threads::detail::get_thread_id_data(thrd)->get_queue<thread_queue>() ==
-                        this);
-
-                    // push the new thread in the pending thread queue
-                    if (schedule_now)
-                    {
-                        // return the thread_id_ref of the newly created thread
-                        if (id) { *id = thrd; }
-                        schedule_thread(PIKA_MOVE(thrd));
-                    }
-                    else
-                    {
-                        // if the thread should not be scheduled the id must be
-                        // returned to the caller as otherwise the thread would
-                        // go out of scope right away.
-                        PIKA_ASSERT(id != nullptr);
-                        *id = PIKA_MOVE(thrd);
-                    }
-
-                    if (&ec != &throws) ec = make_success_code();
-                    return;
+                    // return the thread_id_ref of the newly created thread
+                    if (id) { *id = thrd; }
+                    schedule_thread(PIKA_MOVE(thrd));
                 }
+                else
+                {
+                    // if the thread should not be scheduled the id must be
+                    // returned to the caller as otherwise the thread would
+                    // go out of scope right away.
+                    PIKA_ASSERT(id != nullptr);
+                    *id = PIKA_MOVE(thrd);
+                }
+
+                if (&ec != &throws) ec = make_success_code();
+                return;
             }
 
             // if the initial state is not pending, delayed creation will
@@ -779,6 +856,29 @@ namespace pika::threads::detail {
             return false;
         }
 
+        /// Steal up to half of the pending threads of the given queue. The
+        /// first stolen thread is returned in thrd, the others are moved to
+        /// this queue. Returns the number of stolen threads.
+        std::size_t steal_pending_threads(
+            thread_queue* victim, threads::detail::thread_id_ref_type& thrd)
+        {
+            std::int64_t const work_items_count =
+                victim->work_items_count_.data_.load(std::memory_order_relaxed);
+
+            if (!victim->get_next_thread(thrd, true, true)) { return 0; }
+
+            std::size_t const max_stolen =
+                static_cast<std::size_t>((std::max)(std::int64_t(1), work_items_count / 2));
+            std::size_t stolen = 1;
+            for (; stolen < max_stolen; ++stolen)
+            {
+                threads::detail::thread_id_ref_type next;
+                if (!victim->get_next_thread(next, false, true)) { break; }
+                schedule_thread(PIKA_MOVE(next));
+            }
+            return stolen;
+        }
+
         /// Schedule the passed thread
         void schedule_thread(threads::detail::thread_id_ref_type thrd, bool other_end = false)
         {
@@ -959,8 +1059,8 @@ namespace pika::threads::detail {
             return !add_new_always(added, this, lk, steal);
         }
 
-        inline bool wait_or_add_new(
-            bool running, std::size_t& added, thread_queue* addfrom, bool steal = false) PIKA_HOT
+        inline bool wait_or_add_new(bool running, std::size_t& added, thread_queue* addfrom,
+            bool steal = false, bool steal_half = false) PIKA_HOT
         {
             // try to generate new threads from task lists, but only if our
             // own list of threads is empty
@@ -1001,7 +1101,7 @@ namespace pika::threads::detail {
                 if (!lk.owns_lock()) return false;    // avoid long wait on lock
 
                 // stop running after all pika threads have been terminated
-                bool added_new = add_new_always(added, addfrom, lk, steal);
+                bool added_new = add_new_always(added, addfrom, lk, steal, steal_half);
 #ifdef PIKA_HAVE_THREAD_STACK_MMAP
                 if (!added_new)
                 {
@@ -1060,6 +1160,12 @@ namespace pika::threads::detail {
         ///////////////////////////////////////////////////////////////////////
         void on_start_thread(std::size_t /* num_thread */)
         {
+            // Objects are exchanged with the depot of the NUMA domain of the
+            // first processing unit this worker is bound to
+            auto const& topo = threads::detail::get_topology();
+            std::size_t const pu = threads::detail::find_first(topo.get_cpubind_mask());
+            numa_domain_ = pu == std::size_t(-1) ? 0 : topo.get_numa_node_number(pu);
+
             thread_heap_small_.reserve(parameters_.init_threads_count_);
             thread_heap_medium_.reserve(parameters_.init_threads_count_);
             thread_heap_large_.reserve(parameters_.init_threads_count_);
@@ -1137,6 +1243,11 @@ namespace pika::threads::detail {
         thread_heap_type thread_heap_huge_;
         thread_heap_type thread_heap_nostack_;
 
+        // Depots shared with the other queues, the thread heaps above act as
+        // magazines in front of it
+        std::shared_ptr<threads::detail::thread_data_cache> thread_cache_;
+        std::size_t numa_domain_;
+
 #ifdef PIKA_HAVE_THREAD_CREATION_AND_CLEANUP_RATES
         std::uint64_t add_new_time_;
         std::uint64_t cleanup_terminated_time_;
@@ -264,6 +264,31 @@ namespace pika::threads::detail {
             return false;
         }
 
+        // ----------------------------------------------------------------
+        /// Steal up to half of the ready threads of the victim queue, the
+        /// first one is returned in thrd, the others are moved to this queue.
+        /// Return the number of threads stolen
+        std::size_t steal_next_threads(
+            thread_queue_type* victim, threads::detail::thread_id_ref_type& thrd)
+        {
+            std::int64_t const max_stolen =
+                victim->work_items_count_.data_.load(std::memory_order_relaxed) / 2;
+
+            if (!victim->get_next_thread(thrd, true)) { return 0; }
+
+            // the victim may be a queue shared with this one
+            std::size_t stolen = 1;
+            if (victim == this) { return stolen; }
+
+            for (; std::int64_t(stolen) < max_stolen; ++stolen)
+            {
+                threads::detail::thread_id_ref_type next;
+                if (!victim->get_next_thread(next, true)) { break; }
+                schedule_work(PIKA_MOVE(next), false);
+            }
+            return stolen;
+        }
+
         // ----------------------------------------------------------------
         /// Schedule the passed thread (put it on the ready work queue)
         void schedule_work(threads::detail::thread_id_ref_type thrd, bool other_end)
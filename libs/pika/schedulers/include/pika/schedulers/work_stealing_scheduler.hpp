@@ -0,0 +1,389 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/affinity/affinity_data.hpp>
+#include <pika/assert.hpp>
+#include <pika/concurrency/cache_line_data.hpp>
+#include <pika/concurrency/detail/chase_lev_deque.hpp>
+#include <pika/modules/errors.hpp>
+#include <pika/modules/logging.hpp>
+#include <pika/schedulers/local_queue_scheduler.hpp>
+#include <pika/schedulers/lockfree_queue_backends.hpp>
+#include <pika/threading_base/detail/global_activity_count.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
+#include <pika/threading_base/thread_data.hpp>
+#include <pika/threading_base/thread_num_tss.hpp>
+#include <pika/topology/topology.hpp>
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <pika/config/warnings_prefix.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace pika::threads::detail {
+    ///////////////////////////////////////////////////////////////////////////
+    /// The work_stealing_scheduler keeps one Chase-Lev deque of runnable
+    /// threads per worker thread. Threads created or scheduled by a worker
+    /// thread for itself are pushed to and popped from the bottom of its deque
+    /// (LIFO) without locks. Idle worker threads steal from the top of the
+    /// deques of other worker threads (FIFO).
+    ///
+    /// Only the owning worker thread may push to a deque. Threads which are
+    /// created or scheduled from outside the pool, or for another worker
+    /// thread, go through the queues of the underlying local_queue_scheduler,
+    /// as do threads which yield. These queues are checked after the local
+    /// deque, and periodically before it so that they can not be starved by
+    /// local work. Thread objects for the local deque are created eagerly, so
+    /// once a deque holds max_thread_count threads new threads are staged in
+    /// the shared queue instead, to bound the number of allocated stacks.
+    ///
+    /// Threads with a NUMA hint are kept on the local deque if the calling
+    /// worker thread belongs to the requested NUMA domain. Otherwise they are
+    /// placed in the shared queue of a worker thread of that domain.
+    template <typename Mutex = std::mutex, typename StagedQueuing = lockfree_fifo,
+        typename TerminatedQueuing = lockfree_fifo>
+    class PIKA_EXPORT work_stealing_scheduler
+      : public local_queue_scheduler<Mutex, lockfree_fifo, StagedQueuing, TerminatedQueuing>
+    {
+    public:
+        using base_type =
+            local_queue_scheduler<Mutex, lockfree_fifo, StagedQueuing, TerminatedQueuing>;
+        using typename base_type::init_parameter_type;
+        using typename base_type::thread_queue_type;
+
+    private:
+        using thread_repr = typename threads::detail::thread_id_ref_type::thread_repr;
+
+        // The local deque is not checked first every this many calls to
+        // get_next_thread
+        static constexpr std::uint32_t shared_queue_check_interval = 61;
+
+        struct worker_data
+        {
+            pika::concurrency::detail::chase_lev_deque<thread_repr*> deque;
+
+            // Only accessed by the owning worker thread
+            std::uint32_t tick = 0;
+        };
+
+    public:
+        work_stealing_scheduler(
+            init_parameter_type const& init, bool deferred_initialization = true)
+          : base_type(init, deferred_initialization)
+          , max_local_thread_count_(init.thread_queue_init_.max_thread_count_)
+        {
+            workers_.reserve(init.num_queues_);
+            for (std::size_t i = 0; i != init.num_queues_; ++i)
+            {
+                workers_.push_back(std::make_unique<worker_data>());
+            }
+        }
+
+        static std::string get_scheduler_name() { return "work_stealing_scheduler"; }
+
+        ///////////////////////////////////////////////////////////////////////
+        // create a new thread and schedule it if the initial state is equal to
+        // pending
+        void create_thread(threads::detail::thread_init_data& data,
+            threads::detail::thread_id_ref_type* id, error_code& ec) override
+        {
+            data.schedulehint = resolve_numa_hint(data.schedulehint);
+
+            std::size_t const num_thread = get_local_worker(data.schedulehint);
+            if (num_thread == std::size_t(-1) ||
+                data.initial_state != threads::detail::thread_schedule_state::pending ||
+                workers_[num_thread]->deque.size() >= max_local_thread_count_)
+            {
+                base_type::create_thread(data, id, ec);
+                return;
+            }
+
+            pika::threads::detail::increment_global_activity_count();
+
+            // thread has not been created yet
+            if (id) *id = threads::detail::invalid_thread_id;
+
+            if (data.stacksize == execution::thread_stacksize::current)
+            {
+                data.stacksize = threads::detail::get_self_stacksize_enum();
+            }
+
+            threads::detail::thread_id_ref_type thrd;
+            if (!this->queues_[num_thread]->create_thread_now(data, thrd, ec))
+            {
+                pika::threads::detail::decrement_global_activity_count();
+                return;
+            }
+
+            LTM_(debug)
+                .format("work_stealing_scheduler::create_thread: pool({}), scheduler({}), "
+                        "worker_thread({}), thread({})",
+                    *this->get_parent_pool(), *this, num_thread, thrd)
+#ifdef PIKA_HAVE_THREAD_DESCRIPTION
+                .format(", description({})", data.description)
+#endif
+                ;
+
+            // return the thread_id_ref of the newly created thread
+            if (id) { *id = thrd; }
+            workers_[num_thread]->deque.push(thrd.detach());
+
+            if (&ec != &throws) ec = make_success_code();
+        }
+
+        /// Return the next thread to be executed, return false if none is
+        /// available
+        bool get_next_thread(std::size_t num_thread, bool running,
+            threads::detail::thread_id_ref_type& thrd,
+            bool /*scheduler_mode::enable_stealing*/) override
+        {
+            PIKA_ASSERT(num_thread < workers_.size());
+
+            worker_data& w = *workers_[num_thread];
+            thread_queue_type* q = this->queues_[num_thread];
+
+            q->increment_num_pending_accesses();
+
+            if (++w.tick % shared_queue_check_interval == 0 && q->get_next_thread(thrd))
+            {
+                return true;
+            }
+
+            if (auto next = w.deque.pop())
+            {
+                thrd.reset(*next, false);    // do not addref!
+                return true;
+            }
+
+            if (q->get_next_thread(thrd)) { return true; }
+
+            q->increment_num_pending_misses();
+
+            // Give up, we should have work to convert.
+            if (q->get_staged_queue_length(std::memory_order_relaxed) != 0) { return false; }
+
+#if !defined(PIKA_HAVE_THREAD_SANITIZER)
+            if (!running) { return false; }
+
+            bool const numa_stealing =
+                this->has_scheduler_mode(scheduler_mode::enable_stealing_numa);
+            std::size_t const num_workers = workers_.size();
+
+            // Start with a different victim every time so that idle worker
+            // threads spread out over the other deques
+            std::size_t const first = w.tick % num_workers;
+            for (std::size_t i = 0; i != num_workers; ++i)
+            {
+                std::size_t const idx = (first + i) % num_workers;
+                if (idx == num_thread) { continue; }
+
+                if (!numa_stealing &&
+                    !::pika::threads::detail::test(this->numa_domain_masks_[num_thread],
+                        this->affinity_data_.get_pu_num(idx)))    //-V600
+                {
+                    continue;
+                }
+
+                thread_queue_type* victim = this->queues_[idx];
+                if (auto next = workers_[idx]->deque.steal())
+                {
+                    thrd.reset(*next, false);    // do not addref!
+                }
+                else if (!victim->get_next_thread(thrd, running)) { continue; }
+
+                victim->increment_num_stolen_from_pending();
+                q->increment_num_stolen_to_pending();
+                return true;
+            }
+#else
+            PIKA_UNUSED(running);
+#endif
+
+            return false;
+        }
+
+        /// Schedule the passed thread
+        void schedule_thread(threads::detail::thread_id_ref_type thrd,
+            execution::thread_schedule_hint schedulehint, bool allow_fallback,
+            execution::thread_priority priority = execution::thread_priority::normal) override
+        {
+            schedulehint = resolve_numa_hint(schedulehint);
+
+            std::size_t const num_thread = get_local_worker(schedulehint);
+            if (num_thread == std::size_t(-1))
+            {
+                base_type::schedule_thread(PIKA_MOVE(thrd), schedulehint, allow_fallback, priority);
+                return;
+            }
+
+            PIKA_ASSERT(get_thread_id_data(thrd)->get_scheduler_base() == this);
+
+            LTM_(debug).format("work_stealing_scheduler::schedule_thread: pool({}), "
+                               "scheduler({}), worker_thread({}), thread({}), description({})",
+                *this->get_parent_pool(), *this, num_thread,
+                get_thread_id_data(thrd)->get_thread_id(),
+                get_thread_id_data(thrd)->get_description());
+
+            // detach the thread from the id_ref without decrementing the
+            // reference count
+            workers_[num_thread]->deque.push(thrd.detach());
+        }
+
+        // schedule_thread_last is inherited: threads which yield go to the
+        // back of the shared queue of the worker thread instead of the local
+        // deque, where they would run again immediately.
+
+        ///////////////////////////////////////////////////////////////////////
+        // This returns the current length of the queues (work items and new items)
+        std::int64_t get_queue_length(std::size_t num_thread = std::size_t(-1)) const override
+        {
+            std::int64_t count = base_type::get_queue_length(num_thread);
+            if (std::size_t(-1) != num_thread)
+            {
+                PIKA_ASSERT(num_thread < workers_.size());
+                return count + workers_[num_thread]->deque.size();
+            }
+
+            for (auto const& w : workers_) { count += w->deque.size(); }
+            return count;
+        }
+
+        // Queries whether a given core is idle
+        bool is_core_idle(std::size_t num_thread) const override
+        {
+            return workers_[num_thread]->deque.empty() && base_type::is_core_idle(num_thread);
+        }
+
+        void on_start_thread(std::size_t num_thread) override
+        {
+            // The NUMA domains of the worker threads are computed once, before
+            // the worker threads synchronize in
+            // local_queue_scheduler::on_start_thread
+            if (num_thread == 0 && !numa_domains_initialized_.load(std::memory_order_relaxed))
+            {
+                init_numa_domains();
+            }
+
+            base_type::on_start_thread(num_thread);
+        }
+
+    private:
+        void init_numa_domains()
+        {
+            auto const& topo = ::pika::threads::detail::get_topology();
+
+            // Number the NUMA domains used by this pool consecutively
+            std::map<std::size_t, std::size_t> domain_map;
+            std::vector<std::size_t> worker_domains(workers_.size());
+            for (std::size_t i = 0; i != workers_.size(); ++i)
+            {
+                std::size_t const pu_num =
+                    this->affinity_data_.get_pu_num(this->local_to_global_thread_index(i));
+                worker_domains[i] = topo.get_numa_node_number(pu_num);
+                domain_map.emplace(worker_domains[i], 0);
+            }
+
+            std::size_t index = 0;
+            for (auto& d : domain_map) { d.second = index++; }
+
+            domain_workers_.resize(domain_map.size());
+            worker_domains_.resize(workers_.size());
+            for (std::size_t i = 0; i != workers_.size(); ++i)
+            {
+                worker_domains_[i] = domain_map[worker_domains[i]];
+                domain_workers_[worker_domains_[i]].push_back(i);
+            }
+
+            numa_domains_initialized_.store(true, std::memory_order_release);
+        }
+
+        // Turns a NUMA hint into a thread hint for a worker thread of the
+        // requested domain, preferring the calling worker thread. NUMA hints
+        // are ignored until the NUMA domains of the worker threads are known.
+        execution::thread_schedule_hint resolve_numa_hint(
+            execution::thread_schedule_hint schedulehint)
+        {
+            if (schedulehint.mode != execution::thread_schedule_hint_mode::numa ||
+                !numa_domains_initialized_.load(std::memory_order_acquire))
+            {
+                return schedulehint;
+            }
+
+            std::size_t const domain = std::size_t(schedulehint.hint) % domain_workers_.size();
+
+            std::size_t const num_thread = get_local_worker(execution::thread_schedule_hint());
+            if (num_thread != std::size_t(-1) && worker_domains_[num_thread] == domain)
+            {
+                return execution::thread_schedule_hint(std::int16_t(num_thread));
+            }
+
+            auto const& candidates = domain_workers_[domain];
+            std::size_t const next = next_numa_worker_.fetch_add(1, std::memory_order_relaxed);
+            return execution::thread_schedule_hint(
+                std::int16_t(candidates[next % candidates.size()]));
+        }
+
+        // Returns the index of the calling worker thread if it belongs to the
+        // pool of this scheduler and the hint allows running the thread on
+        // it, otherwise returns -1.
+        std::size_t get_local_worker(execution::thread_schedule_hint schedulehint) const
+        {
+            if (this->parent_pool_ == nullptr ||
+                pika::threads::detail::get_thread_pool_num_tss() !=
+                    this->parent_pool_->get_pool_id().index())
+            {
+                return std::size_t(-1);
+            }
+
+            std::size_t const num_thread = pika::threads::detail::get_local_thread_num_tss();
+            if (num_thread >= workers_.size()) { return std::size_t(-1); }
+
+            if (schedulehint.mode == execution::thread_schedule_hint_mode::thread &&
+                std::size_t(schedulehint.hint) % workers_.size() != num_thread)
+            {
+                return std::size_t(-1);
+            }
+
+            return num_thread;
+        }
+
+        std::int64_t max_local_thread_count_;
+        std::vector<std::unique_ptr<worker_data>> workers_;
+
+        // The NUMA domain of each worker thread and the worker threads of
+        // each NUMA domain, written once by init_numa_domains
+        std::atomic<bool> numa_domains_initialized_{false};
+        std::vector<std::size_t> worker_domains_;
+        std::vector<std::vector<std::size_t>> domain_workers_;
+        std::atomic<std::size_t> next_numa_worker_{0};
+    };
+}    // namespace pika::threads::detail
+
+template <typename Mutex, typename StagedQueuing, typename TerminatedQueuing>
+struct fmt::formatter<
+    pika::threads::detail::work_stealing_scheduler<Mutex, StagedQueuing, TerminatedQueuing>>
+  : fmt::formatter<pika::threads::detail::scheduler_base>
+{
+    template <typename FormatContext>
+    auto format(pika::threads::detail::scheduler_base const& scheduler, FormatContext& ctx)
+    {
+        return fmt::formatter<pika::threads::detail::scheduler_base>::format(scheduler, ctx);
+    }
+};
+
+#include <pika/config/warnings_suffix.hpp>
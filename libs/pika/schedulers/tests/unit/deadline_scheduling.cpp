@@ -0,0 +1,130 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This test checks that the deadline scheduler runs threads in earliest
+// deadline first order and counts the threads which start running after their
+// deadline, once per thread.
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/latch.hpp>
+#include <pika/modules/resource_partitioner.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+using clock_type = std::chrono::steady_clock;
+
+void test_properties()
+{
+    auto const deadline = clock_type::now() + std::chrono::seconds(1);
+    auto sched = ex::with_deadline(ex::thread_pool_scheduler{}, deadline);
+    PIKA_TEST(ex::get_deadline(sched) == deadline);
+    PIKA_TEST(ex::get_deadline(ex::thread_pool_scheduler{}) == clock_type::time_point::max());
+    PIKA_TEST(sched != ex::thread_pool_scheduler{});
+}
+
+void test_order()
+{
+    // All threads are created before the only worker thread is free to run
+    // them, so that they run in order of their deadlines
+    constexpr std::size_t num_threads = 16;
+    auto const start = clock_type::now() + std::chrono::hours(1);
+
+    std::vector<std::size_t> order;
+    pika::latch done(num_threads + 1);
+    for (std::size_t i = 0; i < num_threads; ++i)
+    {
+        // Alternate between late and early deadlines
+        std::size_t const rank = (i % 2 == 0) ? num_threads - 1 - i / 2 : i / 2;
+        ex::execute(ex::with_deadline(ex::thread_pool_scheduler{},
+                        start + std::chrono::milliseconds(rank)),
+            [&, rank] {
+                order.push_back(rank);
+                done.count_down(1);
+            });
+    }
+    done.arrive_and_wait();
+
+    PIKA_TEST_EQ(order.size(), num_threads);
+    for (std::size_t i = 0; i < order.size(); ++i) { PIKA_TEST_EQ(order[i], i); }
+}
+
+void test_misses()
+{
+    auto& pool = pika::resource::get_thread_pool("default");
+    pool.get_num_deadline_misses(std::size_t(-1), true);
+
+    constexpr std::size_t num_threads = 8;
+    auto const past = clock_type::now() - std::chrono::seconds(1);
+    auto const future = clock_type::now() + std::chrono::hours(1);
+
+    pika::latch done(2 * num_threads + 1);
+    for (std::size_t i = 0; i < num_threads; ++i)
+    {
+        ex::execute(ex::with_deadline(ex::thread_pool_scheduler{}, past),
+            [&] { done.count_down(1); });
+        ex::execute(ex::with_deadline(ex::thread_pool_scheduler{}, future),
+            [&] { done.count_down(1); });
+    }
+    done.arrive_and_wait();
+
+    PIKA_TEST_EQ(pool.get_num_deadline_misses(std::size_t(-1), true), std::int64_t(num_threads));
+    PIKA_TEST_EQ(pool.get_num_deadline_misses(std::size_t(-1), false), std::int64_t(0));
+}
+
+void test_misses_resumed()
+{
+    auto& pool = pika::resource::get_thread_pool("default");
+    pool.get_num_deadline_misses(std::size_t(-1), true);
+
+    // A late thread which is suspended and resumed several times is counted
+    // only once
+    auto const past = clock_type::now() - std::chrono::seconds(1);
+    pika::latch done(2);
+    ex::execute(ex::with_deadline(ex::thread_pool_scheduler{}, past), [&] {
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            pika::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        done.count_down(1);
+    });
+    done.arrive_and_wait();
+
+    PIKA_TEST_EQ(pool.get_num_deadline_misses(std::size_t(-1), true), std::int64_t(1));
+}
+
+int pika_main()
+{
+    test_properties();
+    test_order();
+    test_misses();
+    test_misses_resumed();
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    pika::init_params init_args;
+    init_args.cfg = {"pika.os_threads=1"};
+    init_args.rp_callback = [](auto& rp, pika::program_options::variables_map const&) {
+        rp.create_thread_pool("default", pika::resource::scheduling_policy::deadline);
+    };
+
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv, init_args), 0);
+
+    return pika::detail::report_errors();
+}
@@ -0,0 +1,86 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This test checks that the threads queued on a worker thread which is blocked
+// are stolen and run by the other worker threads.
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/runtime.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <thread>
+
+namespace ex = pika::execution::experimental;
+
+constexpr std::size_t num_tasks = 1000;
+
+int pika_main()
+{
+    if (pika::get_num_worker_threads() < 2)
+    {
+        pika::finalize();
+        return EXIT_SUCCESS;
+    }
+
+    std::atomic<std::size_t> executed{0};
+    std::atomic<bool> done{false};
+
+    // Queue the tasks on the current worker thread and block it until all
+    // tasks have run, or give up after a while
+    ex::execute(ex::thread_pool_scheduler{}, [&] {
+        std::size_t const worker = pika::get_worker_thread_num();
+        auto sched = ex::with_hint(
+            ex::thread_pool_scheduler{}, pika::execution::thread_schedule_hint(int(worker)));
+
+        for (std::size_t i = 0; i < num_tasks; ++i)
+        {
+            ex::execute(sched, [&] { ++executed; });
+        }
+
+        auto const start = std::chrono::steady_clock::now();
+        while (executed < num_tasks &&
+            std::chrono::steady_clock::now() - start < std::chrono::seconds(10))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        done = true;
+    });
+
+    while (!done) { pika::this_thread::yield(); }
+
+    PIKA_TEST_EQ(executed.load(), num_tasks);
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+void test_scheduler(int argc, char* argv[], pika::resource::scheduling_policy scheduler)
+{
+    pika::init_params init_args;
+    init_args.rp_callback = [scheduler](auto& rp, pika::program_options::variables_map const&) {
+        rp.create_thread_pool("default", scheduler);
+    };
+
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv, init_args), 0);
+}
+
+int main(int argc, char* argv[])
+{
+    test_scheduler(argc, argv, pika::resource::scheduling_policy::local_priority_fifo);
+#if defined(PIKA_HAVE_CXX11_STD_ATOMIC_128BIT)
+    test_scheduler(argc, argv, pika::resource::scheduling_policy::local_priority_lifo);
+    test_scheduler(argc, argv, pika::resource::scheduling_policy::abp_priority_fifo);
+    test_scheduler(argc, argv, pika::resource::scheduling_policy::abp_priority_lifo);
+#endif
+
+    return pika::detail::report_errors();
+}
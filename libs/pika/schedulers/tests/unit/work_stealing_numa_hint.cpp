@@ -0,0 +1,105 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This test checks that the work_stealing_scheduler runs threads with a NUMA
+// hint on a worker thread of the requested NUMA domain, both when they are
+// spawned from a worker thread and from outside the pool.
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/resource_partitioner/detail/partitioner.hpp>
+#include <pika/runtime.hpp>
+#include <pika/testing.hpp>
+#include <pika/topology/topology.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+constexpr std::size_t num_tasks = 100;
+
+std::size_t get_numa_domain(std::size_t worker_thread_num)
+{
+    std::size_t const pu_num = pika::resource::get_partitioner().get_pu_num(worker_thread_num);
+    return pika::threads::detail::get_topology().get_numa_node_number(pu_num);
+}
+
+// Returns the NUMA domains used by the default pool in increasing order, the
+// n-th domain is the one requested by a NUMA hint n
+std::vector<std::size_t> get_numa_domains()
+{
+    std::set<std::size_t> domains;
+    for (std::size_t i = 0; i != pika::get_num_worker_threads(); ++i)
+    {
+        domains.insert(get_numa_domain(i));
+    }
+
+    return {domains.begin(), domains.end()};
+}
+
+// Checks that tasks with NUMA hints run in the requested NUMA domain. The
+// tasks are spawned from worker threads if from_worker is true, and from the
+// calling thread otherwise.
+void test_numa_hints(std::vector<std::size_t> const& domains, bool from_worker)
+{
+    for (std::size_t hint = 0; hint != 2 * domains.size(); ++hint)
+    {
+        auto sched = ex::with_hint(ex::thread_pool_scheduler{},
+            pika::execution::thread_schedule_hint(
+                pika::execution::thread_schedule_hint_mode::numa, std::int16_t(hint)));
+        std::size_t const expected_domain = domains[hint % domains.size()];
+
+        auto spawn = [&](std::size_t) {
+            tt::sync_wait(ex::schedule(sched) | ex::then([&] {
+                PIKA_TEST_EQ(get_numa_domain(pika::get_worker_thread_num()), expected_domain);
+            }));
+        };
+
+        if (from_worker)
+        {
+            tt::sync_wait(ex::schedule(ex::thread_pool_scheduler{}) | ex::bulk(num_tasks, spawn));
+        }
+        else
+        {
+            for (std::size_t i = 0; i != num_tasks; ++i) { spawn(i); }
+        }
+    }
+}
+
+int pika_main()
+{
+    test_numa_hints(get_numa_domains(), true);
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    pika::init_params init_args;
+    init_args.rp_callback = [](auto& rp, pika::program_options::variables_map const&) {
+        rp.create_thread_pool("default", pika::resource::scheduling_policy::work_stealing);
+    };
+
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv, init_args), 0);
+
+    pika::start(argc, argv, init_args);
+
+    std::vector<std::size_t> domains;
+    tt::sync_wait(ex::schedule(ex::thread_pool_scheduler{}) |
+        ex::then([&] { domains = get_numa_domains(); }));
+    test_numa_hints(domains, false);
+
+    pika::finalize();
+    PIKA_TEST_EQ(pika::stop(), 0);
+
+    return 0;
+}
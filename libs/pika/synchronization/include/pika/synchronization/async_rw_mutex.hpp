@@ -6,20 +6,21 @@
 
 #pragma once
 
+#include <pika/allocator_support/allocator_deleter.hpp>
 #include <pika/allocator_support/internal_allocator.hpp>
+#include <pika/allocator_support/thread_local_caching_allocator.hpp>
 #include <pika/assert.hpp>
-#include <pika/concurrency/spinlock.hpp>
-#include <pika/datastructures/detail/small_vector.hpp>
 #include <pika/execution_base/operation_state.hpp>
 #include <pika/execution_base/receiver.hpp>
 #include <pika/execution_base/sender.hpp>
-#include <pika/execution_base/this_thread.hpp>
-#include <pika/functional/unique_function.hpp>
+#include <pika/memory/intrusive_ptr.hpp>
+#include <pika/thread_support/atomic_count.hpp>
 
 #include <atomic>
+#include <cstdint>
 #include <exception>
 #include <memory>
-#include <mutex>
+#include <new>
 #include <optional>
 #include <type_traits>
 #include <utility>
@@ -33,118 +34,222 @@ namespace pika::execution::experimental {
     };
 
     namespace detail {
-        template <typename T>
-        struct async_rw_mutex_shared_state
+        // Intrusive list node for operation states waiting for access. The
+        // node is embedded in the operation state so that waiting for access
+        // does not allocate.
+        struct async_rw_mutex_continuation
         {
-            using mutex_type = pika::concurrency::detail::spinlock;
-            using shared_state_ptr_type = std::shared_ptr<async_rw_mutex_shared_state>;
-            std::atomic<bool> value_set{false};
-            std::optional<T> value{std::nullopt};
+            async_rw_mutex_continuation* next = nullptr;
+            void (*continue_access)(async_rw_mutex_continuation*) noexcept = nullptr;
+        };
+
+        // Common functionality for the shared states with and without a
+        // value. Each shared state grants access to the next shared state when
+        // its last reference is released. Continuations are pushed onto a
+        // lock-free list which is drained exactly once when access is granted,
+        // after which the list is replaced by a marker so that later
+        // continuations run immediately.
+        template <typename Derived>
+        struct async_rw_mutex_shared_state_base
+        {
+            using shared_state_ptr_type = pika::intrusive_ptr<Derived>;
+            using destroy_function_type = void (*)(Derived*) noexcept;
+
+            pika::detail::atomic_count reference_count{0};
+            std::atomic<async_rw_mutex_continuation*> continuations{nullptr};
             shared_state_ptr_type next_state{nullptr};
-            mutex_type mtx{};
-            pika::detail::small_vector<
-                pika::util::detail::unique_function<void(shared_state_ptr_type)>, 1>
-                continuations{};
-
-            async_rw_mutex_shared_state() = default;
-            async_rw_mutex_shared_state(async_rw_mutex_shared_state&&) = delete;
-            async_rw_mutex_shared_state& operator=(async_rw_mutex_shared_state&&) = delete;
-            async_rw_mutex_shared_state(async_rw_mutex_shared_state const&) = delete;
-            async_rw_mutex_shared_state& operator=(async_rw_mutex_shared_state const&) = delete;
-
-            ~async_rw_mutex_shared_state()
+            destroy_function_type destroy;
+
+            explicit async_rw_mutex_shared_state_base(destroy_function_type destroy) noexcept
+              : destroy(destroy)
             {
-                // If there is no next state the continuations must be empty.
-                PIKA_ASSERT(next_state || continuations.empty());
+            }
+            async_rw_mutex_shared_state_base(async_rw_mutex_shared_state_base&&) = delete;
+            async_rw_mutex_shared_state_base& operator=(
+                async_rw_mutex_shared_state_base&&) = delete;
+            async_rw_mutex_shared_state_base(async_rw_mutex_shared_state_base const&) = delete;
+            async_rw_mutex_shared_state_base& operator=(
+                async_rw_mutex_shared_state_base const&) = delete;
+
+            static async_rw_mutex_continuation* ready() noexcept
+            {
+                return reinterpret_cast<async_rw_mutex_continuation*>(std::uintptr_t(1));
+            }
 
-                // This state must always have the value set by the time it is
-                // destructed. If there is no next state the value is destructed
-                // with this state.
-                PIKA_ASSERT(value);
+            void set_next_state(shared_state_ptr_type state)
+            {
+                // The next state should only be set once
+                PIKA_ASSERT(!next_state);
+                PIKA_ASSERT(state);
+                next_state = PIKA_MOVE(state);
+            }
+
+            // Runs the continuation immediately if access has already been
+            // granted, otherwise adds it to the continuations that are run
+            // when access is granted. The caller must hold a reference to the
+            // state, and this state must not be accessed after the
+            // continuation has been added since it may run (and release the
+            // state) concurrently.
+            void add_continuation(async_rw_mutex_continuation* continuation) noexcept
+            {
+                async_rw_mutex_continuation* head = continuations.load(std::memory_order_acquire);
+                do {
+                    if (head == ready())
+                    {
+                        continuation->continue_access(continuation);
+                        return;
+                    }
+                    continuation->next = head;
+                } while (!continuations.compare_exchange_weak(
+                    head, continuation, std::memory_order_release, std::memory_order_acquire));
+            }
 
-                if (PIKA_LIKELY(next_state))
+            // Grants access to this state, running all continuations added so
+            // far in the order in which they were added.
+            void set_ready() noexcept
+            {
+                async_rw_mutex_continuation* head =
+                    continuations.exchange(ready(), std::memory_order_acq_rel);
+                PIKA_ASSERT(head != ready());
+
+                async_rw_mutex_continuation* reversed = nullptr;
+                while (head != nullptr)
+                {
+                    async_rw_mutex_continuation* next = head->next;
+                    head->next = reversed;
+                    reversed = head;
+                    head = next;
+                }
+
+                while (reversed != nullptr)
                 {
+                    // The continuation may destroy the node
+                    async_rw_mutex_continuation* next = reversed->next;
+                    reversed->continue_access(reversed);
+                    reversed = next;
+                }
+            }
+
+            friend void intrusive_ptr_add_ref(Derived* p) noexcept { ++p->reference_count; }
+
+            friend void intrusive_ptr_release(Derived* p) noexcept
+            {
+                if (--p->reference_count == 0)
+                {
+                    // A state can only be released once it has been granted
+                    // access, since the previous state holds a reference to it
+                    // until then.
+                    PIKA_ASSERT(p->continuations.load(std::memory_order_relaxed) == ready());
+
                     // The current state has now finished all accesses to the
-                    // wrapped value, so we move the value to the next state.
-                    PIKA_ASSERT(value.has_value());
-                    // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
-                    next_state->set_value(PIKA_MOVE(*value));
+                    // wrapped value (if any), so we move the value to the next
+                    // state and grant access to it.
+                    if (PIKA_LIKELY(p->next_state))
+                    {
+                        p->move_value_to(*p->next_state);
+                        p->next_state->set_ready();
+                    }
 
-                    for (auto& continuation : continuations) { continuation(next_state); }
+                    p->destroy(p);
                 }
             }
+        };
+
+        template <typename T>
+        struct async_rw_mutex_shared_state
+          : async_rw_mutex_shared_state_base<async_rw_mutex_shared_state<T>>
+        {
+            using base_type = async_rw_mutex_shared_state_base<async_rw_mutex_shared_state<T>>;
+
+            std::optional<T> value{std::nullopt};
+
+            using base_type::base_type;
 
             template <typename U>
             void set_value(U&& u)
             {
                 PIKA_ASSERT(!value);
                 value.emplace(PIKA_FORWARD(U, u));
-                value_set.store(true, std::memory_order_release);
             }
 
             T& get_value()
             {
-                pika::util::yield_while(
-                    [this]() { return !value_set.load(std::memory_order_acquire); });
                 PIKA_ASSERT(value);
                 // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
                 return *value;
             }
 
-            void set_next_state(std::shared_ptr<async_rw_mutex_shared_state> state)
+            void move_value_to(async_rw_mutex_shared_state& next)
             {
-                // The next state should only be set once
-                PIKA_ASSERT(!next_state);
-                PIKA_ASSERT(state);
-                next_state = PIKA_MOVE(state);
-            }
-
-            template <typename F>
-            void add_continuation(F&& continuation)
-            {
-                std::lock_guard<mutex_type> l(mtx);
-                continuations.emplace_back(PIKA_FORWARD(F, continuation));
+                // This state must always have the value set by the time it is
+                // released.
+                PIKA_ASSERT(value);
+                // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+                next.set_value(PIKA_MOVE(*value));
             }
         };
 
         template <>
         struct async_rw_mutex_shared_state<void>
+          : async_rw_mutex_shared_state_base<async_rw_mutex_shared_state<void>>
         {
-            using mutex_type = pika::concurrency::detail::spinlock;
-            using shared_state_ptr_type = std::shared_ptr<async_rw_mutex_shared_state>;
-            shared_state_ptr_type next_state{nullptr};
-            mutex_type mtx{};
-            pika::detail::small_vector<
-                pika::util::detail::unique_function<void(shared_state_ptr_type)>, 1>
-                continuations{};
-
-            async_rw_mutex_shared_state() = default;
-            async_rw_mutex_shared_state(async_rw_mutex_shared_state&&) = delete;
-            async_rw_mutex_shared_state& operator=(async_rw_mutex_shared_state&&) = delete;
-            async_rw_mutex_shared_state(async_rw_mutex_shared_state const&) = delete;
-            async_rw_mutex_shared_state& operator=(async_rw_mutex_shared_state const&) = delete;
-
-            ~async_rw_mutex_shared_state()
-            {
-                // If there is no next state the continuations must be empty.
-                PIKA_ASSERT(next_state || continuations.empty());
+            using base_type = async_rw_mutex_shared_state_base<async_rw_mutex_shared_state<void>>;
+
+            using base_type::base_type;
+
+            void move_value_to(async_rw_mutex_shared_state&) noexcept {}
+        };
+
+        // Shared states are allocated together with the allocator used to
+        // release them. Stateless allocators are wrapped in a thread-local
+        // cache since shared states are allocated and released at a high rate
+        // when many accesses go through the same mutex.
+        template <typename State, typename Allocator>
+        struct async_rw_mutex_allocated_shared_state final : State
+        {
+        private:
+            using other_allocator = typename std::allocator_traits<
+                Allocator>::template rebind_alloc<async_rw_mutex_allocated_shared_state>;
 
-                for (auto& continuation : continuations) { continuation(next_state); }
+            static constexpr bool use_cache =
+                std::allocator_traits<other_allocator>::is_always_equal::value &&
+                std::is_default_constructible_v<other_allocator>;
+
+            using allocator_type = std::conditional_t<use_cache,
+                pika::detail::thread_local_caching_allocator<other_allocator>, other_allocator>;
+            using allocator_traits = std::allocator_traits<allocator_type>;
+
+            PIKA_NO_UNIQUE_ADDRESS allocator_type alloc;
+
+            static void destroy_state(State* p) noexcept
+            {
+                auto* state = static_cast<async_rw_mutex_allocated_shared_state*>(p);
+                allocator_type other_alloc(state->alloc);
+                allocator_traits::destroy(other_alloc, state);
+                allocator_traits::deallocate(other_alloc, state, 1);
             }
 
-            void set_next_state(std::shared_ptr<async_rw_mutex_shared_state> state)
+        public:
+            explicit async_rw_mutex_allocated_shared_state(allocator_type const& alloc)
+              : State(&destroy_state)
+              , alloc(alloc)
             {
-                // The next state should only be set once
-                PIKA_ASSERT(!next_state);
-                PIKA_ASSERT(state);
-                next_state = PIKA_MOVE(state);
             }
 
-            template <typename F>
-            void add_continuation(F&& continuation)
+            static pika::intrusive_ptr<State> create(Allocator const& allocator)
             {
-                std::lock_guard<mutex_type> l(mtx);
-                continuations.emplace_back(PIKA_FORWARD(F, continuation));
+                using unique_ptr = std::unique_ptr<async_rw_mutex_allocated_shared_state,
+                    pika::detail::allocator_deleter<allocator_type>>;
+
+                allocator_type alloc = [&] {
+                    if constexpr (use_cache) { return allocator_type{}; }
+                    else { return allocator_type(allocator); }
+                }();
+
+                unique_ptr p(allocator_traits::allocate(alloc, 1),
+                    pika::detail::allocator_deleter<allocator_type>{alloc});
+                new (p.get()) async_rw_mutex_allocated_shared_state{alloc};
+                return pika::intrusive_ptr<State>(p.release());
             }
         };
     }    // namespace detail
@@ -164,7 +269,8 @@ namespace pika::execution::experimental {
     struct async_rw_mutex_access_wrapper<ReadWriteT, ReadT, async_rw_mutex_access_type::read>
     {
     private:
-        using shared_state_type = std::shared_ptr<detail::async_rw_mutex_shared_state<ReadWriteT>>;
+        using shared_state_type =
+            pika::intrusive_ptr<detail::async_rw_mutex_shared_state<ReadWriteT>>;
         shared_state_type state;
 
     public:
@@ -196,7 +302,8 @@ namespace pika::execution::experimental {
             "Cannot mix void and non-void type in async_rw_mutex_access_wrapper wrapper (ReadT "
             "is void, ReadWriteT is non-void)");
 
-        using shared_state_type = std::shared_ptr<detail::async_rw_mutex_shared_state<ReadWriteT>>;
+        using shared_state_type =
+            pika::intrusive_ptr<detail::async_rw_mutex_shared_state<ReadWriteT>>;
         shared_state_type state;
 
     public:
@@ -224,7 +331,7 @@ namespace pika::execution::experimental {
     struct async_rw_mutex_access_wrapper<void, void, async_rw_mutex_access_type::read>
     {
     private:
-        using shared_state_type = std::shared_ptr<detail::async_rw_mutex_shared_state<void>>;
+        using shared_state_type = pika::intrusive_ptr<detail::async_rw_mutex_shared_state<void>>;
         shared_state_type state;
 
     public:
@@ -243,7 +350,7 @@ namespace pika::execution::experimental {
     struct async_rw_mutex_access_wrapper<void, void, async_rw_mutex_access_type::readwrite>
     {
     private:
-        using shared_state_type = std::shared_ptr<detail::async_rw_mutex_shared_state<void>>;
+        using shared_state_type = pika::intrusive_ptr<detail::async_rw_mutex_shared_state<void>>;
         shared_state_type state;
 
     public:
@@ -289,19 +396,22 @@ namespace pika::execution::experimental {
 
     // Implementation details:
     //
-    // The async_rw_mutex protects access to a given resource using two
-    // reference counted shared states, the current and the previous state. Each
-    // shared state guards access to the next stage; when the shared state goes
-    // out of scope it triggers continuations for the next stage.
+    // The async_rw_mutex protects access to a given resource using a chain of
+    // intrusively reference counted shared states. Each shared state holds a
+    // reference to the next state in the chain. When the last reference to a
+    // shared state is released it grants access to the next state, which
+    // triggers the continuations that have been waiting for access to it.
     //
     // When read-write access is required a sender is created which holds on to
-    // the newly created shared state for the read-write access and the previous
-    // state. When the sender is connected to a receiver, a callback is added to
-    // the previous shared state's destructor. The callback holds the new state,
-    // and passes a wrapper holding the shared state to set_value. Once the
-    // receiver which receives the wrapper has let the wrapper go out of scope
-    // (and all other references to the shared state are out of scope), the new
-    // shared state will again trigger its continuations.
+    // a newly created shared state for the read-write access. The new state is
+    // set as the next state of the current state. When the sender is connected
+    // to a receiver and started, the operation state adds itself to the list of
+    // continuations of its shared state, or runs immediately if access has
+    // already been granted. The continuation passes a wrapper holding the
+    // shared state to set_value. Once the receiver which receives the wrapper
+    // has let the wrapper go out of scope (and all other references to the
+    // shared state are out of scope), the shared state will grant access to
+    // the next state.
     //
     // When read-only access is required and the previous access was read-only
     // the procedure is the same as for read-write access. When read-only access
@@ -310,6 +420,11 @@ namespace pika::execution::experimental {
     // can run concurrently, and the next access (which must be read-write) is
     // triggered once all instances of that shared state have gone out of scope.
     //
+    // The list of continuations is a lock-free stack onto which operation
+    // states push themselves. It is drained exactly once, when access is
+    // granted. The list nodes are embedded in the operation states, so waiting
+    // for access does not allocate.
+    //
     // The protected value is moved from state to state and is released when the
     // last shared state is destroyed.
 
@@ -321,13 +436,12 @@ namespace pika::execution::experimental {
         struct sender;
 
         using shared_state_type = detail::async_rw_mutex_shared_state<void>;
-        using shared_state_weak_ptr_type = std::weak_ptr<shared_state_type>;
 
         // nvc++ is not able to see this typedef unless it's public
 #if defined(PIKA_NVHPC_VERSION)
     public:
 #endif
-        using shared_state_ptr_type = std::shared_ptr<shared_state_type>;
+        using shared_state_ptr_type = pika::intrusive_ptr<shared_state_type>;
 
     public:
         using read_type = void;
@@ -353,47 +467,39 @@ namespace pika::execution::experimental {
         {
             if (prev_access == async_rw_mutex_access_type::readwrite)
             {
-                auto shared_prev_state = PIKA_MOVE(state);
-                state = std::allocate_shared<shared_state_type, allocator_type>(alloc);
+                add_state();
                 prev_access = async_rw_mutex_access_type::read;
-
-                // Only the first access has no previous shared state. When
-                // there is a previous state we set the next state so that the
-                // value can be passed from the previous state to the next
-                // state.
-                if (PIKA_LIKELY(shared_prev_state))
-                {
-                    shared_prev_state->set_next_state(state);
-                    prev_state = shared_prev_state;
-                }
             }
 
-            return {prev_state, state};
+            return {state};
         }
 
         sender<async_rw_mutex_access_type::readwrite> readwrite()
         {
-            auto shared_prev_state = PIKA_MOVE(state);
-            state = std::allocate_shared<shared_state_type, allocator_type>(alloc);
+            add_state();
             prev_access = async_rw_mutex_access_type::readwrite;
 
-            // Only the first access has no previous shared state. When there is
-            // a previous state we set the next state so that the value can be
-            // passed from the previous state to the next state.
-            if (PIKA_LIKELY(shared_prev_state))
-            {
-                shared_prev_state->set_next_state(state);
-                prev_state = shared_prev_state;
-            }
-
-            return {prev_state, state};
+            return {state};
         }
 
     private:
+        void add_state()
+        {
+            auto prev_state = PIKA_MOVE(state);
+            state = detail::async_rw_mutex_allocated_shared_state<shared_state_type,
+                allocator_type>::create(alloc);
+
+            // Only the first access has no previous shared state. When there is
+            // a previous state we set the next state so that the previous state
+            // can grant access to the next state when it is released. The first
+            // state has access immediately.
+            if (PIKA_LIKELY(prev_state)) { prev_state->set_next_state(state); }
+            else { state->set_ready(); }
+        }
+
         template <async_rw_mutex_access_type AccessType>
         struct sender
         {
-            shared_state_weak_ptr_type prev_state;
             shared_state_ptr_type state;
 
             using access_type =
@@ -411,17 +517,15 @@ namespace pika::execution::experimental {
                 pika::execution::experimental::set_error_t(std::exception_ptr)>;
 
             template <typename R>
-            struct operation_state
+            struct operation_state : detail::async_rw_mutex_continuation
             {
                 std::decay_t<R> r;
-                shared_state_weak_ptr_type prev_state;
                 shared_state_ptr_type state;
 
                 template <typename R_>
-                operation_state(
-                    R_&& r, shared_state_weak_ptr_type prev_state, shared_state_ptr_type state)
-                  : r(PIKA_FORWARD(R_, r))
-                  , prev_state(PIKA_MOVE(prev_state))
+                operation_state(R_&& r, shared_state_ptr_type state)
+                  : detail::async_rw_mutex_continuation{nullptr, &operation_state::continue_access}
+                  , r(PIKA_FORWARD(R_, r))
                   , state(PIKA_MOVE(state))
                 {
                 }
@@ -431,6 +535,21 @@ namespace pika::execution::experimental {
                 operation_state(operation_state const&) = delete;
                 operation_state& operator=(operation_state const&) = delete;
 
+                static void continue_access(detail::async_rw_mutex_continuation* c) noexcept
+                {
+                    auto& os = static_cast<operation_state&>(*c);
+                    try
+                    {
+                        pika::execution::experimental::set_value(
+                            PIKA_MOVE(os.r), access_type{PIKA_MOVE(os.state)});
+                    }
+                    catch (...)
+                    {
+                        pika::execution::experimental::set_error(
+                            PIKA_MOVE(os.r), std::current_exception());
+                    }
+                }
+
                 friend void tag_invoke(
                     pika::execution::experimental::start_t, operation_state& os) noexcept
                 {
@@ -438,43 +557,17 @@ namespace pika::execution::experimental {
                         "async_rw_lock::sender::operation_state state is empty, was the sender "
                         "already started?");
 
-                    auto continuation = [r = PIKA_MOVE(os.r)](shared_state_ptr_type state) mutable {
-                        try
-                        {
-                            pika::execution::experimental::set_value(
-                                PIKA_MOVE(r), access_type{PIKA_MOVE(state)});
-                        }
-                        catch (...)
-                        {
-                            pika::execution::experimental::set_error(
-                                PIKA_MOVE(r), std::current_exception());
-                        }
-                    };
-
-                    if (auto p = os.prev_state.lock())
-                    {
-                        // If the previous state is set and it's still alive,
-                        // add a continuation to be triggered when the previous
-                        // state is released.
-                        p->add_continuation(PIKA_MOVE(continuation));
-                        os.state.reset();
-                        os.prev_state.reset();
-                    }
-                    else
-                    {
-                        // There is no previous state on the first access or the
-                        // previous state has already been released. We can run
-                        // the continuation immediately.
-                        continuation(PIKA_MOVE(os.state));
-                    }
+                    // The continuation runs immediately if access has already
+                    // been granted, otherwise it runs when the previous state
+                    // is released.
+                    os.state->add_continuation(&os);
                 }
             };
 
             template <typename R>
             friend auto tag_invoke(pika::execution::experimental::connect_t, sender&& s, R&& r)
             {
-                return operation_state<R>{
-                    PIKA_FORWARD(R, r), PIKA_MOVE(s.prev_state), PIKA_MOVE(s.state)};
+                return operation_state<R>{PIKA_FORWARD(R, r), PIKA_MOVE(s.state)};
             }
         };
 
@@ -482,7 +575,6 @@ namespace pika::execution::experimental {
 
         async_rw_mutex_access_type prev_access = async_rw_mutex_access_type::readwrite;
 
-        shared_state_weak_ptr_type prev_state;
         shared_state_ptr_type state;
     };
 
@@ -529,61 +621,53 @@ namespace pika::execution::experimental {
         {
             if (prev_access == async_rw_mutex_access_type::readwrite)
             {
-                auto shared_prev_state = PIKA_MOVE(state);
-                state = std::allocate_shared<shared_state_type, allocator_type>(alloc);
+                add_state();
                 prev_access = async_rw_mutex_access_type::read;
-
-                // Only the first access has no previous shared state. When
-                // there is a previous state we set the next state so that the
-                // value can be passed from the previous state to the next
-                // state. When there is no previous state we need to move the
-                // value to the first state.
-                if (PIKA_LIKELY(shared_prev_state))
-                {
-                    shared_prev_state->set_next_state(state);
-                    prev_state = shared_prev_state;
-                }
-                else { state->set_value(PIKA_MOVE(value)); }
             }
 
-            return {prev_state, state};
+            return {state};
         }
 
         sender<async_rw_mutex_access_type::readwrite> readwrite()
         {
-            auto shared_prev_state = PIKA_MOVE(state);
-            state = std::allocate_shared<shared_state_type, allocator_type>(alloc);
+            add_state();
             prev_access = async_rw_mutex_access_type::readwrite;
 
-            // Only the first access has no previous shared state. When there is
-            // a previous state we set the next state so that the value can be
-            // passed from the previous state to the next state. When there is
-            // no previous state we need to move the value to the first state.
-            if (PIKA_LIKELY(shared_prev_state))
-            {
-                shared_prev_state->set_next_state(state);
-                prev_state = shared_prev_state;
-            }
-            else { state->set_value(PIKA_MOVE(value)); }
-
-            return {prev_state, state};
+            return {state};
         }
 
     private:
         using shared_state_type = detail::async_rw_mutex_shared_state<value_type>;
-        using shared_state_weak_ptr_type = std::weak_ptr<shared_state_type>;
 
         // nvc++ is not able to see this typedef unless it's public
 #if defined(PIKA_NVHPC_VERSION)
     public:
 #endif
-        using shared_state_ptr_type = std::shared_ptr<shared_state_type>;
+        using shared_state_ptr_type = pika::intrusive_ptr<shared_state_type>;
 
     private:
+        void add_state()
+        {
+            auto prev_state = PIKA_MOVE(state);
+            state = detail::async_rw_mutex_allocated_shared_state<shared_state_type,
+                allocator_type>::create(alloc);
+
+            // Only the first access has no previous shared state. When there is
+            // a previous state we set the next state so that the value can be
+            // passed from the previous state to the next state. When there is
+            // no previous state we need to move the value to the first state,
+            // which has access immediately.
+            if (PIKA_LIKELY(prev_state)) { prev_state->set_next_state(state); }
+            else
+            {
+                state->set_value(PIKA_MOVE(value));
+                state->set_ready();
+            }
+        }
+
         template <async_rw_mutex_access_type AccessType>
         struct sender
         {
-            shared_state_weak_ptr_type prev_state;
             shared_state_ptr_type state;
 
             using access_type =
@@ -601,17 +685,15 @@ namespace pika::execution::experimental {
                 pika::execution::experimental::set_error_t(std::exception_ptr)>;
 
             template <typename R>
-            struct operation_state
+            struct operation_state : detail::async_rw_mutex_continuation
             {
                 std::decay_t<R> r;
-                shared_state_weak_ptr_type prev_state;
                 shared_state_ptr_type state;
 
                 template <typename R_>
-                operation_state(
-                    R_&& r, shared_state_weak_ptr_type prev_state, shared_state_ptr_type state)
-                  : r(PIKA_FORWARD(R_, r))
-                  , prev_state(PIKA_MOVE(prev_state))
+                operation_state(R_&& r, shared_state_ptr_type state)
+                  : detail::async_rw_mutex_continuation{nullptr, &operation_state::continue_access}
+                  , r(PIKA_FORWARD(R_, r))
                   , state(PIKA_MOVE(state))
                 {
                 }
@@ -621,6 +703,21 @@ namespace pika::execution::experimental {
                 operation_state(operation_state const&) = delete;
                 operation_state& operator=(operation_state const&) = delete;
 
+                static void continue_access(detail::async_rw_mutex_continuation* c) noexcept
+                {
+                    auto& os = static_cast<operation_state&>(*c);
+                    try
+                    {
+                        pika::execution::experimental::set_value(
+                            PIKA_MOVE(os.r), access_type{PIKA_MOVE(os.state)});
+                    }
+                    catch (...)
+                    {
+                        pika::execution::experimental::set_error(
+                            PIKA_MOVE(os.r), std::current_exception());
+                    }
+                }
+
                 friend void tag_invoke(
                     pika::execution::experimental::start_t, operation_state& os) noexcept
                 {
@@ -628,43 +725,17 @@ namespace pika::execution::experimental {
                         "async_rw_lock::sender::operation_state state is empty, was the sender "
                         "already started?");
 
-                    auto continuation = [r = PIKA_MOVE(os.r)](shared_state_ptr_type state) mutable {
-                        try
-                        {
-                            pika::execution::experimental::set_value(
-                                PIKA_MOVE(r), access_type{PIKA_MOVE(state)});
-                        }
-                        catch (...)
-                        {
-                            pika::execution::experimental::set_error(
-                                PIKA_MOVE(r), std::current_exception());
-                        }
-                    };
-
-                    if (auto p = os.prev_state.lock())
-                    {
-                        // If the previous state is set and it's still alive,
-                        // add a continuation to be triggered when the previous
-                        // state is released.
-                        p->add_continuation(PIKA_MOVE(continuation));
-                        os.state.reset();
-                        os.prev_state.reset();
-                    }
-                    else
-                    {
-                        // There is no previous state on the first access or the
-                        // previous state has already been released. We can run
-                        // the continuation immediately.
-                        continuation(PIKA_MOVE(os.state));
-                    }
+                    // The continuation runs immediately if access has already
+                    // been granted, otherwise it runs when the previous state
+                    // is released.
+                    os.state->add_continuation(&os);
                 }
             };
 
             template <typename R>
             friend auto tag_invoke(pika::execution::experimental::connect_t, sender&& s, R&& r)
             {
-                return operation_state<R>{
-                    PIKA_FORWARD(R, r), PIKA_MOVE(s.prev_state), PIKA_MOVE(s.state)};
+                return operation_state<R>{PIKA_FORWARD(R, r), PIKA_MOVE(s.state)};
             }
 
             template <typename R>
@@ -677,7 +748,7 @@ namespace pika::execution::experimental {
                         "connectable");
                 }
 
-                return operation_state<R>{PIKA_FORWARD(R, r), s.prev_state, s.state};
+                return operation_state<R>{PIKA_FORWARD(R, r), s.state};
             }
         };
 
@@ -686,7 +757,6 @@ namespace pika::execution::experimental {
 
         async_rw_mutex_access_type prev_access = async_rw_mutex_access_type::readwrite;
 
-        shared_state_weak_ptr_type prev_state;
         shared_state_ptr_type state;
     };
 }    // namespace pika::execution::experimental
@@ -11,13 +11,22 @@
 #include <pika/config.hpp>
 #include <pika/assert.hpp>
 #include <pika/concurrency/spinlock.hpp>
+#include <pika/execution_base/operation_state.hpp>
+#include <pika/execution_base/receiver.hpp>
+#include <pika/execution_base/sender.hpp>
 #include <pika/modules/concurrency.hpp>
 #include <pika/modules/errors.hpp>
 #include <pika/modules/thread_support.hpp>
 
+#include <atomic>
 #include <cstddef>
+#include <exception>
 #include <memory>
 #include <mutex>
+#include <new>
+#include <optional>
+#include <string>
+#include <type_traits>
 #include <utility>
 
 namespace pika::experimental {
@@ -168,4 +177,544 @@ namespace pika::experimental {
     template <typename T>
     using channel_mpmc = bounded_channel<T, pika::concurrency::detail::spinlock>;
 
+    namespace detail {
+        // Intrusive list node for operation states of async_get and async_set
+        // waiting for a lock_free_bounded_channel to become non-empty or
+        // non-full. The node is embedded in the operation state so that
+        // waiting does not allocate.
+        struct channel_waiter
+        {
+            channel_waiter* next = nullptr;
+            void (*retry)(channel_waiter*) noexcept = nullptr;
+        };
+
+        // A FIFO list of waiters. The list itself is not thread-safe, but the
+        // number of waiters can be read without holding the lock protecting
+        // the list.
+        struct channel_waiter_list
+        {
+            channel_waiter* head = nullptr;
+            channel_waiter* tail = nullptr;
+            std::atomic<std::size_t> size{0};
+
+            void push(channel_waiter* w) noexcept
+            {
+                w->next = nullptr;
+                if (tail == nullptr) { head = w; }
+                else { tail->next = w; }
+                tail = w;
+            }
+
+            channel_waiter* pop() noexcept
+            {
+                channel_waiter* w = head;
+                if (w != nullptr)
+                {
+                    head = w->next;
+                    if (head == nullptr) { tail = nullptr; }
+                    size.fetch_sub(1, std::memory_order_relaxed);
+                }
+                return w;
+            }
+
+            channel_waiter* pop_all() noexcept
+            {
+                channel_waiter* w = head;
+                head = nullptr;
+                tail = nullptr;
+                size.store(0, std::memory_order_relaxed);
+                return w;
+            }
+        };
+
+        enum class channel_wait_result
+        {
+            ready,
+            closed,
+            waiting
+        };
+    }    // namespace detail
+
+    ////////////////////////////////////////////////////////////////////////////
+    // A lock-free implementation of the channel concept with the same
+    // interface as bounded_channel. This channel is bounded to a size given at
+    // construction time and supports multiple producers and multiple
+    // consumers. The data is stored in a ring-buffer where each slot carries a
+    // sequence number which tells producers and consumers whether the slot is
+    // ready to be written or read (D. Vyukov's bounded MPMC queue). For
+    // position pos in lap pos / size the sequence number of the slot is
+    // 2 * lap when the slot can be written and 2 * lap + 1 when it can be
+    // read. This also works for channels with a single slot.
+    //
+    // In addition to get and set, which return false if the channel is empty
+    // or full, async_get and async_set return senders which complete once a
+    // value or a free slot is available. Waiting senders do not block the
+    // calling pika thread; they are completed inline by the set, get, or
+    // close call which made progress possible.
+    //
+    // Values are moved into and out of a slot after the slot has been
+    // claimed. A claimed slot can't be given back, so moving values must not
+    // throw.
+    template <typename T>
+    class lock_free_bounded_channel
+    {
+        static_assert(std::is_nothrow_move_constructible_v<T>,
+            "lock_free_bounded_channel requires T to be nothrow move constructible");
+        static_assert(std::is_nothrow_move_assignable_v<T>,
+            "lock_free_bounded_channel requires T to be nothrow move assignable");
+
+    private:
+        struct cell
+        {
+            std::atomic<std::size_t> sequence;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            T& value() noexcept { return *std::launder(reinterpret_cast<T*>(&storage)); }
+        };
+
+        template <typename U>
+        bool try_enqueue(U&& u) noexcept
+        {
+            std::size_t pos = tail_.data_.load(std::memory_order_relaxed);
+            cell* c = nullptr;
+            std::size_t lap = 0;
+            for (;;)
+            {
+                c = &buffer_[pos % size_];
+                lap = pos / size_;
+                std::size_t const seq = c->sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t const diff = std::ptrdiff_t(seq - 2 * lap);
+                if (diff == 0)
+                {
+                    if (tail_.data_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // full
+                    return false;
+                }
+                else { pos = tail_.data_.load(std::memory_order_relaxed); }
+            }
+
+            new (&c->storage) T(PIKA_FORWARD(U, u));
+            c->sequence.store(2 * lap + 1, std::memory_order_release);
+            return true;
+        }
+
+        template <typename F>
+        bool try_dequeue(F&& f) const noexcept
+        {
+            std::size_t pos = head_.data_.load(std::memory_order_relaxed);
+            cell* c = nullptr;
+            std::size_t lap = 0;
+            for (;;)
+            {
+                c = &buffer_[pos % size_];
+                lap = pos / size_;
+                std::size_t const seq = c->sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t const diff = std::ptrdiff_t(seq - (2 * lap + 1));
+                if (diff == 0)
+                {
+                    if (head_.data_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // empty
+                    return false;
+                }
+                else { pos = head_.data_.load(std::memory_order_relaxed); }
+            }
+
+            f(PIKA_MOVE(c->value()));
+            c->value().~T();
+            c->sequence.store(2 * lap + 2, std::memory_order_release);
+            return true;
+        }
+
+        // Completes the first waiter in the list, if there is one. The waiter
+        // is completed outside the lock since it may access the channel
+        // again.
+        void notify_one(detail::channel_waiter_list& waiters) const noexcept
+        {
+            // Pairs with the fence in wait: either the waiter sees the value
+            // or free slot made available before calling this function, or
+            // this function sees the waiter.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters.size.load(std::memory_order_relaxed) == 0) { return; }
+
+            detail::channel_waiter* w = nullptr;
+            {
+                std::lock_guard<mutex_type> l(waiters_mtx_.data_);
+                w = waiters.pop();
+            }
+
+            if (w != nullptr) { w->retry(w); }
+        }
+
+        std::size_t notify_all(detail::channel_waiter* w) const noexcept
+        {
+            std::size_t count = 0;
+            while (w != nullptr)
+            {
+                // The waiter may be destroyed by retry
+                detail::channel_waiter* next = w->next;
+                w->retry(w);
+                w = next;
+                ++count;
+            }
+            return count;
+        }
+
+        // Calls try_op. If it fails the waiter is added to the given list
+        // unless the channel has been closed.
+        template <typename F>
+        detail::channel_wait_result wait(
+            detail::channel_waiter_list& waiters, detail::channel_waiter& w, F&& try_op) const
+        {
+            if (closed_.load(std::memory_order_acquire))
+            {
+                return detail::channel_wait_result::closed;
+            }
+            if (try_op()) { return detail::channel_wait_result::ready; }
+
+            std::lock_guard<mutex_type> l(waiters_mtx_.data_);
+
+            // close sets closed_ before taking the lock to complete all
+            // waiters
+            if (closed_.load(std::memory_order_relaxed))
+            {
+                return detail::channel_wait_result::closed;
+            }
+
+            waiters.size.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (try_op())
+            {
+                waiters.size.fetch_sub(1, std::memory_order_relaxed);
+                return detail::channel_wait_result::ready;
+            }
+
+            waiters.push(&w);
+            return detail::channel_wait_result::waiting;
+        }
+
+        // Tries to get a value on behalf of an async_get operation state. The
+        // value is stored in the given optional if available.
+        detail::channel_wait_result get_or_wait(
+            detail::channel_waiter& w, std::optional<T>& value) const
+        {
+            auto result = wait(get_waiters_.data_, w, [&] {
+                return try_dequeue([&](T&& t) { value.emplace(PIKA_MOVE(t)); });
+            });
+            if (result == detail::channel_wait_result::ready) { notify_one(set_waiters_.data_); }
+            return result;
+        }
+
+        // Tries to set a value on behalf of an async_set operation state. The
+        // value is moved from only if a free slot is available.
+        detail::channel_wait_result set_or_wait(detail::channel_waiter& w, T& value)
+        {
+            auto result =
+                wait(set_waiters_.data_, w, [&] { return try_enqueue(PIKA_MOVE(value)); });
+            if (result == detail::channel_wait_result::ready) { notify_one(get_waiters_.data_); }
+            return result;
+        }
+
+        static std::exception_ptr closed_error(char const* func)
+        {
+            return std::make_exception_ptr(pika::exception(pika::error::invalid_status,
+                std::string(func) + ": the channel has been closed"));
+        }
+
+    public:
+        explicit lock_free_bounded_channel(std::size_t size)
+          : size_(size)
+          , buffer_(new cell[size])
+        {
+            PIKA_ASSERT(size != 0);
+
+            for (std::size_t i = 0; i != size_; ++i)
+            {
+                buffer_[i].sequence.store(0, std::memory_order_relaxed);
+            }
+
+            head_.data_.store(0, std::memory_order_relaxed);
+            tail_.data_.store(0, std::memory_order_relaxed);
+        }
+
+        lock_free_bounded_channel(lock_free_bounded_channel&&) = delete;
+        lock_free_bounded_channel& operator=(lock_free_bounded_channel&&) = delete;
+        lock_free_bounded_channel(lock_free_bounded_channel const&) = delete;
+        lock_free_bounded_channel& operator=(lock_free_bounded_channel const&) = delete;
+
+        ~lock_free_bounded_channel()
+        {
+            if (!closed_.load(std::memory_order_acquire)) { close(); }
+
+            // invoke destructors for the values remaining in the buffer
+            std::size_t const tail = tail_.data_.load(std::memory_order_relaxed);
+            for (std::size_t pos = head_.data_.load(std::memory_order_relaxed); pos != tail; ++pos)
+            {
+                buffer_[pos % size_].value().~T();
+            }
+        }
+
+        bool get(T* val = nullptr) const noexcept
+        {
+            if (closed_.load(std::memory_order_acquire)) { return false; }
+
+            if (val == nullptr)
+            {
+                std::size_t const pos = head_.data_.load(std::memory_order_relaxed);
+                return buffer_[pos % size_].sequence.load(std::memory_order_acquire) ==
+                    2 * (pos / size_) + 1;
+            }
+
+            if (!try_dequeue([&](T&& t) { *val = PIKA_MOVE(t); })) { return false; }
+
+            notify_one(set_waiters_.data_);
+            return true;
+        }
+
+        bool set(T&& t) noexcept
+        {
+            if (closed_.load(std::memory_order_acquire)) { return false; }
+
+            if (!try_enqueue(PIKA_MOVE(t))) { return false; }
+
+            notify_one(get_waiters_.data_);
+            return true;
+        }
+
+        // Closes the channel. Senders returned by async_get and async_set
+        // which are waiting are completed with an error. Returns the number
+        // of such senders.
+        std::size_t close()
+        {
+            if (closed_.exchange(true, std::memory_order_acq_rel))
+            {
+                PIKA_THROW_EXCEPTION(pika::error::invalid_status,
+                    "pika::experimental::lock_free_bounded_channel::close",
+                    "attempting to close an already closed channel");
+            }
+
+            detail::channel_waiter* get_waiters = nullptr;
+            detail::channel_waiter* set_waiters = nullptr;
+            {
+                std::lock_guard<mutex_type> l(waiters_mtx_.data_);
+                get_waiters = get_waiters_.data_.pop_all();
+                set_waiters = set_waiters_.data_.pop_all();
+            }
+
+            return notify_all(get_waiters) + notify_all(set_waiters);
+        }
+
+        std::size_t capacity() const { return size_; }
+
+    private:
+        using mutex_type = pika::concurrency::detail::spinlock;
+
+        struct get_sender
+        {
+            lock_free_bounded_channel const* channel;
+
+            template <template <typename...> class Tuple, template <typename...> class Variant>
+            using value_types = Variant<Tuple<T>>;
+
+            template <template <typename...> class Variant>
+            using error_types = Variant<std::exception_ptr>;
+
+            static constexpr bool sends_done = false;
+
+            using completion_signatures = pika::execution::experimental::completion_signatures<
+                pika::execution::experimental::set_value_t(T),
+                pika::execution::experimental::set_error_t(std::exception_ptr)>;
+
+            template <typename R>
+            struct operation_state : detail::channel_waiter
+            {
+                std::decay_t<R> r;
+                lock_free_bounded_channel const* channel;
+                std::optional<T> value;
+
+                template <typename R_>
+                operation_state(R_&& r, lock_free_bounded_channel const* channel)
+                  : detail::channel_waiter{nullptr, &operation_state::retry}
+                  , r(PIKA_FORWARD(R_, r))
+                  , channel(channel)
+                {
+                }
+
+                operation_state(operation_state&&) = delete;
+                operation_state& operator=(operation_state&&) = delete;
+                operation_state(operation_state const&) = delete;
+                operation_state& operator=(operation_state const&) = delete;
+
+                static void retry(detail::channel_waiter* w) noexcept
+                {
+                    auto& os = static_cast<operation_state&>(*w);
+                    try
+                    {
+                        switch (os.channel->get_or_wait(os, os.value))
+                        {
+                        case detail::channel_wait_result::ready:
+                            pika::execution::experimental::set_value(
+                                PIKA_MOVE(os.r), PIKA_MOVE(*os.value));
+                            break;
+                        case detail::channel_wait_result::closed:
+                            pika::execution::experimental::set_error(PIKA_MOVE(os.r),
+                                closed_error("pika::experimental::lock_free_bounded_channel::"
+                                             "async_get"));
+                            break;
+                        case detail::channel_wait_result::waiting: break;
+                        }
+                    }
+                    catch (...)
+                    {
+                        pika::execution::experimental::set_error(
+                            PIKA_MOVE(os.r), std::current_exception());
+                    }
+                }
+
+                friend void tag_invoke(
+                    pika::execution::experimental::start_t, operation_state& os) noexcept
+                {
+                    retry(&os);
+                }
+            };
+
+            template <typename R>
+            friend auto tag_invoke(
+                pika::execution::experimental::connect_t, get_sender const& s, R&& r)
+            {
+                return operation_state<R>{PIKA_FORWARD(R, r), s.channel};
+            }
+        };
+
+        struct set_sender
+        {
+            lock_free_bounded_channel* channel;
+            T value;
+
+            template <template <typename...> class Tuple, template <typename...> class Variant>
+            using value_types = Variant<Tuple<>>;
+
+            template <template <typename...> class Variant>
+            using error_types = Variant<std::exception_ptr>;
+
+            static constexpr bool sends_done = false;
+
+            using completion_signatures = pika::execution::experimental::completion_signatures<
+                pika::execution::experimental::set_value_t(),
+                pika::execution::experimental::set_error_t(std::exception_ptr)>;
+
+            template <typename R>
+            struct operation_state : detail::channel_waiter
+            {
+                std::decay_t<R> r;
+                lock_free_bounded_channel* channel;
+                T value;
+
+                template <typename R_>
+                operation_state(R_&& r, lock_free_bounded_channel* channel, T&& value)
+                  : detail::channel_waiter{nullptr, &operation_state::retry}
+                  , r(PIKA_FORWARD(R_, r))
+                  , channel(channel)
+                  , value(PIKA_MOVE(value))
+                {
+                }
+
+                operation_state(operation_state&&) = delete;
+                operation_state& operator=(operation_state&&) = delete;
+                operation_state(operation_state const&) = delete;
+                operation_state& operator=(operation_state const&) = delete;
+
+                static void retry(detail::channel_waiter* w) noexcept
+                {
+                    auto& os = static_cast<operation_state&>(*w);
+                    try
+                    {
+                        switch (os.channel->set_or_wait(os, os.value))
+                        {
+                        case detail::channel_wait_result::ready:
+                            pika::execution::experimental::set_value(PIKA_MOVE(os.r));
+                            break;
+                        case detail::channel_wait_result::closed:
+                            pika::execution::experimental::set_error(PIKA_MOVE(os.r),
+                                closed_error("pika::experimental::lock_free_bounded_channel::"
+                                             "async_set"));
+                            break;
+                        case detail::channel_wait_result::waiting: break;
+                        }
+                    }
+                    catch (...)
+                    {
+                        pika::execution::experimental::set_error(
+                            PIKA_MOVE(os.r), std::current_exception());
+                    }
+                }
+
+                friend void tag_invoke(
+                    pika::execution::experimental::start_t, operation_state& os) noexcept
+                {
+                    retry(&os);
+                }
+            };
+
+            template <typename R>
+            friend auto tag_invoke(pika::execution::experimental::connect_t, set_sender&& s, R&& r)
+            {
+                return operation_state<R>{PIKA_FORWARD(R, r), s.channel, PIKA_MOVE(s.value)};
+            }
+
+            template <typename R>
+            friend auto tag_invoke(
+                pika::execution::experimental::connect_t, set_sender const& s, R&& r)
+            {
+                return operation_state<R>{PIKA_FORWARD(R, r), s.channel, T(s.value)};
+            }
+        };
+
+    public:
+        // Returns a sender which sends the next value of the channel. If the
+        // channel is empty the sender completes once a value has been set.
+        // The sender completes with an error if the channel is closed.
+        get_sender async_get() const noexcept { return {this}; }
+
+        // Returns a sender which stores the given value in the channel. If
+        // the channel is full the sender completes once a slot has been freed
+        // by a consumer. The sender completes with an error if the channel is
+        // closed.
+        set_sender async_set(T t) { return {this, PIKA_MOVE(t)}; }
+
+    private:
+        // keep the head, the tail, and the waiters in separate cache lines
+        mutable pika::concurrency::detail::cache_aligned_data<std::atomic<std::size_t>> head_;
+        pika::concurrency::detail::cache_aligned_data<std::atomic<std::size_t>> tail_;
+
+        mutable pika::concurrency::detail::cache_aligned_data<mutex_type> waiters_mtx_;
+        mutable pika::concurrency::detail::cache_aligned_data<detail::channel_waiter_list>
+            get_waiters_;
+        mutable pika::concurrency::detail::cache_aligned_data<detail::channel_waiter_list>
+            set_waiters_;
+
+        std::size_t size_;
+
+        // channel buffer
+        std::unique_ptr<cell[]> buffer_;
+
+        // this channel was closed, i.e. no further operations are possible
+        std::atomic<bool> closed_{false};
+    };
+
+    template <typename T>
+    using lock_free_channel_mpmc = lock_free_bounded_channel<T>;
+
 }    // namespace pika::experimental
@@ -172,6 +172,9 @@ namespace pika {
 
     }    // namespace detail
 
+    template <typename Callback>
+    class stop_callback;
+
     ///////////////////////////////////////////////////////////////////////////
     //
     // 32.3.3, class stop_token
@@ -185,6 +188,11 @@ namespace pika {
     class stop_token
     {
     public:
+        // The type of callback that can be registered with this stop token,
+        // as used by stop_callback_for_t in P2300
+        template <typename Callback>
+        using callback_type = stop_callback<Callback>;
+
         // 32.3.3.1 constructors, copy, and assignment
 
         // Postconditions: stop_possible() is false and stop_requested() is
@@ -0,0 +1,85 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark measures the overhead of async_rw_mutex when many concurrent
+// readers access the same value. Each iteration requests read-write access
+// followed by a number of read-only accesses which all run concurrently.
+
+#include <pika/async_rw_mutex.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/modules/timing.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+using pika::chrono::detail::high_resolution_timer;
+
+int pika_main(pika::program_options::variables_map& vm)
+{
+    std::uint64_t const iterations = vm["iterations"].as<std::uint64_t>();
+    std::uint64_t const readers = vm["readers"].as<std::uint64_t>();
+    std::uint64_t const repetitions = vm["repetitions"].as<std::uint64_t>();
+
+    ex::thread_pool_scheduler sched{};
+
+    for (std::uint64_t r = 0; r < repetitions; ++r)
+    {
+        ex::async_rw_mutex<std::uint64_t> m{0};
+        std::vector<ex::unique_any_sender<>> senders;
+        senders.reserve(iterations * (readers + 1));
+
+        high_resolution_timer timer;
+        for (std::uint64_t i = 0; i < iterations; ++i)
+        {
+            senders.emplace_back(m.readwrite() | ex::transfer(sched) |
+                ex::then([](auto w) { ++w.get(); }));
+            for (std::uint64_t j = 0; j < readers; ++j)
+            {
+                senders.emplace_back(m.read() | ex::transfer(sched) | ex::then([i](auto w) {
+                    if (w.get() != i + 1) { std::cerr << "unexpected value\n"; }
+                }));
+            }
+        }
+        tt::sync_wait(ex::when_all_vector(std::move(senders)));
+        double const elapsed = timer.elapsed();
+
+        std::uint64_t const accesses = iterations * (readers + 1);
+        std::cout << "accesses " << accesses << ", readers per write " << readers << ", in "
+                  << elapsed << " s : " << (1e6 * elapsed / accesses) << " us/access\n";
+    }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    pika::program_options::options_description cmdline(
+        "usage: " PIKA_APPLICATION_STRING " [options]");
+
+    // clang-format off
+    cmdline.add_options()
+        ("iterations", pika::program_options::value<std::uint64_t>()->default_value(1000),
+         "number of read-write accesses")
+        ("readers", pika::program_options::value<std::uint64_t>()->default_value(100),
+         "number of concurrent read-only accesses after each read-write access")
+        ("repetitions", pika::program_options::value<std::uint64_t>()->default_value(1),
+         "number of repetitions of the benchmark");
+    // clang-format on
+
+    pika::init_params init_args;
+    init_args.desc_cmdline = cmdline;
+
+    return pika::init(pika_main, argc, argv, init_args);
+}
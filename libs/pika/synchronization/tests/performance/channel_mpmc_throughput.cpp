@@ -12,6 +12,7 @@
 #include <pika/synchronization/channel_mpmc.hpp>
 #include <pika/thread.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -19,6 +20,7 @@
 #include <functional>
 #include <iostream>
 #include <utility>
+#include <vector>
 
 namespace ex = pika::execution::experimental;
 namespace tt = pika::this_thread::experimental;
@@ -42,14 +44,16 @@ constexpr int NUM_TESTS = 100000000;
 #endif
 
 ///////////////////////////////////////////////////////////////////////////////
-inline data channel_get(pika::experimental::channel_mpmc<data> const& c)
+template <typename Channel>
+inline data channel_get(Channel const& c)
 {
     data result;
     while (!c.get(&result)) { pika::this_thread::yield(); }
     return result;
 }
 
-inline void channel_set(pika::experimental::channel_mpmc<data>& c, data&& val)
+template <typename Channel>
+inline void channel_set(Channel& c, data&& val)
 {
     while (!c.set(std::move(val)))    // NOLINT
     {
@@ -59,11 +63,12 @@ inline void channel_set(pika::experimental::channel_mpmc<data>& c, data&& val)
 
 ///////////////////////////////////////////////////////////////////////////////
 // Produce
-double thread_func_0(pika::experimental::channel_mpmc<data>& c)
+template <typename Channel>
+double thread_func_0(Channel& c, int num_items)
 {
     auto start = std::chrono::high_resolution_clock::now();
 
-    for (int i = 0; i != NUM_TESTS; ++i) { channel_set(c, data{i}); }
+    for (int i = 0; i != num_items; ++i) { channel_set(c, data{i}); }
 
     auto end = std::chrono::high_resolution_clock::now();
 
@@ -71,14 +76,15 @@ double thread_func_0(pika::experimental::channel_mpmc<data>& c)
 }
 
 // Consume
-double thread_func_1(pika::experimental::channel_mpmc<data>& c)
+template <typename Channel>
+double thread_func_1(Channel& c, int num_items, bool check_order)
 {
     auto start = std::chrono::high_resolution_clock::now();
 
-    for (int i = 0; i != NUM_TESTS; ++i)
+    for (int i = 0; i != num_items; ++i)
     {
         data d = channel_get(c);
-        if (d.data_[0] != i) { std::cout << "Error!\n"; }
+        if (check_order && d.data_[0] != i) { std::cout << "Error!\n"; }
     }
 
     auto end = std::chrono::high_resolution_clock::now();
@@ -86,27 +92,80 @@ double thread_func_1(pika::experimental::channel_mpmc<data>& c)
     return std::chrono::duration<double>(end - start).count();
 }
 
-int pika_main()
+template <typename Channel>
+void run_benchmark(char const* name, int producers, int consumers)
 {
     auto sched = ex::thread_pool_scheduler{};
 
-    pika::experimental::channel_mpmc<data> c(10000);
+    Channel c(10000);
 
-    ex::unique_any_sender<double> producer =
-        ex::transfer_just(sched, std::ref(c)) | ex::then(thread_func_0) | ex::ensure_started();
-    ex::unique_any_sender<double> consumer =
-        ex::transfer_just(sched, std::ref(c)) | ex::then(thread_func_1) | ex::ensure_started();
+    // The order of values is only checked with a single producer and a single
+    // consumer
+    bool const check_order = producers == 1 && consumers == 1;
 
-    auto producer_time = tt::sync_wait(std::move(producer));
+    std::vector<ex::unique_any_sender<double>> producer_senders;
+    for (int i = 0; i != producers; ++i)
+    {
+        producer_senders.emplace_back(ex::transfer_just(sched, std::ref(c), NUM_TESTS / producers) |
+            ex::then(thread_func_0<Channel>) | ex::ensure_started());
+    }
+
+    std::vector<ex::unique_any_sender<double>> consumer_senders;
+    for (int i = 0; i != consumers; ++i)
+    {
+        consumer_senders.emplace_back(
+            ex::transfer_just(sched, std::ref(c), NUM_TESTS / consumers, check_order) |
+            ex::then(thread_func_1<Channel>) | ex::ensure_started());
+    }
+
+    auto producer_times = tt::sync_wait(ex::when_all_vector(std::move(producer_senders)));
+    auto consumer_times = tt::sync_wait(ex::when_all_vector(std::move(consumer_senders)));
+
+    double const producer_time = *std::max_element(producer_times.begin(), producer_times.end());
+    double const consumer_time = *std::max_element(consumer_times.begin(), consumer_times.end());
+
+    std::cout << name << " (" << producers << " producers, " << consumers << " consumers)\n";
     std::cout << "Producer throughput: " << (NUM_TESTS / producer_time) << " [op/s] ("
               << (producer_time / NUM_TESTS) << " [s/op])\n";
-
-    auto consumer_time = tt::sync_wait(std::move(consumer));
     std::cout << "Consumer throughput: " << (NUM_TESTS / consumer_time) << " [op/s] ("
               << (consumer_time / NUM_TESTS) << " [s/op])\n";
+}
+
+int pika_main(pika::program_options::variables_map& vm)
+{
+    int const producers = vm["producers"].as<int>();
+    int const consumers = vm["consumers"].as<int>();
+
+    if (NUM_TESTS % producers != 0 || NUM_TESTS % consumers != 0)
+    {
+        std::cerr << "the number of producers and consumers must divide " << NUM_TESTS << "\n";
+        pika::finalize();
+        return EXIT_FAILURE;
+    }
+
+    run_benchmark<pika::experimental::channel_mpmc<data>>("channel_mpmc", producers, consumers);
+    run_benchmark<pika::experimental::lock_free_channel_mpmc<data>>(
+        "lock_free_channel_mpmc", producers, consumers);
 
     pika::finalize();
     return EXIT_SUCCESS;
 }
 
-int main(int argc, char* argv[]) { return pika::init(pika_main, argc, argv); }
+int main(int argc, char* argv[])
+{
+    pika::program_options::options_description cmdline(
+        "usage: " PIKA_APPLICATION_STRING " [options]");
+
+    // clang-format off
+    cmdline.add_options()
+        ("producers", pika::program_options::value<int>()->default_value(1),
+         "number of producers")
+        ("consumers", pika::program_options::value<int>()->default_value(1),
+         "number of consumers");
+    // clang-format on
+
+    pika::init_params init_args;
+    init_args.desc_cmdline = cmdline;
+
+    return pika::init(pika_main, argc, argv, init_args);
+}
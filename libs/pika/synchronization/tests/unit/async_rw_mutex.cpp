@@ -280,6 +280,67 @@ void test_multiple_when_all(async_rw_mutex<ReadWriteT, ReadT> rwm)
     }
 }
 
+// Stateful allocator which counts the shared states that are alive. Stateful
+// allocators bypass the thread-local cache of shared states.
+template <typename T>
+struct counting_allocator
+{
+    using value_type = T;
+
+    std::atomic<std::ptrdiff_t>* count;
+
+    explicit counting_allocator(std::atomic<std::ptrdiff_t>& count)
+      : count(&count)
+    {
+    }
+
+    template <typename U>
+    counting_allocator(counting_allocator<U> const& other)
+      : count(other.count)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        ++*count;
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        --*count;
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    friend bool operator==(counting_allocator const& a, counting_allocator const& b)
+    {
+        return a.count == b.count;
+    }
+
+    friend bool operator!=(counting_allocator const& a, counting_allocator const& b)
+    {
+        return !(a == b);
+    }
+};
+
+void test_allocator()
+{
+    std::atomic<std::ptrdiff_t> count{0};
+    {
+        async_rw_mutex<std::size_t, std::size_t, counting_allocator<int>> rwm{
+            std::size_t(0), counting_allocator<int>(count)};
+        sync_wait(rwm.readwrite() | then([](auto x) { ++x.get(); }));
+        auto s1 = rwm.read() | then([](auto x) { PIKA_TEST_EQ(x.get(), std::size_t(1)); });
+        auto s2 = rwm.read() | then([](auto x) { PIKA_TEST_EQ(x.get(), std::size_t(1)); });
+        // The readers share a state, and the state of the previous read-write
+        // access has already been released
+        PIKA_TEST_EQ(count.load(), std::ptrdiff_t(1));
+        sync_wait(when_all(std::move(s2), std::move(s1)));
+        sync_wait(rwm.readwrite() | then([](auto x) { PIKA_TEST_EQ(x.get(), std::size_t(1)); }));
+    }
+    PIKA_TEST_EQ(count.load(), std::ptrdiff_t(0));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 int pika_main(pika::program_options::variables_map& vm)
 {
@@ -318,6 +379,8 @@ int pika_main(pika::program_options::variables_map& vm)
     test_multiple_when_all(async_rw_mutex<std::size_t>{0});
     test_multiple_when_all(async_rw_mutex<mytype, mytype_base>{mytype{}});
 
+    test_allocator();
+
     pika::finalize();
     return EXIT_SUCCESS;
 }
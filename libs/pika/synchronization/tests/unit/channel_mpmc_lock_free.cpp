@@ -0,0 +1,211 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/synchronization/channel_mpmc.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+#if defined(PIKA_HAVE_VALGRIND)
+constexpr int NUM_ITEMS = 100;
+#else
+constexpr int NUM_ITEMS = 10000;
+#endif
+
+constexpr int NUM_PRODUCERS = 4;
+constexpr int NUM_CONSUMERS = 4;
+
+///////////////////////////////////////////////////////////////////////////////
+void test_get_set()
+{
+    pika::experimental::lock_free_channel_mpmc<int> c(3);
+    PIKA_TEST_EQ(c.capacity(), std::size_t(3));
+
+    PIKA_TEST(!c.get());
+    PIKA_TEST(c.set(1));
+    PIKA_TEST(c.set(2));
+    PIKA_TEST(c.set(3));
+    PIKA_TEST(!c.set(4));
+    PIKA_TEST(c.get());
+
+    int value = 0;
+    PIKA_TEST(c.get(&value));
+    PIKA_TEST_EQ(value, 1);
+    PIKA_TEST(c.set(4));
+    for (int expected : {2, 3, 4})
+    {
+        PIKA_TEST(c.get(&value));
+        PIKA_TEST_EQ(value, expected);
+    }
+    PIKA_TEST(!c.get(&value));
+
+    PIKA_TEST_EQ(c.close(), std::size_t(0));
+    PIKA_TEST(!c.set(5));
+    PIKA_TEST(!c.get(&value));
+
+    bool caught_exception = false;
+    try
+    {
+        c.close();
+    }
+    catch (pika::exception const&)
+    {
+        caught_exception = true;
+    }
+    PIKA_TEST(caught_exception);
+}
+
+// Values left in the channel are destroyed with the channel
+void test_destroy_values()
+{
+    auto p = std::make_shared<int>(42);
+    {
+        pika::experimental::lock_free_channel_mpmc<std::shared_ptr<int>> c(2);
+        PIKA_TEST(c.set(std::shared_ptr<int>(p)));
+        PIKA_TEST(c.set(std::shared_ptr<int>(p)));
+        PIKA_TEST_EQ(p.use_count(), 3);
+    }
+    PIKA_TEST_EQ(p.use_count(), 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Senders waiting for values or free slots complete once another operation
+// makes progress possible
+void test_async_wait()
+{
+    pika::experimental::lock_free_channel_mpmc<int> c(1);
+
+    std::atomic<int> received{0};
+    ex::start_detached(c.async_get() | ex::then([&](int value) { received = value; }));
+    PIKA_TEST_EQ(received.load(), 0);
+
+    PIKA_TEST(c.set(42));
+    PIKA_TEST_EQ(received.load(), 42);
+    PIKA_TEST(!c.get());
+
+    tt::sync_wait(c.async_set(1));
+
+    std::atomic<bool> set_done{false};
+    ex::start_detached(c.async_set(2) | ex::then([&] { set_done = true; }));
+    PIKA_TEST(!set_done.load());
+
+    int value = 0;
+    PIKA_TEST(c.get(&value));
+    PIKA_TEST_EQ(value, 1);
+    PIKA_TEST(set_done.load());
+    PIKA_TEST_EQ(tt::sync_wait(c.async_get()), 2);
+}
+
+// Waiting senders complete with an error when the channel is closed
+void test_async_close()
+{
+    pika::experimental::lock_free_channel_mpmc<int> c(1);
+
+    std::atomic<bool> caught_exception{false};
+    ex::start_detached(c.async_get() | ex::then([](int) { PIKA_TEST(false); }) |
+        ex::let_error([&](std::exception_ptr) {
+            caught_exception = true;
+            return ex::just();
+        }));
+
+    PIKA_TEST(!caught_exception.load());
+    PIKA_TEST_EQ(c.close(), std::size_t(1));
+    PIKA_TEST(caught_exception.load());
+
+    bool caught_set_exception = false;
+    try
+    {
+        tt::sync_wait(c.async_set(1));
+    }
+    catch (pika::exception const&)
+    {
+        caught_set_exception = true;
+    }
+    PIKA_TEST(caught_set_exception);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Multiple producers and consumers using the sender interface
+void test_async_mpmc()
+{
+    pika::experimental::lock_free_channel_mpmc<int> c(16);
+    auto sched = ex::thread_pool_scheduler{};
+
+    std::vector<ex::unique_any_sender<>> producers;
+    for (int p = 0; p != NUM_PRODUCERS; ++p)
+    {
+        producers.emplace_back(ex::schedule(sched) | ex::then([&c, p] {
+            for (int i = 0; i != NUM_ITEMS; ++i)
+            {
+                tt::sync_wait(c.async_set(p * NUM_ITEMS + i));
+            }
+        }) | ex::ensure_started());
+    }
+
+    std::vector<ex::unique_any_sender<std::vector<int>>> consumers;
+    for (int p = 0; p != NUM_CONSUMERS; ++p)
+    {
+        consumers.emplace_back(ex::schedule(sched) | ex::then([&c] {
+            std::vector<int> values;
+            values.reserve(NUM_ITEMS * NUM_PRODUCERS / NUM_CONSUMERS);
+            for (int i = 0; i != NUM_ITEMS * NUM_PRODUCERS / NUM_CONSUMERS; ++i)
+            {
+                values.push_back(tt::sync_wait(c.async_get()));
+            }
+            return values;
+        }) | ex::ensure_started());
+    }
+
+    tt::sync_wait(ex::when_all_vector(std::move(producers)));
+    auto results = tt::sync_wait(ex::when_all_vector(std::move(consumers)));
+
+    std::vector<int> counts(NUM_ITEMS * NUM_PRODUCERS, 0);
+    for (auto const& values : results)
+    {
+        int last_value[NUM_PRODUCERS] = {};
+        for (int& v : last_value) { v = -1; }
+
+        for (int value : values)
+        {
+            ++counts[value];
+
+            // Values from a single producer arrive in order at each consumer
+            int const producer = value / NUM_ITEMS;
+            PIKA_TEST_LT(last_value[producer], value);
+            last_value[producer] = value;
+        }
+    }
+
+    for (int count : counts) { PIKA_TEST_EQ(count, 1); }
+    PIKA_TEST(!c.get());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int pika_main()
+{
+    test_get_set();
+    test_destroy_values();
+    test_async_wait();
+    test_async_close();
+    test_async_mpmc();
+
+    pika::finalize();
+    return 0;
+}
+
+int main(int argc, char* argv[]) { return pika::init(pika_main, argc, argv); }
@@ -121,10 +121,18 @@ namespace pika::threads::detail {
         std::ptrdiff_t large_stacksize = rtcfg_.get_stack_size(execution::thread_stacksize::large);
         std::ptrdiff_t huge_stacksize = rtcfg_.get_stack_size(execution::thread_stacksize::huge);
 
+        std::int64_t const stack_cache_magazine_size = pika::detail::get_entry_as<std::int64_t>(
+            rtcfg_, "pika.stacks.cache_magazine_size", 64);
+        std::int64_t const stack_cache_high_water_mark = pika::detail::get_entry_as<std::int64_t>(
+            rtcfg_, "pika.stacks.cache_high_water_mark", -1);
+        std::int64_t const stack_cache_trim_interval = pika::detail::get_entry_as<std::int64_t>(
+            rtcfg_, "pika.stacks.cache_trim_interval", 1000);
+
         thread_queue_init_parameters thread_queue_init(max_thread_count, min_tasks_to_steal_pending,
             min_tasks_to_steal_staged, min_add_new_count, max_add_new_count, min_delete_count,
             max_delete_count, max_terminated_threads, init_threads_count, max_idle_backoff_time,
-            small_stacksize, medium_stacksize, large_stacksize, huge_stacksize);
+            small_stacksize, medium_stacksize, large_stacksize, huge_stacksize,
+            stack_cache_magazine_size, stack_cache_high_water_mark, stack_cache_trim_interval);
 
         // instantiate the pools
         for (size_t i = 0; i != num_pools; i++)
@@ -425,6 +433,52 @@ namespace pika::threads::detail {
                 pools_.push_back(PIKA_MOVE(pool));
                 break;
             }
+
+            case resource::work_stealing:
+            {
+                // instantiate the scheduler
+                using local_sched_type = pika::threads::detail::work_stealing_scheduler<>;
+                local_sched_type::init_parameter_type init(thread_pool_init.num_threads_,
+                    thread_pool_init.affinity_data_, thread_queue_init,
+                    "core-work_stealing_scheduler");
+
+                std::unique_ptr<local_sched_type> sched(new local_sched_type(init));
+
+                // set the default scheduler flags
+                sched->set_scheduler_mode(thread_pool_init.mode_);
+                // conditionally set/unset this flag
+                sched->update_scheduler_mode(scheduler_mode::enable_stealing_numa, !numa_sensitive);
+
+                // instantiate the pool
+                std::unique_ptr<thread_pool_base> pool(
+                    new pika::threads::detail::scheduled_thread_pool<local_sched_type>(
+                        PIKA_MOVE(sched), thread_pool_init));
+                pools_.push_back(PIKA_MOVE(pool));
+                break;
+            }
+
+            case resource::deadline:
+            {
+                // instantiate the scheduler
+                using local_sched_type = pika::threads::detail::deadline_queue_scheduler<>;
+                local_sched_type::init_parameter_type init(thread_pool_init.num_threads_,
+                    thread_pool_init.affinity_data_, thread_queue_init,
+                    "core-deadline_queue_scheduler");
+
+                std::unique_ptr<local_sched_type> sched(new local_sched_type(init));
+
+                // set the default scheduler flags
+                sched->set_scheduler_mode(thread_pool_init.mode_);
+                // conditionally set/unset this flag
+                sched->update_scheduler_mode(scheduler_mode::enable_stealing_numa, !numa_sensitive);
+
+                // instantiate the pool
+                std::unique_ptr<thread_pool_base> pool(
+                    new pika::threads::detail::scheduled_thread_pool<local_sched_type>(
+                        PIKA_MOVE(sched), thread_pool_init));
+                pools_.push_back(PIKA_MOVE(pool));
+                break;
+            }
             }
 
             // update the thread_offset for the next pool
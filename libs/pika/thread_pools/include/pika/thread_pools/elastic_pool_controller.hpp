@@ -0,0 +1,104 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <pika/config/warnings_prefix.hpp>
+
+namespace pika::threads::detail {
+    struct elastic_pool_parameters
+    {
+        /// The controller never suspends processing units below this number
+        /// of active processing units
+        std::size_t min_threads = 1;
+
+        /// The controller never resumes processing units beyond this number
+        /// of active processing units. std::size_t(-1) means all processing
+        /// units of the pool.
+        std::size_t max_threads = std::size_t(-1);
+
+        /// Time between two samples of the load of the pool
+        std::chrono::milliseconds interval{10};
+
+        /// A processing unit is suspended when the average fraction of active
+        /// processing units which run tasks stays below this value
+        double suspend_utilization = 0.5;
+
+        /// A processing unit is resumed when the number of queued tasks per
+        /// active processing unit exceeds this value
+        double resume_backlog = 2.0;
+
+        /// The load has to stay on the same side of a threshold for this many
+        /// samples before the controller acts on it, and the controller waits
+        /// for as many samples after changing the number of processing units
+        std::size_t stable_samples = 5;
+    };
+
+    /// Adjusts the number of active processing units of a thread pool to its
+    /// load. The controller periodically samples the queue length and the
+    /// utilization of the pool from a separate OS thread. It suspends
+    /// processing units while the pool is underutilized and resumes them when
+    /// a backlog of tasks builds up.
+    ///
+    /// The pool must have been created with scheduler_mode::enable_elasticity.
+    /// Only the processing units suspended by the controller are resumed by
+    /// it, and they are all resumed when the controller is destroyed. The
+    /// controller has to be destroyed before the runtime is stopped.
+    class PIKA_EXPORT elastic_pool_controller
+    {
+    public:
+        explicit elastic_pool_controller(
+            thread_pool_base& pool, elastic_pool_parameters const& params = {});
+        ~elastic_pool_controller();
+
+        PIKA_NON_COPYABLE(elastic_pool_controller);
+
+        /// Returns the number of processing units currently suspended by the
+        /// controller
+        std::size_t get_num_suspended() const;
+
+    private:
+        void run();
+        void sample();
+        bool suspend_one();
+        bool resume_one();
+
+        thread_pool_base& pool_;
+        elastic_pool_parameters const params_;
+        std::size_t const num_threads_;
+        std::size_t const max_threads_;
+
+        // Smoothed number of processing units running tasks
+        double busy_threads_ = 0.0;
+
+        // Number of consecutive samples above or below the thresholds
+        std::size_t samples_underutilized_ = 0;
+        std::size_t samples_backlogged_ = 0;
+
+        // Processing units suspended by the controller, in the order they
+        // were suspended
+        std::vector<std::size_t> suspended_;
+
+        mutable std::mutex mtx_;
+        std::condition_variable cond_;
+        bool stop_ = false;
+
+        std::thread thread_;
+    };
+}    // namespace pika::threads::detail
+
+#include <pika/config/warnings_suffix.hpp>
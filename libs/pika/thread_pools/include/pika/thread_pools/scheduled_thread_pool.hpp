@@ -188,7 +188,22 @@ namespace pika::threads::detail {
         {
             return sched_->Scheduler::get_num_stolen_to_staged(num, reset);
         }
+
+        std::int64_t get_num_steal_successes(std::size_t num, bool reset) override
+        {
+            return sched_->Scheduler::get_num_steal_successes(num, reset);
+        }
+
+        std::int64_t get_num_steal_failures(std::size_t num, bool reset) override
+        {
+            return sched_->Scheduler::get_num_steal_failures(num, reset);
+        }
 #endif
+        std::int64_t get_num_deadline_misses(std::size_t num, bool reset) override
+        {
+            return sched_->Scheduler::get_num_deadline_misses(num, reset);
+        }
+
         std::int64_t get_queue_length(std::size_t num_thread, bool /* reset */) override
         {
             return sched_->Scheduler::get_queue_length(num_thread);
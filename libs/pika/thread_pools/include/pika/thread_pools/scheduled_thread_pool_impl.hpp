@@ -217,7 +217,7 @@ namespace pika::threads::detail {
             sched_->Scheduler::set_all_states_at_least(runtime_state::stopping);
 
             // make sure we're not waiting
-            sched_->Scheduler::do_some_work(std::size_t(-1));
+            sched_->Scheduler::wake_all_workers();
 
             if (blocking)
             {
@@ -229,7 +229,7 @@ namespace pika::threads::detail {
                     // make sure no OS thread is waiting
                     LTM_(info).format("stop: {} notify_all", id_.name());
 
-                    sched_->Scheduler::do_some_work(std::size_t(-1));
+                    sched_->Scheduler::wake_all_workers();
 
                     LTM_(info).format("stop: {} join:{}", id_.name(), i);
 
@@ -1252,10 +1252,13 @@ namespace pika::threads::detail {
     template <typename Scheduler>
     std::int64_t scheduled_thread_pool<Scheduler>::get_scheduler_utilization() const
     {
+        std::size_t const thread_count = thread_count_.load();
+        if (thread_count == 0) { return 0; }
+
         return (accumulate_projected(counter_data_.begin(), counter_data_.end(), std::int64_t(0),
                     &scheduling_counter_data::tasks_active_) *
                    100) /
-            thread_count_.load();
+            std::int64_t(thread_count);
     }
 
     template <typename Scheduler>
@@ -11,6 +11,7 @@
 #include <pika/functional/unique_function.hpp>
 #include <pika/modules/itt_notify.hpp>
 #include <pika/modules/logging.hpp>
+#include <pika/threading_base/detail/task_trace.hpp>
 #include <pika/threading_base/external_timer.hpp>
 #include <pika/threading_base/scheduler_base.hpp>
 #include <pika/threading_base/scheduler_state.hpp>
@@ -369,7 +370,9 @@ namespace pika::threads::detail {
             bool enable_stealing_staged =
                 enable_stealing && idle_loop_count > params.max_idle_loop_count_ / 2;
 
-            if (PIKA_LIKELY(thrd ||
+            // a thread made pending by the previous thread on this worker
+            // thread runs before the queues are checked
+            if (PIKA_LIKELY(thrd || scheduler.get_next_thread_from_slot(num_thread, thrd) ||
                     scheduler.SchedulingPolicy::get_next_thread(
                         num_thread, running, thrd, enable_stealing)))
             {
@@ -421,6 +424,15 @@ namespace pika::threads::detail {
                                 // and add to aggregate execution time.
                                 exec_time_wrapper exec_time_collector(idle_rate);
 
+                                bool const trace = is_task_trace_enabled();
+                                if (PIKA_UNLIKELY(trace))
+                                {
+                                    record_task_trace_event(thrdptr->set_trace_started() ?
+                                            task_trace_event::resume :
+                                            task_trace_event::start,
+                                        thrdptr, nullptr, thrdptr->get_description());
+                                }
+
 #if defined(PIKA_HAVE_APEX)
                                 // get the APEX data pointer, in case we are resuming the
                                 // thread and have to restore any leaf timers from
@@ -460,6 +472,15 @@ namespace pika::threads::detail {
 
                                 thrd_stat = (*thrdptr)(context_storage);
 #endif
+
+                                if (PIKA_UNLIKELY(trace))
+                                {
+                                    record_task_trace_event(thrd_stat.get_previous() ==
+                                                thread_schedule_state::terminated ?
+                                            task_trace_event::terminate :
+                                            task_trace_event::suspend,
+                                        thrdptr, nullptr, ::pika::detail::thread_description());
+                                }
                             }
 
                             write_state_log(scheduler, num_thread, thrd,
@@ -631,7 +652,14 @@ namespace pika::threads::detail {
                 }
             }
 
-            if (scheduler.custom_polling_function() == pika::threads::detail::polling_status::busy)
+            if (scheduler.custom_polling_function(num_thread) ==
+                pika::threads::detail::polling_status::busy)
+            {
+                idle_loop_count = 0;
+            }
+
+            // expire timers, this may make suspended threads pending again
+            if (scheduler.poll_timers() == pika::threads::detail::polling_status::busy)
             {
                 idle_loop_count = 0;
             }
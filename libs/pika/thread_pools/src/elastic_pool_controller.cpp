@@ -0,0 +1,188 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/modules/errors.hpp>
+#include <pika/modules/logging.hpp>
+#include <pika/thread_pools/elastic_pool_controller.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
+#include <pika/threading_base/scheduler_mode.hpp>
+#include <pika/threading_base/scheduler_state.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace pika::threads::detail {
+    namespace {
+        // Weight of the most recent sample in the smoothed utilization
+        constexpr double utilization_smoothing = 0.25;
+    }    // namespace
+
+    elastic_pool_controller::elastic_pool_controller(
+        thread_pool_base& pool, elastic_pool_parameters const& params)
+      : pool_(pool)
+      , params_(params)
+      , num_threads_(pool.get_os_thread_count())
+      , max_threads_((std::min)(params.max_threads, num_threads_))
+    {
+        if (pool_.get_scheduler() == nullptr ||
+            !pool_.get_scheduler()->has_scheduler_mode(scheduler_mode::enable_elasticity))
+        {
+            PIKA_THROW_EXCEPTION(pika::error::invalid_status,
+                "elastic_pool_controller::elastic_pool_controller",
+                "the thread pool {} does not support suspending processing units",
+                pool_.get_pool_name());
+        }
+
+        if (params_.min_threads == 0 || params_.min_threads > max_threads_)
+        {
+            PIKA_THROW_EXCEPTION(pika::error::bad_parameter,
+                "elastic_pool_controller::elastic_pool_controller",
+                "the minimum number of threads ({}) has to be between 1 and the maximum number "
+                "of threads ({})",
+                params_.min_threads, max_threads_);
+        }
+
+        suspended_.reserve(num_threads_);
+        thread_ = std::thread([this] { run(); });
+    }
+
+    elastic_pool_controller::~elastic_pool_controller()
+    {
+        {
+            std::lock_guard<std::mutex> l(mtx_);
+            stop_ = true;
+        }
+        cond_.notify_one();
+        thread_.join();
+
+        // Leave the pool in the state the controller found it in
+        for (std::size_t virt_core : suspended_)
+        {
+            error_code ec(throwmode::lightweight);
+            pool_.resume_processing_unit_direct(virt_core, ec);
+        }
+    }
+
+    std::size_t elastic_pool_controller::get_num_suspended() const
+    {
+        std::lock_guard<std::mutex> l(mtx_);
+        return suspended_.size();
+    }
+
+    void elastic_pool_controller::run()
+    {
+        std::unique_lock<std::mutex> l(mtx_);
+        while (!cond_.wait_for(l, params_.interval, [this] { return stop_; }))
+        {
+            l.unlock();
+            sample();
+            l.lock();
+        }
+    }
+
+    void elastic_pool_controller::sample()
+    {
+        std::size_t const active = pool_.get_active_os_thread_count();
+        if (active == 0) { return; }
+
+        // Number of processing units which ran tasks since the last sample,
+        // or which are running a task right now if idle rates are not tracked
+#if defined(PIKA_HAVE_THREAD_IDLE_RATES)
+        double const idle_rate = double(pool_.avg_idle_rate_all(true)) / 10000.;
+        double const busy = (1. - idle_rate) * double(active);
+#else
+        double const busy =
+            double(pool_.get_scheduler_utilization()) * double(num_threads_) / 100.;
+#endif
+        busy_threads_ += utilization_smoothing * (busy - busy_threads_);
+
+        double const backlog =
+            double(pool_.get_queue_length(std::size_t(-1), false)) / double(active);
+
+        if (backlog > params_.resume_backlog)
+        {
+            samples_underutilized_ = 0;
+            if (++samples_backlogged_ >= params_.stable_samples && active < max_threads_ &&
+                resume_one())
+            {
+                samples_backlogged_ = 0;
+            }
+        }
+        else if (busy_threads_ < params_.suspend_utilization * double(active))
+        {
+            samples_backlogged_ = 0;
+            if (++samples_underutilized_ >= params_.stable_samples &&
+                active > params_.min_threads && suspend_one())
+            {
+                samples_underutilized_ = 0;
+            }
+        }
+        else
+        {
+            samples_backlogged_ = 0;
+            samples_underutilized_ = 0;
+        }
+    }
+
+    bool elastic_pool_controller::suspend_one()
+    {
+        // Suspend the running processing unit with the highest index so that
+        // the active processing units stay packed at the start of the pool
+        for (std::size_t virt_core = num_threads_; virt_core-- != 0;)
+        {
+            if (pool_.get_scheduler()->get_state(virt_core).load() != runtime_state::running)
+            {
+                continue;
+            }
+
+            error_code ec(throwmode::lightweight);
+            pool_.suspend_processing_unit_direct(virt_core, ec);
+            if (ec) { return false; }
+
+            LTM_(info).format("elastic_pool_controller: pool({}), suspended processing unit {}",
+                pool_.get_pool_name(), virt_core);
+
+            std::lock_guard<std::mutex> l(mtx_);
+            suspended_.push_back(virt_core);
+            return true;
+        }
+
+        return false;
+    }
+
+    bool elastic_pool_controller::resume_one()
+    {
+        std::size_t virt_core = 0;
+        {
+            std::lock_guard<std::mutex> l(mtx_);
+            if (suspended_.empty()) { return false; }
+
+            // Resume the processing unit which was suspended last
+            virt_core = suspended_.back();
+            suspended_.pop_back();
+        }
+
+        error_code ec(throwmode::lightweight);
+        pool_.resume_processing_unit_direct(virt_core, ec);
+        if (ec)
+        {
+            std::lock_guard<std::mutex> l(mtx_);
+            suspended_.push_back(virt_core);
+            return false;
+        }
+
+        LTM_(info).format("elastic_pool_controller: pool({}), resumed processing unit {}",
+            pool_.get_pool_name(), virt_core);
+
+        return true;
+    }
+}    // namespace pika::threads::detail
@@ -5,11 +5,13 @@
 //  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
 #include <pika/config.hpp>
+#include <pika/schedulers/deadline_queue_scheduler.hpp>
 #include <pika/schedulers/local_priority_queue_scheduler.hpp>
 #include <pika/schedulers/local_queue_scheduler.hpp>
 #include <pika/schedulers/shared_priority_queue_scheduler.hpp>
 #include <pika/schedulers/static_priority_queue_scheduler.hpp>
 #include <pika/schedulers/static_queue_scheduler.hpp>
+#include <pika/schedulers/work_stealing_scheduler.hpp>
 #include <pika/thread_pools/scheduled_thread_pool.hpp>
 #include <pika/thread_pools/scheduled_thread_pool_impl.hpp>
 
@@ -51,3 +53,11 @@ template class PIKA_EXPORT pika::threads::detail::scheduled_thread_pool<pika::th
 template class PIKA_EXPORT pika::threads::detail::shared_priority_queue_scheduler<>;
 template class PIKA_EXPORT pika::threads::detail::scheduled_thread_pool<
     pika::threads::detail::shared_priority_queue_scheduler<>>;
+
+template class PIKA_EXPORT pika::threads::detail::work_stealing_scheduler<>;
+template class PIKA_EXPORT pika::threads::detail::scheduled_thread_pool<
+    pika::threads::detail::work_stealing_scheduler<>>;
+
+template class PIKA_EXPORT pika::threads::detail::deadline_queue_scheduler<>;
+template class PIKA_EXPORT pika::threads::detail::scheduled_thread_pool<
+    pika::threads::detail::deadline_queue_scheduler<>>;
@@ -11,7 +11,16 @@
 #include <cstddef>
 
 namespace pika::threads::detail {
+    /// Marks the start of an activity (a pika thread or e.g. an outstanding
+    /// MPI request) which the runtime should wait for. The count is sharded
+    /// per OS thread, so an activity may be started and finished by
+    /// different threads without contending on a single cache line.
     PIKA_EXPORT void increment_global_activity_count();
     PIKA_EXPORT void decrement_global_activity_count();
+
+    /// Returns the number of activities which have been started but not
+    /// finished. The result is never smaller than the number of activities
+    /// running throughout the call, and is zero only if no activity was
+    /// running at some point during the call.
     PIKA_EXPORT std::size_t get_global_activity_count();
 }    // namespace pika::threads::detail
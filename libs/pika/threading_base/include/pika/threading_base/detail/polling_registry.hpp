@@ -0,0 +1,121 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/concurrency/cache_line_data.hpp>
+#include <pika/functional/function.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <pika/config/warnings_prefix.hpp>
+
+namespace pika::threads::detail {
+    enum class polling_status
+    {
+        /// Signals that a polling function currently has no more work to do
+        idle = 0,
+        /// Signals that a polling function still has outstanding work to
+        /// poll for
+        busy = 1
+    };
+
+    /// A source of work that is polled from the scheduling loop of the worker
+    /// threads of a pool, e.g. the completions of MPI requests or CUDA events.
+    struct polling_source
+    {
+        using poll_function_type = pika::util::detail::function<polling_status()>;
+        using work_count_function_type = pika::util::detail::function<std::size_t()>;
+
+        /// Polls for completed work. This may be called concurrently from all
+        /// worker threads of the pool.
+        poll_function_type poll;
+
+        /// Returns the number of outstanding operations of the source. A
+        /// pool is not considered idle while this is non-zero. May be empty
+        /// if the source never has outstanding work.
+        work_count_function_type work_count;
+
+        /// The source is polled on every frequency-th iteration of the
+        /// scheduling loop of each worker thread.
+        std::size_t frequency = 1;
+    };
+
+    /// The polling sources of a scheduler. Sources are identified by name and
+    /// can be added and removed at any time. Polling does not take a lock:
+    /// each worker thread keeps a snapshot of the registered sources which is
+    /// refreshed only when the set of sources has changed. A source may still
+    /// be polled by worker threads that were already polling it while it is
+    /// being removed, but it is kept alive until they are done. Querying the
+    /// work count does not take a lock either.
+    class PIKA_EXPORT polling_registry
+    {
+    public:
+        explicit polling_registry(std::size_t num_threads);
+
+        PIKA_NON_COPYABLE(polling_registry);
+
+        /// Adds a polling source with the given name, replacing any source
+        /// previously added with the same name.
+        void add(std::string name, polling_source source);
+
+        /// Removes the polling source with the given name. Returns false if
+        /// no such source was registered.
+        bool remove(std::string const& name);
+
+        /// Polls the sources that are due on the given worker thread.
+        polling_status poll(std::size_t num_thread);
+
+        /// Returns the sum of the work counts of all sources.
+        std::size_t work_count() const;
+
+        /// Returns the number of registered sources.
+        std::size_t size() const;
+
+    private:
+        struct entry
+        {
+            std::string name;
+            polling_source source;
+        };
+
+        using sources_type = std::vector<entry>;
+        using sources_ptr = std::shared_ptr<sources_type const>;
+
+        struct worker_data
+        {
+            sources_ptr sources;
+            std::uint64_t version = 0;
+            std::size_t iteration = 0;
+        };
+
+        void publish(sources_ptr sources);
+
+        mutable std::mutex mtx_;
+        sources_ptr sources_;
+
+        // The sources as seen by work_count, which may be called from any
+        // thread. Replaced sources are retired and only released once no
+        // call to work_count may be reading them anymore.
+        std::atomic<sources_type const*> current_sources_;
+        mutable std::atomic<std::size_t> work_count_readers_;
+        std::vector<sources_ptr> retired_sources_;
+
+        // Incremented every time the set of sources changes
+        std::atomic<std::uint64_t> version_;
+
+        std::vector<pika::concurrency::detail::cache_line_data<worker_data>> workers_;
+    };
+}    // namespace pika::threads::detail
+
+#include <pika/config/warnings_suffix.hpp>
@@ -0,0 +1,95 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/threading_base/thread_description.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace pika::threads::detail {
+    enum class task_trace_event : std::uint8_t
+    {
+        /// A thread has been created. The parent is the thread which created
+        /// it, if any.
+        create = 0,
+        /// A thread starts running for the first time
+        start = 1,
+        /// A thread stops running without having terminated
+        suspend = 2,
+        /// A thread starts running again after having been suspended
+        resume = 3,
+        /// A thread has finished running
+        terminate = 4,
+    };
+
+    PIKA_EXPORT char const* get_task_trace_event_name(task_trace_event event) noexcept;
+
+    /// A fixed-size trace record. The description either points to a string
+    /// which outlives the trace (thread descriptions are string literals or
+    /// stored annotations), or is the address of the function run by the
+    /// thread.
+    struct task_trace_record
+    {
+        /// Nanoseconds since tracing has been enabled. The raw records hold
+        /// a tick count which is only converted when the trace is read.
+        std::uint64_t timestamp;
+        void const* thread_id;
+        void const* parent_id;
+        union
+        {
+            char const* description;
+            std::size_t address;
+        };
+        /// The global number of the worker thread on which the event was
+        /// recorded, or std::uint32_t(-1) for other OS threads.
+        std::uint32_t worker;
+        task_trace_event event;
+        bool has_address;
+    };
+
+    PIKA_EXPORT extern std::atomic<bool> task_trace_enabled;
+
+    PIKA_FORCEINLINE bool is_task_trace_enabled() noexcept
+    {
+        return task_trace_enabled.load(std::memory_order_relaxed);
+    }
+
+    /// Starts recording task trace events, discarding previously recorded
+    /// events. Each OS thread records into its own ring buffer of
+    /// buffer_size records (rounded up to a power of two), which overwrites
+    /// its oldest records when full. Must not be called while other threads
+    /// record events.
+    PIKA_EXPORT void enable_task_trace(std::size_t buffer_size);
+
+    /// Stops recording task trace events. The recorded events are kept until
+    /// tracing is enabled again.
+    PIKA_EXPORT void disable_task_trace() noexcept;
+
+    /// Appends a record to the ring buffer of the calling OS thread. Only
+    /// call this if is_task_trace_enabled() returns true.
+    PIKA_EXPORT void record_task_trace_event(task_trace_event event, void const* thread_id,
+        void const* parent_id, ::pika::detail::thread_description const& description) noexcept;
+
+    /// Returns the records of all OS threads, ordered by worker thread and
+    /// then by time. Records which are being written concurrently may be
+    /// torn, so this should be called when the traced threads are idle.
+    PIKA_EXPORT std::vector<task_trace_record> get_task_trace();
+
+    /// Writes the recorded events in the Chrome trace event JSON format,
+    /// which can be opened with chrome://tracing or https://ui.perfetto.dev.
+    /// Each run of a thread is a slice on the track of its worker thread.
+    PIKA_EXPORT void write_task_trace_chrome(std::ostream& os);
+
+    /// Writes the recorded events as a Perfetto protobuf trace, using the
+    /// same tracks and slices as write_task_trace_chrome.
+    PIKA_EXPORT void write_task_trace_perfetto(std::ostream& os);
+}    // namespace pika::threads::detail
@@ -0,0 +1,144 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/thread_support/spinlock.hpp>
+#include <pika/threading_base/thread_data.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <pika/config/warnings_prefix.hpp>
+
+namespace pika::threads::detail {
+    struct thread_data_cache_statistics
+    {
+        /// Number of thread objects which were reused, either from the
+        /// magazine of a queue or from a depot.
+        std::uint64_t hits = 0;
+        /// Number of thread objects which had to be allocated.
+        std::uint64_t misses = 0;
+        /// Number of stacks released with madvise while cached in a depot.
+        std::uint64_t trimmed = 0;
+        /// Number of thread objects destroyed because a depot was above its
+        /// high-water mark.
+        std::uint64_t released = 0;
+    };
+
+    /// Process-wide second level cache for unused thread objects and their
+    /// stacks. Each thread queue keeps a small magazine of unused objects per
+    /// stack size which is protected by the lock of the queue. Magazines
+    /// exchange objects with the depot of the NUMA domain of the queue in
+    /// batches, so that queues which create many threads reuse the objects
+    /// released by other queues instead of allocating new stacks.
+    ///
+    /// Depots hold at most \a high_water_mark objects per stack size, excess
+    /// objects are destroyed. Stacks which have been sitting in a depot for a
+    /// full trim interval are released with madvise, keeping the mapping.
+    class PIKA_EXPORT thread_data_cache
+    {
+    public:
+        struct parameters
+        {
+            /// The number of objects per stack size a queue keeps for itself.
+            std::size_t magazine_size = 64;
+            /// The maximum number of objects per stack size and NUMA domain
+            /// kept in the depots, or std::size_t(-1) for no limit.
+            std::size_t high_water_mark = std::size_t(-1);
+            /// How often stacks in the depots are trimmed. A zero interval
+            /// disables trimming.
+            std::chrono::milliseconds trim_interval{1000};
+        };
+
+        thread_data_cache(std::size_t num_domains, parameters const& params);
+        ~thread_data_cache();
+
+        PIKA_NON_COPYABLE(thread_data_cache);
+
+        /// Returns the cache shared by all thread queues, creating it with
+        /// the given parameters if it does not exist. The cache is destroyed,
+        /// together with all objects in its depots, once the last queue has
+        /// released it.
+        static std::shared_ptr<thread_data_cache> get(parameters const& params);
+
+        /// Returns the statistics of the shared cache, or all zeros if there
+        /// is none.
+        static thread_data_cache_statistics get_statistics(bool reset);
+
+        std::size_t get_magazine_size() const noexcept { return params_.magazine_size; }
+        std::size_t get_num_domains() const noexcept { return domains_.size(); }
+
+        /// Moves up to \a count objects with the given stack size from the
+        /// depot of \a domain to \a objects. Returns the number of objects
+        /// moved.
+        std::size_t take(std::size_t domain, std::ptrdiff_t stacksize, thread_id_type* objects,
+            std::size_t count);
+
+        /// Moves \a count objects with the given stack size to the depot of
+        /// \a domain. Objects above the high-water mark of the depot are
+        /// destroyed.
+        void give(std::size_t domain, std::ptrdiff_t stacksize, thread_id_type const* objects,
+            std::size_t count);
+
+        void record_hit(std::size_t domain) noexcept
+        {
+            domains_[domain % domains_.size()]->hits.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void record_miss(std::size_t domain) noexcept
+        {
+            domains_[domain % domains_.size()]->misses.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /// Trims the depots if the trim interval has elapsed since the last
+        /// time they were trimmed. Called from the idle path of the scheduling
+        /// loop.
+        void trim_if_due();
+
+        /// Trims the stacks of all objects which have been in a depot since
+        /// the previous call.
+        void trim();
+
+        thread_data_cache_statistics statistics(bool reset);
+
+    private:
+        struct size_class
+        {
+            std::ptrdiff_t stacksize;
+            std::vector<thread_id_type> objects;
+            // Objects below this index have been trimmed
+            std::size_t trimmed = 0;
+            // The smallest size of objects since the last trim, objects below
+            // this index have not been used since then
+            std::size_t low_water = 0;
+        };
+
+        struct domain
+        {
+            pika::detail::spinlock mtx;
+            std::vector<size_class> size_classes;
+
+            std::atomic<std::uint64_t> hits{0};
+            std::atomic<std::uint64_t> misses{0};
+            std::atomic<std::uint64_t> trimmed{0};
+            std::atomic<std::uint64_t> released{0};
+        };
+
+        static size_class& get_size_class(domain& d, std::ptrdiff_t stacksize);
+
+        parameters params_;
+        std::vector<std::unique_ptr<domain>> domains_;
+        std::atomic<std::int64_t> next_trim_;
+    };
+}    // namespace pika::threads::detail
+
+#include <pika/config/warnings_suffix.hpp>
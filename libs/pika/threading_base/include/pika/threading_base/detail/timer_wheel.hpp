@@ -0,0 +1,146 @@
+//  Copyright (c) 2023 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/thread_support/spinlock.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <pika/config/warnings_prefix.hpp>
+
+namespace pika::threads::detail {
+    class timer_wheel;
+
+    /// Intrusive hook for entries of a \a timer_wheel. The wheel never
+    /// allocates: the owner of an entry has to keep it alive until it has
+    /// either expired or has been cancelled.
+    class timer_wheel_entry
+    {
+    public:
+        using callback_type = void (*)(timer_wheel_entry&) noexcept;
+
+        explicit constexpr timer_wheel_entry(callback_type on_expire) noexcept
+          : on_expire_(on_expire)
+        {
+        }
+
+        PIKA_NON_COPYABLE(timer_wheel_entry);
+
+    private:
+        friend class timer_wheel;
+
+        static constexpr std::uint32_t unarmed = std::uint32_t(-1);
+        static constexpr std::uint32_t expiring = std::uint32_t(-2);
+
+        callback_type on_expire_;
+        timer_wheel_entry* prev_ = nullptr;
+        timer_wheel_entry* next_ = nullptr;
+        std::uint64_t expiry_ = 0;
+        // The batch of expired entries this entry belongs to while its slot
+        // is expiring
+        std::uint64_t batch_ = 0;
+        std::uint32_t slot_ = unarmed;
+    };
+
+    /// A hierarchical timing wheel. Deadlines are rounded up to the resolution
+    /// of the wheel, i.e. entries never expire early. Scheduling and
+    /// cancelling an entry are O(1); expiring entries is O(1) per entry plus
+    /// a bounded amount of bookkeeping per level for each time the wheel is
+    /// advanced.
+    ///
+    /// Expired entries are collected while the wheel is locked and their
+    /// callbacks are invoked after it has been unlocked, in batches of one
+    /// call to \a advance. Callbacks may schedule entries on the same wheel.
+    /// Once \a cancel returns the callback of the entry is guaranteed to be
+    /// neither running nor to run in the future. Callbacks must therefore not
+    /// cancel other entries of the wheel, as that may wait for their own
+    /// batch to finish.
+    class PIKA_EXPORT timer_wheel
+    {
+    public:
+        using clock_type = std::chrono::steady_clock;
+
+        static constexpr std::size_t slot_bits = 6;
+        static constexpr std::size_t num_slots = std::size_t(1) << slot_bits;
+        static constexpr std::size_t num_levels = 6;
+
+        explicit timer_wheel(
+            std::chrono::nanoseconds resolution = std::chrono::microseconds(100));
+
+        PIKA_NON_COPYABLE(timer_wheel);
+
+        /// Arm \a entry to expire at \a abs_time. The entry must not be armed,
+        /// but it may be re-armed from its own expiry callback.
+        /// Returns true if the entry is now the earliest known deadline of the
+        /// wheel, in which case callers may want to wake up sleeping workers.
+        bool schedule(timer_wheel_entry& entry, clock_type::time_point abs_time);
+
+        /// Disarm \a entry. Returns true if the entry was removed before it
+        /// expired, false if it has already expired (or was never armed). If
+        /// the callback of the entry is running this waits for it to return.
+        bool cancel(timer_wheel_entry& entry);
+
+        /// Expire all entries with a deadline at or before \a now. Only one
+        /// thread advances the wheel and invokes expiry callbacks at a time;
+        /// concurrent callers return immediately. Returns the number of
+        /// expired entries.
+        std::size_t advance(clock_type::time_point now);
+        std::size_t advance()
+        {
+            if (empty()) return 0;
+            return advance(clock_type::now());
+        }
+
+        bool empty() const noexcept { return size() == 0; }
+        std::size_t size() const noexcept { return size_.load(std::memory_order_relaxed); }
+
+        /// A lower bound on the deadline of the next entry to expire.
+        clock_type::time_point next_expiry() const noexcept;
+
+        std::chrono::nanoseconds resolution() const noexcept
+        {
+            return std::chrono::nanoseconds(resolution_);
+        }
+
+    private:
+        std::uint64_t to_ticks(clock_type::time_point t, bool round_up) const noexcept;
+
+        void insert(timer_wheel_entry& entry) noexcept;
+        void unlink(timer_wheel_entry& entry) noexcept;
+        void cascade() noexcept;
+        void expire_current_slot(
+            timer_wheel_entry*& expired_head, timer_wheel_entry*& expired_tail) noexcept;
+        std::uint64_t next_event_tick() const noexcept;
+
+        using mutex_type = pika::detail::spinlock;
+
+        clock_type::time_point const epoch_;
+        std::int64_t const resolution_;
+
+        mutable mutex_type mtx_;
+
+        // All entries with a deadline before current_tick_ have expired.
+        std::uint64_t current_tick_;
+        std::atomic<std::uint64_t> next_event_tick_;
+        std::atomic<std::size_t> size_;
+
+        // Batches of expired entries are numbered consecutively. A new batch
+        // is only started once the callbacks of the previous one have
+        // returned.
+        std::uint64_t started_batches_;
+        std::atomic<std::uint64_t> finished_batches_;
+
+        std::uint64_t occupied_[num_levels];
+        timer_wheel_entry* slots_[num_levels][num_slots];
+    };
+}    // namespace pika::threads::detail
+
+#include <pika/config/warnings_suffix.hpp>
@@ -0,0 +1,107 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/concurrency/cache_line_data.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if !defined(__linux__)
+# include <condition_variable>
+# include <mutex>
+#endif
+
+#include <pika/config/warnings_prefix.hpp>
+
+namespace pika::threads::detail {
+    /// Parking slots for the idle worker threads of a scheduler. Each worker
+    /// thread parks on its own slot (a futex on Linux) so that new work can
+    /// wake up the worker thread it was queued for, or the closest parked
+    /// worker thread, instead of all of them.
+    ///
+    /// A slot behaves like a binary semaphore which is reset when parking:
+    /// waking up a worker thread which is about to park makes it return from
+    /// park immediately.
+    class PIKA_EXPORT worker_parking
+    {
+    public:
+        explicit worker_parking(std::size_t num_threads);
+
+        PIKA_NON_COPYABLE(worker_parking);
+
+        /// Parks the given worker thread until it is woken up or the timeout
+        /// expires. Returns true if the worker thread was woken up.
+        ///
+        /// has_work is called after the worker thread has been marked as
+        /// parked, the worker thread does not wait if it returns true. Work
+        /// which is added after that check wakes up the worker thread, so no
+        /// wakeup is lost between the last check for work and parking.
+        template <typename F>
+        bool park(std::size_t num_thread, std::chrono::milliseconds timeout, F&& has_work)
+        {
+            if (!begin_park(num_thread)) { return true; }
+            if (!has_work()) { wait(num_thread, timeout); }
+            return end_park(num_thread);
+        }
+
+        bool park(std::size_t num_thread, std::chrono::milliseconds timeout)
+        {
+            return park(num_thread, timeout, [] { return false; });
+        }
+
+        /// Wakes up the given worker thread if it is parked, otherwise the
+        /// closest parked worker thread. If num_thread is std::size_t(-1) the
+        /// search starts at a different worker thread on every call. Does
+        /// nothing if no worker thread is parked. Returns true if a worker
+        /// thread was woken up.
+        bool unpark_one(std::size_t num_thread);
+
+        /// Wakes up all worker threads, including those which are about to
+        /// park.
+        void unpark_all();
+
+        std::size_t num_parked() const noexcept
+        {
+            return num_parked_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        enum slot_state : std::uint32_t
+        {
+            running = 0,
+            parked = 1,
+            notified = 2
+        };
+
+        struct slot
+        {
+            std::atomic<std::uint32_t> state{running};
+#if !defined(__linux__)
+            std::mutex mtx;
+            std::condition_variable cond;
+#endif
+        };
+
+        bool begin_park(std::size_t num_thread);
+        void wait(std::size_t num_thread, std::chrono::milliseconds timeout);
+        bool end_park(std::size_t num_thread);
+
+        bool try_unpark(std::size_t num_thread);
+        void wake(slot& s);
+
+        std::vector<pika::concurrency::detail::cache_line_data<slot>> slots_;
+        std::atomic<std::size_t> num_parked_{0};
+        std::atomic<std::size_t> next_{0};
+    };
+}    // namespace pika::threads::detail
+
+#include <pika/config/warnings_suffix.hpp>
@@ -11,6 +11,9 @@
 #include <pika/concurrency/cache_line_data.hpp>
 #include <pika/functional/function.hpp>
 #include <pika/modules/errors.hpp>
+#include <pika/threading_base/detail/polling_registry.hpp>
+#include <pika/threading_base/detail/timer_wheel.hpp>
+#include <pika/threading_base/detail/worker_parking.hpp>
 #include <pika/threading_base/scheduler_mode.hpp>
 #include <pika/threading_base/scheduler_state.hpp>
 #include <pika/threading_base/thread_data.hpp>
@@ -40,15 +43,6 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 namespace pika::threads::detail {
-    enum class polling_status
-    {
-        /// Signals that a polling function currently has no more work to do
-        idle = 0,
-        /// Signals that a polling function still has outstanding work to
-        /// poll for
-        busy = 1
-    };
-
     ///////////////////////////////////////////////////////////////////////////
     /// The scheduler_base defines the interface to be implemented by all
     /// scheduler policies
@@ -97,6 +91,10 @@ namespace pika::threads::detail {
         /// possibly idling OS threads
         void do_some_work(std::size_t);
 
+        /// Wakes up all idling OS threads, e.g. to make them notice a change
+        /// of state
+        void wake_all_workers();
+
         virtual void suspend(std::size_t num_thread);
         virtual void resume(std::size_t num_thread);
 
@@ -175,8 +173,26 @@ namespace pika::threads::detail {
         virtual std::int64_t get_num_stolen_to_pending(std::size_t num_thread, bool reset) = 0;
         virtual std::int64_t get_num_stolen_from_staged(std::size_t num_thread, bool reset) = 0;
         virtual std::int64_t get_num_stolen_to_staged(std::size_t num_thread, bool reset) = 0;
+
+        // Number of successful and failed attempts to steal from another
+        // queue, for schedulers which count them
+        virtual std::int64_t get_num_steal_successes(std::size_t /*num_thread*/, bool /*reset*/)
+        {
+            return 0;
+        }
+        virtual std::int64_t get_num_steal_failures(std::size_t /*num_thread*/, bool /*reset*/)
+        {
+            return 0;
+        }
 #endif
 
+        // Number of threads which started running after their deadline, for
+        // schedulers which order threads by deadline
+        virtual std::int64_t get_num_deadline_misses(std::size_t /*num_thread*/, bool /*reset*/)
+        {
+            return 0;
+        }
+
         virtual std::int64_t get_queue_length(std::size_t num_thread = std::size_t(-1)) const = 0;
 
         virtual std::int64_t get_thread_count(threads::detail::thread_schedule_state state =
@@ -258,70 +274,79 @@ namespace pika::threads::detail {
             return thread_queue_init_.small_stacksize_;
         }
 
-        using polling_function_ptr = polling_status (*)();
-        using polling_work_count_function_ptr = std::size_t (*)();
+        /// Puts the given pending thread into the next thread slot of the
+        /// calling worker thread if scheduler_mode::enable_next_thread_slot
+        /// is set, so that the worker thread runs it as soon as the current
+        /// thread suspends or finishes. Returns false and leaves thrd
+        /// untouched if the calling OS thread is not a worker thread of this
+        /// scheduler or if the thread does not have normal priority. A thread
+        /// which was held by the slot is scheduled normally.
+        bool schedule_thread_next(
+            threads::detail::thread_id_ref_type& thrd, execution::thread_priority priority);
+
+        /// Takes the thread out of the next thread slot of the given worker
+        /// thread. After max_next_thread_slot_count consecutive threads have
+        /// been taken from the slot the thread in it is put at the end of the
+        /// queues instead, so that a chain of threads waking each other up
+        /// can not starve the other threads.
+        bool get_next_thread_from_slot(
+            std::size_t num_thread, threads::detail::thread_id_ref_type& thrd)
+        {
+            PIKA_ASSERT(num_thread < next_thread_slots_.size());
 
-        static polling_status null_polling_function() { return polling_status::idle; }
+            next_thread_slot& slot = next_thread_slots_[num_thread].data_;
+            if (PIKA_LIKELY(!slot.thrd_))
+            {
+                slot.count_ = 0;
+                return false;
+            }
 
-        static std::size_t null_polling_work_count_function() { return 0; }
+            if (++slot.count_ > max_next_thread_slot_count)
+            {
+                slot.count_ = 0;
+                schedule_thread_last(PIKA_MOVE(slot.thrd_),
+                    execution::thread_schedule_hint(static_cast<std::int16_t>(num_thread)), true);
+                return false;
+            }
 
-        void set_mpi_polling_functions(
-            polling_function_ptr mpi_func, polling_work_count_function_ptr mpi_work_count_func)
-        {
-            polling_function_mpi_.store(mpi_func, std::memory_order_relaxed);
-            polling_work_count_function_mpi_.store(mpi_work_count_func, std::memory_order_relaxed);
+            thrd = PIKA_MOVE(slot.thrd_);
+            return true;
         }
 
-        void clear_mpi_polling_function()
+        /// Adds a source of work that is polled from the scheduling loop of
+        /// the worker threads, replacing any source added earlier with the
+        /// same name. See \a polling_registry.
+        void add_polling_source(std::string name, polling_source source)
         {
-            polling_function_mpi_.store(&null_polling_function, std::memory_order_relaxed);
-            polling_work_count_function_mpi_.store(
-                &null_polling_work_count_function, std::memory_order_relaxed);
+            polling_sources_.add(std::move(name), std::move(source));
         }
 
-        void set_cuda_polling_functions(
-            polling_function_ptr cuda_func, polling_work_count_function_ptr cuda_work_count_func)
+        /// Removes the polling source with the given name. Returns false if
+        /// no such source was added.
+        bool remove_polling_source(std::string const& name)
         {
-            polling_function_cuda_.store(cuda_func, std::memory_order_relaxed);
-            polling_work_count_function_cuda_.store(
-                cuda_work_count_func, std::memory_order_relaxed);
+            return polling_sources_.remove(name);
         }
 
-        void clear_cuda_polling_function()
+        polling_status custom_polling_function(std::size_t num_thread)
         {
-            polling_function_cuda_.store(&null_polling_function, std::memory_order_relaxed);
-            polling_work_count_function_cuda_.store(
-                &null_polling_work_count_function, std::memory_order_relaxed);
+            return polling_sources_.poll(num_thread);
         }
 
-        polling_status custom_polling_function() const
+        timer_wheel& get_timer_wheel() noexcept { return timers_; }
+
+        // Expire the timers whose deadline has passed. This is called from the
+        // scheduling loop and reports busy if any timer has expired.
+        polling_status poll_timers()
         {
-            polling_status status = polling_status::idle;
-#if defined(PIKA_HAVE_MODULE_ASYNC_MPI)
-            if ((*polling_function_mpi_.load(std::memory_order_relaxed))() == polling_status::busy)
-            {
-                status = polling_status::busy;
-            }
-#endif
-#if defined(PIKA_HAVE_MODULE_ASYNC_CUDA)
-            if ((*polling_function_cuda_.load(std::memory_order_relaxed))() == polling_status::busy)
-            {
-                status = polling_status::busy;
-            }
-#endif
-            return status;
+            return timers_.advance() != 0 ? polling_status::busy : polling_status::idle;
         }
 
         std::size_t get_polling_work_count() const
         {
-            std::size_t work_count = 0;
-#if defined(PIKA_HAVE_MODULE_ASYNC_MPI)
-            work_count += polling_work_count_function_mpi_.load(std::memory_order_relaxed)();
-#endif
-#if defined(PIKA_HAVE_MODULE_ASYNC_CUDA)
-            work_count += polling_work_count_function_cuda_.load(std::memory_order_relaxed)();
-#endif
-            return work_count;
+            // Armed timers will eventually create work, e.g. by completing a
+            // sender returned by schedule_after
+            return timers_.size() + polling_sources_.work_count();
         }
 
     protected:
@@ -330,8 +355,6 @@ namespace pika::threads::detail {
 
 #if defined(PIKA_HAVE_THREAD_MANAGER_IDLE_BACKOFF)
         // support for suspension on idle queues
-        pu_mutex_type mtx_;
-        std::condition_variable cond_;
         struct idle_backoff_data
         {
             std::uint32_t wait_count_;
@@ -354,10 +377,28 @@ namespace pika::threads::detail {
         // the pool that owns this scheduler
         threads::detail::thread_pool_base* parent_pool_;
 
-        std::atomic<polling_function_ptr> polling_function_mpi_;
-        std::atomic<polling_function_ptr> polling_function_cuda_;
-        std::atomic<polling_work_count_function_ptr> polling_work_count_function_mpi_;
-        std::atomic<polling_work_count_function_ptr> polling_work_count_function_cuda_;
+        // sources of work polled by the worker threads, e.g. MPI requests
+        polling_registry polling_sources_;
+
+        // timers for timed suspension of threads scheduled by this scheduler
+        timer_wheel timers_;
+
+        // support for scheduler_mode::enable_next_thread_slot, each slot is
+        // only accessed by its worker thread
+        static constexpr std::uint32_t max_next_thread_slot_count = 16;
+
+        struct next_thread_slot
+        {
+            threads::detail::thread_id_ref_type thrd_;
+            std::uint32_t count_ = 0;
+        };
+        std::vector<pika::concurrency::detail::cache_line_data<next_thread_slot>>
+            next_thread_slots_;
+
+#if defined(PIKA_HAVE_THREAD_MANAGER_IDLE_BACKOFF)
+        // idle worker threads park here until new work is added for them
+        worker_parking parking_;
+#endif
 
 #if defined(PIKA_HAVE_SCHEDULER_LOCAL_STORAGE)
     public:
@@ -46,6 +46,16 @@ namespace pika::threads {
         /// This option allows for certain schedulers to explicitly disable
         /// exponential idle-back off
         enable_idle_backoff = 0x100,
+        /// This option makes worker threads run a thread which was made
+        /// pending by the thread they are currently running next, instead of
+        /// putting it at the end of a queue
+        enable_next_thread_slot = 0x200,
+        /// This option makes thread_pool_scheduler run the continuations of
+        /// schedule() as stackless tasks on the stack of the worker thread.
+        /// Continuations which yield, sleep, or wait block the worker thread,
+        /// and later operations of the same type run as stackful threads.
+        /// Joining a pika::thread from such a continuation throws.
+        enable_stackless_senders = 0x400,
 
         // clang-format off
         /// This option represents the default mode.
@@ -65,7 +75,9 @@ namespace pika::threads {
             assign_work_thread_parent |
             steal_high_priority_first |
             steal_after_local |
-            enable_idle_backoff
+            enable_idle_backoff |
+            enable_next_thread_slot |
+            enable_stackless_senders
         // clang-format on
     };
 
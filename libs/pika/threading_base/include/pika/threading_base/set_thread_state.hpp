@@ -20,4 +20,12 @@ namespace pika::threads::detail {
         execution::thread_priority priority,
         execution::thread_schedule_hint schedulehint = execution::thread_schedule_hint(),
         bool retry_on_active = true, error_code& ec = throws);
+
+    /// Change the state of the suspended thread \a id to \a new_state and
+    /// schedule it, but only if its state is still \a expected_state. Returns
+    /// false without changing the state otherwise.
+    PIKA_EXPORT bool set_suspended_thread_state(thread_id_type const& id,
+        thread_state expected_state, thread_schedule_state new_state,
+        thread_restart_state new_state_ex,
+        execution::thread_schedule_hint schedulehint = execution::thread_schedule_hint());
 }    // namespace pika::threads::detail
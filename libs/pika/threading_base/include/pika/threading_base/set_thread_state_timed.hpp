@@ -10,50 +10,85 @@
 #include <pika/coroutines/coroutine.hpp>
 #include <pika/modules/errors.hpp>
 #include <pika/modules/timing.hpp>
+#include <pika/threading_base/detail/timer_wheel.hpp>
 #include <pika/threading_base/scheduler_base.hpp>
 #include <pika/threading_base/set_thread_state.hpp>
 #include <pika/threading_base/threading_base_fwd.hpp>
 
-#include <atomic>
+#include <cstdint>
 
 namespace pika::threads::detail {
 
+    /// A pending state change of a thread, registered with the timer wheel of
+    /// a scheduler. The timer has to be kept alive (together with the thread
+    /// it refers to) until it has either expired or has been cancelled using
+    /// \a cancel_thread_state_timed.
+    struct thread_state_timer : timer_wheel_entry
+    {
+        thread_state_timer() noexcept
+          : timer_wheel_entry(&on_expire)
+        {
+        }
+
+        scheduler_base* scheduler_ = nullptr;
+        thread_id_type thrd_;
+        thread_schedule_state newstate_ = thread_schedule_state::pending;
+        thread_restart_state newstate_ex_ = thread_restart_state::timeout;
+        execution::thread_priority priority_ = execution::thread_priority::normal;
+        execution::thread_schedule_hint schedulehint_;
+        bool retry_on_active_ = true;
+
+        // If not negative, the tag of the active state of the thread when the
+        // timer was armed. The timer then only resumes the thread from the
+        // suspension following that state, directly changing its state
+        // instead of retrying with a new task if the thread is still active.
+        std::int64_t active_tag_ = -1;
+
+    private:
+        PIKA_EXPORT static void on_expire(timer_wheel_entry& entry) noexcept;
+    };
+
     /// Set a timer to set the state of the given \a thread to the given
     /// new value after it expired (at the given time)
-    PIKA_EXPORT thread_id_ref_type set_thread_state_timed(scheduler_base* scheduler,
+    PIKA_EXPORT void set_thread_state_timed(scheduler_base* scheduler, thread_state_timer& timer,
         pika::chrono::steady_time_point const& abs_time, thread_id_type const& thrd,
         thread_schedule_state newstate, thread_restart_state newstate_ex,
         execution::thread_priority priority, execution::thread_schedule_hint schedulehint,
-        std::atomic<bool>* started, bool retry_on_active, error_code& ec);
+        bool retry_on_active, error_code& ec);
 
-    inline thread_id_ref_type set_thread_state_timed(scheduler_base* scheduler,
+    inline void set_thread_state_timed(scheduler_base* scheduler, thread_state_timer& timer,
         pika::chrono::steady_time_point const& abs_time, thread_id_type const& id,
-        std::atomic<bool>* started, bool retry_on_active, error_code& ec)
+        bool retry_on_active, error_code& ec)
     {
-        return set_thread_state_timed(scheduler, abs_time, id, thread_schedule_state::pending,
+        set_thread_state_timed(scheduler, timer, abs_time, id, thread_schedule_state::pending,
             thread_restart_state::timeout, execution::thread_priority::normal,
-            execution::thread_schedule_hint(), started, retry_on_active, ec);
+            execution::thread_schedule_hint(), retry_on_active, ec);
     }
 
     // Set a timer to set the state of the given \a thread to the given
     // new value after it expired (after the given duration)
-    inline thread_id_ref_type set_thread_state_timed(scheduler_base* scheduler,
+    inline void set_thread_state_timed(scheduler_base* scheduler, thread_state_timer& timer,
         pika::chrono::steady_duration const& rel_time, thread_id_type const& thrd,
         thread_schedule_state newstate, thread_restart_state newstate_ex,
         execution::thread_priority priority, execution::thread_schedule_hint schedulehint,
-        std::atomic<bool>* started, bool retry_on_active, error_code& ec)
+        bool retry_on_active, error_code& ec)
     {
-        return set_thread_state_timed(scheduler, rel_time.from_now(), thrd, newstate, newstate_ex,
-            priority, schedulehint, started, retry_on_active, ec);
+        set_thread_state_timed(scheduler, timer, rel_time.from_now(), thrd, newstate, newstate_ex,
+            priority, schedulehint, retry_on_active, ec);
     }
 
-    inline thread_id_ref_type set_thread_state_timed(scheduler_base* scheduler,
+    inline void set_thread_state_timed(scheduler_base* scheduler, thread_state_timer& timer,
         pika::chrono::steady_duration const& rel_time, thread_id_type const& thrd,
-        std::atomic<bool>* started, bool retry_on_active, error_code& ec)
+        bool retry_on_active, error_code& ec)
     {
-        return set_thread_state_timed(scheduler, rel_time.from_now(), thrd,
+        set_thread_state_timed(scheduler, timer, rel_time.from_now(), thrd,
             thread_schedule_state::pending, thread_restart_state::timeout,
-            execution::thread_priority::normal, execution::thread_schedule_hint(), started,
-            retry_on_active, ec);
+            execution::thread_priority::normal, execution::thread_schedule_hint(), retry_on_active,
+            ec);
     }
+
+    /// Cancel a timer previously set with \a set_thread_state_timed. Returns
+    /// true if the timer was cancelled before it expired. Once this function
+    /// returns the timer will not change the state of its thread anymore.
+    PIKA_EXPORT bool cancel_thread_state_timed(thread_state_timer& timer);
 }    // namespace pika::threads::detail
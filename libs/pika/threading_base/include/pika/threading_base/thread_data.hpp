@@ -28,6 +28,7 @@
 #endif
 
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <forward_list>
@@ -382,6 +383,14 @@ namespace pika::threads::detail {
         constexpr execution::thread_priority get_priority() const noexcept { return priority_; }
         void set_priority(execution::thread_priority priority) noexcept { priority_ = priority; }
 
+        /// Return the time by which this thread should have run, the maximum
+        /// time point if the thread has no deadline
+        std::chrono::steady_clock::time_point get_deadline() const noexcept { return deadline_; }
+        bool has_deadline() const noexcept
+        {
+            return deadline_ != std::chrono::steady_clock::time_point::max();
+        }
+
         // handle thread interruption
         bool interruption_requested() const noexcept
         {
@@ -423,6 +432,10 @@ namespace pika::threads::detail {
 
         PIKA_FORCEINLINE bool is_stackless() const noexcept { return is_stackless_; }
 
+        /// Marks the thread as started for the task trace. Returns whether
+        /// the thread had already been marked as started.
+        bool set_trace_started() noexcept { return std::exchange(trace_started_, true); }
+
         void destroy_thread() override;
 
         scheduler_base* get_scheduler_base() const noexcept { return scheduler_base_; }
@@ -447,6 +460,10 @@ namespace pika::threads::detail {
             return *static_cast<ThreadQueue*>(queue_);
         }
 
+        // Thread objects may be recycled by a different queue than the one
+        // that created them
+        void set_queue(void* queue) noexcept { queue_ = queue; }
+
         /// \brief Execute the thread function
         ///
         /// \returns        This function returns the thread state the thread
@@ -472,6 +489,11 @@ namespace pika::threads::detail {
         virtual void init() = 0;
         virtual void rebind(thread_init_data& init_data) = 0;
 
+        /// Release the physical memory backing the unused part of the stack
+        /// of a thread which is not currently running. This is a no-op for
+        /// stackless threads.
+        virtual void trim_stack() noexcept {}
+
 #if defined(PIKA_HAVE_APEX)
         std::shared_ptr<pika::detail::external_timer::task_wrapper> get_timer_data() const noexcept
         {
@@ -522,11 +544,13 @@ namespace pika::threads::detail {
 #endif
         ///////////////////////////////////////////////////////////////////////
         execution::thread_priority priority_;
+        std::chrono::steady_clock::time_point deadline_;
 
         bool requested_interrupt_;
         bool enabled_interrupt_;
         bool ran_exit_funcs_;
         bool const is_stackless_;
+        bool trace_started_;
 
         // Singly linked list (heap-allocated)
         std::forward_list<util::detail::function<void()>> exit_funcs_;
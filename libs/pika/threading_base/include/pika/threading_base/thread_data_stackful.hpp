@@ -93,6 +93,8 @@ namespace pika::threads::detail {
             PIKA_ASSERT(coroutine_.is_ready());
         }
 
+        void trim_stack() noexcept override { coroutine_.impl()->trim_stack(); }
+
         thread_data_stackful(thread_init_data& init_data, void* queue, std::ptrdiff_t stacksize,
             thread_id_addref addref)
           : thread_data(init_data, queue, stacksize, false, addref)
@@ -76,12 +76,14 @@ namespace pika::threads::detail {
     /// Set a timer to set the state of the given \a thread to the given
     /// new value after it expired (at the given time)
     ///
+    /// \param timer      [in,out] The timer to register with the scheduler
+    ///                   of the thread. It has to be kept alive until it
+    ///                   has expired or has been cancelled with
+    ///                   \a cancel_thread_state_timed.
     /// \param id         [in] The thread id of the thread the state should
     ///                   be modified for.
     /// \param abs_time   [in] Absolute point in time for the new thread to be
     ///                   run
-    /// \param started    [in,out] A helper variable allowing to track the
-    ///                   state of the timer helper thread
     /// \param state      [in] The new state to be set for the thread
     ///                   referenced by the \a id parameter.
     /// \param stateex    [in] The new extended state to be set for the
@@ -98,23 +100,12 @@ namespace pika::threads::detail {
     ///                   throw but returns the result code using the
     ///                   parameter \a ec. Otherwise it throws an instance
     ///                   of pika#exception.
-    PIKA_EXPORT thread_id_ref_type set_thread_state(thread_id_type const& id,
-        pika::chrono::steady_time_point const& abs_time, std::atomic<bool>* started,
-        thread_schedule_state state = thread_schedule_state::pending,
-        thread_restart_state stateex = thread_restart_state::timeout,
-        execution::thread_priority priority = execution::thread_priority::normal,
-        bool retry_on_active = true, error_code& ec = throws);
-
-    inline thread_id_ref_type set_thread_state(thread_id_type const& id,
+    PIKA_EXPORT void set_thread_state(thread_state_timer& timer, thread_id_type const& id,
         pika::chrono::steady_time_point const& abs_time,
         thread_schedule_state state = thread_schedule_state::pending,
         thread_restart_state stateex = thread_restart_state::timeout,
         execution::thread_priority priority = execution::thread_priority::normal,
-        bool retry_on_active = true, error_code& /*ec*/ = throws)
-    {
-        return set_thread_state(
-            id, abs_time, nullptr, state, stateex, priority, retry_on_active, throws);
-    }
+        bool retry_on_active = true, error_code& ec = throws);
 
     ///////////////////////////////////////////////////////////////////////////
     /// \brief  Set the thread state of the \a thread referenced by the
@@ -123,6 +114,10 @@ namespace pika::threads::detail {
     /// Set a timer to set the state of the given \a thread to the given
     /// new value after it expired (after the given duration)
     ///
+    /// \param timer      [in,out] The timer to register with the scheduler
+    ///                   of the thread. It has to be kept alive until it
+    ///                   has expired or has been cancelled with
+    ///                   \a cancel_thread_state_timed.
     /// \param id         [in] The thread id of the thread the state should
     ///                   be modified for.
     /// \param rel_time   [in] Time duration after which the new thread should
@@ -143,15 +138,15 @@ namespace pika::threads::detail {
     ///                   throw but returns the result code using the
     ///                   parameter \a ec. Otherwise it throws an instance
     ///                   of pika#exception.
-    inline thread_id_ref_type set_thread_state(thread_id_type const& id,
+    inline void set_thread_state(thread_state_timer& timer, thread_id_type const& id,
         pika::chrono::steady_duration const& rel_time,
         thread_schedule_state state = thread_schedule_state::pending,
         thread_restart_state stateex = thread_restart_state::timeout,
         execution::thread_priority priority = execution::thread_priority::normal,
         bool retry_on_active = true, error_code& ec = throws)
     {
-        return set_thread_state(
-            id, rel_time.from_now(), state, stateex, priority, retry_on_active, ec);
+        set_thread_state(
+            timer, id, rel_time.from_now(), state, stateex, priority, retry_on_active, ec);
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -16,6 +16,7 @@
 #endif
 #include <pika/type_support/unused.hpp>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -31,8 +32,8 @@ namespace pika::threads::detail {
 #if defined(PIKA_HAVE_THREAD_DESCRIPTION)
           , description()
 #endif
-#if defined(PIKA_HAVE_THREAD_PARENT_REFERENCE)
           , parent_id(nullptr)
+#if defined(PIKA_HAVE_THREAD_PARENT_REFERENCE)
           , parent_phase(0)
 #endif
 #ifdef PIKA_HAVE_APEX
@@ -44,6 +45,7 @@ namespace pika::threads::detail {
           , initial_state(thread_schedule_state::pending)
           , run_now(false)
           , scheduler_base(nullptr)
+          , deadline(std::chrono::steady_clock::time_point::max())
         {
             if (initial_state == thread_schedule_state::staged)
             {
@@ -62,11 +64,12 @@ namespace pika::threads::detail {
             initial_state = rhs.initial_state;
             run_now = rhs.run_now;
             scheduler_base = rhs.scheduler_base;
+            deadline = rhs.deadline;
 #if defined(PIKA_HAVE_THREAD_DESCRIPTION)
             description = PIKA_MOVE(rhs.description);
 #endif
-#if defined(PIKA_HAVE_THREAD_PARENT_REFERENCE)
             parent_id = rhs.parent_id;
+#if defined(PIKA_HAVE_THREAD_PARENT_REFERENCE)
             parent_phase = rhs.parent_phase;
 #endif
 #ifdef PIKA_HAVE_APEX
@@ -82,8 +85,8 @@ namespace pika::threads::detail {
 #if defined(PIKA_HAVE_THREAD_DESCRIPTION)
           , description(PIKA_MOVE(rhs.description))
 #endif
-#if defined(PIKA_HAVE_THREAD_PARENT_REFERENCE)
           , parent_id(rhs.parent_id)
+#if defined(PIKA_HAVE_THREAD_PARENT_REFERENCE)
           , parent_phase(rhs.parent_phase)
 #endif
 #ifdef PIKA_HAVE_APEX
@@ -97,6 +100,7 @@ namespace pika::threads::detail {
           , initial_state(rhs.initial_state)
           , run_now(rhs.run_now)
           , scheduler_base(rhs.scheduler_base)
+          , deadline(rhs.deadline)
         {
         }
 
@@ -112,8 +116,8 @@ namespace pika::threads::detail {
 #if defined(PIKA_HAVE_THREAD_DESCRIPTION)
           , description(desc)
 #endif
-#if defined(PIKA_HAVE_THREAD_PARENT_REFERENCE)
           , parent_id(nullptr)
+#if defined(PIKA_HAVE_THREAD_PARENT_REFERENCE)
           , parent_phase(0)
 #endif
 #ifdef PIKA_HAVE_APEX
@@ -127,6 +131,7 @@ namespace pika::threads::detail {
           , initial_state(initial_state_)
           , run_now(run_now_)
           , scheduler_base(scheduler_base_)
+          , deadline(std::chrono::steady_clock::time_point::max())
         {
 #ifndef PIKA_HAVE_THREAD_DESCRIPTION
             PIKA_UNUSED(desc);
@@ -144,8 +149,10 @@ namespace pika::threads::detail {
 #if defined(PIKA_HAVE_THREAD_DESCRIPTION)
         ::pika::detail::thread_description description;
 #endif
-#if defined(PIKA_HAVE_THREAD_PARENT_REFERENCE)
+        // The parent is always recorded for the task trace, but it is only
+        // kept by the thread with PIKA_HAVE_THREAD_PARENT_REFERENCE
         thread_id_type parent_id;
+#if defined(PIKA_HAVE_THREAD_PARENT_REFERENCE)
         std::size_t parent_phase;
 #endif
 #ifdef PIKA_HAVE_APEX
@@ -161,5 +168,10 @@ namespace pika::threads::detail {
         bool run_now;
 
         ::pika::threads::detail::scheduler_base* scheduler_base;
+
+        // The time by which the thread should have run, used by schedulers
+        // which order threads by deadline. The maximum time point means that
+        // the thread has no deadline.
+        std::chrono::steady_clock::time_point deadline;
     };
 }    // namespace pika::threads::detail
@@ -182,6 +182,10 @@ namespace pika::threads::detail {
         mask_type get_used_processing_units() const;
         hwloc_bitmap_ptr get_numa_domain_bitmap() const;
 
+        /// Return the NUMA domain of the processing unit the given worker
+        /// thread (indexed from zero within the pool) is bound to
+        std::size_t get_numa_domain(std::size_t thread_num) const;
+
         // performance counters
 #if defined(PIKA_HAVE_THREAD_CUMULATIVE_COUNTS)
         virtual std::int64_t get_executed_threads(std::size_t /*thread_num*/, bool /*reset*/)
@@ -283,8 +287,21 @@ namespace pika::threads::detail {
         {
             return 0;
         }
+        virtual std::int64_t get_num_steal_successes(std::size_t /*thread_num*/, bool /*reset*/)
+        {
+            return 0;
+        }
+        virtual std::int64_t get_num_steal_failures(std::size_t /*thread_num*/, bool /*reset*/)
+        {
+            return 0;
+        }
 #endif
 
+        virtual std::int64_t get_num_deadline_misses(std::size_t /*thread_num*/, bool /*reset*/)
+        {
+            return 0;
+        }
+
         virtual std::int64_t get_thread_count(thread_schedule_state /*state*/,
             execution::thread_priority /*priority*/, std::size_t /*num_thread*/, bool /*reset*/)
         {
@@ -34,7 +34,10 @@ namespace pika::threads::detail {
             std::ptrdiff_t small_stacksize = PIKA_SMALL_STACK_SIZE,
             std::ptrdiff_t medium_stacksize = PIKA_MEDIUM_STACK_SIZE,
             std::ptrdiff_t large_stacksize = PIKA_LARGE_STACK_SIZE,
-            std::ptrdiff_t huge_stacksize = PIKA_HUGE_STACK_SIZE)
+            std::ptrdiff_t huge_stacksize = PIKA_HUGE_STACK_SIZE,
+            std::int64_t stack_cache_magazine_size = 64,
+            std::int64_t stack_cache_high_water_mark = -1,
+            std::int64_t stack_cache_trim_interval = 1000)
           // NOLINTEND(bugprone-easily-swappable-parameters)
           : max_thread_count_(max_thread_count)
           , min_tasks_to_steal_pending_(min_tasks_to_steal_pending)
@@ -51,6 +54,9 @@ namespace pika::threads::detail {
           , large_stacksize_(large_stacksize)
           , huge_stacksize_(huge_stacksize)
           , nostack_stacksize_((std::numeric_limits<std::ptrdiff_t>::max)())
+          , stack_cache_magazine_size_(stack_cache_magazine_size)
+          , stack_cache_high_water_mark_(stack_cache_high_water_mark)
+          , stack_cache_trim_interval_(stack_cache_trim_interval)
         {
         }
 
@@ -69,5 +75,10 @@ namespace pika::threads::detail {
         std::ptrdiff_t const large_stacksize_;
         std::ptrdiff_t const huge_stacksize_;
         std::ptrdiff_t const nostack_stacksize_;
+        std::int64_t stack_cache_magazine_size_;
+        // A negative value means no limit
+        std::int64_t stack_cache_high_water_mark_;
+        // In milliseconds, zero disables trimming
+        std::int64_t stack_cache_trim_interval_;
     };
 }    // namespace pika::threads::detail
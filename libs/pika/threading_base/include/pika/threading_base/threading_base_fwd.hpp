@@ -47,6 +47,7 @@ namespace pika::threads::detail {
     class thread_data;
     class thread_data_stackful;
     class thread_data_stackless;
+    struct thread_state_timer;
 
     using thread_id_ref_type = thread_id_ref;
     using thread_id_type = thread_id;
@@ -54,16 +54,16 @@ namespace pika::threads::detail {
 
         thread_self* self = get_self_ptr();
 
-#ifdef PIKA_HAVE_THREAD_PARENT_REFERENCE
         if (nullptr == data.parent_id)
         {
             if (self)
             {
                 data.parent_id = get_thread_id_data(self->get_thread_id());
+#ifdef PIKA_HAVE_THREAD_PARENT_REFERENCE
                 data.parent_phase = self->get_thread_phase();
+#endif
             }
         }
-#endif
 
         if (nullptr == data.scheduler_base) data.scheduler_base = scheduler;
 
@@ -17,6 +17,7 @@
 #include <pika/threading_base/execution_agent.hpp>
 #include <pika/threading_base/scheduler_base.hpp>
 #include <pika/threading_base/set_thread_state.hpp>
+#include <pika/threading_base/set_thread_state_timed.hpp>
 #include <pika/threading_base/thread_description.hpp>
 
 #ifdef PIKA_HAVE_THREAD_BACKTRACE_ON_SUSPENSION
@@ -86,22 +87,52 @@ namespace pika::threads::detail {
         sleep_until(sleep_duration.from_now(), desc);
     }
 
+    namespace {
+        // Makes sure that a timer living on the stack of a suspended thread is
+        // disarmed before it goes out of scope, also when the thread was woken
+        // up early or interrupted.
+        struct cancel_timer_on_exit
+        {
+            thread_state_timer& timer_;
+
+            ~cancel_timer_on_exit() { cancel_thread_state_timed(timer_); }
+        };
+    }    // namespace
+
     void execution_agent::sleep_until(
         pika::chrono::steady_time_point const& sleep_time, const char* desc)
     {
-        // Just yield until time has passed by...
-        auto now = std::chrono::steady_clock::now();
-
-        // Note: we yield at least once to allow for other threads to
-        // make progress in any case. We also use yield instead of yield_k
-        // for the same reason.
-        std::size_t k = 0;
-        do {
-            if (k < 32 || k & 1) { do_yield(desc, thread_schedule_state::pending_boost); }
-            else { do_yield(desc, thread_schedule_state::pending); }
-            ++k;
-            now = std::chrono::steady_clock::now();
-        } while (now < sleep_time.value());
+        // Note: we yield at least once to allow for other threads to make
+        // progress in any case.
+        if (sleep_time.value() <= std::chrono::steady_clock::now())
+        {
+            do_yield(desc, thread_schedule_state::pending_boost);
+            return;
+        }
+
+        thread_id_type id = self_.get_thread_id();
+        if (PIKA_UNLIKELY(!id))
+        {
+            PIKA_THROW_EXCEPTION(pika::error::null_thread_id, "execution_agent::sleep_until",
+                "null thread id encountered (is this executed on a pika-thread?)");
+        }
+
+        // Suspend the thread and let the timer wheel of its scheduler make it
+        // pending again once the deadline has passed. The thread may also be
+        // resumed early, in which case the timer is cancelled. The timer only
+        // resumes the thread from the suspension below, also if it expires
+        // before the thread has been suspended.
+        thread_state_timer timer;
+        timer.active_tag_ = get_thread_id_data(id)->get_state().tag();
+        set_thread_state_timed(get_thread_id_data(id)->get_scheduler_base(), timer, sleep_time, id,
+            thread_schedule_state::pending, thread_restart_state::timeout,
+            execution::thread_priority::boost,
+            execution::thread_schedule_hint{
+                static_cast<std::int16_t>(pika::get_local_worker_thread_num())},
+            true, throws);
+
+        cancel_timer_on_exit on_exit{timer};
+        do_yield(desc, thread_schedule_state::suspended);
     }
 
 #if defined(PIKA_HAVE_VERIFY_LOCKS)
@@ -4,26 +4,110 @@
 //  Distributed under the Boost Software License, Version 1.0. (See accompanying
 //  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
+#include <pika/concurrency/cache_line_data.hpp>
 #include <pika/threading_base/detail/global_activity_count.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
+#include <memory>
+#include <thread>
 
 namespace pika::threads::detail {
-    static std::atomic<std::size_t> global_activity_count{0};
+    namespace {
+        // The activity count is split into shards on separate cache lines so
+        // that threads incrementing and decrementing it concurrently do not
+        // contend on a single cache line. Each shard only ever grows: the
+        // number of activities is the difference between the started and
+        // finished activities summed over all shards. An activity may finish
+        // on another shard than the one it started on.
+        struct activity_count_shard
+        {
+            std::atomic<std::size_t> started{0};
+            std::atomic<std::size_t> finished{0};
+        };
+
+        using activity_count_shard_type =
+            pika::concurrency::detail::cache_aligned_data<activity_count_shard>;
+
+        struct activity_count_shards
+        {
+            activity_count_shards()
+              : num_shards(
+                    std::size_t(1) << max_shards_log2(std::thread::hardware_concurrency()))
+              , shards(new activity_count_shard_type[num_shards])
+            {
+            }
+
+            static std::size_t max_shards_log2(std::size_t concurrency)
+            {
+                std::size_t log2 = 0;
+                while ((std::size_t(1) << log2) < (std::max)(concurrency, std::size_t(1)) &&
+                    log2 < 10)
+                {
+                    ++log2;
+                }
+                return log2;
+            }
+
+            activity_count_shard& get_shard()
+            {
+                // Threads are assigned shards round-robin the first time
+                // they change the activity count. With more threads than
+                // shards some threads share a shard.
+                thread_local std::size_t const shard =
+                    next_shard.fetch_add(1, std::memory_order_relaxed) & (num_shards - 1);
+                return shards[shard].data_;
+            }
+
+            std::size_t const num_shards;
+            std::unique_ptr<activity_count_shard_type[]> const shards;
+            std::atomic<std::size_t> next_shard{0};
+        };
+
+        activity_count_shards& get_activity_count_shards()
+        {
+            // The shards are never freed since activities may still finish
+            // while static objects are destroyed.
+            static activity_count_shards* shards = new activity_count_shards;
+            return *shards;
+        }
+    }    // namespace
 
     void increment_global_activity_count()
     {
-        global_activity_count.fetch_add(1, std::memory_order_acquire);
+        get_activity_count_shards().get_shard().started.fetch_add(1, std::memory_order_release);
     }
 
     void decrement_global_activity_count()
     {
-        global_activity_count.fetch_sub(1, std::memory_order_release);
+        get_activity_count_shards().get_shard().finished.fetch_add(1, std::memory_order_release);
     }
 
     std::size_t get_global_activity_count()
     {
-        return global_activity_count.load(std::memory_order_acquire);
+        auto& shards = get_activity_count_shards();
+
+        // The finished activities are summed before the started ones. An
+        // activity is always started before it finishes, so every finished
+        // activity seen by the first pass is also seen as started by the
+        // second pass. The difference can thus never be smaller than the
+        // number of activities which were running throughout the call, and
+        // is zero only if there was a point during the call at which no
+        // activity was running. Activities started during the call may make
+        // the difference larger, which only makes waiting more conservative.
+        std::size_t finished = 0;
+        for (std::size_t i = 0; i != shards.num_shards; ++i)
+        {
+            finished += shards.shards[i].data_.finished.load(std::memory_order_acquire);
+        }
+
+        std::size_t started = 0;
+        for (std::size_t i = 0; i != shards.num_shards; ++i)
+        {
+            started += shards.shards[i].data_.started.load(std::memory_order_acquire);
+        }
+
+        return started - finished;
     }
 }    // namespace pika::threads::detail
@@ -0,0 +1,132 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/threading_base/detail/polling_registry.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace pika::threads::detail {
+    polling_registry::polling_registry(std::size_t num_threads)
+      : current_sources_(nullptr)
+      , work_count_readers_(0)
+      , version_(0)
+      , workers_(num_threads)
+    {
+    }
+
+    void polling_registry::add(std::string name, polling_source source)
+    {
+        PIKA_ASSERT(source.poll);
+        if (source.frequency == 0) source.frequency = 1;
+
+        std::lock_guard<std::mutex> l(mtx_);
+
+        auto sources = sources_ ? std::make_shared<sources_type>(*sources_) :
+                                  std::make_shared<sources_type>();
+
+        auto it = std::find_if(sources->begin(), sources->end(),
+            [&](entry const& e) { return e.name == name; });
+        if (it != sources->end()) { it->source = std::move(source); }
+        else { sources->push_back(entry{std::move(name), std::move(source)}); }
+
+        publish(std::move(sources));
+    }
+
+    bool polling_registry::remove(std::string const& name)
+    {
+        std::lock_guard<std::mutex> l(mtx_);
+
+        if (!sources_) return false;
+
+        auto it = std::find_if(sources_->begin(), sources_->end(),
+            [&](entry const& e) { return e.name == name; });
+        if (it == sources_->end()) return false;
+
+        auto sources = std::make_shared<sources_type>();
+        sources->reserve(sources_->size() - 1);
+        std::copy_if(sources_->begin(), sources_->end(), std::back_inserter(*sources),
+            [&](entry const& e) { return e.name != name; });
+
+        publish(sources->empty() ? nullptr : std::move(sources));
+        return true;
+    }
+
+    void polling_registry::publish(sources_ptr sources)
+    {
+        if (sources_) { retired_sources_.push_back(std::move(sources_)); }
+        sources_ = std::move(sources);
+        current_sources_.store(sources_.get(), std::memory_order_seq_cst);
+
+        // A call to work_count starting after this point sees the new
+        // sources
+        if (work_count_readers_.load(std::memory_order_seq_cst) == 0)
+        {
+            retired_sources_.clear();
+        }
+
+        version_.fetch_add(1, std::memory_order_release);
+    }
+
+    polling_status polling_registry::poll(std::size_t num_thread)
+    {
+        PIKA_ASSERT(num_thread < workers_.size());
+        worker_data& data = workers_[num_thread].data_;
+
+        std::uint64_t const version = version_.load(std::memory_order_acquire);
+        if (PIKA_UNLIKELY(version != data.version))
+        {
+            std::lock_guard<std::mutex> l(mtx_);
+            data.sources = sources_;
+            data.version = version_.load(std::memory_order_relaxed);
+        }
+
+        if (!data.sources) return polling_status::idle;
+
+        std::size_t const iteration = data.iteration++;
+
+        polling_status status = polling_status::idle;
+        for (entry const& e : *data.sources)
+        {
+            if (e.source.frequency != 1 && iteration % e.source.frequency != 0) continue;
+            if (e.source.poll() == polling_status::busy) status = polling_status::busy;
+        }
+        return status;
+    }
+
+    std::size_t polling_registry::work_count() const
+    {
+        // This is called repeatedly by idle worker threads, so it only
+        // announces itself to publish instead of taking the lock
+        work_count_readers_.fetch_add(1, std::memory_order_seq_cst);
+
+        std::size_t count = 0;
+        if (auto const* sources = current_sources_.load(std::memory_order_seq_cst))
+        {
+            for (entry const& e : *sources)
+            {
+                if (e.source.work_count) count += e.source.work_count();
+            }
+        }
+
+        work_count_readers_.fetch_sub(1, std::memory_order_release);
+        return count;
+    }
+
+    std::size_t polling_registry::size() const
+    {
+        std::lock_guard<std::mutex> l(mtx_);
+        return sources_ ? sources_->size() : 0;
+    }
+}    // namespace pika::threads::detail
@@ -11,6 +11,7 @@
 #include <pika/threading_base/scheduler_mode.hpp>
 #include <pika/threading_base/scheduler_state.hpp>
 #include <pika/threading_base/thread_init_data.hpp>
+#include <pika/threading_base/thread_num_tss.hpp>
 #include <pika/threading_base/thread_pool_base.hpp>
 #if defined(PIKA_HAVE_SCHEDULER_LOCAL_STORAGE)
 # include <pika/coroutines/detail/tss.hpp>
@@ -44,10 +45,11 @@ namespace pika::threads::detail {
       , description_(description)
       , thread_queue_init_(thread_queue_init)
       , parent_pool_(nullptr)
-      , polling_function_mpi_(&null_polling_function)
-      , polling_function_cuda_(&null_polling_function)
-      , polling_work_count_function_mpi_(&null_polling_work_count_function)
-      , polling_work_count_function_cuda_(&null_polling_work_count_function)
+      , polling_sources_(num_threads)
+      , next_thread_slots_(num_threads)
+#if defined(PIKA_HAVE_THREAD_MANAGER_IDLE_BACKOFF)
+      , parking_(num_threads)
+#endif
     {
         set_scheduler_mode(mode);
 
@@ -84,8 +86,19 @@ namespace pika::threads::detail {
 
             ++data.wait_count_;
 
-            std::unique_lock<pu_mutex_type> l(mtx_);
-            if (cond_.wait_for(l, period) == std::cv_status::no_timeout)
+            // Don't sleep past the next timer deadline, the timers are only
+            // expired by the scheduling loop
+            if (!timers_.empty())
+            {
+                auto const until_next_timer = std::chrono::ceil<std::chrono::milliseconds>(
+                    timers_.next_expiry() - timer_wheel::clock_type::now());
+                period = (std::max)(
+                    std::chrono::milliseconds(0), (std::min)(period, until_next_timer));
+            }
+
+            // Work which was added right before parking may have missed
+            // this thread
+            if (parking_.park(num_thread, period, [&] { return get_queue_length() != 0; }))
             {
                 // reset counter if thread was woken up
                 data.wait_count_ = 0;
@@ -98,14 +111,66 @@ namespace pika::threads::detail {
 
     /// This function gets called by the thread-manager whenever new work
     /// has been added, allowing the scheduler to reactivate one or more of
-    /// possibly idling OS threads
-    void scheduler_base::do_some_work(std::size_t)
+    /// possibly idling OS threads. Only one OS thread is woken up: the one the
+    /// work was added for if it is idling, otherwise the closest idling one.
+    void scheduler_base::do_some_work(std::size_t num_thread)
+    {
+#if defined(PIKA_HAVE_THREAD_MANAGER_IDLE_BACKOFF)
+        if (has_scheduler_mode(scheduler_mode::enable_idle_backoff))
+        {
+            parking_.unpark_one(num_thread);
+        }
+#else
+        (void) num_thread;
+#endif
+    }
+
+    void scheduler_base::wake_all_workers()
     {
 #if defined(PIKA_HAVE_THREAD_MANAGER_IDLE_BACKOFF)
-        if (has_scheduler_mode(scheduler_mode::enable_idle_backoff)) { cond_.notify_all(); }
+        parking_.unpark_all();
 #endif
     }
 
+    bool scheduler_base::schedule_thread_next(
+        threads::detail::thread_id_ref_type& thrd, execution::thread_priority priority)
+    {
+        // Hints are ignored like when threads are stolen, the hint given when
+        // resuming a thread is only the worker thread it was suspended on
+        if (!has_scheduler_mode(scheduler_mode::enable_next_thread_slot) ||
+            priority != execution::thread_priority::normal)
+        {
+            return false;
+        }
+
+        // Only the worker threads of this scheduler have a slot
+        if (parent_pool_ == nullptr ||
+            get_thread_pool_num_tss() != parent_pool_->get_pool_id().index())
+        {
+            return false;
+        }
+
+        std::size_t const num_thread = get_local_thread_num_tss();
+        if (num_thread >= next_thread_slots_.size()) { return false; }
+
+        PIKA_ASSERT(get_thread_id_data(thrd)->get_scheduler_base() == this);
+
+        // The most recently woken up thread runs next, a thread which was
+        // waiting in the slot goes to the queues
+        next_thread_slot& slot = next_thread_slots_[num_thread].data_;
+        std::swap(slot.thrd_, thrd);
+        if (thrd)
+        {
+            auto const previous_priority = get_thread_id_data(thrd)->get_priority();
+            schedule_thread(PIKA_MOVE(thrd),
+                execution::thread_schedule_hint(static_cast<std::int16_t>(num_thread)), true,
+                previous_priority);
+            do_some_work(num_thread);
+        }
+
+        return true;
+    }
+
     void scheduler_base::suspend(std::size_t num_thread)
     {
         PIKA_ASSERT(num_thread < suspend_conds_.size());
@@ -238,6 +303,7 @@ namespace pika::threads::detail {
     {
         using state_type = std::atomic<pika::runtime_state>;
         for (state_type& state : states_) { state.store(s); }
+        wake_all_workers();
     }
 
     void scheduler_base::set_all_states_at_least(pika::runtime_state s)
@@ -247,6 +313,7 @@ namespace pika::threads::detail {
         {
             if (state < s) { state.store(s); }
         }
+        wake_all_workers();
     }
 
     // return whether all states are at least at the given one
@@ -291,7 +358,7 @@ namespace pika::threads::detail {
     {
         // distribute the same value across all cores
         mode_.data_.store(mode, std::memory_order_release);
-        do_some_work(std::size_t(-1));
+        wake_all_workers();
     }
 
     void scheduler_base::add_scheduler_mode(scheduler_mode mode)
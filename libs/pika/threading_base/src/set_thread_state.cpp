@@ -61,6 +61,39 @@ namespace pika::threads::detail {
         return thread_result_type(thread_schedule_state::terminated, invalid_thread_id);
     }
 
+    namespace {
+        // Schedule a thread which was not pending before its state was
+        // changed to new_state
+        void schedule_pending_thread(thread_id_type const& thrd, thread_schedule_state new_state,
+            execution::thread_schedule_hint schedulehint)
+        {
+            if (new_state != thread_schedule_state::pending &&
+                new_state != thread_schedule_state::pending_boost)
+            {
+                return;
+            }
+
+            // REVIEW: Passing a specific target thread may interfere with the
+            // round robin queuing.
+
+            auto* thrd_data = get_thread_id_data(thrd);
+            auto* scheduler = thrd_data->get_scheduler_base();
+
+            // Run the thread next on the calling worker thread if the
+            // scheduler has a next thread slot enabled
+            thread_id_ref_type thrd_ref(thrd);
+            if (new_state != thread_schedule_state::pending ||
+                !scheduler->schedule_thread_next(thrd_ref, thrd_data->get_priority()))
+            {
+                scheduler->schedule_thread(
+                    PIKA_MOVE(thrd_ref), schedulehint, false, thrd_data->get_priority());
+                // NOTE: Don't care if the hint is a NUMA hint, just want to
+                // wake up a thread.
+                scheduler->do_some_work(schedulehint.hint);
+            }
+        }
+    }    // namespace
+
     ///////////////////////////////////////////////////////////////////////////
     thread_state set_thread_state(thread_id_type const& thrd, thread_schedule_state new_state,
         thread_restart_state new_state_ex, execution::thread_priority priority,
@@ -221,23 +254,31 @@ namespace pika::threads::detail {
 
         thread_schedule_state previous_state_val = previous_state.state();
         if (!(previous_state_val == thread_schedule_state::pending ||
-                previous_state_val == thread_schedule_state::pending_boost) &&
-            (new_state == thread_schedule_state::pending ||
-                new_state == thread_schedule_state::pending_boost))
+                previous_state_val == thread_schedule_state::pending_boost))
         {
-            // REVIEW: Passing a specific target thread may interfere with the
-            // round robin queuing.
-
-            auto* thrd_data = get_thread_id_data(thrd);
-            auto* scheduler = thrd_data->get_scheduler_base();
-            scheduler->schedule_thread(thrd, schedulehint, false, thrd_data->get_priority());
-            // NOTE: Don't care if the hint is a NUMA hint, just want to wake up
-            // a thread.
-            scheduler->do_some_work(schedulehint.hint);
+            schedule_pending_thread(thrd, new_state, schedulehint);
         }
 
         if (&ec != &throws) ec = make_success_code();
 
         return previous_state;
     }
+
+    bool set_suspended_thread_state(thread_id_type const& thrd, thread_state expected_state,
+        thread_schedule_state new_state, thread_restart_state new_state_ex,
+        execution::thread_schedule_hint schedulehint)
+    {
+        PIKA_ASSERT(thrd);
+        PIKA_ASSERT(expected_state.state() == thread_schedule_state::suspended);
+        PIKA_ASSERT(new_state != thread_schedule_state::active &&
+            new_state != thread_schedule_state::suspended);
+
+        if (!get_thread_id_data(thrd)->restore_state(new_state, new_state_ex, expected_state))
+        {
+            return false;
+        }
+
+        schedule_pending_thread(thrd, new_state, schedulehint);
+        return true;
+    }
 }    // namespace pika::threads::detail
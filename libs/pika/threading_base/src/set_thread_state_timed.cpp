@@ -6,171 +6,89 @@
 
 #include <pika/config.hpp>
 #include <pika/assert.hpp>
-#include <pika/coroutines/coroutine.hpp>
-#include <pika/functional/bind.hpp>
-#include <pika/functional/bind_front.hpp>
 #include <pika/modules/errors.hpp>
-#include <pika/threading_base/create_thread.hpp>
+#include <pika/threading_base/detail/timer_wheel.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
+#include <pika/threading_base/set_thread_state.hpp>
 #include <pika/threading_base/set_thread_state_timed.hpp>
+#include <pika/threading_base/thread_data.hpp>
 #include <pika/threading_base/threading_base_fwd.hpp>
 
-#include <atomic>
-#include <chrono>
-#include <functional>
-#include <memory>
-#include <system_error>
-#include <utility>
+#include <cstddef>
 
 namespace pika::threads::detail {
-    /// This thread function is used by the at_timer thread below to trigger
-    /// the required action.
-    thread_result_type wake_timer_thread(thread_id_ref_type const& thrd,
-        thread_schedule_state /*newstate*/, thread_restart_state /*newstate_ex*/,
-        execution::thread_priority /*priority*/, thread_id_type timer_id,
-        std::shared_ptr<std::atomic<bool>> const& triggered, bool retry_on_active,
-        thread_restart_state my_statex)
+    /// This function is called by the timer wheel of the scheduler once the
+    /// timer has expired and triggers the required action.
+    void thread_state_timer::on_expire(timer_wheel_entry& entry) noexcept
     {
-        if (PIKA_UNLIKELY(!thrd))
-        {
-            PIKA_THROW_EXCEPTION(pika::error::null_thread_id, "threads::detail::wake_timer_thread",
-                "null thread id encountered (id)");
-            return thread_result_type(thread_schedule_state::terminated, invalid_thread_id);
-        }
+        auto& timer = static_cast<thread_state_timer&>(entry);
 
-        if (PIKA_UNLIKELY(!timer_id))
+        if (timer.active_tag_ < 0)
         {
-            PIKA_THROW_EXCEPTION(pika::error::null_thread_id, "threads::detail::wake_timer_thread",
-                "null thread id encountered (timer_id)");
-            return thread_result_type(thread_schedule_state::terminated, invalid_thread_id);
+            error_code ec(throwmode::lightweight);    // do not throw
+            set_thread_state(timer.thrd_, timer.newstate_, timer.newstate_ex_, timer.priority_,
+                timer.schedulehint_, timer.retry_on_active_, ec);
+            return;
         }
 
-        PIKA_ASSERT(
-            my_statex == thread_restart_state::abort || my_statex == thread_restart_state::timeout);
-
-        if (!triggered->load())
+        thread_state const state = get_thread_id_data(timer.thrd_)->get_state();
+        if (state.state() == thread_schedule_state::active && state.tag() == timer.active_tag_)
         {
-            error_code ec(throwmode::lightweight);    // do not throw
-            set_thread_state(timer_id, thread_schedule_state::pending, my_statex,
-                execution::thread_priority::boost, execution::thread_schedule_hint(),
-                retry_on_active, ec);
+            // The timer has expired before the thread got to suspend itself.
+            // Try again with the next tick of the timer wheel.
+            timer.scheduler_->get_timer_wheel().schedule(
+                timer, pika::chrono::steady_clock::now());
+            return;
         }
 
-        return thread_result_type(thread_schedule_state::terminated, invalid_thread_id);
-    }
-
-    /// This thread function initiates the required set_state action (on
-    /// behalf of one of the threads#detail#set_thread_state functions).
-    thread_result_type at_timer(scheduler_base* scheduler,
-        std::chrono::steady_clock::time_point& /*abs_time*/, thread_id_ref_type const& thrd,
-        thread_schedule_state newstate, thread_restart_state newstate_ex,
-        execution::thread_priority priority, std::atomic<bool>* /*started*/, bool retry_on_active)
-    {
-        if (PIKA_UNLIKELY(!thrd))
+        // Anything else than the suspension following the arming of the timer
+        // means that the thread has already been resumed
+        if (state.state() == thread_schedule_state::suspended &&
+            state.tag() == timer.active_tag_ + 1)
         {
-            PIKA_THROW_EXCEPTION(pika::error::null_thread_id, "threads::detail::at_timer",
-                "null thread id encountered");
-            return thread_result_type(thread_schedule_state::terminated, invalid_thread_id);
+            set_suspended_thread_state(
+                timer.thrd_, state, timer.newstate_, timer.newstate_ex_, timer.schedulehint_);
         }
-
-        // create a new thread in suspended state, which will execute the
-        // requested set_state when timer fires and will re-awaken this thread,
-        // allowing the deadline_timer to go out of scope gracefully
-        thread_id_ref_type self_id = get_self_id();    // keep alive
-
-        std::shared_ptr<std::atomic<bool>> triggered(std::make_shared<std::atomic<bool>>(false));
-
-        thread_init_data data(
-            util::detail::bind_front(&wake_timer_thread, thrd, newstate, newstate_ex, priority,
-                self_id.noref(), triggered, retry_on_active),
-            "wake_timer", priority, execution::thread_schedule_hint(),
-            execution::thread_stacksize::small_, thread_schedule_state::suspended, true);
-
-        thread_id_ref_type wake_id = invalid_thread_id;
-        create_thread(scheduler, data, wake_id);
-
-        PIKA_THROW_EXCEPTION(
-            pika::error::invalid_status, "at_timer", "Timed suspension is currently not supported");
-        // // create timer firing in correspondence with given time
-        // using deadline_timer =
-        //     asio::basic_waitable_timer<std::chrono::steady_clock>;
-
-        // asio::io_context* s = get_default_timer_service();
-        // PIKA_ASSERT(s);
-        // deadline_timer t(*s, abs_time);
-
-        // // let the timer invoke the set_state on the new (suspended) thread
-        // t.async_wait([wake_id = PIKA_MOVE(wake_id), priority, retry_on_active](
-        //                  std::error_code const& ec) {
-        //     if (ec == std::make_error_code(std::errc::operation_canceled))
-        //     {
-        //            set_thread_state(wake_id.noref(), thread_schedule_state::pending,
-        //                thread_restart_state::abort, priority,
-        //                execution::thread_schedule_hint(), retry_on_active, throws);
-        //     }
-        //     else
-        //     {
-        //         set_thread_state(wake_id.noref(),
-        //             thread_schedule_state::pending,
-        //             thread_restart_state::timeout, priority,
-        //             execution::thread_schedule_hint(), retry_on_active, throws);
-        //     }
-        // });
-
-        // if (started != nullptr)
-        // {
-        //     started->store(true);
-        // }
-
-        // // this waits for the thread to be reactivated when the timer fired
-        // // if it returns signaled the timer has been canceled, otherwise
-        // // the timer fired and the wake_timer_thread above has been executed
-        // thread_restart_state statex = get_self().yield(thread_result_type(
-        //     thread_schedule_state::suspended, invalid_thread_id));
-
-        // PIKA_ASSERT(statex == thread_restart_state::abort ||
-        //     statex == thread_restart_state::timeout);
-
-        // // NOLINTNEXTLINE(bugprone-branch-clone)
-        // if (thread_restart_state::timeout != statex)    //-V601
-        // {
-        //     triggered->store(true);
-        //     // wake_timer_thread has not been executed yet, cancel timer
-        //     t.cancel();
-        // }
-        // else
-        // {
-        //     set_thread_state(
-        //         thrd.noref(), newstate, newstate_ex, priority);
-        // }
-
-        return thread_result_type(thread_schedule_state::terminated, invalid_thread_id);
     }
 
     /// Set a timer to set the state of the given \a thread to the given
     /// new value after it expired (at the given time)
-    thread_id_ref_type set_thread_state_timed(scheduler_base* scheduler,
+    void set_thread_state_timed(scheduler_base* scheduler, thread_state_timer& timer,
         pika::chrono::steady_time_point const& abs_time, thread_id_type const& thrd,
         thread_schedule_state newstate, thread_restart_state newstate_ex,
         execution::thread_priority priority, execution::thread_schedule_hint schedulehint,
-        std::atomic<bool>* started, bool retry_on_active, error_code& ec)
+        bool retry_on_active, error_code& ec)
     {
         if (PIKA_UNLIKELY(!thrd))
         {
-            PIKA_THROWS_IF(ec, pika::error::null_thread_id, "threads::detail::set_thread_state",
-                "null thread id encountered");
-            return invalid_thread_id;
+            PIKA_THROWS_IF(ec, pika::error::null_thread_id,
+                "threads::detail::set_thread_state_timed", "null thread id encountered");
+            return;
         }
 
-        // this creates a new thread which creates the timer and handles the
-        // requested actions
-        thread_init_data data(
-            util::detail::bind(&at_timer, scheduler, abs_time.value(), thread_id_ref_type(thrd),
-                newstate, newstate_ex, priority, started, retry_on_active),
-            "at_timer (expire at)", priority, schedulehint, execution::thread_stacksize::small_,
-            thread_schedule_state::pending, true);
+        PIKA_ASSERT(scheduler != nullptr);
 
-        thread_id_ref_type newid = invalid_thread_id;
-        create_thread(scheduler, data, newid, ec);    //-V601
-        return newid;
+        timer.scheduler_ = scheduler;
+        timer.thrd_ = thrd;
+        timer.newstate_ = newstate;
+        timer.newstate_ex_ = newstate_ex;
+        timer.priority_ = priority;
+        timer.schedulehint_ = schedulehint;
+        timer.retry_on_active_ = retry_on_active;
+
+        // The timer is expired by the scheduling loop. Make sure a worker that
+        // is currently backing off notices the new, earlier deadline.
+        if (scheduler->get_timer_wheel().schedule(timer, abs_time.value()))
+        {
+            scheduler->do_some_work(std::size_t(-1));
+        }
+
+        if (&ec != &throws) ec = make_success_code();
+    }
+
+    bool cancel_thread_state_timed(thread_state_timer& timer)
+    {
+        if (timer.scheduler_ == nullptr) return false;
+        return timer.scheduler_->get_timer_wheel().cancel(timer);
     }
 }    // namespace pika::threads::detail
@@ -0,0 +1,523 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/threading_base/detail/task_trace.hpp>
+#include <pika/threading_base/thread_description.hpp>
+#include <pika/threading_base/thread_num_tss.hpp>
+#include <pika/timing/detail/timestamp.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// rdtscp is cheap enough to take a timestamp for every event, other ways of
+// reading the time stamp counter serialize the pipeline
+#if (defined(__x86_64__) || defined(_M_X64)) && defined(PIKA_HAVE_RDTSCP) &&                      \
+    !defined(PIKA_MSVC) && !defined(PIKA_NVHPC_VERSION)
+# define PIKA_TASK_TRACE_USE_TIMESTAMP_COUNTER
+#endif
+
+namespace pika::threads::detail {
+    std::atomic<bool> task_trace_enabled{false};
+
+    char const* get_task_trace_event_name(task_trace_event event) noexcept
+    {
+        switch (event)
+        {
+        case task_trace_event::create: return "create";
+        case task_trace_event::start: return "start";
+        case task_trace_event::suspend: return "suspend";
+        case task_trace_event::resume: return "resume";
+        case task_trace_event::terminate: return "terminate";
+        }
+        return "unknown";
+    }
+
+    namespace {
+        std::uint64_t steady_clock_ns() noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+
+        std::uint64_t task_trace_ticks() noexcept
+        {
+#if defined(PIKA_TASK_TRACE_USE_TIMESTAMP_COUNTER)
+            return pika::chrono::detail::timestamp();
+#else
+            return steady_clock_ns();
+#endif
+        }
+
+        // A single-writer ring buffer. Only the OS thread owning the buffer
+        // writes records, and it publishes them by incrementing written.
+        struct task_trace_buffer
+        {
+            task_trace_buffer(std::size_t size, std::uint32_t worker)
+              : records(new task_trace_record[size])
+              , mask(size - 1)
+              , worker(worker)
+            {
+            }
+
+            std::unique_ptr<task_trace_record[]> records;
+            std::size_t const mask;
+            std::uint32_t const worker;
+            std::atomic<std::uint64_t> written{0};
+        };
+
+        struct task_trace_registry
+        {
+            std::mutex mtx;
+            std::vector<std::unique_ptr<task_trace_buffer>> buffers;
+            std::size_t buffer_size = 0;
+
+            // Incremented whenever tracing is enabled so that OS threads
+            // know when to allocate a new buffer
+            std::atomic<std::uint64_t> generation{0};
+
+            // Used to convert ticks to nanoseconds since tracing has been
+            // enabled
+            std::uint64_t start_ticks = 0;
+            std::uint64_t start_ns = 0;
+        };
+
+        task_trace_registry registry;
+
+        thread_local task_trace_buffer* local_buffer = nullptr;
+        thread_local std::uint64_t local_generation = 0;
+
+        void allocate_local_buffer() noexcept
+        {
+            std::lock_guard<std::mutex> l(registry.mtx);
+            local_generation = registry.generation.load(std::memory_order_relaxed);
+            local_buffer = nullptr;
+
+            try
+            {
+                auto const worker = static_cast<std::uint32_t>(get_global_thread_num_tss());
+                registry.buffers.push_back(
+                    std::make_unique<task_trace_buffer>(registry.buffer_size, worker));
+                local_buffer = registry.buffers.back().get();
+            }
+            catch (std::bad_alloc const&)
+            {
+                // This OS thread does not record any events
+            }
+        }
+    }    // namespace
+
+    void enable_task_trace(std::size_t buffer_size)
+    {
+        std::size_t size = 1;
+        while (size < (std::max)(buffer_size, std::size_t(1))) { size <<= 1; }
+
+        {
+            std::lock_guard<std::mutex> l(registry.mtx);
+            registry.buffers.clear();
+            registry.buffer_size = size;
+            registry.start_ns = steady_clock_ns();
+            registry.start_ticks = task_trace_ticks();
+            registry.generation.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        task_trace_enabled.store(true, std::memory_order_release);
+    }
+
+    void disable_task_trace() noexcept
+    {
+        task_trace_enabled.store(false, std::memory_order_release);
+    }
+
+    void record_task_trace_event(task_trace_event event, void const* thread_id,
+        void const* parent_id, ::pika::detail::thread_description const& description) noexcept
+    {
+        if (PIKA_UNLIKELY(local_generation != registry.generation.load(std::memory_order_relaxed)))
+        {
+            allocate_local_buffer();
+        }
+
+        task_trace_buffer* buffer = local_buffer;
+        if (PIKA_UNLIKELY(buffer == nullptr)) { return; }
+
+        std::uint64_t const n = buffer->written.load(std::memory_order_relaxed);
+        task_trace_record& r = buffer->records[n & buffer->mask];
+
+        r.timestamp = task_trace_ticks();
+        r.thread_id = thread_id;
+        r.parent_id = parent_id;
+        r.has_address =
+            description.kind() == ::pika::detail::thread_description::data_type_address;
+        if (r.has_address) { r.address = description.get_address(); }
+        else { r.description = description.get_description(); }
+        r.worker = buffer->worker;
+        r.event = event;
+
+        buffer->written.store(n + 1, std::memory_order_release);
+    }
+
+    namespace {
+        // Returns the records of each buffer, with timestamps converted to
+        // nanoseconds. Buffers of worker threads come first, ordered by
+        // worker thread number.
+        std::vector<std::vector<task_trace_record>> collect_task_trace()
+        {
+            std::vector<std::vector<task_trace_record>> tracks;
+
+            std::lock_guard<std::mutex> l(registry.mtx);
+
+            std::uint64_t const end_ticks = task_trace_ticks();
+            std::uint64_t const end_ns = steady_clock_ns();
+            double const ns_per_tick = end_ticks > registry.start_ticks ?
+                double(end_ns - registry.start_ns) / double(end_ticks - registry.start_ticks) :
+                1.0;
+
+            std::vector<task_trace_buffer const*> buffers;
+            for (auto const& b : registry.buffers) { buffers.push_back(b.get()); }
+            std::stable_sort(buffers.begin(), buffers.end(),
+                [](auto const* lhs, auto const* rhs) { return lhs->worker < rhs->worker; });
+
+            for (auto const* b : buffers)
+            {
+                std::uint64_t const written = b->written.load(std::memory_order_acquire);
+                std::uint64_t const size = b->mask + 1;
+                std::uint64_t const first = written > size ? written - size : 0;
+
+                std::vector<task_trace_record> records;
+                records.reserve(written - first);
+                for (std::uint64_t i = first; i != written; ++i)
+                {
+                    task_trace_record r = b->records[i & b->mask];
+                    r.timestamp = r.timestamp > registry.start_ticks ?
+                        std::uint64_t(double(r.timestamp - registry.start_ticks) * ns_per_tick) :
+                        0;
+                    records.push_back(r);
+                }
+                tracks.push_back(std::move(records));
+            }
+
+            return tracks;
+        }
+
+        enum class trace_item
+        {
+            slice_begin,
+            slice_end,
+            instant
+        };
+
+        // Calls f(item, record) for the events of one track, turning runs of
+        // threads into slices. The end of a run whose beginning has been
+        // overwritten is skipped.
+        template <typename F>
+        void visit_track(std::vector<task_trace_record> const& records, F&& f)
+        {
+            bool in_slice = false;
+            for (auto const& r : records)
+            {
+                switch (r.event)
+                {
+                case task_trace_event::create: f(trace_item::instant, r); break;
+                case task_trace_event::start:
+                case task_trace_event::resume:
+                    if (in_slice) { break; }
+                    in_slice = true;
+                    f(trace_item::slice_begin, r);
+                    break;
+                case task_trace_event::suspend:
+                case task_trace_event::terminate:
+                    if (!in_slice) { break; }
+                    in_slice = false;
+                    f(trace_item::slice_end, r);
+                    break;
+                }
+            }
+        }
+
+        // Assigns a track id to each buffer: worker threads use their worker
+        // thread number, other OS threads are numbered after the workers
+        std::vector<std::uint64_t> get_track_ids(
+            std::vector<std::vector<task_trace_record>> const& tracks)
+        {
+            std::vector<std::uint64_t> ids;
+            std::uint64_t next_id = 0;
+            for (auto const& t : tracks)
+            {
+                std::uint32_t const worker = t.empty() ? std::uint32_t(-1) : t.front().worker;
+                if (worker != std::uint32_t(-1))
+                {
+                    ids.push_back(worker);
+                    next_id = (std::max)(next_id, std::uint64_t(worker) + 1);
+                }
+                else { ids.push_back(next_id++); }
+            }
+            return ids;
+        }
+
+        std::string get_track_name(std::vector<task_trace_record> const& records)
+        {
+            std::uint32_t const worker =
+                records.empty() ? std::uint32_t(-1) : records.front().worker;
+            if (worker == std::uint32_t(-1)) { return "external-thread"; }
+            return fmt::format("worker-thread#{}", worker);
+        }
+
+        std::string get_description(task_trace_record const& r)
+        {
+            if (r.has_address) { return fmt::format("address {:#x}", r.address); }
+            if (r.description == nullptr) { return "<unknown>"; }
+            return r.description;
+        }
+
+        std::string json_escape(std::string_view s)
+        {
+            std::string escaped;
+            escaped.reserve(s.size());
+            for (char c : s)
+            {
+                switch (c)
+                {
+                case '"': escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n"; break;
+                case '\t': escaped += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        escaped += fmt::format("\\u{:04x}", static_cast<unsigned>(c));
+                    }
+                    else { escaped += c; }
+                }
+            }
+            return escaped;
+        }
+    }    // namespace
+
+    std::vector<task_trace_record> get_task_trace()
+    {
+        std::vector<task_trace_record> records;
+        for (auto& t : collect_task_trace())
+        {
+            records.insert(records.end(), t.begin(), t.end());
+        }
+        return records;
+    }
+
+    void write_task_trace_chrome(std::ostream& os)
+    {
+        auto const tracks = collect_task_trace();
+        auto const track_ids = get_track_ids(tracks);
+
+        os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+        bool first = true;
+        auto write_event = [&](std::string const& event) {
+            os << (first ? "\n" : ",\n") << event;
+            first = false;
+        };
+
+        for (std::size_t i = 0; i < tracks.size(); ++i)
+        {
+            std::uint64_t const tid = track_ids[i];
+            write_event(fmt::format(
+                R"({{"name":"thread_name","ph":"M","pid":0,"tid":{},"args":{{"name":"{}"}}}})",
+                tid, get_track_name(tracks[i])));
+
+            visit_track(tracks[i], [&](trace_item item, task_trace_record const& r) {
+                auto const ts = fmt::format("{}.{:03}", r.timestamp / 1000, r.timestamp % 1000);
+                auto const event = get_task_trace_event_name(r.event);
+                switch (item)
+                {
+                case trace_item::slice_begin:
+                    write_event(fmt::format(R"({{"name":"{}","cat":"pika","ph":"B","ts":{},)"
+                                            R"("pid":0,"tid":{},"args":{{"thread":"{}","begin":"{}"}}}})",
+                        json_escape(get_description(r)), ts, tid, r.thread_id, event));
+                    break;
+                case trace_item::slice_end:
+                    write_event(fmt::format(
+                        R"({{"ph":"E","ts":{},"pid":0,"tid":{},"args":{{"end":"{}"}}}})", ts, tid,
+                        event));
+                    break;
+                case trace_item::instant:
+                    write_event(fmt::format(R"({{"name":"{}","cat":"pika","ph":"i","s":"t",)"
+                                            R"("ts":{},"pid":0,"tid":{},"args":{{"thread":"{}",)"
+                                            R"("parent":"{}","description":"{}"}}}})",
+                        event, ts, tid, r.thread_id, r.parent_id,
+                        json_escape(get_description(r))));
+                    break;
+                }
+            });
+        }
+
+        os << "\n]}\n";
+    }
+
+    namespace {
+        // Just enough of the protobuf wire format to write Perfetto traces
+        struct protobuf_writer
+        {
+            std::string data;
+
+            void varint(std::uint64_t value)
+            {
+                while (value >= 0x80)
+                {
+                    data.push_back(static_cast<char>((value & 0x7f) | 0x80));
+                    value >>= 7;
+                }
+                data.push_back(static_cast<char>(value));
+            }
+
+            void field(std::uint32_t number, std::uint64_t value)
+            {
+                varint(std::uint64_t(number) << 3);
+                varint(value);
+            }
+
+            void field(std::uint32_t number, std::string_view value)
+            {
+                varint((std::uint64_t(number) << 3) | 2);
+                varint(value.size());
+                data.append(value.data(), value.size());
+            }
+        };
+
+        // Field numbers from perfetto/protos/perfetto/trace
+        namespace perfetto {
+            constexpr std::uint32_t trace_packet = 1;
+
+            constexpr std::uint32_t packet_timestamp = 8;
+            constexpr std::uint32_t packet_trusted_packet_sequence_id = 10;
+            constexpr std::uint32_t packet_track_event = 11;
+            constexpr std::uint32_t packet_sequence_flags = 13;
+            constexpr std::uint32_t packet_track_descriptor = 60;
+
+            constexpr std::uint32_t track_descriptor_uuid = 1;
+            constexpr std::uint32_t track_descriptor_name = 2;
+
+            constexpr std::uint32_t track_event_debug_annotations = 4;
+            constexpr std::uint32_t track_event_type = 9;
+            constexpr std::uint32_t track_event_track_uuid = 11;
+            constexpr std::uint32_t track_event_name = 23;
+
+            constexpr std::uint32_t debug_annotation_string_value = 6;
+            constexpr std::uint32_t debug_annotation_pointer_value = 7;
+            constexpr std::uint32_t debug_annotation_name = 10;
+
+            constexpr std::uint64_t type_slice_begin = 1;
+            constexpr std::uint64_t type_slice_end = 2;
+            constexpr std::uint64_t type_instant = 3;
+
+            constexpr std::uint64_t seq_incremental_state_cleared = 1;
+
+            constexpr std::uint64_t sequence_id = 1;
+        }    // namespace perfetto
+
+        std::string pointer_annotation(std::string_view name, void const* value)
+        {
+            protobuf_writer w;
+            w.field(perfetto::debug_annotation_name, name);
+            w.field(perfetto::debug_annotation_pointer_value,
+                static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(value)));
+            return std::move(w.data);
+        }
+
+        std::string string_annotation(std::string_view name, std::string_view value)
+        {
+            protobuf_writer w;
+            w.field(perfetto::debug_annotation_name, name);
+            w.field(perfetto::debug_annotation_string_value, value);
+            return std::move(w.data);
+        }
+    }    // namespace
+
+    void write_task_trace_perfetto(std::ostream& os)
+    {
+        auto const tracks = collect_task_trace();
+        auto const track_ids = get_track_ids(tracks);
+
+        protobuf_writer trace;
+        bool first = true;
+        auto write_packet = [&](protobuf_writer& packet) {
+            packet.field(perfetto::packet_trusted_packet_sequence_id, perfetto::sequence_id);
+            if (first)
+            {
+                packet.field(
+                    perfetto::packet_sequence_flags, perfetto::seq_incremental_state_cleared);
+                first = false;
+            }
+            trace.field(perfetto::trace_packet, packet.data);
+        };
+
+        for (std::size_t i = 0; i < tracks.size(); ++i)
+        {
+            // Track uuids must be non-zero
+            std::uint64_t const uuid = track_ids[i] + 1;
+
+            {
+                protobuf_writer descriptor;
+                descriptor.field(perfetto::track_descriptor_uuid, uuid);
+                descriptor.field(perfetto::track_descriptor_name, get_track_name(tracks[i]));
+
+                protobuf_writer packet;
+                packet.field(perfetto::packet_track_descriptor, descriptor.data);
+                write_packet(packet);
+            }
+
+            visit_track(tracks[i], [&](trace_item item, task_trace_record const& r) {
+                protobuf_writer event;
+                event.field(perfetto::track_event_track_uuid, uuid);
+                switch (item)
+                {
+                case trace_item::slice_begin:
+                    event.field(perfetto::track_event_type, perfetto::type_slice_begin);
+                    event.field(perfetto::track_event_name, get_description(r));
+                    event.field(perfetto::track_event_debug_annotations,
+                        pointer_annotation("thread", r.thread_id));
+                    event.field(perfetto::track_event_debug_annotations,
+                        string_annotation("begin", get_task_trace_event_name(r.event)));
+                    break;
+                case trace_item::slice_end:
+                    event.field(perfetto::track_event_type, perfetto::type_slice_end);
+                    event.field(perfetto::track_event_debug_annotations,
+                        string_annotation("end", get_task_trace_event_name(r.event)));
+                    break;
+                case trace_item::instant:
+                    event.field(perfetto::track_event_type, perfetto::type_instant);
+                    event.field(perfetto::track_event_name, get_task_trace_event_name(r.event));
+                    event.field(perfetto::track_event_debug_annotations,
+                        pointer_annotation("thread", r.thread_id));
+                    event.field(perfetto::track_event_debug_annotations,
+                        pointer_annotation("parent", r.parent_id));
+                    event.field(perfetto::track_event_debug_annotations,
+                        string_annotation("description", get_description(r)));
+                    break;
+                }
+
+                protobuf_writer packet;
+                packet.field(perfetto::packet_timestamp, r.timestamp);
+                packet.field(perfetto::packet_track_event, event.data);
+                write_packet(packet);
+            });
+        }
+
+        os.write(trace.data.data(), static_cast<std::streamsize>(trace.data.size()));
+    }
+}    // namespace pika::threads::detail
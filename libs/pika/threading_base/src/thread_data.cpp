@@ -13,6 +13,7 @@
 #include <pika/modules/errors.hpp>
 #include <pika/modules/logging.hpp>
 #include <pika/thread_support/unlock_guard.hpp>
+#include <pika/threading_base/detail/task_trace.hpp>
 #include <pika/threading_base/scheduler_base.hpp>
 #include <pika/threading_base/thread_data.hpp>
 #if defined(PIKA_HAVE_APEX)
@@ -47,10 +48,12 @@ namespace pika::threads::detail {
       , backtrace_(nullptr)
 #endif
       , priority_(init_data.priority)
+      , deadline_(init_data.deadline)
       , requested_interrupt_(false)
       , enabled_interrupt_(true)
       , ran_exit_funcs_(false)
       , is_stackless_(is_stackless)
+      , trace_started_(false)
       , scheduler_base_(init_data.scheduler_base)
       , last_worker_thread_num_(std::size_t(-1))
       , stacksize_(stacksize)
@@ -78,6 +81,12 @@ namespace pika::threads::detail {
 #if defined(PIKA_HAVE_APEX)
         set_timer_data(init_data.timer_data);
 #endif
+
+        if (is_task_trace_enabled())
+        {
+            record_task_trace_event(
+                task_trace_event::create, this, init_data.parent_id.get(), get_description());
+        }
     }
 
     thread_data::~thread_data()
@@ -183,9 +192,11 @@ namespace pika::threads::detail {
         backtrace_ = nullptr;
 #endif
         priority_ = init_data.priority;
+        deadline_ = init_data.deadline;
         requested_interrupt_ = false;
         enabled_interrupt_ = true;
         ran_exit_funcs_ = false;
+        trace_started_ = false;
         exit_funcs_.clear();
         scheduler_base_ = init_data.scheduler_base;
         last_worker_thread_num_.store(std::size_t(-1), std::memory_order_relaxed);
@@ -216,6 +227,12 @@ namespace pika::threads::detail {
 #if defined(PIKA_HAVE_APEX)
         set_timer_data(init_data.timer_data);
 #endif
+
+        if (is_task_trace_enabled())
+        {
+            record_task_trace_event(
+                task_trace_event::create, this, init_data.parent_id.get(), get_description());
+        }
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,233 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/threading_base/detail/thread_data_cache.hpp>
+#include <pika/threading_base/thread_data.hpp>
+#include <pika/topology/topology.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace pika::threads::detail {
+    namespace {
+        std::mutex& get_cache_mutex()
+        {
+            static std::mutex mtx;
+            return mtx;
+        }
+
+        std::weak_ptr<thread_data_cache>& get_cache_instance()
+        {
+            static std::weak_ptr<thread_data_cache> cache;
+            return cache;
+        }
+
+        std::int64_t now_ns()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+    }    // namespace
+
+    thread_data_cache::thread_data_cache(std::size_t num_domains, parameters const& params)
+      : params_(params)
+      , next_trim_(now_ns() + std::chrono::nanoseconds(params.trim_interval).count())
+    {
+        if (params_.magazine_size == 0) params_.magazine_size = 1;
+
+        domains_.reserve((std::max)(num_domains, std::size_t(1)));
+        for (std::size_t i = 0; i != domains_.capacity(); ++i)
+        {
+            domains_.push_back(std::make_unique<domain>());
+        }
+    }
+
+    thread_data_cache::~thread_data_cache()
+    {
+        for (auto& d : domains_)
+        {
+            for (auto& sc : d->size_classes)
+            {
+                for (auto t : sc.objects) { get_thread_id_data(t)->destroy(); }
+            }
+        }
+    }
+
+    std::shared_ptr<thread_data_cache> thread_data_cache::get(parameters const& params)
+    {
+        std::lock_guard<std::mutex> l(get_cache_mutex());
+
+        auto& instance = get_cache_instance();
+        auto cache = instance.lock();
+        if (!cache)
+        {
+            cache = std::make_shared<thread_data_cache>(
+                get_topology().get_number_of_numa_nodes(), params);
+            instance = cache;
+        }
+        return cache;
+    }
+
+    thread_data_cache_statistics thread_data_cache::get_statistics(bool reset)
+    {
+        std::shared_ptr<thread_data_cache> cache;
+        {
+            std::lock_guard<std::mutex> l(get_cache_mutex());
+            cache = get_cache_instance().lock();
+        }
+        return cache ? cache->statistics(reset) : thread_data_cache_statistics{};
+    }
+
+    thread_data_cache::size_class& thread_data_cache::get_size_class(
+        domain& d, std::ptrdiff_t stacksize)
+    {
+        // There are only a handful of stack sizes
+        auto it = std::find_if(d.size_classes.begin(), d.size_classes.end(),
+            [&](size_class const& sc) { return sc.stacksize == stacksize; });
+        if (it != d.size_classes.end()) return *it;
+
+        d.size_classes.push_back(size_class{stacksize, {}, 0, 0});
+        return d.size_classes.back();
+    }
+
+    std::size_t thread_data_cache::take(
+        std::size_t domain, std::ptrdiff_t stacksize, thread_id_type* objects, std::size_t count)
+    {
+        auto& d = *domains_[domain % domains_.size()];
+
+        std::lock_guard<pika::detail::spinlock> l(d.mtx);
+        size_class& sc = get_size_class(d, stacksize);
+
+        std::size_t const n = (std::min)(count, sc.objects.size());
+        std::copy(sc.objects.end() - n, sc.objects.end(), objects);
+        sc.objects.resize(sc.objects.size() - n);
+
+        sc.trimmed = (std::min)(sc.trimmed, sc.objects.size());
+        sc.low_water = (std::min)(sc.low_water, sc.objects.size());
+
+        return n;
+    }
+
+    void thread_data_cache::give(std::size_t domain, std::ptrdiff_t stacksize,
+        thread_id_type const* objects, std::size_t count)
+    {
+        auto& d = *domains_[domain % domains_.size()];
+
+        std::size_t accepted = 0;
+        {
+            std::lock_guard<pika::detail::spinlock> l(d.mtx);
+            size_class& sc = get_size_class(d, stacksize);
+
+            if (sc.objects.size() < params_.high_water_mark)
+            {
+                accepted = (std::min)(count, params_.high_water_mark - sc.objects.size());
+            }
+            sc.objects.insert(sc.objects.end(), objects, objects + accepted);
+        }
+
+        // Destroy the objects which did not fit without holding the lock, this
+        // unmaps their stacks
+        if (accepted != count)
+        {
+            for (std::size_t i = accepted; i != count; ++i)
+            {
+                get_thread_id_data(objects[i])->destroy();
+            }
+            d.released.fetch_add(count - accepted, std::memory_order_relaxed);
+        }
+    }
+
+    void thread_data_cache::trim_if_due()
+    {
+        if (params_.trim_interval.count() == 0) return;
+
+        std::int64_t const now = now_ns();
+        std::int64_t next = next_trim_.load(std::memory_order_relaxed);
+        if (now < next) return;
+
+        // Only one thread trims per interval
+        if (!next_trim_.compare_exchange_strong(next,
+                now + std::chrono::nanoseconds(params_.trim_interval).count(),
+                std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        trim();
+    }
+
+    void thread_data_cache::trim()
+    {
+        std::vector<thread_id_type> idle;
+        for (auto& dp : domains_)
+        {
+            auto& d = *dp;
+
+            std::unique_lock<pika::detail::spinlock> l(d.mtx);
+            for (std::size_t i = 0; i != d.size_classes.size(); ++i)
+            {
+                size_class& sc = d.size_classes[i];
+                PIKA_ASSERT(sc.trimmed <= sc.low_water && sc.low_water <= sc.objects.size());
+
+                // Objects between the trimmed ones and the low-water mark have
+                // not been touched since the previous trim. They are taken out
+                // of the depot while their stacks are released so that they
+                // can not be handed out in the meantime.
+                auto const first = sc.objects.begin() + sc.trimmed;
+                auto const last = sc.objects.begin() + sc.low_water;
+                if (first == last)
+                {
+                    sc.low_water = sc.objects.size();
+                    continue;
+                }
+
+                idle.assign(first, last);
+                sc.objects.erase(first, last);
+                std::ptrdiff_t const stacksize = sc.stacksize;
+
+                l.unlock();
+                for (auto t : idle) { get_thread_id_data(t)->trim_stack(); }
+                l.lock();
+
+                // The size classes may have been modified while unlocked
+                size_class& current = get_size_class(d, stacksize);
+                current.objects.insert(
+                    current.objects.begin() + current.trimmed, idle.begin(), idle.end());
+                current.trimmed += idle.size();
+                current.low_water = current.objects.size();
+
+                d.trimmed.fetch_add(idle.size(), std::memory_order_relaxed);
+            }
+        }
+    }
+
+    thread_data_cache_statistics thread_data_cache::statistics(bool reset)
+    {
+        auto get = [reset](std::atomic<std::uint64_t>& value) {
+            return reset ? value.exchange(0, std::memory_order_relaxed) :
+                           value.load(std::memory_order_relaxed);
+        };
+
+        thread_data_cache_statistics result;
+        for (auto& d : domains_)
+        {
+            result.hits += get(d->hits);
+            result.misses += get(d->misses);
+            result.trimmed += get(d->trimmed);
+            result.released += get(d->released);
+        }
+        return result;
+    }
+}    // namespace pika::threads::detail
@@ -51,14 +51,20 @@ namespace pika::threads::detail {
     }
 
     ///////////////////////////////////////////////////////////////////////////
-    thread_id_ref_type set_thread_state(thread_id_type const& id,
-        pika::chrono::steady_time_point const& abs_time, std::atomic<bool>* timer_started,
-        thread_schedule_state state, thread_restart_state stateex,
-        execution::thread_priority priority, bool retry_on_active, error_code& ec)
+    void set_thread_state(thread_state_timer& timer, thread_id_type const& id,
+        pika::chrono::steady_time_point const& abs_time, thread_schedule_state state,
+        thread_restart_state stateex, execution::thread_priority priority, bool retry_on_active,
+        error_code& ec)
     {
-        return set_thread_state_timed(get_thread_id_data(id)->get_scheduler_base(), abs_time, id,
-            state, stateex, priority, execution::thread_schedule_hint(), timer_started,
-            retry_on_active, ec);
+        if (PIKA_UNLIKELY(!id))
+        {
+            PIKA_THROWS_IF(ec, pika::error::null_thread_id, "threads::detail::set_thread_state",
+                "null thread id encountered");
+            return;
+        }
+
+        set_thread_state_timed(get_thread_id_data(id)->get_scheduler_base(), timer, abs_time, id,
+            state, stateex, priority, execution::thread_schedule_hint(), retry_on_active, ec);
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -301,6 +307,44 @@ namespace pika::threads::detail {
 
 namespace pika::this_thread {
 
+    namespace {
+        // Stackless threads run on the stack of the worker thread and can't
+        // be suspended. Yielding and sleeping are done through the current
+        // execution agent instead, which blocks the worker thread like a
+        // plain OS thread. Waiting to be resumed by another thread is not
+        // possible without suspending.
+        threads::detail::thread_restart_state suspend_stackless(
+            threads::detail::thread_schedule_state state, threads::detail::thread_id_type nextid,
+            pika::chrono::steady_time_point const* abs_time, error_code& ec)
+        {
+            // the thread to run next is scheduled normally instead
+            if (nextid)
+            {
+                auto* scheduler = get_thread_id_data(nextid)->get_scheduler_base();
+                scheduler->schedule_thread(PIKA_MOVE(nextid), execution::thread_schedule_hint());
+            }
+
+            if (abs_time != nullptr)
+            {
+                pika::execution::this_thread::detail::sleep_until(
+                    abs_time->value(), "this_thread::suspend");
+                if (&ec != &throws) ec = make_success_code();
+                return threads::detail::thread_restart_state::timeout;
+            }
+
+            if (state == threads::detail::thread_schedule_state::suspended)
+            {
+                PIKA_THROWS_IF(ec, pika::error::invalid_status, "this_thread::suspend",
+                    "stackless threads can not be suspended, only yield and sleep are supported");
+                return threads::detail::thread_restart_state::unknown;
+            }
+
+            pika::execution::this_thread::detail::yield("this_thread::suspend");
+            if (&ec != &throws) ec = make_success_code();
+            return threads::detail::thread_restart_state::signaled;
+        }
+    }    // namespace
+
     /// The function \a suspend will return control to the thread manager
     /// (suspends the current thread). It sets the new state of this thread
     /// to the thread state passed as the parameter.
@@ -321,6 +365,11 @@ namespace pika::this_thread {
         threads::detail::interruption_point(id.noref(), ec);
         if (ec) return threads::detail::thread_restart_state::unknown;
 
+        if (get_thread_id_data(id)->is_stackless())
+        {
+            return suspend_stackless(state, PIKA_MOVE(nextid), nullptr, ec);
+        }
+
         threads::detail::thread_restart_state statex =
             threads::detail::thread_restart_state::unknown;
 
@@ -385,6 +434,12 @@ namespace pika::this_thread {
         threads::detail::interruption_point(id.noref(), ec);
         if (ec) return threads::detail::thread_restart_state::unknown;
 
+        if (get_thread_id_data(id)->is_stackless())
+        {
+            return suspend_stackless(threads::detail::thread_schedule_state::suspended,
+                PIKA_MOVE(nextid), &abs_time, ec);
+        }
+
         // let the thread manager do other things while waiting
         threads::detail::thread_restart_state statex =
             threads::detail::thread_restart_state::unknown;
@@ -402,12 +457,13 @@ namespace pika::this_thread {
 #ifdef PIKA_HAVE_THREAD_BACKTRACE_ON_SUSPENSION
             threads::detail::reset_backtrace bt(id, ec);
 #endif
-            std::atomic<bool> timer_started(false);
-            threads::detail::thread_id_ref_type timer_id =
-                threads::detail::set_thread_state(id.noref(), abs_time, &timer_started,
-                    threads::detail::thread_schedule_state::pending,
-                    threads::detail::thread_restart_state::timeout,
-                    execution::thread_priority::boost, true, ec);
+            // the timer lives on the stack of this thread, it is either
+            // expired or cancelled before we return
+            threads::detail::thread_state_timer timer;
+            threads::detail::set_thread_state(timer, id.noref(), abs_time,
+                threads::detail::thread_schedule_state::pending,
+                threads::detail::thread_restart_state::timeout, execution::thread_priority::boost,
+                true, ec);
             if (ec) return threads::detail::thread_restart_state::unknown;
 
             // We might need to dispatch 'nextid' to it's correct scheduler
@@ -432,13 +488,7 @@ namespace pika::this_thread {
             {
                 PIKA_ASSERT(statex == threads::detail::thread_restart_state::abort ||
                     statex == threads::detail::thread_restart_state::signaled);
-                error_code ec1(throwmode::lightweight);    // do not throw
-                pika::util::yield_while(
-                    [&timer_started]() { return !timer_started.load(); }, "set_thread_state_timed");
-                threads::detail::set_thread_state(timer_id.noref(),
-                    threads::detail::thread_schedule_state::pending,
-                    threads::detail::thread_restart_state::abort, execution::thread_priority::boost,
-                    true, ec1);
+                threads::detail::cancel_thread_state_timed(timer);
             }
         }
 
@@ -0,0 +1,306 @@
+//  Copyright (c) 2023 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/execution_base/this_thread.hpp>
+#include <pika/threading_base/detail/timer_wheel.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace pika::threads::detail {
+    namespace {
+        constexpr std::uint64_t slot_mask = timer_wheel::num_slots - 1;
+
+        // Number of ticks covered by one slot of the given level
+        constexpr std::uint64_t level_granularity(std::size_t level) noexcept
+        {
+            return std::uint64_t(1) << (level * timer_wheel::slot_bits);
+        }
+
+        // Deadlines further out than this are parked in the last level and
+        // re-inserted when that slot is cascaded
+        constexpr std::uint64_t max_delta = level_granularity(timer_wheel::num_levels) - 1;
+
+        inline std::size_t count_trailing_zeros(std::uint64_t v) noexcept
+        {
+            PIKA_ASSERT(v != 0);
+#if defined(__GNUC__)
+            return static_cast<std::size_t>(__builtin_ctzll(v));
+#else
+            std::size_t n = 0;
+            while ((v & 1) == 0)
+            {
+                v >>= 1;
+                ++n;
+            }
+            return n;
+#endif
+        }
+
+        // Round t up to the next multiple of the given level's granularity
+        constexpr std::uint64_t round_up(std::uint64_t t, std::size_t level) noexcept
+        {
+            std::uint64_t const g = level_granularity(level);
+            return (t + g - 1) & ~(g - 1);
+        }
+    }    // namespace
+
+    timer_wheel::timer_wheel(std::chrono::nanoseconds resolution)
+      : epoch_(clock_type::now())
+      , resolution_((std::max)(resolution.count(), std::chrono::nanoseconds::rep(1)))
+      , current_tick_(0)
+      , next_event_tick_(std::uint64_t(-1))
+      , size_(0)
+      , started_batches_(0)
+      , finished_batches_(0)
+      , occupied_{}
+      , slots_{}
+    {
+    }
+
+    std::uint64_t timer_wheel::to_ticks(clock_type::time_point t, bool round_up) const noexcept
+    {
+        if (t <= epoch_) return 0;
+
+        auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t - epoch_).count();
+        auto ticks = static_cast<std::uint64_t>(ns / resolution_);
+        if (round_up && ns % resolution_ != 0) ++ticks;
+        return ticks;
+    }
+
+    bool timer_wheel::schedule(timer_wheel_entry& entry, clock_type::time_point abs_time)
+    {
+        PIKA_ASSERT(entry.slot_ == timer_wheel_entry::unarmed ||
+            entry.slot_ == timer_wheel_entry::expiring);
+
+        // The deadline is rounded up so that an entry never expires early
+        entry.expiry_ = to_ticks(abs_time, true);
+
+        std::lock_guard<mutex_type> l(mtx_);
+
+        insert(entry);
+        size_.fetch_add(1, std::memory_order_relaxed);
+
+        std::uint64_t const next_event = next_event_tick();
+        bool const earliest = next_event < next_event_tick_.load(std::memory_order_relaxed);
+        next_event_tick_.store(next_event, std::memory_order_relaxed);
+        return earliest;
+    }
+
+    bool timer_wheel::cancel(timer_wheel_entry& entry)
+    {
+        std::uint64_t batch = 0;
+        {
+            std::lock_guard<mutex_type> l(mtx_);
+
+            if (entry.slot_ == timer_wheel_entry::unarmed) return false;
+            if (entry.slot_ != timer_wheel_entry::expiring)
+            {
+                unlink(entry);
+                size_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            batch = entry.batch_;
+        }
+
+        // The entry has expired, but its callback may still be running. The
+        // entry itself may not be touched by the wheel anymore once the
+        // callback has been invoked, so wait for the whole batch instead.
+        pika::util::yield_while(
+            [&]() { return finished_batches_.load(std::memory_order_acquire) < batch; },
+            "timer_wheel::cancel");
+        entry.slot_ = timer_wheel_entry::unarmed;
+        return false;
+    }
+
+    std::size_t timer_wheel::advance(clock_type::time_point now)
+    {
+        std::uint64_t const now_tick = to_ticks(now, false);
+        if (now_tick < next_event_tick_.load(std::memory_order_relaxed)) return 0;
+
+        // Only one thread has to do the work, everyone else can continue
+        // executing tasks
+        std::unique_lock<mutex_type> l(mtx_, std::try_to_lock);
+        if (!l.owns_lock()) return 0;
+
+        // The callbacks of the previous batch are still running
+        if (finished_batches_.load(std::memory_order_relaxed) != started_batches_) return 0;
+
+        timer_wheel_entry* expired = nullptr;
+        timer_wheel_entry* expired_tail = nullptr;
+        std::size_t const size_before = size_.load(std::memory_order_relaxed);
+        while (current_tick_ <= now_tick)
+        {
+            if (size_.load(std::memory_order_relaxed) == 0)
+            {
+                current_tick_ = now_tick + 1;
+                break;
+            }
+
+            if ((current_tick_ & slot_mask) == 0) { cascade(); }
+            expire_current_slot(expired, expired_tail);
+            ++current_tick_;
+
+            // Skip ticks at which nothing can expire or cascade
+            current_tick_ = (std::min)(next_event_tick(), now_tick + 1);
+        }
+
+        next_event_tick_.store(next_event_tick(), std::memory_order_relaxed);
+        std::size_t const num_expired = size_before - size_.load(std::memory_order_relaxed);
+        if (expired == nullptr) return num_expired;
+
+        std::uint64_t const batch = started_batches_;
+        l.unlock();
+
+        // The callbacks are invoked without holding the lock. The next
+        // entry has to be read before invoking the callback as the entry may
+        // be reused or destroyed as soon as the callback has started.
+        while (expired != nullptr)
+        {
+            timer_wheel_entry* next = expired->next_;
+            expired->on_expire_(*expired);
+            expired = next;
+        }
+
+        finished_batches_.store(batch, std::memory_order_release);
+        return num_expired;
+    }
+
+    timer_wheel::clock_type::time_point timer_wheel::next_expiry() const noexcept
+    {
+        std::uint64_t const next_event = next_event_tick_.load(std::memory_order_relaxed);
+        if (next_event == std::uint64_t(-1)) return clock_type::time_point::max();
+
+        return epoch_ +
+            std::chrono::duration_cast<clock_type::duration>(
+                std::chrono::nanoseconds(static_cast<std::int64_t>(next_event) * resolution_));
+    }
+
+    void timer_wheel::insert(timer_wheel_entry& entry) noexcept
+    {
+        // Entries with a deadline in the past expire at the next tick
+        std::uint64_t expiry = (std::max)(entry.expiry_, current_tick_);
+        std::uint64_t const delta = expiry - current_tick_;
+
+        std::size_t level = 0;
+        if (delta > max_delta)
+        {
+            level = num_levels - 1;
+            expiry = current_tick_ + max_delta;
+        }
+        else
+        {
+            while (delta >= level_granularity(level + 1)) { ++level; }
+        }
+
+        std::size_t const slot = (expiry >> (level * slot_bits)) & slot_mask;
+
+        timer_wheel_entry*& head = slots_[level][slot];
+        entry.prev_ = nullptr;
+        entry.next_ = head;
+        if (head != nullptr) { head->prev_ = &entry; }
+        head = &entry;
+
+        entry.slot_ = static_cast<std::uint32_t>(level * num_slots + slot);
+        occupied_[level] |= std::uint64_t(1) << slot;
+    }
+
+    void timer_wheel::unlink(timer_wheel_entry& entry) noexcept
+    {
+        std::size_t const level = entry.slot_ / num_slots;
+        std::size_t const slot = entry.slot_ % num_slots;
+
+        if (entry.prev_ != nullptr) { entry.prev_->next_ = entry.next_; }
+        else { slots_[level][slot] = entry.next_; }
+        if (entry.next_ != nullptr) { entry.next_->prev_ = entry.prev_; }
+
+        if (slots_[level][slot] == nullptr) { occupied_[level] &= ~(std::uint64_t(1) << slot); }
+
+        entry.prev_ = nullptr;
+        entry.next_ = nullptr;
+        entry.slot_ = timer_wheel_entry::unarmed;
+    }
+
+    // Move the entries of the slots that have come into range of the lower
+    // levels down. This is called whenever the first level wraps around.
+    void timer_wheel::cascade() noexcept
+    {
+        for (std::size_t level = 1; level != num_levels; ++level)
+        {
+            std::size_t const slot = (current_tick_ >> (level * slot_bits)) & slot_mask;
+
+            timer_wheel_entry* entry = slots_[level][slot];
+            slots_[level][slot] = nullptr;
+            occupied_[level] &= ~(std::uint64_t(1) << slot);
+
+            while (entry != nullptr)
+            {
+                timer_wheel_entry* next = entry->next_;
+                insert(*entry);
+                entry = next;
+            }
+
+            // Higher levels only need to be cascaded when this level wraps
+            // around as well
+            if (slot != 0) break;
+        }
+    }
+
+    // Move the entries of the current slot to the list of expired entries.
+    // The callbacks are invoked by advance once the wheel has been unlocked.
+    void timer_wheel::expire_current_slot(
+        timer_wheel_entry*& expired_head, timer_wheel_entry*& expired_tail) noexcept
+    {
+        std::size_t const slot = current_tick_ & slot_mask;
+        if (slots_[0][slot] != nullptr && expired_head == nullptr) { ++started_batches_; }
+
+        while (timer_wheel_entry* entry = slots_[0][slot])
+        {
+            PIKA_ASSERT(entry->expiry_ <= current_tick_);
+
+            unlink(*entry);
+            size_.fetch_sub(1, std::memory_order_relaxed);
+
+            entry->slot_ = timer_wheel_entry::expiring;
+            entry->batch_ = started_batches_;
+            if (expired_tail != nullptr) { expired_tail->next_ = entry; }
+            else { expired_head = entry; }
+            expired_tail = entry;
+        }
+    }
+
+    // Returns the next tick at which an entry may expire or has to be
+    // cascaded to a lower level.
+    std::uint64_t timer_wheel::next_event_tick() const noexcept
+    {
+        std::uint64_t const current_slot = current_tick_ & slot_mask;
+        if (occupied_[0] != 0)
+        {
+            // Entries in the current rotation of the first level
+            std::uint64_t const upcoming = occupied_[0] & (~std::uint64_t(0) << current_slot);
+            if (upcoming != 0)
+            {
+                return current_tick_ - current_slot + count_trailing_zeros(upcoming);
+            }
+
+            // Entries in the next rotation
+            return round_up(current_tick_, 1);
+        }
+
+        for (std::size_t level = 1; level != num_levels; ++level)
+        {
+            if (occupied_[level] != 0) { return round_up(current_tick_, level); }
+        }
+
+        return std::uint64_t(-1);
+    }
+}    // namespace pika::threads::detail
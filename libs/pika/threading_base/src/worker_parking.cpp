@@ -0,0 +1,173 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/threading_base/detail/worker_parking.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__linux__)
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <time.h>
+# include <unistd.h>
+#else
+# include <condition_variable>
+# include <mutex>
+#endif
+
+namespace pika::threads::detail {
+#if defined(__linux__)
+    namespace {
+        static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t),
+            "the futex word must be a plain 32-bit integer");
+
+        std::uint32_t* futex_address(std::atomic<std::uint32_t>& state) noexcept
+        {
+            return reinterpret_cast<std::uint32_t*>(&state);
+        }
+    }    // namespace
+#endif
+
+    worker_parking::worker_parking(std::size_t num_threads)
+      : slots_(num_threads)
+    {
+    }
+
+    bool worker_parking::begin_park(std::size_t num_thread)
+    {
+        PIKA_ASSERT(num_thread < slots_.size());
+        slot& s = slots_[num_thread].data_;
+
+        // Consume a wakeup which arrived while the worker thread was running
+        std::uint32_t expected = running;
+        if (!s.state.compare_exchange_strong(expected, parked, std::memory_order_seq_cst))
+        {
+            PIKA_ASSERT(expected == notified);
+            s.state.store(running, std::memory_order_relaxed);
+            return false;
+        }
+
+        num_parked_.fetch_add(1, std::memory_order_relaxed);
+
+        // Pairs with the fence in unpark_one: either the caller of
+        // unpark_one sees this worker thread as parked, or has_work sees the
+        // work added before the call to unpark_one
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return true;
+    }
+
+    void worker_parking::wait(std::size_t num_thread, std::chrono::milliseconds timeout)
+    {
+        slot& s = slots_[num_thread].data_;
+
+        auto const deadline = std::chrono::steady_clock::now() + timeout;
+#if defined(__linux__)
+        while (s.state.load(std::memory_order_acquire) == parked)
+        {
+            auto const now = std::chrono::steady_clock::now();
+            if (now >= deadline) { break; }
+
+            auto const ns =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+            timespec ts;
+            ts.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+            ts.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+
+            // Returns immediately if the state is not parked anymore
+            syscall(SYS_futex, futex_address(s.state), FUTEX_WAIT_PRIVATE, parked, &ts, nullptr, 0);
+        }
+#else
+        std::unique_lock<std::mutex> l(s.mtx);
+        s.cond.wait_until(
+            l, deadline, [&] { return s.state.load(std::memory_order_acquire) != parked; });
+#endif
+    }
+
+    bool worker_parking::end_park(std::size_t num_thread)
+    {
+        slot& s = slots_[num_thread].data_;
+
+        num_parked_.fetch_sub(1, std::memory_order_relaxed);
+
+        // The worker thread was woken up if the state has been changed by
+        // try_unpark or unpark_all, otherwise the timeout expired
+        return s.state.exchange(running, std::memory_order_acq_rel) == notified;
+    }
+
+    bool worker_parking::unpark_one(std::size_t num_thread)
+    {
+        // Pairs with the fence in begin_park, the work added by the caller
+        // has to be visible before checking for parked worker threads
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (num_parked_.load(std::memory_order_relaxed) == 0) { return false; }
+
+        std::size_t const num_threads = slots_.size();
+        if (num_thread == std::size_t(-1))
+        {
+            num_thread = next_.fetch_add(1, std::memory_order_relaxed) % num_threads;
+        }
+        else { num_thread %= num_threads; }
+
+        if (try_unpark(num_thread)) { return true; }
+
+        // Look for the closest parked worker thread on either side
+        for (std::size_t i = 1; i <= num_threads / 2; ++i)
+        {
+            if (try_unpark((num_thread + i) % num_threads) ||
+                try_unpark((num_thread + num_threads - i) % num_threads))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void worker_parking::unpark_all()
+    {
+        for (auto& s : slots_)
+        {
+            if (s.data_.state.exchange(notified, std::memory_order_acq_rel) == parked)
+            {
+                wake(s.data_);
+            }
+        }
+    }
+
+    bool worker_parking::try_unpark(std::size_t num_thread)
+    {
+        slot& s = slots_[num_thread].data_;
+
+        std::uint32_t expected = parked;
+        if (s.state.load(std::memory_order_relaxed) != parked ||
+            !s.state.compare_exchange_strong(expected, notified, std::memory_order_acq_rel))
+        {
+            return false;
+        }
+
+        wake(s);
+        return true;
+    }
+
+    void worker_parking::wake(slot& s)
+    {
+#if defined(__linux__)
+        syscall(SYS_futex, futex_address(s.state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+        // Taking the lock makes sure that the worker thread is either not
+        // waiting yet, and will see the new state, or is already waiting
+        {
+            std::lock_guard<std::mutex> l(s.mtx);
+        }
+        s.cond.notify_one();
+#endif
+    }
+}    // namespace pika::threads::detail
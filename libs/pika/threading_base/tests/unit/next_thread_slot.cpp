@@ -0,0 +1,160 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This test checks that with scheduler_mode::enable_next_thread_slot a thread
+// which is woken up runs before the threads which are already queued, and that
+// threads waking each other up can not starve the queued threads.
+
+#include <pika/condition_variable.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/mutex.hpp>
+#include <pika/runtime.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+
+// Yield until pred returns true. All threads run on the same worker thread,
+// so no synchronization is needed beyond the mutex used by the condition
+// variables.
+template <typename F>
+void yield_until(F&& f)
+{
+    while (!f()) { pika::this_thread::yield(); }
+}
+
+void test_woken_thread_runs_first()
+{
+    constexpr std::size_t num_queued = 3;
+
+    pika::mutex mtx;
+    pika::condition_variable cond_queued;
+    pika::condition_variable cond_woken;
+    bool notified_queued = false;
+    bool notified_woken = false;
+    std::size_t waiting = 0;
+    std::vector<std::string> order;
+
+    for (std::size_t i = 0; i < num_queued; ++i)
+    {
+        ex::execute(ex::thread_pool_scheduler{}, [&] {
+            std::unique_lock l{mtx};
+            ++waiting;
+            cond_queued.wait(l, [&] { return notified_queued; });
+            order.emplace_back("queued");
+        });
+    }
+
+    ex::execute(ex::thread_pool_scheduler{}, [&] {
+        std::unique_lock l{mtx};
+        ++waiting;
+        cond_woken.wait(l, [&] { return notified_woken; });
+        order.emplace_back("woken");
+    });
+
+    yield_until([&] { return waiting == num_queued + 1; });
+
+    {
+        std::unique_lock l{mtx};
+
+        // The queued threads are resumed first, and end up in the queue when
+        // the last thread is resumed
+        notified_queued = true;
+        cond_queued.notify_all();
+        notified_woken = true;
+        cond_woken.notify_one();
+    }
+
+    yield_until([&] { return order.size() == num_queued + 1; });
+
+    PIKA_TEST_EQ(order.front(), std::string("woken"));
+}
+
+void test_no_starvation()
+{
+    constexpr std::size_t max_exchanges = 10000;
+
+    pika::mutex mtx;
+    pika::condition_variable cond_ping_pong[2];
+    pika::condition_variable cond_queued;
+    int turn = -1;
+    bool notified_queued = false;
+    bool stop = false;
+    std::size_t waiting = 0;
+    std::size_t finished = 0;
+    std::size_t exchanges = 0;
+    std::size_t exchanges_before_queued = max_exchanges;
+
+    // Two threads which keep waking each other up
+    for (int i = 0; i < 2; ++i)
+    {
+        ex::execute(ex::thread_pool_scheduler{}, [&, i] {
+            std::unique_lock l{mtx};
+            ++waiting;
+            while (true)
+            {
+                cond_ping_pong[i].wait(l, [&] { return turn == i; });
+                turn = 1 - i;
+                cond_ping_pong[1 - i].notify_one();
+
+                if (stop || exchanges == max_exchanges) { break; }
+                ++exchanges;
+            }
+            ++finished;
+        });
+    }
+
+    ex::execute(ex::thread_pool_scheduler{}, [&] {
+        std::unique_lock l{mtx};
+        ++waiting;
+        cond_queued.wait(l, [&] { return notified_queued; });
+        exchanges_before_queued = exchanges;
+        stop = true;
+        ++finished;
+    });
+
+    yield_until([&] { return waiting == 3; });
+
+    {
+        std::unique_lock l{mtx};
+        notified_queued = true;
+        cond_queued.notify_one();
+        turn = 0;
+        cond_ping_pong[0].notify_one();
+    }
+
+    yield_until([&] { return finished == 3; });
+
+    PIKA_TEST_LT(exchanges_before_queued, max_exchanges);
+}
+
+int pika_main()
+{
+    pika::threads::add_scheduler_mode(pika::threads::scheduler_mode::enable_next_thread_slot);
+
+    test_woken_thread_runs_first();
+    test_no_starvation();
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    pika::init_params init_args;
+    init_args.cfg = {"pika.os_threads=1"};
+
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv, init_args), 0);
+
+    return pika::detail::report_errors();
+}
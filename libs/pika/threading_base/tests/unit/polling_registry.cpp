@@ -0,0 +1,133 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/init.hpp>
+#include <pika/modules/resource_partitioner.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+#include <pika/threading_base/detail/polling_registry.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+
+using pika::threads::detail::polling_registry;
+using pika::threads::detail::polling_source;
+using pika::threads::detail::polling_status;
+
+void test_add_remove()
+{
+    polling_registry registry(2);
+    PIKA_TEST_EQ(registry.size(), std::size_t(0));
+    PIKA_TEST(registry.poll(0) == polling_status::idle);
+    PIKA_TEST_EQ(registry.work_count(), std::size_t(0));
+
+    std::size_t a_polls = 0;
+    std::size_t b_polls = 0;
+    registry.add("a", {[&]() {
+        ++a_polls;
+        return polling_status::busy;
+    },
+                          []() { return std::size_t(3); }});
+    registry.add("b", {[&]() {
+        ++b_polls;
+        return polling_status::idle;
+    },
+                          {}});
+    PIKA_TEST_EQ(registry.size(), std::size_t(2));
+    PIKA_TEST_EQ(registry.work_count(), std::size_t(3));
+
+    PIKA_TEST(registry.poll(0) == polling_status::busy);
+    PIKA_TEST(registry.poll(1) == polling_status::busy);
+    PIKA_TEST_EQ(a_polls, std::size_t(2));
+    PIKA_TEST_EQ(b_polls, std::size_t(2));
+
+    // Adding a source with an existing name replaces it
+    std::size_t c_polls = 0;
+    registry.add("a", {[&]() {
+        ++c_polls;
+        return polling_status::idle;
+    },
+                          {}});
+    PIKA_TEST_EQ(registry.size(), std::size_t(2));
+    PIKA_TEST_EQ(registry.work_count(), std::size_t(0));
+    PIKA_TEST(registry.poll(0) == polling_status::idle);
+    PIKA_TEST_EQ(a_polls, std::size_t(2));
+    PIKA_TEST_EQ(c_polls, std::size_t(1));
+
+    PIKA_TEST(registry.remove("a"));
+    PIKA_TEST(!registry.remove("a"));
+    PIKA_TEST_EQ(registry.size(), std::size_t(1));
+    registry.poll(1);
+    PIKA_TEST_EQ(c_polls, std::size_t(1));
+    PIKA_TEST_EQ(b_polls, std::size_t(4));
+
+    PIKA_TEST(registry.remove("b"));
+    PIKA_TEST_EQ(registry.size(), std::size_t(0));
+    PIKA_TEST(registry.poll(0) == polling_status::idle);
+    PIKA_TEST_EQ(b_polls, std::size_t(4));
+}
+
+void test_frequency()
+{
+    polling_registry registry(1);
+
+    std::size_t every_polls = 0;
+    std::size_t fourth_polls = 0;
+    registry.add("every", {[&]() {
+        ++every_polls;
+        return polling_status::idle;
+    },
+                              {}, 1});
+    registry.add("fourth", {[&]() {
+        ++fourth_polls;
+        return polling_status::idle;
+    },
+                               {}, 4});
+
+    for (std::size_t i = 0; i != 16; ++i) { registry.poll(0); }
+
+    PIKA_TEST_EQ(every_polls, std::size_t(16));
+    PIKA_TEST_EQ(fourth_polls, std::size_t(4));
+}
+
+// A source registered with the default pool is polled by its worker threads
+// and keeps the pool busy while it reports outstanding work
+int pika_main()
+{
+    auto* sched = pika::resource::get_thread_pool("default").get_scheduler();
+    PIKA_TEST(sched != nullptr);
+
+    auto remaining = std::make_shared<std::atomic<std::size_t>>(100);
+    sched->add_polling_source("test", {[remaining]() {
+        std::size_t r = remaining->load();
+        while (r != 0 && !remaining->compare_exchange_weak(r, r - 1)) {}
+        return r > 1 ? polling_status::busy : polling_status::idle;
+    },
+                                          [remaining]() { return remaining->load(); }});
+
+    while (remaining->load() != 0) { pika::this_thread::yield(); }
+    PIKA_TEST_EQ(sched->get_polling_work_count(), std::size_t(0));
+
+    PIKA_TEST(sched->remove_polling_source("test"));
+    PIKA_TEST(!sched->remove_polling_source("test"));
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    test_add_remove();
+    test_frequency();
+
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv), 0);
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This test checks that the task trace records the life cycle of pika threads
+// and that it can be written in the Chrome and Perfetto formats.
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/latch.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+#include <pika/threading_base/detail/task_trace.hpp>
+#include <pika/threading_base/thread_data.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+using pika::threads::detail::task_trace_event;
+using pika::threads::detail::task_trace_record;
+
+char const* const trace_file = "task_trace_test.json";
+
+// Returns the id of the traced thread
+void const* run_traced_thread()
+{
+    void const* id = nullptr;
+    pika::latch done(2);
+    ex::execute(ex::with_annotation(ex::thread_pool_scheduler{}, "traced"), [&] {
+        id = pika::threads::detail::get_self_id_data();
+        pika::this_thread::yield();
+        done.count_down(1);
+    });
+    done.arrive_and_wait();
+    return id;
+}
+
+void test_events()
+{
+    pika::threads::detail::enable_task_trace(1024);
+    void const* id = run_traced_thread();
+    pika::threads::detail::disable_task_trace();
+
+    auto const records = pika::threads::detail::get_task_trace();
+
+    auto create = records.begin();
+    while (create != records.end() &&
+        !(create->event == task_trace_event::create && create->thread_id == id))
+    {
+        ++create;
+    }
+    PIKA_TEST(create != records.end());
+    if (create == records.end()) { return; }
+    PIKA_TEST_EQ(create->parent_id,
+        static_cast<void const*>(pika::threads::detail::get_self_id_data()));
+    PIKA_TEST_EQ(create->worker, std::uint32_t(0));
+#if defined(PIKA_HAVE_THREAD_DESCRIPTION)
+    PIKA_TEST(!create->has_address);
+    PIKA_TEST_EQ(std::string(create->description), std::string("traced"));
+#endif
+
+    // The traced thread runs twice as it yields once
+    std::vector<task_trace_event> expected{task_trace_event::start, task_trace_event::suspend,
+        task_trace_event::resume, task_trace_event::terminate};
+    std::vector<task_trace_event> events;
+    std::uint64_t timestamp = create->timestamp;
+    for (auto it = std::next(create); it != records.end(); ++it)
+    {
+        if (it->thread_id != create->thread_id) { continue; }
+        PIKA_TEST_LTE(timestamp, it->timestamp);
+        timestamp = it->timestamp;
+        events.push_back(it->event);
+        if (it->event == task_trace_event::terminate) { break; }
+    }
+    PIKA_TEST(events == expected);
+}
+
+void test_overwrite()
+{
+    constexpr std::size_t buffer_size = 4;
+    pika::threads::detail::enable_task_trace(buffer_size);
+    for (std::size_t i = 0; i < 8; ++i) { run_traced_thread(); }
+    pika::threads::detail::disable_task_trace();
+
+    auto const records = pika::threads::detail::get_task_trace();
+    std::set<std::uint32_t> workers;
+    for (auto const& r : records) { workers.insert(r.worker); }
+    PIKA_TEST_LTE(records.size(), buffer_size * workers.size());
+}
+
+void test_formats()
+{
+    pika::threads::detail::enable_task_trace(1024);
+    run_traced_thread();
+    pika::threads::detail::disable_task_trace();
+
+    std::ostringstream chrome;
+    pika::threads::detail::write_task_trace_chrome(chrome);
+    std::string const json = chrome.str();
+    PIKA_TEST_EQ(json.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), std::size_t(0));
+    PIKA_TEST_NEQ(json.find("\"ph\":\"B\""), std::string::npos);
+    PIKA_TEST_NEQ(json.find("\"ph\":\"E\""), std::string::npos);
+#if defined(PIKA_HAVE_THREAD_DESCRIPTION)
+    PIKA_TEST_NEQ(json.find("\"name\":\"traced\""), std::string::npos);
+#endif
+    PIKA_TEST_EQ(json.substr(json.size() - 3), std::string("]}\n"));
+
+    std::ostringstream perfetto;
+    pika::threads::detail::write_task_trace_perfetto(perfetto);
+    std::string const proto = perfetto.str();
+    // Every packet is a length-delimited field with number 1
+    PIKA_TEST(!proto.empty());
+    PIKA_TEST_EQ(proto[0], '\x0a');
+    PIKA_TEST_NEQ(proto.find("worker-thread#0"), std::string::npos);
+}
+
+int pika_main()
+{
+    test_events();
+    test_overwrite();
+    test_formats();
+
+    // Leave a trace for the runtime to write at shutdown
+    pika::threads::detail::enable_task_trace(1024);
+    run_traced_thread();
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    std::remove(trace_file);
+
+    pika::init_params init_args;
+    init_args.cfg = {"pika.os_threads=1", std::string("pika.trace.file=") + trace_file};
+
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv, init_args), 0);
+
+    // The runtime writes the trace when it shuts down
+    std::ifstream in(trace_file);
+    std::string const json(std::istreambuf_iterator<char>(in), {});
+    PIKA_TEST_NEQ(json.find("\"ph\":\"B\""), std::string::npos);
+    std::remove(trace_file);
+
+    return pika::detail::report_errors();
+}
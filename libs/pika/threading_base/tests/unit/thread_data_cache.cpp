@@ -0,0 +1,131 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+#include <pika/threading_base/detail/thread_data_cache.hpp>
+#include <pika/threading_base/thread_data_stackful.hpp>
+#include <pika/threading_base/thread_init_data.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+using pika::threads::detail::thread_data_cache;
+using pika::threads::detail::thread_id_type;
+
+constexpr std::ptrdiff_t stacksize = PIKA_SMALL_STACK_SIZE;
+
+std::vector<thread_id_type> make_objects(std::size_t count)
+{
+    std::vector<thread_id_type> objects;
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        pika::threads::detail::thread_init_data init_data;
+        auto* p = pika::threads::detail::thread_data_stackful::create(
+            init_data, nullptr, stacksize, pika::threads::detail::thread_id_addref::no);
+        p->init();
+        objects.emplace_back(p);
+    }
+    return objects;
+}
+
+void test_depot()
+{
+    thread_data_cache::parameters params;
+    params.magazine_size = 4;
+    params.high_water_mark = 8;
+    params.trim_interval = std::chrono::milliseconds(0);
+    thread_data_cache cache(2, params);
+
+    // Objects above the high-water mark are destroyed
+    auto objects = make_objects(10);
+    cache.give(0, stacksize, objects.data(), objects.size());
+    auto stats = cache.statistics(false);
+    PIKA_TEST_EQ(stats.released, std::uint64_t(2));
+
+    // Domains and stack sizes are separate
+    std::vector<thread_id_type> taken(10);
+    PIKA_TEST_EQ(cache.take(1, stacksize, taken.data(), taken.size()), std::size_t(0));
+    PIKA_TEST_EQ(cache.take(0, 2 * stacksize, taken.data(), taken.size()), std::size_t(0));
+
+    PIKA_TEST_EQ(cache.take(0, stacksize, taken.data(), 5), std::size_t(5));
+    PIKA_TEST_EQ(cache.take(0, stacksize, taken.data() + 5, 5), std::size_t(3));
+    PIKA_TEST_EQ(cache.take(0, stacksize, taken.data(), 1), std::size_t(0));
+
+    // Only objects which have not been used for a full interval are trimmed
+    cache.give(0, stacksize, taken.data(), 8);
+    cache.trim();
+    PIKA_TEST_EQ(cache.statistics(false).trimmed, std::uint64_t(0));
+
+    PIKA_TEST_EQ(cache.take(0, stacksize, taken.data(), 3), std::size_t(3));
+    cache.give(0, stacksize, taken.data(), 3);
+    cache.trim();
+    PIKA_TEST_EQ(cache.statistics(false).trimmed, std::uint64_t(5));
+
+    // The remaining objects are trimmed after the next interval
+    cache.trim();
+    PIKA_TEST_EQ(cache.statistics(false).trimmed, std::uint64_t(8));
+
+    cache.record_hit(0);
+    cache.record_miss(1);
+    stats = cache.statistics(true);
+    PIKA_TEST_EQ(stats.hits, std::uint64_t(1));
+    PIKA_TEST_EQ(stats.misses, std::uint64_t(1));
+    PIKA_TEST_EQ(stats.trimmed, std::uint64_t(8));
+    PIKA_TEST_EQ(stats.released, std::uint64_t(2));
+
+    stats = cache.statistics(false);
+    PIKA_TEST_EQ(stats.hits, std::uint64_t(0));
+    PIKA_TEST_EQ(stats.trimmed, std::uint64_t(0));
+}
+
+void test_runtime()
+{
+    // Spawn more threads than fit into the magazines at once, and then do it
+    // again to reuse the objects that went through the depot
+    ex::thread_pool_scheduler sched{};
+    auto spawn = [&](std::size_t count) {
+        std::vector<ex::unique_any_sender<>> senders;
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            senders.push_back(ex::schedule(sched) | ex::then([] { pika::this_thread::yield(); }));
+        }
+        tt::sync_wait(ex::when_all_vector(std::move(senders)));
+    };
+
+    spawn(1000);
+    thread_data_cache::get_statistics(true);
+
+    spawn(1000);
+    auto const stats = thread_data_cache::get_statistics(false);
+    PIKA_TEST(stats.hits + stats.misses >= 1000);
+    PIKA_TEST(stats.hits > 0);
+}
+
+int pika_main()
+{
+    test_depot();
+    test_runtime();
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    PIKA_TEST_EQ_MSG(pika::init(pika_main, argc, argv), 0, "pika main exited with non-zero status");
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+//  Copyright (c) 2023 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/testing.hpp>
+#include <pika/threading_base/detail/timer_wheel.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+using pika::threads::detail::timer_wheel;
+using pika::threads::detail::timer_wheel_entry;
+using namespace std::chrono_literals;
+
+struct test_entry : timer_wheel_entry
+{
+    test_entry()
+      : timer_wheel_entry(&on_expire)
+    {
+    }
+
+    timer_wheel::clock_type::time_point deadline;
+    std::size_t expired = 0;
+
+    static void on_expire(timer_wheel_entry& entry) noexcept
+    {
+        ++static_cast<test_entry&>(entry).expired;
+    }
+};
+
+void test_expiry_order()
+{
+    timer_wheel wheel(1ms);
+    auto const start = timer_wheel::clock_type::now();
+
+    std::mt19937 gen(0);
+    // Covers the first four levels of the wheel
+    std::uniform_int_distribution<std::int64_t> dist(0, std::int64_t(1) << 24);
+
+    std::size_t const num_entries = 10000;
+    std::vector<std::unique_ptr<test_entry>> entries;
+    for (std::size_t i = 0; i != num_entries; ++i)
+    {
+        auto e = std::make_unique<test_entry>();
+        e->deadline = start + std::chrono::milliseconds(dist(gen));
+        wheel.schedule(*e, e->deadline);
+        entries.push_back(std::move(e));
+    }
+    PIKA_TEST_EQ(wheel.size(), num_entries);
+
+    std::size_t total_expired = 0;
+    for (auto now = start; !wheel.empty(); now += std::chrono::milliseconds(dist(gen) / 1000))
+    {
+        total_expired += wheel.advance(now);
+
+        for (auto const& e : entries)
+        {
+            // Never early, at most one tick late
+            if (e->deadline > now) { PIKA_TEST_EQ(e->expired, std::size_t(0)); }
+            else if (e->deadline + 1ms <= now) { PIKA_TEST_EQ(e->expired, std::size_t(1)); }
+        }
+    }
+
+    PIKA_TEST_EQ(total_expired, num_entries);
+    for (auto const& e : entries) { PIKA_TEST_EQ(e->expired, std::size_t(1)); }
+}
+
+void test_cancel()
+{
+    timer_wheel wheel(1ms);
+    auto const start = timer_wheel::clock_type::now();
+
+    test_entry a;
+    test_entry b;
+    test_entry c;
+
+    PIKA_TEST(wheel.schedule(a, start + 10ms));
+    PIKA_TEST(!wheel.schedule(b, start + 20ms));
+    PIKA_TEST(wheel.schedule(c, start + 5ms));
+    PIKA_TEST_EQ(wheel.size(), std::size_t(3));
+    PIKA_TEST(wheel.next_expiry() >= start + 5ms);
+    PIKA_TEST(wheel.next_expiry() <= start + 6ms);
+
+    PIKA_TEST(wheel.cancel(a));
+    PIKA_TEST(!wheel.cancel(a));
+    PIKA_TEST_EQ(wheel.size(), std::size_t(2));
+
+    PIKA_TEST_EQ(wheel.advance(start + 15ms), std::size_t(1));
+    PIKA_TEST_EQ(c.expired, std::size_t(1));
+    PIKA_TEST(!wheel.cancel(c));
+
+    PIKA_TEST(wheel.cancel(b));
+    PIKA_TEST(wheel.empty());
+    PIKA_TEST_EQ(wheel.advance(start + 1s), std::size_t(0));
+    PIKA_TEST_EQ(a.expired, std::size_t(0));
+    PIKA_TEST_EQ(b.expired, std::size_t(0));
+
+    // Entries can be re-armed after they have been cancelled or have expired.
+    // Deadlines in the past expire with the next tick, other deadlines may
+    // expire up to one tick late.
+    wheel.schedule(a, start + 2s);
+    wheel.schedule(c, start);
+    PIKA_TEST_EQ(wheel.advance(start + 1100ms), std::size_t(1));
+    PIKA_TEST_EQ(c.expired, std::size_t(2));
+    PIKA_TEST_EQ(wheel.advance(start + 2s - 1ms), std::size_t(0));
+    PIKA_TEST_EQ(wheel.advance(start + 2s + 1ms), std::size_t(1));
+    PIKA_TEST_EQ(a.expired, std::size_t(1));
+}
+
+// An entry which re-arms itself from its expiry callback, which is invoked
+// without the wheel being locked
+struct periodic_entry : timer_wheel_entry
+{
+    periodic_entry(timer_wheel& wheel, std::size_t periods)
+      : timer_wheel_entry(&on_expire)
+      , wheel(wheel)
+      , periods(periods)
+    {
+    }
+
+    timer_wheel& wheel;
+    timer_wheel::clock_type::time_point deadline;
+    std::size_t periods;
+    std::size_t expired = 0;
+
+    static void on_expire(timer_wheel_entry& entry) noexcept
+    {
+        auto& e = static_cast<periodic_entry&>(entry);
+        if (++e.expired == e.periods) return;
+
+        e.deadline += 10ms;
+        e.wheel.schedule(e, e.deadline);
+    }
+};
+
+void test_reschedule_from_callback()
+{
+    timer_wheel wheel(1ms);
+    auto const start = timer_wheel::clock_type::now();
+
+    periodic_entry p(wheel, 3);
+    test_entry a;
+    p.deadline = start + 10ms;
+    wheel.schedule(p, p.deadline);
+    wheel.schedule(a, start + 25ms);
+
+    PIKA_TEST_EQ(wheel.advance(start + 11ms), std::size_t(1));
+    PIKA_TEST_EQ(p.expired, std::size_t(1));
+    PIKA_TEST_EQ(wheel.size(), std::size_t(2));
+
+    // The entry re-armed by the callback expires together with the other entry
+    PIKA_TEST_EQ(wheel.advance(start + 26ms), std::size_t(2));
+    PIKA_TEST_EQ(p.expired, std::size_t(2));
+    PIKA_TEST_EQ(a.expired, std::size_t(1));
+
+    PIKA_TEST_EQ(wheel.advance(start + 31ms), std::size_t(1));
+    PIKA_TEST_EQ(p.expired, std::size_t(3));
+    PIKA_TEST(wheel.empty());
+    PIKA_TEST(!wheel.cancel(p));
+}
+
+void test_beyond_range()
+{
+    // With a resolution of 1ns the wheel covers roughly 68s
+    timer_wheel wheel(1ns);
+    auto const start = timer_wheel::clock_type::now();
+
+    test_entry a;
+    wheel.schedule(a, start + 100s);
+
+    PIKA_TEST_EQ(wheel.advance(start + 60s), std::size_t(0));
+    PIKA_TEST_EQ(wheel.advance(start + 99s), std::size_t(0));
+    PIKA_TEST_EQ(a.expired, std::size_t(0));
+    PIKA_TEST_EQ(wheel.advance(start + 100s), std::size_t(1));
+    PIKA_TEST_EQ(a.expired, std::size_t(1));
+}
+
+int main()
+{
+    test_expiry_order();
+    test_cancel();
+    test_reschedule_from_callback();
+    test_beyond_range();
+
+    return 0;
+}
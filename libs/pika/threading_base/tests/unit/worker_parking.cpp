@@ -0,0 +1,80 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/testing.hpp>
+#include <pika/threading_base/detail/worker_parking.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+using pika::threads::detail::worker_parking;
+using namespace std::chrono_literals;
+
+void test_timeout()
+{
+    worker_parking parking(2);
+
+    auto const start = std::chrono::steady_clock::now();
+    PIKA_TEST(!parking.park(0, 10ms));
+    PIKA_TEST(std::chrono::steady_clock::now() - start >= 10ms);
+
+    // Nobody is parked, so there is nobody to wake up
+    PIKA_TEST(!parking.unpark_one(0));
+    PIKA_TEST_EQ(parking.num_parked(), std::size_t(0));
+}
+
+void test_unpark_before_park()
+{
+    worker_parking parking(2);
+
+    // A wakeup for a worker thread which is about to park is not lost
+    parking.unpark_all();
+    PIKA_TEST(parking.park(1, 10s));
+
+    // The wakeup is consumed by parking
+    PIKA_TEST(!parking.park(1, 1ms));
+}
+
+void wait_until_parked(worker_parking& parking, std::size_t num_parked)
+{
+    while (parking.num_parked() != num_parked) { std::this_thread::yield(); }
+}
+
+void test_unpark_target()
+{
+    worker_parking parking(4);
+
+    std::atomic<bool> woken[2] = {false, false};
+    std::thread t0([&] { woken[0] = parking.park(0, 10s); });
+    std::thread t2([&] { woken[1] = parking.park(2, 10s); });
+
+    wait_until_parked(parking, 2);
+
+    // The given worker thread is woken up if it is parked
+    PIKA_TEST(parking.unpark_one(2));
+    t2.join();
+    PIKA_TEST(woken[1]);
+    PIKA_TEST_EQ(parking.num_parked(), std::size_t(1));
+
+    // Otherwise the closest parked worker thread is woken up
+    PIKA_TEST(parking.unpark_one(1));
+    t0.join();
+    PIKA_TEST(woken[0]);
+
+    PIKA_TEST(!parking.unpark_one(std::size_t(-1)));
+}
+
+int main()
+{
+    test_timeout();
+    test_unpark_before_park();
+    test_unpark_target();
+
+    return pika::detail::report_errors();
+}
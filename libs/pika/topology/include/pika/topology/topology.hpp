@@ -168,6 +168,17 @@ namespace pika::threads::detail {
         mask_cref_type get_core_affinity_mask(
             std::size_t num_thread, error_code& ec = throws) const;
 
+        /// \brief Return a bit mask where each set bit corresponds to a
+        ///        processing unit sharing the last level cache with the
+        ///        given thread. If the topology does not report caches this
+        ///        is the NUMA node affinity mask of the thread.
+        ///
+        /// \param ec         [in,out] this represents the error status on exit,
+        ///                   if this is pre-initialized to \a pika#throws
+        ///                   the function will throw on error instead.
+        mask_cref_type get_cache_affinity_mask(
+            std::size_t num_thread, error_code& ec = throws) const;
+
         /// \brief Return a bit mask where each set bit corresponds to a
         ///        processing unit available to the given thread.
         ///
@@ -328,6 +339,8 @@ namespace pika::threads::detail {
             return init_core_affinity_mask_from_core(get_core_number(num_thread), default_mask);
         }
 
+        mask_type init_cache_affinity_mask(std::size_t num_thread) const;
+
         void init_num_of_pus();
 
         hwloc_topology_t topo;
@@ -362,6 +375,7 @@ namespace pika::threads::detail {
         std::vector<mask_type> socket_affinity_masks_;
         std::vector<mask_type> numa_node_affinity_masks_;
         std::vector<mask_type> core_affinity_masks_;
+        std::vector<mask_type> cache_affinity_masks_;
         std::vector<mask_type> thread_affinity_masks_;
         mask_type main_thread_affinity_mask_;
     };
@@ -279,6 +279,7 @@ namespace pika::threads::detail {
         socket_affinity_masks_.reserve(num_of_pus_);
         numa_node_affinity_masks_.reserve(num_of_pus_);
         core_affinity_masks_.reserve(num_of_pus_);
+        cache_affinity_masks_.reserve(num_of_pus_);
         thread_affinity_masks_.reserve(num_of_pus_);
 
         for (std::size_t i = 0; i < num_of_pus_; ++i)
@@ -296,6 +297,11 @@ namespace pika::threads::detail {
             core_affinity_masks_.push_back(init_core_affinity_mask(i));
         }
 
+        for (std::size_t i = 0; i < num_of_pus_; ++i)
+        {
+            cache_affinity_masks_.push_back(init_cache_affinity_mask(i));
+        }
+
         for (std::size_t i = 0; i < num_of_pus_; ++i)
         {
             thread_affinity_masks_.push_back(init_thread_affinity_mask(i));
@@ -331,6 +337,7 @@ namespace pika::threads::detail {
         detail::write_to_log_mask("socket_affinity_mask", socket_affinity_masks_);
         detail::write_to_log_mask("numa_node_affinity_mask", numa_node_affinity_masks_);
         detail::write_to_log_mask("core_affinity_mask", core_affinity_masks_);
+        detail::write_to_log_mask("cache_affinity_mask", cache_affinity_masks_);
         detail::write_to_log_mask("thread_affinity_mask", thread_affinity_masks_);
     }
 
@@ -441,6 +448,23 @@ namespace pika::threads::detail {
         return empty_mask;
     }
 
+    mask_cref_type topology::get_cache_affinity_mask(std::size_t num_thread, error_code& ec) const
+    {
+        std::size_t num_pu = num_thread % num_of_pus_;
+
+        if (num_pu < cache_affinity_masks_.size())
+        {
+            if (&ec != &throws) ec = make_success_code();
+
+            return cache_affinity_masks_[num_pu];
+        }
+
+        PIKA_THROWS_IF(ec, pika::error::bad_parameter,
+            "pika::threads::detail::topology::get_cache_affinity_mask",
+            "thread number {} is out of range", num_thread);
+        return empty_mask;
+    }
+
     mask_cref_type topology::get_thread_affinity_mask(std::size_t num_thread, error_code& ec) const
     {    // {{{
         std::size_t num_pu = num_thread % num_of_pus_;
@@ -1043,6 +1067,38 @@ namespace pika::threads::detail {
         return default_mask;
     }    // }}}
 
+    mask_type topology::init_cache_affinity_mask(std::size_t num_thread) const
+    {    // {{{
+        std::size_t num_pu = (num_thread + pu_offset) % num_of_pus_;
+
+        // Find the outermost cache containing the PU
+        hwloc_obj_t cache_obj = nullptr;
+        {
+            std::unique_lock<mutex_type> lk(topo_mtx);
+            hwloc_obj_t obj =
+                hwloc_get_obj_by_type(topo, HWLOC_OBJ_PU, static_cast<unsigned>(num_pu));
+            for (; obj != nullptr; obj = obj->parent)
+            {
+#if HWLOC_API_VERSION >= 0x0002'0000
+                if (hwloc_obj_type_is_cache(obj->type)) { cache_obj = obj; }
+#else
+                if (obj->type == HWLOC_OBJ_CACHE) { cache_obj = obj; }
+#endif
+            }
+        }
+
+        if (cache_obj)
+        {
+            mask_type cache_affinity_mask = mask_type();
+            resize(cache_affinity_mask, get_number_of_pus());
+
+            extract_node_mask(cache_obj, cache_affinity_mask);
+            return cache_affinity_mask;
+        }
+
+        return numa_node_affinity_masks_[num_thread];
+    }    // }}}
+
     mask_type topology::init_thread_affinity_mask(std::size_t num_thread) const
     {    // {{{
 
@@ -1480,6 +1536,8 @@ namespace pika::threads::detail {
         print_mask_vector(os, numa_node_affinity_masks_);
         os << "core                  : \n";
         print_mask_vector(os, core_affinity_masks_);
+        os << "last level cache      : \n";
+        print_mask_vector(os, cache_affinity_masks_);
         os << "PUs (/threads)        : \n";
         print_mask_vector(os, thread_affinity_masks_);
 
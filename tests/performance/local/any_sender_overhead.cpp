@@ -0,0 +1,184 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark measures the time to construct, connect, and start
+// type-erased senders wrapping senders of different sizes, with the default
+// and a larger embedded storage. Senders which don't fit in the embedded
+// storage are allocated from the per-thread pools of the heap storage, or
+// directly on the heap if they are larger than the largest size class. The
+// benchmark is run on one worker thread and concurrently on all worker
+// threads.
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/modules/timing.hpp>
+#include <pika/runtime.hpp>
+#include <pika/testing/performance.hpp>
+
+#include <fmt/format.h>
+#include <fmt/printf.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace po = pika::program_options;
+namespace tt = pika::this_thread::experimental;
+
+struct sink_receiver
+{
+    using is_receiver = void;
+
+    std::uint64_t& sum;
+
+    friend void tag_invoke(ex::set_value_t, sink_receiver&& r, int x) noexcept { r.sum += x; }
+
+    friend void tag_invoke(ex::set_error_t, sink_receiver&&, std::exception_ptr) noexcept
+    {
+        std::terminate();
+    }
+
+    friend void tag_invoke(ex::set_stopped_t, sink_receiver&&) noexcept { std::terminate(); }
+
+    friend constexpr ex::empty_env tag_invoke(ex::get_env_t, sink_receiver const&) noexcept
+    {
+        return {};
+    }
+};
+
+// Returns a sender sending x, which is at least PaddingSize bytes large
+template <std::size_t PaddingSize>
+auto padded_just(int x)
+{
+    return ex::just(x) | ex::then([padding = std::array<unsigned char, PaddingSize>{}](int x) {
+        return x + padding[0];
+    });
+}
+
+template <typename AnySender, typename Sender>
+void construct_connect_start(Sender const& s, std::uint64_t iterations, std::uint64_t& sum)
+{
+    for (std::uint64_t i = 0; i < iterations; ++i)
+    {
+        AnySender as{s};
+        auto os = ex::connect(std::move(as), sink_receiver{sum});
+        ex::start(os);
+    }
+}
+
+struct result
+{
+    std::string storage;
+    std::size_t sender_size;
+    std::size_t threads;
+    double time_per_sender;
+};
+
+template <typename AnySender, std::size_t PaddingSize>
+void run(std::string const& storage, std::uint64_t iterations, std::vector<result>& results)
+{
+    auto const s = padded_just<PaddingSize>(1);
+    auto const num_threads = pika::get_num_worker_threads();
+
+    // Warm up the pools
+    std::uint64_t sum = 0;
+    construct_connect_start<AnySender>(s, 100, sum);
+
+    pika::chrono::detail::high_resolution_timer timer;
+    construct_connect_start<AnySender>(s, iterations, sum);
+    double const elapsed = timer.elapsed();
+    results.push_back({storage, sizeof(s), 1, elapsed / double(iterations)});
+
+    std::vector<std::uint64_t> sums(num_threads, 0);
+    timer.restart();
+    tt::sync_wait(ex::schedule(ex::thread_pool_scheduler{}) |
+        ex::bulk(num_threads,
+            [&](std::size_t t) { construct_connect_start<AnySender>(s, iterations, sums[t]); }));
+    double const elapsed_all = timer.elapsed();
+    results.push_back({storage, sizeof(s), num_threads, elapsed_all / double(iterations)});
+
+    for (auto const t : sums) { sum += t; }
+    if (sum != (100 + iterations * (num_threads + 1)))
+    {
+        std::cerr << "any_sender_overhead: wrong result for " << storage << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+template <typename AnySender>
+void run_sizes(std::string const& storage, std::uint64_t iterations, std::vector<result>& results)
+{
+    run<AnySender, 1>(storage, iterations, results);
+    run<AnySender, 64>(storage, iterations, results);
+    run<AnySender, 256>(storage, iterations, results);
+    run<AnySender, 1024>(storage, iterations, results);
+    run<AnySender, 4096>(storage, iterations, results);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int pika_main(po::variables_map& vm)
+{
+    auto const iterations = vm["iterations"].as<std::uint64_t>();
+    auto const perftest_json = vm["perftest-json"].as<bool>();
+
+    std::vector<result> results;
+    run_sizes<ex::unique_any_sender<int>>("unique_any_sender", iterations, results);
+    run_sizes<ex::any_sender<int>>("any_sender", iterations, results);
+    run_sizes<ex::basic_unique_any_sender<512, int>>(
+        "basic_unique_any_sender<512>", iterations, results);
+
+    if (perftest_json)
+    {
+        pika::util::detail::json_perf_times t;
+        for (auto const& r : results)
+        {
+            t.add(fmt::format("any_sender_overhead - {} threads - {} - {} bytes", r.threads,
+                      r.storage, r.sender_size),
+                r.time_per_sender);
+        }
+        std::cout << t;
+    }
+    else
+    {
+        fmt::print("storage,sender_size,threads,time_per_sender_ns\n");
+        for (auto const& r : results)
+        {
+            fmt::print("{},{},{},{}\n", r.storage, r.sender_size, r.threads,
+                r.time_per_sender * 1e9);
+        }
+    }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    po::options_description cmdline("usage: " PIKA_APPLICATION_STRING " [options]");
+
+    // clang-format off
+    cmdline.add_options()
+        ("iterations", po::value<std::uint64_t>()->default_value(100000),
+         "number of senders constructed per thread for each sender size")
+        ("perftest-json", po::bool_switch(),
+         "print average time per sender in json format for use with performance CI")
+        // clang-format on
+        ;
+
+    // Initialize and run pika.
+    pika::init_params init_args;
+    init_args.desc_cmdline = cmdline;
+
+    return pika::init(pika_main, argc, argv, init_args);
+}
@@ -0,0 +1,127 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark runs bulk on the thread_pool_scheduler over elements which
+// each busy-wait for 10 ns up to 1 ms, comparing the adaptive chunking used
+// by default to fixed chunk sizes set with with_chunk_size. The number of
+// elements is chosen so that the total work is roughly the same for every
+// element cost.
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/modules/timing.hpp>
+#include <pika/runtime.hpp>
+#include <pika/testing/performance.hpp>
+
+#include <fmt/format.h>
+#include <fmt/printf.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "worker_timed.hpp"
+
+namespace ex = pika::execution::experimental;
+namespace po = pika::program_options;
+namespace tt = pika::this_thread::experimental;
+
+// Returns the average time of one bulk in seconds
+double run(ex::thread_pool_scheduler sched, std::uint64_t n, std::uint64_t element_ns,
+    std::uint64_t repetitions)
+{
+    pika::chrono::detail::high_resolution_timer timer;
+    for (std::uint64_t r = 0; r < repetitions; ++r)
+    {
+        tt::sync_wait(ex::schedule(sched) |
+            ex::bulk(n, [element_ns](std::uint64_t) { worker_timed(element_ns); }));
+    }
+    return timer.elapsed() / double(repetitions);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int pika_main(po::variables_map& vm)
+{
+    auto const total_us = vm["total-us"].as<std::uint64_t>();
+    auto const repetitions = vm["repetitions"].as<std::uint64_t>();
+    auto const perftest_json = vm["perftest-json"].as<bool>();
+    auto const num_threads = pika::get_num_worker_threads();
+
+    // The chunk size bulk used before adaptive chunking, giving at most 8
+    // chunks per worker thread, is also included as "static"
+    auto static_chunk_size = [&](std::uint64_t n) {
+        std::size_t chunk_size = 1;
+        while (chunk_size * num_threads * 8 < n) { chunk_size *= 2; }
+        return chunk_size;
+    };
+
+    pika::util::detail::json_perf_times t;
+    if (!perftest_json)
+    {
+        fmt::print("element_ns,elements,adaptive_us,static_us,chunk_size_1_us,ideal_us\n");
+    }
+
+    for (std::uint64_t element_ns = 10; element_ns <= 1000000; element_ns *= 10)
+    {
+        std::uint64_t const n = (std::max)(std::uint64_t(total_us * 1000 / element_ns),
+            std::uint64_t(4 * num_threads));
+
+        std::vector<std::pair<std::string, double>> times{
+            {"adaptive", run(ex::thread_pool_scheduler{}, n, element_ns, repetitions)},
+            {"static",
+                run(ex::with_chunk_size(ex::thread_pool_scheduler{}, static_chunk_size(n)), n,
+                    element_ns, repetitions)},
+            {"chunk size 1",
+                run(ex::with_chunk_size(ex::thread_pool_scheduler{}, 1), n, element_ns,
+                    repetitions)}};
+
+        if (perftest_json)
+        {
+            for (auto const& [name, time] : times)
+            {
+                t.add(fmt::format("bulk_chunking - {} threads - {} ns elements - {}",
+                          num_threads, element_ns, name),
+                    time);
+            }
+        }
+        else
+        {
+            double const ideal = double(n * element_ns) * 1e-9 / double(num_threads);
+            fmt::print("{},{},{},{},{},{}\n", element_ns, n, times[0].second * 1e6,
+                times[1].second * 1e6, times[2].second * 1e6, ideal * 1e6);
+        }
+    }
+
+    if (perftest_json) { std::cout << t; }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    po::options_description cmdline("usage: " PIKA_APPLICATION_STRING " [options]");
+
+    // clang-format off
+    cmdline.add_options()
+        ("total-us", po::value<std::uint64_t>()->default_value(10000), "total work in one bulk (in microseconds)")
+        ("repetitions", po::value<std::uint64_t>()->default_value(10), "number of times each bulk is run")
+        ("perftest-json", po::bool_switch(), "print average time per bulk in json format for use with performance CI")
+        // clang-format on
+        ;
+
+    // Initialize and run pika.
+    pika::init_params init_args;
+    init_args.desc_cmdline = cmdline;
+
+    return pika::init(pika_main, argc, argv, init_args);
+}
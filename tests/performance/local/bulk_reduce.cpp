@@ -0,0 +1,113 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark sums a vector on the thread_pool_scheduler with
+// transform_reduce, which keeps one partial sum per worker thread, and with
+// bulk adding every element to a shared atomic.
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/modules/timing.hpp>
+#include <pika/runtime.hpp>
+#include <pika/testing/performance.hpp>
+
+#include <fmt/format.h>
+#include <fmt/printf.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace po = pika::program_options;
+namespace tt = pika::this_thread::experimental;
+
+///////////////////////////////////////////////////////////////////////////////
+int pika_main(po::variables_map& vm)
+{
+    auto const n = vm["n"].as<std::uint64_t>();
+    auto const repetitions = vm["repetitions"].as<std::uint64_t>();
+    auto const perftest_json = vm["perftest-json"].as<bool>();
+
+    std::vector<std::int64_t> v(n);
+    std::iota(v.begin(), v.end(), std::int64_t(0));
+    std::int64_t const expected = std::accumulate(v.begin(), v.end(), std::int64_t(0));
+
+    double reduce_time = 0.0;
+    {
+        pika::chrono::detail::high_resolution_timer timer;
+        for (std::uint64_t r = 0; r < repetitions; ++r)
+        {
+            auto const sum = tt::sync_wait(ex::schedule(ex::thread_pool_scheduler{}) |
+                ex::transform_reduce(
+                    n, std::int64_t(0), std::plus<>{}, [&](std::uint64_t i) { return v[i]; }));
+            if (sum != expected) { std::cerr << "transform_reduce gave a wrong sum\n"; }
+        }
+        reduce_time = timer.elapsed() / double(repetitions);
+    }
+
+    double atomic_time = 0.0;
+    {
+        pika::chrono::detail::high_resolution_timer timer;
+        for (std::uint64_t r = 0; r < repetitions; ++r)
+        {
+            std::atomic<std::int64_t> sum{0};
+            tt::sync_wait(ex::schedule(ex::thread_pool_scheduler{}) |
+                ex::bulk(n, [&](std::uint64_t i) {
+                    sum.fetch_add(v[i], std::memory_order_relaxed);
+                }));
+            if (sum != expected) { std::cerr << "bulk with atomics gave a wrong sum\n"; }
+        }
+        atomic_time = timer.elapsed() / double(repetitions);
+    }
+
+    if (perftest_json)
+    {
+        pika::util::detail::json_perf_times t;
+        t.add(fmt::format("bulk_reduce - {} threads - transform_reduce",
+                  pika::get_num_worker_threads()),
+            reduce_time);
+        t.add(fmt::format("bulk_reduce - {} threads - bulk with atomics",
+                  pika::get_num_worker_threads()),
+            atomic_time);
+        std::cout << t;
+    }
+    else
+    {
+        fmt::print("elements,transform_reduce_us,bulk_atomic_us\n");
+        fmt::print("{},{},{}\n", n, reduce_time * 1e6, atomic_time * 1e6);
+    }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    po::options_description cmdline("usage: " PIKA_APPLICATION_STRING " [options]");
+
+    // clang-format off
+    cmdline.add_options()
+        ("n", po::value<std::uint64_t>()->default_value(10000000), "number of elements to sum")
+        ("repetitions", po::value<std::uint64_t>()->default_value(10),
+         "number of times each sum is computed")
+        ("perftest-json", po::bool_switch(),
+         "print average time per sum in json format for use with performance CI")
+        // clang-format on
+        ;
+
+    // Initialize and run pika.
+    pika::init_params init_args;
+    init_args.desc_cmdline = cmdline;
+
+    return pika::init(pika_main, argc, argv, init_args);
+}
@@ -0,0 +1,138 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark starts a large number of tasks which all sleep until the same
+// deadline. It reports the CPU time consumed by the process while the tasks
+// are sleeping and the wake-up jitter, i.e. how late the tasks are woken up
+// after their deadline.
+
+#include <pika/config.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/latch.hpp>
+#include <pika/modules/timing.hpp>
+#include <pika/runtime.hpp>
+#include <pika/testing/performance.hpp>
+#include <pika/thread.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace po = pika::program_options;
+
+///////////////////////////////////////////////////////////////////////////////
+int pika_main(po::variables_map& vm)
+{
+    using pika::chrono::detail::high_resolution_timer;
+
+    auto const sleepers = vm["sleepers"].as<std::size_t>();
+    auto const sleep_duration = std::chrono::milliseconds(vm["sleep-ms"].as<std::uint64_t>());
+    auto const perftest_json = vm["perftest-json"].as<bool>();
+
+    // Without idle backoff the workers keep polling for work while all tasks
+    // are sleeping
+    if (vm["idle-backoff"].as<bool>())
+    {
+        pika::threads::add_scheduler_mode(pika::threads::scheduler_mode::enable_idle_backoff);
+    }
+
+    // The sleepers need very little stack
+    auto sched = ex::with_stacksize(
+        ex::thread_pool_scheduler{}, pika::execution::thread_stacksize::small_);
+
+    // Shared with the sleepers as they may still be accessing the latch after
+    // it has been released
+    auto done = std::make_shared<pika::latch>(sleepers);
+    std::vector<std::chrono::nanoseconds> lateness(sleepers);
+
+    high_resolution_timer timer;
+
+    auto const deadline = std::chrono::steady_clock::now() + sleep_duration;
+    for (std::size_t i = 0; i != sleepers; ++i)
+    {
+        ex::execute(sched, [&lateness, done, deadline, i] {
+            pika::this_thread::sleep_until(deadline);
+            lateness[i] = std::chrono::steady_clock::now() - deadline;
+            done->count_down(1);
+        });
+    }
+
+    // Only measure the CPU time used while the sleepers are suspended
+    std::clock_t const cpu_start = std::clock();
+    done->wait();
+    std::clock_t const cpu_end = std::clock();
+
+    double const wall_s = timer.elapsed();
+    double const cpu_s = double(cpu_end - cpu_start) / CLOCKS_PER_SEC;
+
+    std::sort(lateness.begin(), lateness.end());
+    auto const to_us = [](std::chrono::nanoseconds d) { return double(d.count()) / 1e3; };
+
+    double jitter_avg_us = 0.0;
+    for (auto l : lateness) jitter_avg_us += to_us(l);
+    jitter_avg_us /= double(sleepers);
+    double const jitter_p50_us = to_us(lateness[sleepers / 2]);
+    double const jitter_p99_us = to_us(lateness[sleepers * 99 / 100]);
+    double const jitter_max_us = to_us(lateness.back());
+
+    if (perftest_json)
+    {
+        auto const num_threads = pika::get_num_worker_threads();
+
+        pika::util::detail::json_perf_times t;
+        t.add(fmt::format("concurrent_sleepers - {} threads - cpu time", num_threads), cpu_s);
+        t.add(fmt::format("concurrent_sleepers - {} threads - jitter p99", num_threads),
+            jitter_p99_us);
+        std::cout << t;
+    }
+    else
+    {
+        fmt::print("sleepers,sleep_ms,threads,wall_s,cpu_s,jitter_avg_us,jitter_p50_us,"
+                   "jitter_p99_us,jitter_max_us\n");
+        fmt::print("{},{},{},{},{},{},{},{},{}\n", sleepers, sleep_duration.count(),
+            pika::get_num_worker_threads(), wall_s, cpu_s, jitter_avg_us, jitter_p50_us,
+            jitter_p99_us, jitter_max_us);
+    }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    po::options_description cmdline("usage: " PIKA_APPLICATION_STRING " [options]");
+
+    // clang-format off
+    cmdline.add_options()
+        ("sleepers", po::value<std::size_t>()->default_value(100000),
+         "number of concurrently sleeping tasks")
+        ("sleep-ms", po::value<std::uint64_t>()->default_value(1000),
+         "time to sleep in milliseconds")
+        ("idle-backoff", po::bool_switch(),
+         "let idle worker threads back off while all tasks are sleeping")
+        ("perftest-json", po::bool_switch(),
+         "print final timings in json format for use with performance CI")
+        // clang-format on
+        ;
+
+    // Initialize and run pika.
+    pika::init_params init_args;
+    init_args.desc_cmdline = cmdline;
+
+    return pika::init(pika_main, argc, argv, init_args);
+}
@@ -0,0 +1,198 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark submits bursts of busy-waiting tasks from three deadline
+// classes (tight, normal and loose) and reports, per class, the fraction of
+// tasks which finished after their deadline and the latency from submission
+// to completion. Deadlines are attached with the with_deadline property and
+// are only taken into account by --pika:queuing=deadline, so running the
+// benchmark with other schedulers gives a baseline.
+
+#include <pika/config.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/latch.hpp>
+#include <pika/modules/timing.hpp>
+#include <pika/runtime.hpp>
+#include <pika/testing/performance.hpp>
+#include <pika/thread.hpp>
+
+#include <fmt/format.h>
+#include <fmt/printf.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace po = pika::program_options;
+
+using clock_type = std::chrono::steady_clock;
+
+struct deadline_class
+{
+    char const* name;
+    std::chrono::microseconds budget;
+    unsigned weight;
+};
+
+// Deadlines relative to the submission time, and how many tasks out of 10
+// belong to each class
+constexpr std::array<deadline_class, 3> classes{{
+    {"tight", std::chrono::microseconds(200), 2},
+    {"normal", std::chrono::microseconds(2000), 3},
+    {"loose", std::chrono::microseconds(20000), 5},
+}};
+
+struct task_result
+{
+    std::size_t cls;
+    double latency_us;
+    bool missed;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+int pika_main(po::variables_map& vm)
+{
+    auto const tasks = vm["tasks"].as<std::uint64_t>();
+    auto const burst = vm["burst"].as<std::uint64_t>();
+    auto const interval = std::chrono::microseconds(vm["interval-us"].as<std::uint64_t>());
+    auto const task_duration = vm["task-us"].as<double>() * 1e-6;
+    auto const deadline_scale = vm["deadline-scale"].as<double>();
+    auto const perftest_json = vm["perftest-json"].as<bool>();
+
+    std::vector<task_result> results(tasks);
+    pika::latch done(static_cast<std::ptrdiff_t>(tasks + 1));
+
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<unsigned> dist(0, 9);
+    auto pick_class = [&] {
+        unsigned r = dist(gen);
+        for (std::size_t c = 0; c < classes.size(); ++c)
+        {
+            if (r < classes[c].weight) { return c; }
+            r -= classes[c].weight;
+        }
+        return classes.size() - 1;
+    };
+
+    for (std::uint64_t i = 0; i < tasks;)
+    {
+        std::uint64_t const n = (std::min)(burst, tasks - i);
+        for (std::uint64_t j = 0; j < n; ++j, ++i)
+        {
+            std::size_t const cls = pick_class();
+            auto const submitted = clock_type::now();
+            auto const deadline = submitted +
+                std::chrono::duration_cast<clock_type::duration>(
+                    classes[cls].budget * deadline_scale);
+
+            ex::execute(ex::with_deadline(ex::thread_pool_scheduler{}, deadline),
+                [&, i, cls, submitted, deadline] {
+                    pika::chrono::detail::high_resolution_timer t;
+                    while (t.elapsed() < task_duration) {}
+
+                    auto const finished = clock_type::now();
+                    results[i] = task_result{cls,
+                        std::chrono::duration<double, std::micro>(finished - submitted).count(),
+                        finished > deadline};
+                    done.count_down(1);
+                });
+        }
+
+        pika::this_thread::sleep_for(interval);
+    }
+
+    done.arrive_and_wait();
+
+    if (perftest_json)
+    {
+        pika::util::detail::json_perf_times t;
+        for (std::size_t c = 0; c < classes.size(); ++c)
+        {
+            std::size_t count = 0;
+            std::size_t missed = 0;
+            for (auto const& r : results)
+            {
+                if (r.cls != c) { continue; }
+                ++count;
+                missed += r.missed;
+            }
+            t.add(fmt::format("deadline_classes - {} threads - {} miss rate",
+                      pika::get_num_worker_threads(), classes[c].name),
+                count == 0 ? 0.0 : double(missed) / double(count));
+        }
+        std::cout << t;
+        pika::finalize();
+        return EXIT_SUCCESS;
+    }
+
+    fmt::print("class,deadline_us,tasks,missed,miss_rate,latency_avg_us,latency_p50_us,"
+               "latency_p99_us,latency_max_us\n");
+    for (std::size_t c = 0; c < classes.size(); ++c)
+    {
+        std::vector<double> latencies;
+        std::size_t missed = 0;
+        for (auto const& r : results)
+        {
+            if (r.cls != c) { continue; }
+            latencies.push_back(r.latency_us);
+            missed += r.missed;
+        }
+
+        if (latencies.empty()) { continue; }
+
+        std::sort(latencies.begin(), latencies.end());
+        double avg = 0.0;
+        for (double l : latencies) { avg += l; }
+        avg /= double(latencies.size());
+
+        auto percentile = [&](double p) {
+            return latencies[std::size_t(p * double(latencies.size() - 1))];
+        };
+
+        fmt::print("{},{},{},{},{},{},{},{},{}\n", classes[c].name,
+            double(classes[c].budget.count()) * deadline_scale, latencies.size(), missed,
+            double(missed) / double(latencies.size()), avg, percentile(0.5), percentile(0.99),
+            latencies.back());
+    }
+
+    auto& pool = pika::resource::get_thread_pool("default");
+    fmt::print("scheduler deadline misses (started late): {}\n",
+        pool.get_num_deadline_misses(std::size_t(-1), false));
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    po::options_description cmdline("usage: " PIKA_APPLICATION_STRING " [options]");
+
+    // clang-format off
+    cmdline.add_options()
+        ("tasks", po::value<std::uint64_t>()->default_value(20000), "number of tasks to submit")
+        ("burst", po::value<std::uint64_t>()->default_value(16), "number of tasks submitted at once")
+        ("interval-us", po::value<std::uint64_t>()->default_value(500), "time between two bursts (in microseconds)")
+        ("task-us", po::value<double>()->default_value(20.0), "time each task spends busy waiting (in microseconds)")
+        ("deadline-scale", po::value<double>()->default_value(1.0), "factor applied to the deadlines of all classes")
+        ("perftest-json", po::bool_switch(), "print miss rate per class in json format for use with performance CI")
+        // clang-format on
+        ;
+
+    // Initialize and run pika.
+    pika::init_params init_args;
+    init_args.desc_cmdline = cmdline;
+
+    return pika::init(pika_main, argc, argv, init_args);
+}
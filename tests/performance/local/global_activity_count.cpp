@@ -0,0 +1,157 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark measures the cost of starting and finishing activities from
+// many OS threads concurrently, comparing the sharded global activity count
+// used by the schedulers to a single shared atomic counter. Each thread
+// repeatedly increments and decrements the count, as the schedulers do when
+// creating and destroying pika threads, while one thread polls the count as
+// thread_manager::wait does.
+
+#include <pika/modules/program_options.hpp>
+#include <pika/modules/timing.hpp>
+#include <pika/testing/performance.hpp>
+#include <pika/threading_base/detail/global_activity_count.hpp>
+
+#include <fmt/format.h>
+#include <fmt/printf.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using pika::program_options::command_line_parser;
+using pika::program_options::notify;
+using pika::program_options::options_description;
+using pika::program_options::store;
+using pika::program_options::value;
+using pika::program_options::variables_map;
+
+struct shared_counter
+{
+    static std::atomic<std::size_t> count;
+
+    static void increment() { count.fetch_add(1, std::memory_order_acquire); }
+    static void decrement() { count.fetch_sub(1, std::memory_order_release); }
+    static std::size_t get() { return count.load(std::memory_order_acquire); }
+};
+
+std::atomic<std::size_t> shared_counter::count{0};
+
+struct sharded_counter
+{
+    static void increment() { pika::threads::detail::increment_global_activity_count(); }
+    static void decrement() { pika::threads::detail::decrement_global_activity_count(); }
+    static std::size_t get() { return pika::threads::detail::get_global_activity_count(); }
+};
+
+// Returns the time per increment and decrement pair in nanoseconds
+template <typename Counter>
+double run(std::size_t num_threads, std::uint64_t iterations)
+{
+    std::atomic<std::size_t> ready{0};
+    std::atomic<bool> start{false};
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (std::size_t t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([&] {
+            ++ready;
+            while (!start.load(std::memory_order_acquire)) { std::this_thread::yield(); }
+            for (std::uint64_t i = 0; i < iterations; ++i)
+            {
+                Counter::increment();
+                Counter::decrement();
+            }
+        });
+    }
+
+    // Poll the count like thread_manager::wait while the workers run
+    std::thread poller([&] {
+        std::size_t underflows = 0;
+        while (!done.load(std::memory_order_acquire))
+        {
+            underflows += Counter::get() > std::size_t(-1) / 2;
+            std::this_thread::yield();
+        }
+        if (underflows != 0) { std::cerr << "activity count underflowed\n"; }
+    });
+
+    while (ready.load() != num_threads) { std::this_thread::yield(); }
+
+    pika::chrono::detail::high_resolution_timer timer;
+    start.store(true, std::memory_order_release);
+    for (auto& t : threads) { t.join(); }
+    double const elapsed = timer.elapsed();
+
+    done.store(true, std::memory_order_release);
+    poller.join();
+
+    return elapsed * 1e9 / double(iterations);
+}
+
+int app_main(variables_map& vm)
+{
+    auto const iterations = vm["iterations"].as<std::uint64_t>();
+    auto const max_threads = vm["max-threads"].as<std::size_t>();
+    auto const perftest_json = vm["perftest-json"].as<bool>();
+
+    pika::util::detail::json_perf_times t;
+    if (!perftest_json) { fmt::print("threads,shared_ns,sharded_ns\n"); }
+
+    for (std::size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+    {
+        double const shared = run<shared_counter>(num_threads, iterations);
+        double const sharded = run<sharded_counter>(num_threads, iterations);
+
+        if (perftest_json)
+        {
+            t.add(fmt::format("global_activity_count - {} threads - shared", num_threads),
+                shared);
+            t.add(fmt::format("global_activity_count - {} threads - sharded", num_threads),
+                sharded);
+        }
+        else { fmt::print("{},{},{}\n", num_threads, shared, sharded); }
+    }
+
+    if (perftest_json) { std::cout << t; }
+
+    return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    variables_map vm;
+
+    options_description cmdline("Usage: " PIKA_APPLICATION_STRING " [options]");
+
+    // clang-format off
+    cmdline.add_options()
+        ("help,h", "print out program usage (this message)")
+        ("iterations", value<std::uint64_t>()->default_value(1000000), "number of increment and decrement pairs per thread")
+        ("max-threads", value<std::size_t>()->default_value(64), "largest number of threads to run with (doubling from 1)")
+        ("perftest-json", pika::program_options::bool_switch(), "print times per increment and decrement pair in json format for use with performance CI")
+        // clang-format on
+        ;
+
+    store(command_line_parser(argc, argv).options(cmdline).run(), vm);
+
+    notify(vm);
+
+    if (vm.count("help"))
+    {
+        std::cout << cmdline;
+        return 0;
+    }
+
+    return app_main(vm);
+}
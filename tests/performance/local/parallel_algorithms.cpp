@@ -0,0 +1,234 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark compares the algorithms of pika::algorithms on the
+// thread_pool_scheduler with the serial standard algorithms and, if pika is
+// configured with PIKA_WITH_EXAMPLES_TBB, with the parallel algorithms of
+// TBB using the same number of threads as pika.
+
+#include <pika/algorithms.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/modules/timing.hpp>
+#include <pika/runtime.hpp>
+#include <pika/testing/performance.hpp>
+
+#if defined(PIKA_PARALLEL_ALGORITHMS_WITH_TBB)
+# include <tbb/blocked_range.h>
+# include <tbb/global_control.h>
+# include <tbb/parallel_for.h>
+# include <tbb/parallel_scan.h>
+# include <tbb/parallel_sort.h>
+#endif
+
+#include <fmt/format.h>
+#include <fmt/printf.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace pa = pika::algorithms::experimental;
+namespace po = pika::program_options;
+namespace tt = pika::this_thread::experimental;
+
+struct result
+{
+    std::string algorithm;
+    std::string implementation;
+    double time;
+};
+
+// Returns the average time of f over the repetitions, not counting the time
+// of setup which is called before each repetition
+template <typename Setup, typename F>
+double time_average(std::uint64_t repetitions, Setup&& setup, F&& f)
+{
+    double total = 0.0;
+    for (std::uint64_t r = 0; r < repetitions; ++r)
+    {
+        setup();
+        pika::chrono::detail::high_resolution_timer timer;
+        f();
+        total += timer.elapsed();
+    }
+    return total / double(repetitions);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int pika_main(po::variables_map& vm)
+{
+    auto const n = vm["n"].as<std::uint64_t>();
+    auto const repetitions = vm["repetitions"].as<std::uint64_t>();
+    auto const perftest_json = vm["perftest-json"].as<bool>();
+    auto const num_threads = pika::get_num_worker_threads();
+
+#if defined(PIKA_PARALLEL_ALGORITHMS_WITH_TBB)
+    tbb::global_control tbb_threads(tbb::global_control::max_allowed_parallelism, num_threads);
+#endif
+
+    ex::thread_pool_scheduler sched{};
+    std::vector<double> input(n);
+    std::vector<double> output(n);
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    for (auto& x : input) { x = dist(gen); }
+    std::vector<double> unsorted = input;
+
+    auto const no_setup = [] {};
+    auto const reset_input = [&] { input = unsorted; };
+    auto const f = [](double x) { return 2.0 * x + 1.0; };
+    auto const increment = [](double& x) { x += 1.0; };
+
+    std::vector<result> results;
+    auto const add = [&](std::string algorithm, std::string implementation, auto&& setup,
+                         auto&& run) {
+        double const time = time_average(repetitions, setup, run);
+        results.push_back({PIKA_MOVE(algorithm), PIKA_MOVE(implementation), time});
+    };
+
+    // for_each
+    add("for_each", "std", no_setup, [&] { std::for_each(input.begin(), input.end(), increment); });
+    add("for_each", "pika", no_setup,
+        [&] { tt::sync_wait(pa::for_each(sched, input.begin(), input.end(), increment)); });
+
+    // transform
+    add("transform", "std", no_setup,
+        [&] { std::transform(input.begin(), input.end(), output.begin(), f); });
+    add("transform", "pika", no_setup, [&] {
+        tt::sync_wait(pa::transform(sched, input.begin(), input.end(), output.begin(), f));
+    });
+
+    // copy
+    add("copy", "std", no_setup, [&] { std::copy(input.begin(), input.end(), output.begin()); });
+    add("copy", "pika", no_setup,
+        [&] { tt::sync_wait(pa::copy(sched, input.begin(), input.end(), output.begin())); });
+
+    // fill
+    add("fill", "std", no_setup, [&] { std::fill(output.begin(), output.end(), 1.0); });
+    add("fill", "pika", no_setup,
+        [&] { tt::sync_wait(pa::fill(sched, output.begin(), output.end(), 1.0)); });
+
+    // sort
+    add("sort", "std", reset_input, [&] { std::sort(input.begin(), input.end()); });
+    add("sort", "pika", reset_input,
+        [&] { tt::sync_wait(pa::sort(sched, input.begin(), input.end())); });
+
+    // inclusive_scan
+    add("inclusive_scan", "std", no_setup,
+        [&] { std::inclusive_scan(input.begin(), input.end(), output.begin()); });
+    add("inclusive_scan", "pika", no_setup, [&] {
+        tt::sync_wait(pa::inclusive_scan(sched, input.begin(), input.end(), output.begin()));
+    });
+
+    // exclusive_scan
+    add("exclusive_scan", "std", no_setup,
+        [&] { std::exclusive_scan(input.begin(), input.end(), output.begin(), 0.0); });
+    add("exclusive_scan", "pika", no_setup, [&] {
+        tt::sync_wait(pa::exclusive_scan(sched, input.begin(), input.end(), output.begin(), 0.0));
+    });
+
+#if defined(PIKA_PARALLEL_ALGORITHMS_WITH_TBB)
+    using range_type = tbb::blocked_range<std::size_t>;
+    range_type const range(0, n);
+
+    add("for_each", "tbb", no_setup, [&] {
+        tbb::parallel_for(range, [&](range_type const& r) {
+            for (std::size_t i = r.begin(); i != r.end(); ++i) { increment(input[i]); }
+        });
+    });
+    add("transform", "tbb", no_setup, [&] {
+        tbb::parallel_for(range, [&](range_type const& r) {
+            for (std::size_t i = r.begin(); i != r.end(); ++i) { output[i] = f(input[i]); }
+        });
+    });
+    add("copy", "tbb", no_setup, [&] {
+        tbb::parallel_for(range, [&](range_type const& r) {
+            std::copy(input.begin() + r.begin(), input.begin() + r.end(),
+                output.begin() + r.begin());
+        });
+    });
+    add("fill", "tbb", no_setup, [&] {
+        tbb::parallel_for(range, [&](range_type const& r) {
+            std::fill(output.begin() + r.begin(), output.begin() + r.end(), 1.0);
+        });
+    });
+    add("sort", "tbb", reset_input, [&] { tbb::parallel_sort(input.begin(), input.end()); });
+
+    auto const tbb_scan = [&](bool inclusive) {
+        tbb::parallel_scan(
+            range, 0.0,
+            [&](range_type const& r, double sum, bool is_final_scan) {
+                for (std::size_t i = r.begin(); i != r.end(); ++i)
+                {
+                    if (is_final_scan && !inclusive) { output[i] = sum; }
+                    sum += input[i];
+                    if (is_final_scan && inclusive) { output[i] = sum; }
+                }
+                return sum;
+            },
+            std::plus<>{});
+    };
+    add("inclusive_scan", "tbb", no_setup, [&] { tbb_scan(true); });
+    add("exclusive_scan", "tbb", no_setup, [&] { tbb_scan(false); });
+#endif
+
+    std::stable_sort(results.begin(), results.end(),
+        [](result const& a, result const& b) { return a.algorithm < b.algorithm; });
+
+    if (perftest_json)
+    {
+        pika::util::detail::json_perf_times t;
+        for (auto const& r : results)
+        {
+            t.add(fmt::format("parallel_algorithms - {} threads - {} - {}", num_threads,
+                      r.algorithm, r.implementation),
+                r.time);
+        }
+        std::cout << t;
+    }
+    else
+    {
+        fmt::print("algorithm,implementation,elements,threads,time_us\n");
+        for (auto const& r : results)
+        {
+            fmt::print(
+                "{},{},{},{},{}\n", r.algorithm, r.implementation, n, num_threads, r.time * 1e6);
+        }
+    }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    po::options_description cmdline("usage: " PIKA_APPLICATION_STRING " [options]");
+
+    // clang-format off
+    cmdline.add_options()
+        ("n", po::value<std::uint64_t>()->default_value(10000000), "number of elements")
+        ("repetitions", po::value<std::uint64_t>()->default_value(10), "number of times each algorithm is run")
+        ("perftest-json", po::bool_switch(), "print average time per algorithm in json format for use with performance CI")
+        // clang-format on
+        ;
+
+    // Initialize and run pika.
+    pika::init_params init_args;
+    init_args.desc_cmdline = cmdline;
+
+    return pika::init(pika_main, argc, argv, init_args);
+}
@@ -14,18 +14,21 @@
 // to 999999), which are summed on the previous level and sent back upstream,
 // until reaching the root actor. (The answer should be 499999500000).
 
-// This code implements two versions of the skynet micro benchmark: a 'normal'
-// and a futurized one.
+// This code implements two versions of the skynet micro benchmark: one which
+// blocks on the results of the child actors and one which composes senders.
 
-#include <pika/chrono.hpp>
-#include <pika/future.hpp>
+#include <pika/execution.hpp>
 #include <pika/init.hpp>
 
 #include <chrono>
 #include <cstdint>
 #include <iostream>
+#include <utility>
 #include <vector>
 
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
 ///////////////////////////////////////////////////////////////////////////////
 std::int64_t skynet(std::int64_t num, std::int64_t size, std::int64_t div)
 {
@@ -33,49 +36,50 @@ std::int64_t skynet(std::int64_t num, std::int64_t size, std::int64_t div)
     {
         size /= div;
 
-        std::vector<pika::future<std::int64_t>> results;
+        std::vector<ex::unique_any_sender<std::int64_t>> results;
         results.reserve(div);
 
         for (std::int64_t i = 0; i != div; ++i)
         {
             std::int64_t sub_num = num + i * size;
-            results.push_back(pika::async(skynet, sub_num, size, div));
+            results.emplace_back(
+                ex::transfer_just(ex::thread_pool_scheduler{}, sub_num, size, div) |
+                ex::then(skynet) | ex::ensure_started());
         }
 
-        pika::wait_all(results);
-
         std::int64_t sum = 0;
-        for (auto& f : results) sum += f.get();
+        for (auto& s : results) sum += tt::sync_wait(std::move(s));
         return sum;
     }
     return num;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-pika::future<std::int64_t> skynet_f(std::int64_t num, std::int64_t size, std::int64_t div)
+ex::unique_any_sender<std::int64_t> skynet_s(std::int64_t num, std::int64_t size, std::int64_t div)
 {
     if (size != 1)
     {
         size /= div;
 
-        std::vector<pika::future<std::int64_t>> results;
+        std::vector<ex::unique_any_sender<std::int64_t>> results;
         results.reserve(div);
 
         for (std::int64_t i = 0; i != div; ++i)
         {
             std::int64_t sub_num = num + i * size;
-            results.push_back(pika::async(skynet_f, sub_num, size, div));
+            results.emplace_back(
+                ex::transfer_just(ex::thread_pool_scheduler{}, sub_num, size, div) |
+                ex::let_value(skynet_s));
         }
 
-        return pika::dataflow(
-            [](std::vector<pika::future<std::int64_t>>&& sums) {
+        return ex::when_all_vector(std::move(results)) |
+            ex::then([](std::vector<std::int64_t>&& sums) {
                 std::int64_t sum = 0;
-                for (auto& f : sums) sum += f.get();
+                for (auto s : sums) sum += s;
                 return sum;
-            },
-            results);
+            });
     }
-    return pika::make_ready_future(num);
+    return ex::just(num);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -85,25 +89,26 @@ int pika_main()
         using namespace std::chrono;
         auto start = high_resolution_clock::now();
 
-        pika::future<std::int64_t> result = pika::async(skynet, 0, 1000000, 10);
-        result.wait();
+        std::int64_t result = tt::sync_wait(
+            ex::transfer_just(ex::thread_pool_scheduler{}, 0, 1000000, 10) | ex::then(skynet));
 
         auto dur = duration_cast<milliseconds>(high_resolution_clock::now() - start);
 
-        std::cout << "Result 1: " << result.get() << " in " << dur.count() << " ms.\n";
+        std::cout << "Result 1: " << result << " in " << dur.count() << " ms.\n";
     }
 
     {
         using namespace std::chrono;
         auto start = high_resolution_clock::now();
 
-        pika::future<std::int64_t> result = pika::async(skynet_f, 0, 1000000, 10);
-        result.wait();
+        std::int64_t result = tt::sync_wait(skynet_s(0, 1000000, 10));
 
         auto dur = duration_cast<milliseconds>(high_resolution_clock::now() - start);
 
-        std::cout << "Result 2: " << result.get() << " in " << dur.count() << " ms.\n";
+        std::cout << "Result 2: " << result << " in " << dur.count() << " ms.\n";
     }
+
+    pika::finalize();
     return 0;
 }
 
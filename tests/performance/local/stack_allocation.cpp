@@ -0,0 +1,154 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark measures the time to allocate, first touch, and free
+// coroutine stacks when each stack is mapped separately and when stacks are
+// carved from the slabs of the stack arena (pika.stacks.arena). Guard pages
+// are used if enabled in the configuration (pika.stacks.use_guard_pages), in
+// the arena with one guard page per slab or, with
+// pika.stacks.arena_guard_per_stack, per stack. Unlike task_overhead
+// --live-tasks this measures only the stack allocation, without the cost of
+// creating and scheduling tasks.
+//
+// The benchmark also reports the number of memory mappings added while all
+// stacks are allocated, counted as lines of /proc/self/maps. Each mapping
+// counts towards the vm.max_map_count limit.
+
+#include <pika/coroutines/detail/posix_utility.hpp>
+#include <pika/init.hpp>
+#include <pika/modules/timing.hpp>
+#include <pika/testing/performance.hpp>
+
+#include <fmt/format.h>
+#include <fmt/printf.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace po = pika::program_options;
+namespace posix = pika::threads::coroutines::detail::posix;
+
+struct result
+{
+    char const* mode;
+    double alloc_time;
+    double free_time;
+    std::ptrdiff_t mappings;
+};
+
+// Returns the number of memory mappings of the process, or zero if
+// /proc/self/maps is not available
+std::ptrdiff_t count_mappings()
+{
+    std::ifstream maps("/proc/self/maps");
+    std::ptrdiff_t count = 0;
+    for (std::string line; std::getline(maps, line);) { ++count; }
+    return count;
+}
+
+result run(bool arena, std::size_t stacks, std::size_t stack_size, std::uint64_t repetitions)
+{
+    posix::use_stack_arena = arena;
+
+    std::vector<void*> allocated(stacks);
+    double alloc_time = 0.0;
+    double free_time = 0.0;
+    std::ptrdiff_t mappings = 0;
+    for (std::uint64_t r = 0; r < repetitions; ++r)
+    {
+        std::ptrdiff_t const mappings_before = count_mappings();
+
+        pika::chrono::detail::high_resolution_timer timer;
+        for (auto& stack : allocated)
+        {
+            stack = posix::alloc_stack(stack_size);
+
+            // Stacks grow downwards, a task touches at least the topmost page
+            static_cast<char volatile*>(stack)[stack_size - 1] = 0;
+        }
+        alloc_time += timer.elapsed();
+
+        // Counted outside of the timed region
+        mappings = (std::max)(mappings, count_mappings() - mappings_before);
+
+        timer.restart();
+        for (auto stack : allocated) { posix::free_stack(stack, stack_size); }
+        free_time += timer.elapsed();
+    }
+
+    double const count = double(stacks) * double(repetitions);
+    return {arena ? "arena" : "mapped", alloc_time / count, free_time / count, mappings};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int pika_main(po::variables_map& vm)
+{
+    auto const stacks = vm["stacks"].as<std::size_t>();
+    auto const stack_size = vm["stack-size"].as<std::size_t>();
+    auto const repetitions = vm["repetitions"].as<std::uint64_t>();
+    auto const perftest_json = vm["perftest-json"].as<bool>();
+
+    bool const use_stack_arena = posix::use_stack_arena;
+    result const results[] = {run(false, stacks, stack_size, repetitions),
+        run(true, stacks, stack_size, repetitions)};
+    posix::use_stack_arena = use_stack_arena;
+
+    if (perftest_json)
+    {
+        pika::util::detail::json_perf_times t;
+        for (auto const& r : results)
+        {
+            t.add(fmt::format("stack_allocation - {} - alloc", r.mode), r.alloc_time);
+            t.add(fmt::format("stack_allocation - {} - free", r.mode), r.free_time);
+        }
+        std::cout << t;
+    }
+    else
+    {
+        fmt::print("mode,stacks,stack_size,guard_pages,arena_guard_per_stack,alloc_time_us,"
+                   "free_time_us,mappings\n");
+        for (auto const& r : results)
+        {
+            fmt::print("{},{},{},{},{},{},{},{}\n", r.mode, stacks, stack_size,
+                posix::use_guard_pages, posix::use_stack_arena_guard_per_stack,
+                r.alloc_time * 1e6, r.free_time * 1e6, r.mappings);
+        }
+    }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    po::options_description cmdline("usage: " PIKA_APPLICATION_STRING " [options]");
+
+    // clang-format off
+    cmdline.add_options()
+        ("stacks", po::value<std::size_t>()->default_value(20000),
+         "number of stacks allocated at the same time")
+        ("stack-size", po::value<std::size_t>()->default_value(0x20000),
+         "size of the stacks in bytes, has to be a multiple of the page size")
+        ("repetitions", po::value<std::uint64_t>()->default_value(5),
+         "number of times the stacks are allocated and freed")
+        ("perftest-json", po::bool_switch(),
+         "print average times per stack in json format for use with performance CI")
+        // clang-format on
+        ;
+
+    // Initialize and run pika.
+    pika::init_params init_args;
+    init_args.desc_cmdline = cmdline;
+
+    return pika::init(pika_main, argc, argv, init_args);
+}
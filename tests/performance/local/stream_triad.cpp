@@ -0,0 +1,133 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark measures the memory bandwidth of the STREAM triad kernel,
+// a[i] = b[i] + s * c[i], run with bulk on the thread_pool_scheduler with
+// and without NUMA affinity. The arrays are allocated without being touched
+// and are first touched by a bulk on the same scheduler as the triad, so
+// that with NUMA affinity each page is mostly accessed from the NUMA domain
+// that it was placed in.
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/modules/timing.hpp>
+#include <pika/runtime.hpp>
+#include <pika/testing/performance.hpp>
+
+#include <fmt/format.h>
+#include <fmt/printf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace ex = pika::execution::experimental;
+namespace po = pika::program_options;
+namespace tt = pika::this_thread::experimental;
+
+// Returns the average bandwidth of the triad in GB/s
+double stream_triad(ex::thread_pool_scheduler const& sched, std::uint64_t n,
+    std::uint64_t repetitions)
+{
+    // The arrays are default-initialized so that the pages are first
+    // touched by the bulk below
+    std::unique_ptr<double[]> a(new double[n]);
+    std::unique_ptr<double[]> b(new double[n]);
+    std::unique_ptr<double[]> c(new double[n]);
+
+    tt::sync_wait(ex::schedule(sched) | ex::bulk(n, [&](std::uint64_t i) {
+        a[i] = 0.0;
+        b[i] = 1.0;
+        c[i] = 2.0;
+    }));
+
+    double const s = 3.0;
+    auto triad = ex::schedule(sched) |
+        ex::bulk(n, [a = a.get(), b = b.get(), c = c.get(), s](std::uint64_t i) {
+            a[i] = b[i] + s * c[i];
+        });
+
+    // Warm up
+    tt::sync_wait(triad);
+
+    pika::chrono::detail::high_resolution_timer timer;
+    for (std::uint64_t r = 0; r < repetitions; ++r) { tt::sync_wait(triad); }
+    double const elapsed = timer.elapsed();
+
+    for (std::uint64_t i = 0; i < n; ++i)
+    {
+        if (a[i] != 7.0)
+        {
+            std::cerr << "stream_triad: wrong result at index " << i << "\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    // The triad reads two arrays and writes one
+    double const bytes = 3.0 * sizeof(double) * double(n) * double(repetitions);
+    return bytes / elapsed / 1e9;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int pika_main(po::variables_map& vm)
+{
+    auto const n = vm["n"].as<std::uint64_t>();
+    auto const repetitions = vm["repetitions"].as<std::uint64_t>();
+    auto const chunk_size = vm["chunk-size"].as<std::size_t>();
+    auto const perftest_json = vm["perftest-json"].as<bool>();
+    auto const num_threads = pika::get_num_worker_threads();
+
+    auto const sched = ex::with_chunk_size(ex::thread_pool_scheduler{}, chunk_size);
+    double const bandwidth = stream_triad(sched, n, repetitions);
+    double const bandwidth_numa =
+        stream_triad(ex::with_numa_affinity(sched, true), n, repetitions);
+
+    if (perftest_json)
+    {
+        // The time per triad is reported for consistency with the other
+        // benchmarks
+        double const bytes = 3.0 * sizeof(double) * double(n);
+        pika::util::detail::json_perf_times t;
+        t.add(fmt::format("stream_triad - {} threads - default", num_threads),
+            bytes / bandwidth / 1e9);
+        t.add(fmt::format("stream_triad - {} threads - numa affinity", num_threads),
+            bytes / bandwidth_numa / 1e9);
+        std::cout << t;
+    }
+    else
+    {
+        fmt::print("placement,elements,threads,bandwidth_gb_s\n");
+        fmt::print("default,{},{},{}\n", n, num_threads, bandwidth);
+        fmt::print("numa affinity,{},{},{}\n", n, num_threads, bandwidth_numa);
+    }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    po::options_description cmdline("usage: " PIKA_APPLICATION_STRING " [options]");
+
+    // clang-format off
+    cmdline.add_options()
+        ("n", po::value<std::uint64_t>()->default_value(20000000), "number of elements per array")
+        ("repetitions", po::value<std::uint64_t>()->default_value(10), "number of times the triad is run")
+        ("chunk-size", po::value<std::size_t>()->default_value(0), "chunk size of the bulk (0 for adaptive chunking)")
+        ("perftest-json", po::bool_switch(), "print average time per triad in json format for use with performance CI")
+        // clang-format on
+        ;
+
+    // Initialize and run pika.
+    pika::init_params init_args;
+    init_args.desc_cmdline = cmdline;
+
+    return pika::init(pika_main, argc, argv, init_args);
+}
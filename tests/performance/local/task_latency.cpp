@@ -40,6 +40,12 @@ int pika_main(po::variables_map& vm)
     auto const repetitions = vm["repetitions"].as<std::uint64_t>();
     auto const nostack = vm["nostack"].as<bool>();
     auto const perftest_json = vm["perftest-json"].as<bool>();
+    auto const next_thread_slot = vm["next-thread-slot"].as<bool>();
+
+    if (next_thread_slot)
+    {
+        pika::threads::add_scheduler_mode(pika::threads::scheduler_mode::enable_next_thread_slot);
+    }
 
     double time_avg_s = 0.0;
     double time_min_s = std::numeric_limits<double>::max();
@@ -76,8 +82,9 @@ int pika_main(po::variables_map& vm)
     if (perftest_json)
     {
         pika::util::detail::json_perf_times t;
-        t.add(fmt::format("task_latency - {} threads - {}", pika::get_num_worker_threads(),
-                  nostack ? "nostack" : "default stack"),
+        t.add(fmt::format("task_latency - {} threads - {}{}", pika::get_num_worker_threads(),
+                  nostack ? "nostack" : "default stack",
+                  next_thread_slot ? " - next thread slot" : ""),
             time_avg_us);
         std::cout << t;
     }
@@ -99,8 +106,12 @@ int main(int argc, char* argv[])
     // clang-format off
     cmdline.add_options()
         ("nostack", po::bool_switch(), "use stackless threads")
-        ("repetitions", po::value<std::uint64_t>()->default_value(1), "number of repetitions of the benchmark")
-        ("perftest-json", po::bool_switch(), "print final task size in json format for use with performance CI")
+        ("repetitions", po::value<std::uint64_t>()->default_value(1),
+         "number of repetitions of the benchmark")
+        ("perftest-json", po::bool_switch(),
+         "print final task size in json format for use with performance CI")
+        ("next-thread-slot", po::bool_switch(),
+         "run threads which are woken up by a worker thread next on that worker thread")
         // clang-format on
         ;
 
@@ -19,11 +19,13 @@
 #include <fmt/ostream.h>
 #include <fmt/printf.h>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -32,6 +34,10 @@
 #include <utility>
 #include <vector>
 
+#if defined(PIKA_HAVE_UNISTD_H)
+# include <unistd.h>
+#endif
+
 using pika::program_options::options_description;
 using pika::program_options::value;
 using pika::program_options::variables_map;
@@ -336,6 +342,71 @@ void function_apply_hierarchical_placement(std::uint64_t count, bool csv)
     print_stats("execute_hierarchical", "latch", "thread_pool_scheduler", count, duration, csv);
 }
 
+// Returns the resident set size of the process in bytes, or 0 if it can not be
+// determined
+std::size_t resident_set_size()
+{
+#if defined(__linux) || defined(linux) || defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    std::size_t size = 0;
+    std::size_t resident = 0;
+    if (statm >> size >> resident)
+    {
+        return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+// Keeps all tasks alive until the last one has been spawned, so that each task
+// needs its own stack. This measures the cost of allocating (and faulting in)
+// new stacks instead of reusing the stacks of terminated tasks.
+void function_create_thread_live(std::uint64_t count, bool csv)
+{
+    pika::latch started(count + 1);
+    pika::latch finished(count);
+
+    auto const sched = pika::threads::detail::get_self_id_data()->get_scheduler_base();
+    auto func = [&]() {
+        started.arrive_and_wait();
+        null_function();
+        finished.count_down(1);
+    };
+    auto const thread_func = pika::threads::detail::thread_function_nullary<decltype(func)>{func};
+    auto const desc = pika::detail::thread_description();
+    auto const prio = pika::execution::thread_priority::normal;
+    auto const hint = pika::execution::thread_schedule_hint();
+    auto const stack_size = pika::execution::thread_stacksize::small_;
+    pika::error_code ec;
+
+    std::size_t const rss_before = resident_set_size();
+
+    // start the clock
+    high_resolution_timer walltime;
+    for (std::uint64_t i = 0; i < count; ++i)
+    {
+        auto init = pika::threads::detail::thread_init_data(
+            pika::threads::detail::thread_function_type(thread_func), desc, prio, hint, stack_size,
+            pika::threads::detail::thread_schedule_state::pending, false, sched);
+        sched->create_thread(init, nullptr, ec);
+    }
+    started.arrive_and_wait();
+    double const spawn_duration = walltime.elapsed();
+    std::size_t const rss_live = resident_set_size();
+    finished.wait();
+
+    // stop the clock
+    const double duration = walltime.elapsed();
+    print_stats("create_thread_live", "latch", "none", count, duration, csv);
+    if (!csv)
+    {
+        fmt::print(std::cout,
+            "spawned {} live tasks in {} seconds : {} us/task, rss increase {} MiB\n", count,
+            spawn_duration, 1e6 * spawn_duration / count,
+            (rss_live - (std::min)(rss_before, rss_live)) / double(1 << 20));
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 int pika_main(variables_map& vm)
 {
@@ -357,6 +428,7 @@ int pika_main(variables_map& vm)
         num_iterations = vm["delay-iterations"].as<std::uint64_t>();
 
         const std::uint64_t count = vm["tasks"].as<std::uint64_t>();
+        const std::uint64_t live_count = vm["live-tasks"].as<std::uint64_t>();
         bool csv = vm.count("csv") != 0;
         if (PIKA_UNLIKELY(0 == count))
             throw std::logic_error("error: count of 0 tasks specified\n");
@@ -377,6 +449,7 @@ int pika_main(variables_map& vm)
                 function_create_thread(count, csv);
                 function_apply_hierarchical_placement(count, csv);
             }
+            if (live_count > 0) { function_create_thread_live(live_count, csv); }
         }
     }
 
@@ -395,6 +468,10 @@ int main(int argc, char* argv[])
         value<std::uint64_t>()->default_value(500000),
         "number of tasks to invoke")
 
+        ("live-tasks", value<std::uint64_t>()->default_value(0),
+         "number of tasks to keep alive at the same time to measure stack allocation "
+         "(0 to disable)")
+
         ("delay-iterations", value<std::uint64_t>()->default_value(0),
          "number of iterations in the delay loop")
 
@@ -0,0 +1,119 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark measures the overhead of scheduling continuations with
+// thread_pool_scheduler. Each step of a chain starts the next step as a
+// continuation of schedule() on the same scheduler, so that the steps run one
+// after the other.
+
+#include <pika/config.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/latch.hpp>
+#include <pika/modules/timing.hpp>
+#include <pika/runtime.hpp>
+#include <pika/testing/performance.hpp>
+#include <pika/thread.hpp>
+
+#include <fmt/format.h>
+#include <fmt/printf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+namespace ex = pika::execution::experimental;
+namespace po = pika::program_options;
+
+struct chain_step
+{
+    ex::thread_pool_scheduler sched;
+    std::uint64_t remaining;
+    pika::latch* done;
+
+    void operator()() const
+    {
+        if (remaining == 0)
+        {
+            done->count_down(1);
+            return;
+        }
+
+        ex::start_detached(
+            ex::schedule(sched) | ex::then(chain_step{sched, remaining - 1, done}));
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+int pika_main(po::variables_map& vm)
+{
+    using pika::chrono::detail::high_resolution_timer;
+
+    auto const steps = vm["steps"].as<std::uint64_t>();
+    auto const chains = vm["chains"].as<std::uint64_t>();
+    auto const stackless = vm["stackless"].as<bool>();
+    auto const perftest_json = vm["perftest-json"].as<bool>();
+
+    if (stackless)
+    {
+        pika::threads::add_scheduler_mode(pika::threads::scheduler_mode::enable_stackless_senders);
+    }
+
+    pika::latch done(static_cast<std::ptrdiff_t>(chains + 1));
+
+    high_resolution_timer timer;
+
+    for (std::uint64_t i = 0; i < chains; ++i)
+    {
+        chain_step{ex::thread_pool_scheduler{}, steps, &done}();
+    }
+    done.arrive_and_wait();
+
+    double const time_s = timer.elapsed();
+    double const time_per_step_ns = time_s * 1e9 / double(steps);
+
+    if (perftest_json)
+    {
+        pika::util::detail::json_perf_times t;
+        t.add(fmt::format("then_chain - {} threads - {} chains{}", pika::get_num_worker_threads(),
+                  chains, stackless ? " - stackless" : ""),
+            time_per_step_ns);
+        std::cout << t;
+    }
+    else
+    {
+        fmt::print("steps,chains,time_s,time_per_step_ns\n");
+        fmt::print("{},{},{},{}\n", steps, chains, time_s, time_per_step_ns);
+    }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    po::options_description cmdline("usage: " PIKA_APPLICATION_STRING " [options]");
+
+    // clang-format off
+    cmdline.add_options()
+        ("steps", po::value<std::uint64_t>()->default_value(10000000),
+         "number of continuations in each chain")
+        ("chains", po::value<std::uint64_t>()->default_value(1),
+         "number of chains running concurrently")
+        ("stackless", po::bool_switch(), "run continuations as stackless tasks")
+        ("perftest-json", po::bool_switch(),
+         "print average time per continuation in json format for use with performance CI")
+        // clang-format on
+        ;
+
+    // Initialize and run pika.
+    pika::init_params init_args;
+    init_args.desc_cmdline = cmdline;
+
+    return pika::init(pika_main, argc, argv, init_args);
+}
@@ -0,0 +1,134 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark submits tasks from a thread outside the runtime at a low rate
+// and measures the time between submitting a task and the task starting to
+// run, as well as the CPU time used by the process while the worker threads
+// are mostly idle.
+
+#include <pika/config.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/latch.hpp>
+#include <pika/modules/timing.hpp>
+#include <pika/runtime.hpp>
+#include <pika/testing/performance.hpp>
+#include <pika/thread.hpp>
+
+#include <fmt/format.h>
+#include <fmt/printf.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace po = pika::program_options;
+
+///////////////////////////////////////////////////////////////////////////////
+int pika_main(po::variables_map& vm)
+{
+    using clock = std::chrono::steady_clock;
+
+    auto const tasks = vm["tasks"].as<std::uint64_t>();
+    auto const interval = std::chrono::microseconds(vm["interval-us"].as<std::uint64_t>());
+    auto const perftest_json = vm["perftest-json"].as<bool>();
+    auto const idle_backoff = vm["idle-backoff"].as<bool>();
+
+    if (idle_backoff)
+    {
+        pika::threads::add_scheduler_mode(pika::threads::scheduler_mode::enable_idle_backoff);
+    }
+
+    std::vector<double> latencies_us(tasks);
+    pika::latch done(static_cast<std::ptrdiff_t>(tasks + 1));
+
+    std::clock_t const cpu_start = std::clock();
+    auto const wall_start = clock::now();
+
+    std::thread submitter([&] {
+        for (std::uint64_t i = 0; i < tasks; ++i)
+        {
+            std::this_thread::sleep_for(interval);
+
+            auto const submitted = clock::now();
+            ex::execute(ex::thread_pool_scheduler{}, [&, i, submitted] {
+                latencies_us[i] =
+                    std::chrono::duration<double, std::micro>(clock::now() - submitted).count();
+                done.count_down(1);
+            });
+        }
+    });
+
+    done.arrive_and_wait();
+
+    double const wall_s = std::chrono::duration<double>(clock::now() - wall_start).count();
+    double const cpu_s = double(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+    submitter.join();
+
+    double latency_avg_us = 0.0;
+    double latency_min_us = std::numeric_limits<double>::max();
+    double latency_max_us = 0.0;
+    for (double l : latencies_us)
+    {
+        latency_avg_us += l;
+        latency_min_us = (std::min)(latency_min_us, l);
+        latency_max_us = (std::max)(latency_max_us, l);
+    }
+    latency_avg_us /= double(tasks);
+
+    // CPU time used per worker thread relative to the elapsed time, 1.0 means
+    // that the worker threads were spinning all the time
+    double const cpu_utilization = cpu_s / (wall_s * double(pika::get_num_worker_threads()));
+
+    if (perftest_json)
+    {
+        pika::util::detail::json_perf_times t;
+        t.add(fmt::format("wake_latency - {} threads{}", pika::get_num_worker_threads(),
+                  idle_backoff ? " - idle backoff" : ""),
+            latency_avg_us);
+        std::cout << t;
+    }
+    else
+    {
+        fmt::print("tasks,interval_us,latency_avg_us,latency_min_us,latency_max_us,wall_time_s,"
+                   "cpu_time_s,cpu_utilization\n");
+        fmt::print("{},{},{},{},{},{},{},{}\n", tasks, interval.count(), latency_avg_us,
+            latency_min_us, latency_max_us, wall_s, cpu_s, cpu_utilization);
+    }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    po::options_description cmdline("usage: " PIKA_APPLICATION_STRING " [options]");
+
+    // clang-format off
+    cmdline.add_options()
+        ("tasks", po::value<std::uint64_t>()->default_value(1000), "number of tasks to submit")
+        ("interval-us", po::value<std::uint64_t>()->default_value(1000), "time between submitting two tasks (in microseconds)")
+        ("idle-backoff", po::bool_switch(), "let idle worker threads park instead of spinning")
+        ("perftest-json", po::bool_switch(), "print average latency in json format for use with performance CI")
+        // clang-format on
+        ;
+
+    // Initialize and run pika.
+    pika::init_params init_args;
+    init_args.desc_cmdline = cmdline;
+
+    return pika::init(pika_main, argc, argv, init_args);
+}
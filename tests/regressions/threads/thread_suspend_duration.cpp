@@ -15,6 +15,7 @@
 #include <cstddef>
 #include <cstdlib>
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -24,12 +25,12 @@ using pika::program_options::variables_map;
 
 using pika::threads::detail::register_work;
 
-using pika::barrier;
+using barrier = pika::barrier<>;
 
 using std::chrono::microseconds;
 
 ///////////////////////////////////////////////////////////////////////////////
-void suspend_test(barrier& b, std::size_t iterations, std::size_t n)
+void suspend_test(std::shared_ptr<barrier> b, std::size_t iterations, std::size_t n)
 {
     for (std::size_t i = 0; i < iterations; ++i)
     {
@@ -38,7 +39,7 @@ void suspend_test(barrier& b, std::size_t iterations, std::size_t n)
     }
 
     // Wait for all pika threads to enter the barrier.
-    b.wait();
+    b->arrive_and_wait();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -57,19 +58,21 @@ int pika_main(variables_map& vm)
     if (vm.count("suspend-duration")) suspend_duration = vm["suspend-duration"].as<std::size_t>();
 
     {
-        barrier b(pxthreads + 1);
+        // The barrier is shared with the pika threads as they may still be
+        // waiting on it when this thread leaves the scope.
+        auto b = std::make_shared<barrier>(pxthreads + 1);
 
         // Create the pika threads.
         for (std::size_t i = 0; i < pxthreads; ++i)
         {
             pika::threads::detail::thread_init_data data(
                 pika::threads::detail::make_thread_function_nullary(pika::util::detail::bind(
-                    &suspend_test, std::ref(b), iterations, suspend_duration)),
+                    &suspend_test, b, iterations, suspend_duration)),
                 "suspend_test");
             register_work(data);
         }
 
-        b.wait();    // Wait for all pika threads to enter the barrier.
+        b->arrive_and_wait();    // Wait for all pika threads to enter the barrier.
     }
 
     // Initiate shutdown of the runtime system.